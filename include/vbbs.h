@@ -33,20 +33,37 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string.h>
 #include <stdlib.h> 
 
+#include <vbbs/admin.h>
+#include <vbbs/arena.h>
 #include <vbbs/buffer.h>
 #include <vbbs/conn.h>
 #include <vbbs/crc.h>
 #include <vbbs/db.h>
+#include <vbbs/event.h>
 #include <vbbs/list.h>
 #include <vbbs/log.h>
 #include <vbbs/map.h>
+#include <vbbs/memory.h>
+#include <vbbs/metrics.h>
+#include <vbbs/msg.h>
+#include <vbbs/pbkdf2.h>
+#include <vbbs/pool.h>
+#include <vbbs/qwk.h>
 #include <vbbs/rb.h>
+#include <vbbs/search.h>
 #include <vbbs/session.h>
 #include <vbbs/sha1.h>
 #include <vbbs/terminal.h>
+#include <vbbs/throttle.h>
 #include <vbbs/time.h>
+#include <vbbs/transfer.h>
 #include <vbbs/user.h>
+#include <vbbs/worker.h>
+#include <vbbs/zip.h>
 
+#include <vbbs/db/lastread.h>
+#include <vbbs/db/msg.h>
+#include <vbbs/db/search.h>
 #include <vbbs/db/user.h>
 
 #include <vbbs/conn/console.h>
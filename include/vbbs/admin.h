@@ -0,0 +1,91 @@
+#ifndef VBBS_ADMIN_H
+#define VBBS_ADMIN_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+#include <vbbs/list.h>
+#include <vbbs/metrics.h>
+
+/**
+ * A read-only admin endpoint on a Unix domain socket, served from the main
+ * event loop. Send one line, "metrics", "json" or "sessions", or an HTTP
+ * GET of /metrics, /json or /sessions, and the answer comes back before the
+ * connection is closed. Every buffer is allocated with the listener, so
+ * answering a request never allocates.
+ */
+
+#define ADMIN_SOCKET_FILE "vbbs.sock"
+#define ADMIN_MAX_CLIENTS 4
+#define ADMIN_REQUEST_SIZE 256
+#define ADMIN_RESPONSE_SIZE 65536
+
+typedef struct AdminClient
+{
+    int socket;                    /* -1 when the slot is free */
+    char request[ADMIN_REQUEST_SIZE];
+    int requestLength;
+    char *response;                /* ADMIN_RESPONSE_SIZE bytes */
+    int responseLength;            /* 0 until the request is complete */
+    int responseSent;
+} AdminClient;
+
+typedef struct AdminListener
+{
+    int socket;
+    char path[108];
+    AdminClient clients[ADMIN_MAX_CLIENTS];
+} AdminListener;
+
+/** Listen on path, replacing a stale socket. Returns NULL on failure. */
+AdminListener *NewAdminListener(const char *path);
+
+/** Close every client and the listener, and remove the socket file. */
+void DestroyAdminListener(AdminListener *listener);
+
+/**
+ * The answer to one request line, written to out. HTTP requests are given
+ * a status line and headers.
+ */
+void BuildAdminResponse(const char *request, ArrayList *sessions,
+    MetricsText *out);
+
+#ifdef _POSIX_VERSION
+
+#include <sys/select.h>
+
+/** Add the listener and its clients to the sets, returning the new max. */
+int SetAdminFds(AdminListener *listener, fd_set *readFds, fd_set *writeFds,
+    int maxFd);
+
+/** Accept, read and answer whatever select() found ready. */
+void HandleAdminFds(AdminListener *listener, fd_set *readFds,
+    fd_set *writeFds, ArrayList *sessions);
+
+#endif /* _POSIX_VERSION */
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef VBBS_ARENA_H
+#define VBBS_ARENA_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+/**
+ * A bump pointer arena for scratch memory that is freed all at once, e.g.
+ * everything a session allocates for one screen. Allocations come from
+ * chunks of ARENA_CHUNK_SIZE, or a chunk of their own if larger. A mark
+ * records the current position and resetting to it frees everything
+ * allocated since. Like pools, an arena belongs to one thread.
+ */
+
+#define ARENA_CHUNK_SIZE 4096
+
+typedef struct ArenaChunk ArenaChunk;
+
+typedef struct Arena
+{
+    ArenaChunk *chunk;          /* Newest chunk, allocations come from here */
+    size_t used;                /* Bytes handed out */
+    size_t reserved;            /* Bytes in chunks, counted against limit */
+    size_t limit;               /* 0 for no limit */
+    size_t peak;                /* Most bytes reserved at once */
+    unsigned long refused;      /* Allocations that would pass the limit */
+} Arena;
+
+typedef struct ArenaMark
+{
+    ArenaChunk *chunk;
+    size_t offset;
+    size_t used;
+} ArenaMark;
+
+/** Start an empty arena which will reserve at most limit bytes. */
+void InitArena(Arena *arena, size_t limit);
+
+/**
+ * size bytes aligned as malloc would, or NULL if that would reserve more
+ * than the limit or malloc fails.
+ */
+void *ArenaAlloc(Arena *arena, size_t size);
+
+/** A copy of string, or NULL as for ArenaAlloc. */
+char *ArenaCopyString(Arena *arena, const char *string);
+
+ArenaMark GetArenaMark(const Arena *arena);
+
+/** Free everything allocated since mark was taken. */
+void ResetArena(Arena *arena, ArenaMark mark);
+
+/** Free everything. The arena can be used again afterwards. */
+void DestroyArena(Arena *arena);
+
+#endif
@@ -40,6 +40,8 @@ typedef void (*TerminalTypeHandler)(void *userData, const char *type);
 typedef void (*ConnectionSpeedHandler)(void *userData, const char *speed);
 /* EchoHandler is called when data is received so it can be echoed back. */
 typedef void (*EchoHandler)(void *userData, const char c);
+/* TelnetOptionHandler is called when a WILL, WONT, DO or DONT is received. */
+typedef void (*TelnetOptionHandler)(void *userData, int command, int option);
 
 typedef enum {
    ECHO_ON,
@@ -52,6 +54,8 @@ typedef struct Buffer {
    uint8_t *tail;  /* A pointer to the end of the buffer */
    int length;    /* The current size of the buffer */
    int maxSize; /* The maximum size of the buffer */
+   int capacity; /* Bytes allocated, grows as needed up to maxSize */
+   int initialSize; /* Bytes allocated by NewBuffer */
    bool convertNewlines; /* Whether to convert newlines */
    bool handleANSI; /* Whether to handle ANSI escape codes */
    bool handleTelnet; /* Whether to handle Telnet commands */
@@ -65,10 +69,19 @@ typedef struct Buffer {
    TerminalTypeHandler terminalType; /* Handler for terminal type */
    ConnectionSpeedHandler connectionSpeed; /* Handler for connection speed */
    EchoHandler echo; /* Handler for echoing data */
+   TelnetOptionHandler telnetOption; /* Handler for option negotiation */
 } Buffer;
 
 Buffer* NewBuffer(int size);
 void DestroyBuffer(Buffer *buffer);
+
+/**
+ * Let the buffer hold up to maxSize bytes. Space is allocated as writes
+ * need it, and the buffer goes back to its first size once it is cleared.
+ * maxSize must not be less than the size the buffer was created with.
+ */
+void SetBufferLimit(Buffer *buffer, int maxSize);
+
 void ClearBuffer(Buffer *buffer);
 bool IsBufferEmpty(Buffer *buffer);
 bool IsBufferFull(Buffer *buffer);
@@ -112,6 +125,7 @@ typedef struct InputBuffer {
    InputMode inputMode;
    char nextLine[256];
    bool nextLineReady;
+   int scanned; /* Leading bytes FindNextLine has checked for a CR */
 } InputBuffer;
 
 InputBuffer* NewInputBuffer(int size);
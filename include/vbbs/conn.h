@@ -33,6 +33,27 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vbbs/user.h>
 #include <vbbs/terminal.h>
 
+/**
+ * Output queued for a connection may grow to CONNECTION_OUTPUT_LIMIT bytes.
+ * Once it reaches the high watermark the session stops producing more, by
+ * no longer reading input and by pausing long listings, until it drains
+ * to the low watermark.
+ */
+#define CONNECTION_OUTPUT_LIMIT (64 * 1024)
+#define CONNECTION_OUTPUT_HIGH_WATER (16 * 1024)
+#define CONNECTION_OUTPUT_LOW_WATER (4 * 1024)
+
+/**
+ * A paced connection may send up to this many nanoseconds' worth of output
+ * at once, so a caller at any speed is woken at most about 20 times a
+ * second rather than once per byte.
+ */
+#define CONNECTION_OUTPUT_BURST_NANOS 50000000UL
+
+/* Negotiated speeds are clamped to what a serial line could manage. */
+#define CONNECTION_MIN_SPEED 50
+#define CONNECTION_MAX_SPEED 4000000
+
 typedef enum
 {
     CONSOLE,
@@ -63,6 +84,11 @@ typedef struct
     Buffer *outputBuffer;
     bool inEscape;
     bool inCSI;
+    bool binaryMode; /* The client has agreed to TELNET BINARY output */
+    struct Transfer *transfer; /* The active file transfer, if any */
+    bool outputPaused; /* Output passed the high watermark, not yet drained */
+    unsigned long outputNanosPerByte; /* 0 unless output is paced */
+    unsigned long outputReady; /* When the last paced byte is on the wire */
 } Connection;
 
 /* typedef void (*DisconnectFunction)(Connection *conn);*/
@@ -74,4 +100,39 @@ void WriteToConnection(Connection *conn, const char *format, ...);
 void WriteCharToConnection(Connection *conn, char c);
 int WriteBufferToConnection(Connection *conn);
 
+/**
+ * Set the output limit and watermarks for new connections. Returns FALSE,
+ * changing nothing, unless 0 < lowWater < highWater <= limit.
+ */
+bool SetOutputLimits(int limit, int highWater, int lowWater);
+void GetOutputLimits(int *limit, int *highWater, int *lowWater);
+
+/**
+ * Whether the session should hold off producing output. This becomes TRUE
+ * when the queued output reaches the high watermark and stays so until it
+ * drains to the low watermark.
+ */
+bool IsOutputPaused(Connection *conn);
+
+/**
+ * Emulate a serial line by pacing output at the caller's connection speed,
+ * ten bits per byte. New connections start at bitsPerSecond, until the
+ * caller negotiates its own speed. 0 turns pacing off for new connections.
+ */
+void SetOutputRate(unsigned int bitsPerSecond);
+unsigned int GetOutputRate(void);
+
+/**
+ * Record the speed of a connection, which also paces its output if output
+ * pacing is on. The speed is clamped to CONNECTION_MIN_SPEED through
+ * CONNECTION_MAX_SPEED, and a speed of 0 is ignored.
+ */
+void SetConnectionSpeed(Connection *conn, unsigned int bitsPerSecond);
+
+/**
+ * Nanoseconds until a paced connection may send a full burst, or all of its
+ * queued output if that is less. 0 when it may write now.
+ */
+unsigned long GetOutputDelay(Connection *conn);
+
 #endif
@@ -53,4 +53,7 @@ void DestroyTelnetConnection(Connection *conn);
 const char* TelnetRemoteAddress(Connection *conn);
 int TelnetRemotePort(Connection *conn);
 
+/** The remote IPv4 address in host byte order, or 0 if unknown. */
+uint32_t TelnetRemoteIP(Connection *conn);
+
 #endif
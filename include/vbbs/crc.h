@@ -30,6 +30,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define CCITT_POLY 0x1021
 #define CRC16_POLY 0xA001
+#define CRC32_POLY 0xEDB88320UL
 
 typedef enum {
     CRC16_CCITT = 0,
@@ -41,4 +42,11 @@ uint8_t ChecksumS(const char *str);
 uint16_t CRC16(CRC16_TYPE crc_type, const void *data, int len);
 uint16_t CRC16S(CRC16_TYPE crcType, const char *str);
 
+/**
+ * CRC-32 as used by ZIP and Ethernet. Pass 0 to start, or a previous result
+ * to continue the calculation over more data.
+ */
+uint32_t CRC32(uint32_t crc, const void *data, int len);
+uint32_t CRC32S(const char *str);
+
 #endif /* _VBBS_CRC_H */
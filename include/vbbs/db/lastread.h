@@ -0,0 +1,109 @@
+#ifndef VBBS_DB_LASTREAD_H
+#define VBBS_DB_LASTREAD_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/db/msg.h>
+
+#include <stdio.h>
+
+#define LASTREAD_DB_FILE "lastread.db"
+
+#define LASTREAD_MAGIC "VLR1"
+#define LASTREAD_VERSION 1
+
+/**
+ * Area IDs are used directly as the column in each user's row. Rows start
+ * LASTREAD_AREA_GROWTH wide and the file is rewritten with wider rows when
+ * a higher area ID appears, up to LASTREAD_MAX_AREAS.
+ */
+#define LASTREAD_AREA_GROWTH 16
+#define LASTREAD_MAX_AREAS 65536
+
+/** Number of user rows added each time the file has to grow. */
+#define LASTREAD_USER_GROWTH 64
+
+/**
+ * The first record of the last-read file. It is followed by one row of
+ * areaStride uint32_t values per user, indexed by user ID and then area ID,
+ * so the pointer for a user and area is found without searching and a
+ * user's pointers for every area are contiguous.
+ */
+typedef struct LastReadHeader
+{
+   char magic[4];
+   uint32_t version;
+   uint32_t areaStride;
+   uint32_t userCapacity;  /* Rows allocated in the file */
+   uint32_t reserved[4];
+} LastReadHeader;
+
+typedef struct LastReadDB
+{
+   char *filename;
+   FILE *file;
+   LastReadHeader *header;    /* Points into the map when mapped */
+   uint32_t *pointers;        /* Mapped rows, NULL if not mapped */
+   LastReadHeader headerCopy; /* Used when the file isn't mapped */
+   uint32_t *row;             /* Scratch row when the file isn't mapped */
+} LastReadDB;
+
+/** Unread message count for one area, as returned by NewScan. */
+typedef struct NewScanResult
+{
+   unsigned int areaID;
+   uint32_t highWater;
+   uint32_t lastRead;
+   uint32_t unread;
+} NewScanResult;
+
+extern LastReadDB *lastReadDB;
+
+bool LoadLastReadDB(void);
+uint32_t GetLastRead(unsigned int userID, unsigned int areaID);
+bool SetLastRead(unsigned int userID, unsigned int areaID, uint32_t number);
+
+/**
+ * Compare a user's last-read pointers with the high-water mark of every
+ * area in the message database. Fills in up to size results, one per area,
+ * and returns the number filled in or -1 on error. Message headers and
+ * bodies are never read.
+ */
+int NewScan(unsigned int userID, NewScanResult *results, int size);
+
+LastReadDB *OpenLastReadDB(const char *filename);
+void CloseLastReadDB(LastReadDB *db);
+void SyncLastReadDB(LastReadDB *db);
+
+uint32_t _GetLastRead(LastReadDB *db, unsigned int userID,
+   unsigned int areaID);
+bool _SetLastRead(LastReadDB *db, unsigned int userID, unsigned int areaID,
+   uint32_t number);
+int _NewScan(LastReadDB *db, MessageDB *messages, unsigned int userID,
+   NewScanResult *results, int size);
+
+#endif
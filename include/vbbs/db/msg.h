@@ -0,0 +1,157 @@
+#ifndef VBBS_DB_MSG_H
+#define VBBS_DB_MSG_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/db.h>
+#include <vbbs/log.h>
+#include <vbbs/msg.h>
+#include <vbbs/list.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MESSAGE_DB_FILE "msgareas.db"
+
+/** Area files are named from the area ID, e.g. area0001.idx/area0001.dat */
+#define MESSAGE_AREA_FILE_FORMAT "%sarea%04u%s"
+#define MESSAGE_INDEX_EXTENSION ".idx"
+#define MESSAGE_DATA_EXTENSION ".dat"
+
+#define MESSAGE_INDEX_MAGIC "VMI1"
+#define MESSAGE_INDEX_VERSION 1
+
+/** Number of header slots added each time an index file has to grow. */
+#define MESSAGE_INDEX_GROWTH 4096
+
+/** Bodies are found by 32-bit offsets, so an area's data file stops here. */
+#define MESSAGE_DATA_MAX 0xFFFFFFFFUL
+
+/**
+ * The first record of an index file. Message n's header is stored at
+ * sizeof(MessageIndexHeader) + (n - 1) * sizeof(MessageHeader), so any
+ * message can be found without searching.
+ */
+typedef struct MessageIndexHeader
+{
+   char magic[4];
+   uint32_t version;
+   uint32_t recordSize;
+   uint32_t areaID;
+   uint32_t highWater;  /* Number of the last message posted */
+   uint32_t capacity;   /* Header slots allocated in the file */
+   uint32_t reserved[10];
+} MessageIndexHeader;
+
+/**
+ * A message area. Headers live in a fixed-width index file that is memory
+ * mapped on POSIX systems. Bodies are appended to a data file, each one
+ * followed by a DB_RECORD_SEPARATOR so the data file can be rebuilt or
+ * scanned on its own.
+ */
+typedef struct MessageArea
+{
+   unsigned int areaID;
+   char name[41];
+   char description[81];
+   char indexFilename[256];
+   char dataFilename[256];
+   FILE *index;
+   FILE *data;
+   long dataSize;
+   bool dataDirty;                /* Data written but not flushed */
+   MessageIndexHeader *header;    /* Points into the map when mapped */
+   MessageHeader *records;        /* Mapped headers, NULL if not mapped */
+   MessageIndexHeader headerCopy; /* Used when the index isn't mapped */
+   MessageHeader scratch;         /* Used when the index isn't mapped */
+} MessageArea;
+
+typedef struct MessageDB
+{
+   char *filename;
+   char *directory;
+   unsigned int nextAreaID;
+   ArrayList *areas;
+} MessageDB;
+
+extern MessageDB *messageDB;
+
+/** Called after every message is posted, e.g. to index it for search. */
+typedef void (*MessagePostHandler)(MessageArea *area,
+   const MessageHeader *header);
+
+bool LoadMessageDB(void);
+bool SaveMessageDB(void);
+MessageArea *AddMessageArea(const char *name, const char *description);
+MessageArea *GetMessageAreaByID(unsigned int areaID);
+MessageArea *GetMessageAreaByName(const char *name);
+int GetMessageAreaCount(void);
+
+MessageDB *NewMessageDB(const char *filename);
+void DestroyMessageDB(MessageDB *db);
+
+bool _LoadMessageDB(MessageDB *db);
+bool _SaveMessageDB(MessageDB *db);
+MessageArea *_AddMessageArea(MessageDB *db, const char *name,
+   const char *description);
+MessageArea *_GetMessageAreaByID(MessageDB *db, unsigned int areaID);
+MessageArea *_GetMessageAreaByName(MessageDB *db, const char *name);
+int _GetMessageAreaCount(MessageDB *db);
+
+/** Open (creating if needed) the files for an area. */
+MessageArea *OpenMessageArea(const char *directory, unsigned int areaID,
+   const char *name, const char *description);
+void CloseMessageArea(MessageArea *area);
+
+/** Flush the index and data files to disk. */
+void SyncMessageArea(MessageArea *area);
+
+/**
+ * Append a message to an area. The header's number, body offset and body
+ * length are filled in. Returns the new message number, or 0 on failure.
+ * Any header pointers previously returned for this area become invalid.
+ */
+uint32_t PostMessage(MessageArea *area, MessageHeader *header,
+   const char *body, uint32_t length);
+
+/** Set the handler PostMessage calls, or NULL for none. */
+void SetMessagePostHandler(MessagePostHandler handler);
+
+/** O(1) lookup of a message header. Returns NULL if there is no message. */
+const MessageHeader *GetMessageHeader(MessageArea *area, uint32_t number);
+
+/**
+ * Read up to size bytes of a message body, starting offset bytes in.
+ * Returns the number of bytes read, or -1 on error.
+ */
+int ReadMessageBody(MessageArea *area, const MessageHeader *header,
+   uint32_t offset, char *buffer, int size);
+
+uint32_t GetHighWaterMark(MessageArea *area);
+
+#endif
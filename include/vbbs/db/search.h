@@ -0,0 +1,162 @@
+#ifndef VBBS_DB_SEARCH_H
+#define VBBS_DB_SEARCH_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/search.h>
+#include <vbbs/db/msg.h>
+
+#include <stdio.h>
+#include <time.h>
+
+#define SEARCH_DB_FILE "search.idx"
+
+#define SEARCH_INDEX_MAGIC "VSI1"
+#define SEARCH_INDEX_VERSION 1
+
+/** A changed index is saved at least this often, in seconds. */
+#define SEARCH_CHECKPOINT_INTERVAL 300L
+
+/** Query terms beyond this are ignored. */
+#define SEARCH_MAX_QUERY_TERMS 16
+
+/** A message matched by a search. */
+typedef struct SearchHit
+{
+   uint32_t areaID;
+   uint32_t number;
+} SearchHit;
+
+typedef struct SearchTerm
+{
+   char *term;
+   uint32_t hash;
+   PostingList postings;
+} SearchTerm;
+
+/**
+ * An inverted index over message subjects and bodies. Every indexed message
+ * is given a document ID, in the order it was indexed, and each term has a
+ * posting list of the documents and word positions it appears at.
+ */
+typedef struct SearchIndex
+{
+   char *filename;
+   SearchTerm *terms;
+   uint32_t termCount;
+   uint32_t termCapacity;
+   uint32_t *table;              /* Hash table of term index + 1, 0 if empty */
+   uint32_t tableSize;           /* Always a power of two */
+   SearchHit *documents;         /* Indexed by document ID, 0 is unused */
+   uint32_t documentCount;
+   uint32_t documentCapacity;
+   uint32_t *indexedHighWater;   /* Last message indexed, by area ID */
+   uint32_t areaCapacity;
+   bool dirty;                   /* Changed since it was last saved */
+   time_t savedAt;               /* When it was last loaded or saved */
+   /* Working space reused between messages. */
+   struct SearchToken *tokens;
+   uint32_t tokenCount;
+   uint32_t tokenCapacity;
+   uint32_t *positions;
+   uint32_t positionCapacity;
+   char *text;
+   size_t textCapacity;
+   bool failed;
+} SearchIndex;
+
+extern SearchIndex *searchIndex;
+
+/**
+ * Load the saved index. If it is damaged the index is left empty, to be
+ * rebuilt from the message base by UpdateSearchIndex, and FALSE returned.
+ */
+bool LoadSearchIndex(void);
+bool SaveSearchIndex(void);
+
+/**
+ * Index every message posted since the index was last updated. Returns the
+ * number of messages indexed.
+ */
+int UpdateSearchIndex(void);
+
+/**
+ * Save the index if it has changed and SEARCH_CHECKPOINT_INTERVAL seconds
+ * have passed since it was last saved. Returns TRUE if it was saved.
+ */
+bool CheckpointSearchIndex(void);
+
+/**
+ * A MessagePostHandler that indexes new messages as they are posted, so
+ * searches never wait on indexing.
+ */
+void IndexPostedMessage(MessageArea *area, const MessageHeader *header);
+
+/**
+ * Find messages containing every word of query. Words in double quotes
+ * must appear together as a phrase. Up to size hits are stored, oldest
+ * first, and the number stored is returned, or -1 on error.
+ */
+int SearchMessages(const char *query, SearchHit *hits, int size);
+
+/**
+ * As SearchMessages, but only messages the user can read are returned, so
+ * other users' private mail never turns up in their results.
+ */
+int SearchVisibleMessages(const char *query, const User *user,
+   SearchHit *hits, int size);
+
+SearchIndex *NewSearchIndex(const char *filename);
+void DestroySearchIndex(SearchIndex *index);
+
+bool _LoadSearchIndex(SearchIndex *index);
+bool _SaveSearchIndex(SearchIndex *index);
+int _UpdateSearchIndex(SearchIndex *index, MessageDB *messages);
+bool _CheckpointSearchIndex(SearchIndex *index, time_t now);
+int _SearchMessages(SearchIndex *index, const char *query, SearchHit *hits,
+   int size);
+int _SearchVisibleMessages(SearchIndex *index, MessageDB *messages,
+   const User *user, const char *query, SearchHit *hits, int size);
+
+/** Add a single message's text to the index. */
+bool IndexDocument(SearchIndex *index, uint32_t areaID, uint32_t number,
+   const char *text, size_t length);
+
+/** Read a message from an area and add its subject and body to the index. */
+bool IndexMessage(SearchIndex *index, MessageArea *area,
+   const MessageHeader *header);
+
+/**
+ * Index every message in an area posted since the area was last indexed,
+ * adding the number indexed to count. Returns FALSE if one couldn't be.
+ */
+bool IndexNewMessages(SearchIndex *index, MessageArea *area, int *count);
+
+/** Look up the posting list for a term, or NULL if it was never seen. */
+const PostingList *FindSearchTerm(SearchIndex *index, const char *term);
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef VBBS_EVENT_H
+#define VBBS_EVENT_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+#include <stdio.h>
+
+#define EVENT_LOG_FILE "vbbs.evt"
+
+#define EVENT_LOG_MAGIC "VEV1"
+#define EVENT_LOG_VERSION 1
+#define EVENT_HEADER_SIZE 16
+#define EVENT_RECORD_SIZE 48
+#define EVENT_USERNAME_SIZE 20
+
+/** Records read from disk at a time by an EventReader. */
+#define EVENT_READ_BATCH 1024
+
+/** Never renumber these, they are stored in the file. */
+typedef enum
+{
+    EVENT_NONE = 0,
+    EVENT_CONNECT = 1,
+    EVENT_DISCONNECT = 2,
+    EVENT_LOGIN = 3,
+    EVENT_LOGIN_FAILED = 4,
+    EVENT_TRANSFER_COMPLETE = 5,
+    EVENT_TRANSFER_FAILED = 6,
+    EVENT_TYPE_COUNT
+} EventType;
+
+/**
+ * A well-known event, such as a login. On disk every record is exactly
+ * EVENT_RECORD_SIZE bytes with little endian fields in this order, after
+ * a header of the magic, version and record size:
+ *
+ *   0 time  4 type  6 connectionType  8 sessionID  12 userID  16 remoteIP
+ *  20 remotePort  22 reserved  24 value  28 username (NUL padded)
+ */
+typedef struct Event
+{
+    uint32_t time;                 /* Seconds since the epoch */
+    uint16_t type;                 /* EventType */
+    uint16_t connectionType;       /* ConnectionType */
+    uint32_t sessionID;
+    uint32_t userID;               /* 0 if not logged in */
+    uint32_t remoteIP;             /* IPv4 address in host order, or 0 */
+    uint16_t remotePort;
+    uint32_t value;                /* Bytes for transfers, else attempts */
+    char username[EVENT_USERNAME_SIZE + 1];
+} Event;
+
+typedef struct EventReader
+{
+    FILE *file;
+    uint8_t *batch;                /* EVENT_READ_BATCH records */
+    int count;                     /* Records in batch */
+    int next;                      /* Next record to return */
+} EventReader;
+
+void EncodeEvent(const Event *event, uint8_t *record);
+void DecodeEvent(const uint8_t *record, Event *event);
+
+const char *EventTypeName(EventType type);
+
+/** Returns EVENT_NONE if the name isn't known. Ignores case. */
+EventType ParseEventType(const char *name);
+
+/** Opens (appending to) the event log. Logging is off until this is done. */
+bool OpenEventLog(const char *filename);
+void CloseEventLog(void);
+bool IsEventLogOpen(void);
+
+/**
+ * Record an event. The time is filled in if it is zero. Records are
+ * buffered until FlushEventLog is called.
+ */
+void LogEvent(Event *event);
+void FlushEventLog(void);
+
+/** Returns NULL if the file can't be read or isn't an event log. */
+EventReader *OpenEventReader(const char *filename);
+void CloseEventReader(EventReader *reader);
+
+/** Returns FALSE at the end of the file. */
+bool ReadEvent(EventReader *reader, Event *event);
+
+#endif
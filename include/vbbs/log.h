@@ -32,6 +32,43 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define LOG_FILE "vBBS.log"
 
+/** Longest log line, including the timestamp. Longer lines are truncated. */
+#define LOG_MESSAGE_SIZE 512
+
+/** Lines queued for the writer thread. Must be a power of two. */
+#define LOG_RING_SIZE 1024
+
+/** Most bytes the writer thread hands to a single write call. */
+#define LOG_BATCH_SIZE 65536
+
+/** How long the idle writer thread sleeps between checks. */
+#define LOG_IDLE_WAIT_MS 50
+
+/** The log is rotated when it reaches this size. 0 disables. */
+#define LOG_ROTATE_SIZE (10L * 1024 * 1024)
+
+/** The log is rotated when it has been open this long. 0 disables. */
+#define LOG_ROTATE_INTERVAL 86400L
+
+/** Rotated logs kept as vBBS.log.1 (newest) to vBBS.log.N. */
+#define LOG_ROTATE_KEEP 5
+
+/** Messages per second, and burst size, allowed from one call site. */
+#define LOG_SITE_RATE 20
+#define LOG_SITE_BURST 100
+
+/** Messages per second, and burst size, allowed for one session. */
+#define LOG_SESSION_RATE 50
+#define LOG_SESSION_BURST 200
+
+/** Call sites and sessions tracked at once. Must be a power of two. */
+#define LOG_RATE_SLOTS 256
+
+/** Asynchronous logging needs POSIX threads and GCC style atomics. */
+#if defined(_POSIX_VERSION) && defined(__GNUC__)
+#define LOG_ASYNC_SUPPORTED
+#endif
+
 typedef enum
 {
     LOG_DEBUG,
@@ -45,11 +82,97 @@ void CloseLog(void);
 
 void SetLogLevel(LogLevel level);
 
+/** Choose whether log lines are also written to stderr. On by default. */
+void SetLogEcho(bool echo);
+
+/**
+ * Switch to asynchronous logging. Callers format their message into a
+ * preallocated ring and return; a writer thread batches the lines into as
+ * few writes as possible. If the ring is full the message is dropped and
+ * counted rather than making the caller wait. Returns FALSE if it isn't
+ * supported on this platform or the thread could not be started.
+ */
+bool StartAsyncLog(void);
+
+/** Write any queued lines and go back to logging synchronously. */
+void StopAsyncLog(void);
+
+/**
+ * Wait until every line queued so far has been written. Does nothing when
+ * logging synchronously.
+ */
+void FlushLog(void);
+
+/** Total number of messages dropped because the ring was full. */
+unsigned long GetDroppedLogMessages(void);
+
+/**
+ * Rotate the log once it reaches maxBytes or has been open for maxSeconds,
+ * keeping keep old files. Zero disables either limit. When logging
+ * asynchronously the writer thread does the rotation. Call before
+ * StartAsyncLog.
+ */
+void SetLogRotation(long maxBytes, long maxSeconds, int keep);
+
+/**
+ * Set the token bucket limits applied to each call site and each session.
+ * A rate of 0 turns that limit off. Call before StartAsyncLog. Each thread
+ * has its own buckets, so a call site logging from several threads gets
+ * the limit in each of them.
+ */
+void SetLogRateLimits(int siteRate, int siteBurst, int sessionRate,
+    int sessionBurst);
+
+/**
+ * Messages logged by this thread are counted against this session's limit
+ * until it is changed. 0 means no session.
+ */
+void SetLogSession(uint32_t sessionID);
+
+/**
+ * Used by the logging macros. Returns FALSE if the call site or current
+ * session is over its limit. Once a source is allowed again, a summary of
+ * how many of its messages were suppressed is logged first.
+ */
+bool AllowLogMessage(const char *file, int line);
+
+/** Total number of messages suppressed by the rate limits. */
+unsigned long GetSuppressedLogMessages(void);
+
+/**
+ * Calls below this level are removed at compile time, e.g. build with
+ * -DLOG_MIN_LEVEL=LOG_INFO to drop every Debug call.
+ */
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_DEBUG
+#endif
+
+/** Messages below this level are discarded at runtime. See SetLogLevel. */
+extern LogLevel LOG_LEVEL;
+
+#define IsLogLevelEnabled(level) \
+    ((level) >= LOG_MIN_LEVEL && (level) >= LOG_LEVEL)
+
 void LogMessage(LogLevel level, const char *format, ...);
 
-void Debug(const char* format, ...);
-void Info(const char* format, ...);
-void Warn(const char* format, ...);
-void Error(const char* format, ...);
+void _Debug(const char* format, ...);
+void _Info(const char* format, ...);
+void _Warn(const char* format, ...);
+void _Error(const char* format, ...);
+
+/*
+ * Debug("format", ...) and friends expand to a level and rate check
+ * guarding the call, so the arguments are only evaluated when the message
+ * will be logged. Below LOG_MIN_LEVEL the check is a constant and the
+ * compiler drops the call altogether. They are statements, not
+ * expressions. LogMessage is not rate limited.
+ */
+#define IsLogAllowed(level) \
+    (IsLogLevelEnabled(level) && AllowLogMessage(__FILE__, __LINE__))
+
+#define Debug if (!IsLogAllowed(LOG_DEBUG)) {} else _Debug
+#define Info if (!IsLogAllowed(LOG_INFO)) {} else _Info
+#define Warn if (!IsLogAllowed(LOG_WARN)) {} else _Warn
+#define Error if (!IsLogAllowed(LOG_ERROR)) {} else _Error
 
 #endif
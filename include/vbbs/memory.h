@@ -0,0 +1,94 @@
+#ifndef VBBS_MEMORY_H
+#define VBBS_MEMORY_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+/**
+ * Tracked allocation. Every block from TrackedMalloc is counted in the
+ * vbbs_memory_bytes gauge and charged to the current memory account, if
+ * there is one, and is credited back to that same account when freed. The
+ * session code makes a session's account current while its handlers run,
+ * so what a caller's session allocates is charged to it.
+ *
+ * Blocks carry a small header recording their size and account, so they
+ * must only be resized with TrackedRealloc and freed with TrackedFree.
+ * Like pools, an account belongs to the one thread that uses it.
+ */
+
+typedef struct MemoryAccount
+{
+    size_t bytes;               /* Bytes in blocks charged here */
+    size_t peak;                /* Most bytes charged at once */
+    unsigned long blocks;       /* Blocks charged here */
+    bool released;              /* Freed along with its last block */
+} MemoryAccount;
+
+/** An empty account, or NULL if it couldn't be allocated. */
+MemoryAccount *NewMemoryAccount(void);
+
+/**
+ * The owner is finished with the account. Blocks still charged to it, e.g.
+ * ones it added to a shared structure, keep it alive until they are freed.
+ */
+void ReleaseMemoryAccount(MemoryAccount *account);
+
+/** Charge this thread's allocations to account, NULL for none. */
+void SetMemoryAccount(MemoryAccount *account);
+MemoryAccount *GetMemoryAccount(void);
+
+/** As malloc, charged to the current account. */
+void *TrackedMalloc(size_t size);
+
+/** As calloc, charged to the current account. */
+void *TrackedCalloc(size_t count, size_t size);
+
+/**
+ * As realloc. The block stays charged to the account it was first
+ * allocated for, so a shared list that grows during a session's handler
+ * isn't charged to that session.
+ */
+void *TrackedRealloc(void *memory, size_t size);
+
+/** Free a tracked block. NULL is ignored. */
+void TrackedFree(void *memory);
+
+/** The account memory from TrackedMalloc is charged to, or NULL. */
+MemoryAccount *GetMemoryAccountOf(const void *memory);
+
+/** Bytes in every tracked block. */
+size_t GetTrackedMemory(void);
+
+/**
+ * Tracked bytes above which the server is short of memory and refuses new
+ * connections, 0 for no limit. Allocations are never refused.
+ */
+void SetMemoryLimit(size_t limit);
+size_t GetMemoryLimit(void);
+bool IsMemoryExhausted(void);
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef VBBS_METRICS_H
+#define VBBS_METRICS_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+/**
+ * Counters and histograms are split into shards, one per thread (threads
+ * share shards once there are more than METRICS_SHARDS), so updates never
+ * contend. Reading a value adds the shards up.
+ */
+#define METRICS_SHARDS 8
+#define METRICS_CACHE_LINE 64
+#define METRICS_MAX 64
+
+/**
+ * Histograms keep exact counts below 2^HISTOGRAM_SUB_BITS and otherwise
+ * 2^HISTOGRAM_SUB_BITS buckets per power of two, so a bucket is never more
+ * than 1/16th (6.25%) wider than its lower bound. Values of
+ * 2^HISTOGRAM_MAX_BITS and above go in the last bucket.
+ */
+#define HISTOGRAM_SUB_BITS 4
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_MAX_BITS 40
+#define HISTOGRAM_BUCKETS \
+    ((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+typedef enum
+{
+    METRIC_COUNTER,
+    METRIC_GAUGE,
+    METRIC_HISTOGRAM
+} MetricType;
+
+typedef struct CounterShard
+{
+    unsigned long value;
+    char padding[METRICS_CACHE_LINE - sizeof(unsigned long)];
+} CounterShard;
+
+/** A value that only goes up, e.g. connections accepted. */
+typedef struct Counter
+{
+    CounterShard shards[METRICS_SHARDS];
+} Counter;
+
+/** A value that goes up and down, e.g. active sessions. */
+typedef struct Gauge
+{
+    long value;
+} Gauge;
+
+typedef struct HistogramShard
+{
+    unsigned long count;
+    unsigned long sum;
+    unsigned long buckets[HISTOGRAM_BUCKETS];
+    char padding[METRICS_CACHE_LINE];
+} HistogramShard;
+
+/** A distribution of values, e.g. latencies in nanoseconds. */
+typedef struct Histogram
+{
+    HistogramShard shards[METRICS_SHARDS];
+} Histogram;
+
+/**
+ * Text being built in a caller supplied buffer, so exporting metrics
+ * doesn't allocate. Anything past the end is dropped and truncated set.
+ */
+typedef struct MetricsText
+{
+    char *text;
+    int length;
+    int size;
+    bool truncated;
+} MetricsText;
+
+typedef struct Metric
+{
+    const char *name;              /* Prometheus style, e.g. vbbs_x_total */
+    const char *help;
+    MetricType type;
+    void *metric;                  /* Counter, Gauge or Histogram */
+} Metric;
+
+/** Built in metrics, registered by InitMetrics. */
+extern Counter connectionsAccepted;
+extern Counter bytesReceived;
+extern Counter bytesSent;
+extern Counter authSuccesses;
+extern Counter authFailures;
+extern Counter userDBSaves;
+extern Gauge activeSessions;
+extern Histogram readTime;
+extern Histogram writeTime;
+extern Histogram authTime;
+extern Histogram saveUserDBTime;
+extern Histogram loopIterationTime;
+extern Histogram loopLag;
+extern Histogram handlerTime;
+extern Counter slowHandlers;
+extern Gauge pendingWork;
+extern Counter rejectedWork;
+extern Histogram workLatency;
+extern Counter throttledConnections;
+extern Counter throttledLogins;
+extern Counter poolAllocations;
+extern Gauge poolSlabs;
+extern Gauge memoryBytes;
+extern Histogram sessionMemory;
+extern Counter memoryDisconnects;
+extern Counter memoryRefusedConnections;
+extern Counter outputPauses;
+extern Counter droppedOutput;
+extern Counter outputDelays;
+
+/** Nanoseconds from an arbitrary starting point, for timing. */
+unsigned long MonotonicNanos(void);
+
+void InitMetrics(void);
+
+/** Returns FALSE if the registry is full or the name is taken. */
+bool RegisterMetric(const char *name, const char *help, MetricType type,
+    void *metric);
+int GetMetricCount(void);
+const Metric *GetMetric(int index);
+const Metric *FindMetric(const char *name);
+
+#define IncrementCounter(counter) AddToCounter((counter), 1)
+void AddToCounter(Counter *counter, unsigned long n);
+unsigned long GetCounterValue(const Counter *counter);
+
+void SetGauge(Gauge *gauge, long value);
+void AddToGauge(Gauge *gauge, long n);
+long GetGaugeValue(const Gauge *gauge);
+
+void RecordHistogram(Histogram *histogram, unsigned long value);
+
+/** Record the nanoseconds since start, a MonotonicNanos value. */
+#define RecordElapsed(histogram, start) \
+    RecordHistogram((histogram), MonotonicNanos() - (start))
+
+unsigned long GetHistogramCount(const Histogram *histogram);
+unsigned long GetHistogramSum(const Histogram *histogram);
+
+/** Adds every shard's bucket counts into buckets[HISTOGRAM_BUCKETS]. */
+void GetHistogramBuckets(const Histogram *histogram, unsigned long *buckets);
+
+/** The smallest value that falls in a bucket. */
+unsigned long HistogramBucketValue(int index);
+
+/**
+ * An upper bound on the given fraction (0.0 to 1.0) of recorded values,
+ * e.g. 0.99 for the 99th percentile. Returns 0 if nothing was recorded.
+ */
+unsigned long GetHistogramPercentile(const Histogram *histogram,
+    double fraction);
+
+void ResetHistogram(Histogram *histogram);
+
+void InitMetricsText(MetricsText *out, char *buffer, int size);
+void AppendMetricsText(MetricsText *out, const char *format, ...);
+
+/**
+ * Every registered metric in the Prometheus text exposition format.
+ * Histograms are given cumulative buckets at each power of two.
+ */
+void WritePrometheusMetrics(MetricsText *out);
+
+/**
+ * Every registered metric as the members of a JSON object, without the
+ * surrounding braces. Histograms give their count, sum and percentiles.
+ */
+void WriteJsonMetrics(MetricsText *out);
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef VBBS_MSG_H
+#define VBBS_MSG_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/user.h>
+#include <time.h>
+
+#define MESSAGE_FROM_SIZE 32
+#define MESSAGE_TO_SIZE 32
+#define MESSAGE_SUBJECT_SIZE 64
+
+/* Message flags */
+#define MESSAGE_DELETED 0x01
+#define MESSAGE_PRIVATE 0x02
+
+/**
+ * The fixed-width header of a message. Headers are stored back to back in
+ * an area's index file, so this layout is also the on-disk format and must
+ * stay a multiple of 8 bytes with no padding. Fields are in host byte order.
+ */
+typedef struct MessageHeader
+{
+    uint32_t number;      /* Message number, starting at 1 */
+    uint32_t replyTo;     /* Number of the message this replies to, or 0 */
+    uint32_t posted;      /* Time the message was posted */
+    uint32_t flags;       /* MESSAGE_* flags */
+    uint32_t bodyOffset;  /* Offset of the body in the area's data file */
+    uint32_t bodyLength;  /* Length of the body in bytes */
+    uint32_t fromUserID;  /* User ID of the author, or 0 if remote */
+    uint32_t reserved;
+    char from[MESSAGE_FROM_SIZE];
+    char to[MESSAGE_TO_SIZE];
+    char subject[MESSAGE_SUBJECT_SIZE];
+} MessageHeader;
+
+/** Clear a header and fill in the addressing fields. */
+void InitMessageHeader(MessageHeader *header, const char *from,
+    const char *to, const char *subject);
+bool IsMessageDeleted(const MessageHeader *header);
+
+/**
+ * Can this user read this message? Deleted messages are hidden, and
+ * private ones are only shown to their author and the user they are to.
+ */
+bool IsMessageVisible(const MessageHeader *header, const User *user);
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef VBBS_PBKDF2_H
+#define VBBS_PBKDF2_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/sha1.h>
+
+#define SHA1_DIGEST_SIZE 20
+#define SHA1_BLOCK_SIZE 64
+
+/**
+ * HMAC-SHA1 for one key. The two SHA1 contexts have already absorbed the
+ * key XORed with the inner and outer pads, so the key is only hashed once
+ * however many messages are signed with it.
+ */
+typedef struct
+{
+    SHA1_CTX inner;
+    SHA1_CTX outer;
+} HMAC_SHA1_CTX;
+
+void HMACSHA1Init(HMAC_SHA1_CTX *context, const unsigned char *key,
+    uint32_t keyLength);
+
+/** Sign data. The context is not changed, so it can be reused. */
+void HMACSHA1(const HMAC_SHA1_CTX *context, const unsigned char *data,
+    uint32_t length, unsigned char digest[SHA1_DIGEST_SIZE]);
+
+/**
+ * PBKDF2 (RFC 8018) with HMAC-SHA1, deriving outLength bytes into out.
+ * Each iteration after the first costs exactly two SHA1 compressions.
+ */
+void PBKDF2SHA1(const unsigned char *password, uint32_t passwordLength,
+    const unsigned char *salt, uint32_t saltLength, unsigned long iterations,
+    unsigned char *out, uint32_t outLength);
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef VBBS_POOL_H
+#define VBBS_POOL_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+/**
+ * A pool hands out fixed size objects carved from slabs of objectsPerSlab,
+ * and keeps freed ones on a free list for the next caller, so objects
+ * that come and go with every call cost one pop instead of a malloc.
+ * Slabs are only returned to malloc by DestroyPool.
+ *
+ * Pools are not locked: each belongs to the one thread that uses it,
+ * which for the ones in vbbs is the event loop. A worker thread that
+ * needs its own objects gives itself its own Pool.
+ *
+ * Building with POOL_DISABLED, which ASan builds do by default, makes
+ * every allocation a malloc so use after free is still caught.
+ */
+
+#if !defined(POOL_DISABLED) && defined(__SANITIZE_ADDRESS__)
+#define POOL_DISABLED
+#endif
+#if !defined(POOL_DISABLED) && defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define POOL_DISABLED
+#endif
+#endif
+
+typedef struct PoolSlab PoolSlab;
+
+typedef struct Pool
+{
+    const char *name;
+    size_t objectSize;
+    int objectsPerSlab;
+    void *freeList;             /* Free objects, linked by their first word */
+    PoolSlab *slabs;
+    unsigned long allocations;  /* PoolAlloc calls that succeeded */
+    unsigned long frees;
+    unsigned long inUse;
+    unsigned long peakInUse;
+    unsigned long slabCount;
+} Pool;
+
+/** A static Pool for objects of size bytes, e.g. POOL("session", ...). */
+#define POOL(name, size, objectsPerSlab) \
+    { name, size, objectsPerSlab, NULL, NULL, 0, 0, 0, 0, 0 }
+
+/** An uninitialised object, or NULL if a new slab couldn't be allocated. */
+void *PoolAlloc(Pool *pool);
+
+/** Return an object from PoolAlloc. NULL is ignored. */
+void PoolFree(Pool *pool, void *object);
+
+/** Free every slab. Objects still in use become invalid. */
+void DestroyPool(Pool *pool);
+
+#endif
@@ -0,0 +1,155 @@
+#ifndef VBBS_QWK_H
+#define VBBS_QWK_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/user.h>
+#include <vbbs/db/lastread.h>
+#include <vbbs/db/msg.h>
+#include <vbbs/zip.h>
+
+#include <stdio.h>
+#include <time.h>
+
+/** Packets are named after the BBS ID, e.g. VBBS.QWK and VBBS.REP. */
+#define QWK_BBS_ID "VBBS"
+#define QWK_BBS_NAME "vBBS"
+
+#define QWK_BLOCK_SIZE 128
+#define QWK_LINE_END 0xE3
+#define QWK_ACTIVE 0xE1
+#define QWK_INACTIVE 0xE2
+
+/** Messages per packet when the caller doesn't set a limit. */
+#define QWK_DEFAULT_MAX_MESSAGES 2000
+
+/** Messages a session adds to its packet in each pass of the event loop. */
+#define QWK_MESSAGES_PER_PASS 50
+
+/** Replies longer than this many blocks are skipped. */
+#define QWK_MAX_REPLY_BLOCKS 512
+
+/** Where a packet will leave an area's last-read pointer once received. */
+typedef struct QwkAreaPointer
+{
+    unsigned int areaID;
+    uint32_t lastRead;
+    uint32_t messageCount;  /* Messages from this area in the packet */
+    long ndxOffset;         /* Where this area's NDX records start */
+} QwkAreaPointer;
+
+/**
+ * A QWK packet written to a file. The packet is a ZIP archive containing
+ * CONTROL.DAT, DOOR.ID, MESSAGES.DAT and one NDX file per conference, with
+ * conference numbers matching area IDs.
+ */
+typedef struct QwkPacket
+{
+    char path[256];
+    unsigned int userID;
+    uint32_t messageCount;
+    long size;
+    QwkAreaPointer *areas;
+    int areaCount;
+} QwkPacket;
+
+/**
+ * A packet part way through being built. Messages are added a few at a
+ * time by ContinueQwkPacket, so a large packet doesn't hold up other
+ * callers, and the user must outlive the builder.
+ */
+typedef struct QwkBuilder
+{
+    QwkPacket *packet;
+    MessageDB *messages;
+    LastReadDB *lastRead;
+    const User *user;
+    uint32_t maxMessages;
+    ZipWriter *zip;
+    FILE *file;
+    FILE *ndx;              /* NDX records, until MESSAGES.DAT is done */
+    char *chunk;
+    int areaLimit;          /* Areas when the packet was started */
+    uint32_t number;        /* Next message to look at in the current area */
+    uint32_t block;         /* Block the next message starts at */
+    time_t now;
+    bool failed;
+} QwkBuilder;
+
+/**
+ * Build a packet of the messages a user hasn't read, writing it to path.
+ * Messages are read from the message base and written out in a single
+ * sequential pass, so memory use doesn't depend on the size of the packet.
+ * Last-read pointers are not changed until CommitQwkPacket is called.
+ */
+QwkPacket *BuildQwkPacket(const char *path, const User *user,
+    uint32_t maxMessages);
+QwkPacket *_BuildQwkPacket(MessageDB *messages, LastReadDB *lastRead,
+    const char *path, const User *user, uint32_t maxMessages);
+
+/** Start building a packet, as BuildQwkPacket does all at once. */
+QwkBuilder *StartQwkPacket(const char *path, const User *user,
+    uint32_t maxMessages);
+QwkBuilder *_StartQwkPacket(MessageDB *messages, LastReadDB *lastRead,
+    const char *path, const User *user, uint32_t maxMessages);
+
+/**
+ * Add up to count more messages to the packet. Returns TRUE if there are
+ * more to add, or FALSE once it is ready for FinishQwkPacket.
+ */
+bool ContinueQwkPacket(QwkBuilder *builder, uint32_t count);
+
+/**
+ * Write the rest of the packet and free the builder. Returns the packet,
+ * or NULL if it couldn't be built.
+ */
+QwkPacket *FinishQwkPacket(QwkBuilder *builder);
+
+/** Give up on a packet, deleting what was written of it. */
+void DestroyQwkBuilder(QwkBuilder *builder);
+
+/** Move the user's last-read pointers past the messages in the packet. */
+bool CommitQwkPacket(QwkPacket *packet);
+bool _CommitQwkPacket(LastReadDB *lastRead, QwkPacket *packet);
+
+/** Free a packet and delete its file. */
+void DestroyQwkPacket(QwkPacket *packet);
+
+/**
+ * Post the replies in a REP packet. The path may be the REP archive
+ * itself, if it was stored without compression, or the BBSID.MSG file
+ * extracted from it. Returns the number of messages posted, or -1 if the
+ * packet couldn't be read.
+ */
+int ImportReplyPacket(const char *path, const User *user);
+int _ImportReplyPacket(MessageDB *messages, const char *path,
+    const User *user);
+
+/** Convert a QWK NDX block number to the four byte Microsoft Binary form. */
+void EncodeMSBIN(uint32_t value, uint8_t *out);
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef VBBS_SEARCH_H
+#define VBBS_SEARCH_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <stddef.h>
+
+/** Longer words are truncated to this many characters, less one. */
+#define SEARCH_MAX_TERM_LENGTH 32
+
+/** Number of documents encoded in each posting list block. */
+#define SEARCH_BLOCK_SIZE 128
+
+/**
+ * Skip entry for one block of a posting list. A block holds up to
+ * SEARCH_BLOCK_SIZE documents, each encoded as a varint document ID delta,
+ * a varint position count and varint position deltas. The first delta in
+ * a block is taken from the previous block's lastDoc, so a cursor can start
+ * decoding at any block.
+ */
+typedef struct PostingBlock
+{
+    uint32_t lastDoc;
+    uint32_t offset;  /* Offset of the block in the posting data */
+    uint32_t count;   /* Documents in the block */
+} PostingBlock;
+
+/** The documents, and positions within them, that contain one term. */
+typedef struct PostingList
+{
+    uint32_t docCount;
+    uint32_t lastDoc;
+    uint8_t *data;
+    uint32_t length;
+    uint32_t capacity;
+    PostingBlock *blocks;
+    uint32_t blockCount;
+    uint32_t blockCapacity;
+} PostingList;
+
+/** A position within a posting list. */
+typedef struct PostingCursor
+{
+    const PostingList *list;
+    uint32_t block;
+    uint32_t inBlock;           /* Documents decoded in the current block */
+    const uint8_t *next;        /* Start of the next document's entry */
+    const uint8_t *positions;   /* Position deltas for the current document */
+    uint32_t doc;               /* Current document, valid unless done */
+    uint32_t frequency;         /* Number of positions in doc */
+    bool done;
+} PostingCursor;
+
+/**
+ * Called for each word in a text. Terms are lower case ASCII letters and
+ * digits; positions count words from zero.
+ */
+typedef void (*TokenHandler)(void *context, const char *term, int length,
+    uint32_t position);
+
+/** Split text into terms. Returns the number of terms found. */
+uint32_t TokenizeText(const char *text, size_t length, TokenHandler handler,
+    void *context);
+
+int EncodeVarint(uint8_t *buffer, uint32_t value);
+const uint8_t *DecodeVarint(const uint8_t *buffer, uint32_t *value);
+
+void InitPostingList(PostingList *list);
+void FreePostingList(PostingList *list);
+
+/**
+ * Append a document to a posting list. Documents must be added in
+ * increasing order and positions must be increasing.
+ */
+bool AppendPosting(PostingList *list, uint32_t doc, const uint32_t *positions,
+    uint32_t count);
+
+/**
+ * Check a posting list read from disk before any cursor walks it. Every
+ * entry must decode inside its block, documents must increase and be no
+ * more than maxDoc, and the skip entries must agree with the data.
+ */
+bool IsPostingListValid(const PostingList *list, uint32_t maxDoc);
+
+/** Start a cursor on the first document of a list. */
+void OpenPostingCursor(PostingCursor *cursor, const PostingList *list);
+
+/** Move to the next document. Returns FALSE when there are no more. */
+bool NextPosting(PostingCursor *cursor);
+
+/**
+ * Move to the first document at or after target, galloping over the block
+ * skip entries. Returns FALSE when there is no such document.
+ */
+bool SeekPosting(PostingCursor *cursor, uint32_t target);
+
+/**
+ * Decode the current document's positions into buffer, which must hold
+ * cursor->frequency values.
+ */
+void ReadPositions(const PostingCursor *cursor, uint32_t *buffer);
+
+#endif
@@ -29,10 +29,22 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vbbs/types.h>
 
 #include <stdio.h>
+#include <time.h>
 #include <vbbs/log.h>
 #include <vbbs/user.h>
 #include <vbbs/terminal.h>
 #include <vbbs/conn.h>
+#include <vbbs/arena.h>
+#include <vbbs/memory.h>
+
+/** Most scratch memory one caller's session may hold. */
+#define SESSION_ARENA_LIMIT (64 * 1024)
+
+/** Default for the most memory a session may hold before it is hung up. */
+#define SESSION_MEMORY_LIMIT (1024 * 1024)
+
+/** Event handlers taking at least this long are logged as slow. */
+#define SLOW_HANDLER_THRESHOLD_MS 100
 
 typedef struct Session Session;
 
@@ -47,14 +59,66 @@ struct Session {
    uint8_t loginAttempts;
    char tempBuffer[256];
    bool isNewUser;
+   bool passwordMatched;        /* Result of the last password check */
+   struct QwkBuilder *qwkBuilder; /* Packet being built, if any */
+   struct QwkPacket *qwkPacket; /* Packet being downloaded, if any */
+   time_t lastActivity;         /* When input was last received */
+   Arena arena;                 /* Scratch memory, freed with the session */
+   ArenaMark screenMark;        /* What is freed on each new screen */
+   MemoryAccount *memory;       /* What the session's handlers allocated */
+   size_t peakMemory;           /* Most memory held after a handler */
+   bool awaitingOutput;         /* Handler runs again once output drains */
+   int listPosition;            /* Next row of a paused listing */
 };
 
 Session* NewSession(Connection *conn);
 void DestroySession(Session *session);
+
+/** The name of a session input handler, e.g. "MainMenuSelection". */
+const char *GetEventHandlerName(EventHandler handler);
+
+/**
+ * Call the session's event handler, if it has one, timing it. A call that
+ * takes longer than the slow handler threshold is logged with the session
+ * and handler name. Allocations the handler makes are charged to the
+ * session, and a session holding more than the session memory limit
+ * afterwards is told so and disconnected. Handlers must always be called
+ * through this.
+ */
+void RunEventHandler(Session *session);
+
+/** Set the slow handler threshold, 0 logs every call. */
+void SetSlowHandlerThreshold(unsigned long milliseconds);
+unsigned long GetSlowHandlerThreshold(void);
+
+/** Bytes charged to the session plus its scratch memory. */
+size_t GetSessionMemory(const Session *session);
+
+/** Set the session memory limit, 0 for no limit. */
+void SetSessionMemoryLimit(size_t limit);
+size_t GetSessionMemoryLimit(void);
+
 void Connected(Session *session);
 void SetSessionWindowSize(void *userData, int width, int height);
 void SetSessionTerminalType(void *userData, const char *type);
 void SetSessionConnectionSpeed(void *userData, const char *speed);
 void EchoCharToSession(void *userData, const char c);
+void SetSessionTelnetOption(void *userData, int command, int option);
+
+/**
+ * Start sending a file to the caller. Input is ignored while the file is
+ * being sent, and the next handler is called once the transfer completes.
+ * Returns FALSE if the file could not be opened.
+ */
+bool StartDownload(Session *session, const char *path, EventHandler next);
+
+/** Called by the event loop when the connection can accept more data. */
+void ContinueDownload(Session *session);
+
+/**
+ * Called by the event loop after writing to the connection. Runs a handler
+ * that stopped because output was paused, once it no longer is.
+ */
+void ContinueOutput(Session *session);
 
 #endif
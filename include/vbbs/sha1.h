@@ -21,6 +21,36 @@ typedef struct
     unsigned char buffer[64];
 } SHA1_CTX;
 
+/* Implementations of SHA1Transform, slowest first. */
+typedef enum
+{
+    SHA1_PORTABLE,
+    SHA1_SSSE3,
+    SHA1_SHA_NI
+} SHA1Implementation;
+
+/*
+ * Use the fastest implementation this CPU supports. Call once at startup,
+ * before any threads are hashing; until then the portable one is used.
+ */
+SHA1Implementation SHA1SelectImplementation(
+    void
+    );
+
+/* Nonzero if this CPU and build support an implementation. */
+int SHA1Supported(
+    SHA1Implementation implementation
+    );
+
+/* Switch to an implementation, returning 0 if it is not supported. */
+int SHA1UseImplementation(
+    SHA1Implementation implementation
+    );
+
+const char *SHA1ImplementationName(
+    SHA1Implementation implementation
+    );
+
 void SHA1Transform(
     uint32_t state[5],
     const unsigned char buffer[64]
@@ -48,6 +48,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define IDENTIFY "\033[c"
 #define IDENTIFY_RESPONSE "\033[?%50sc"
+/* Each attribute in the response takes at least 2 bytes, e.g. "1;". */
+#define MAX_IDENTIFY_ATTRIBUTES 25
 
 #define DEVICE_STATUS_REPORT "\033[5n"
 
@@ -0,0 +1,76 @@
+#ifndef VBBS_THROTTLE_H
+#define VBBS_THROTTLE_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+/**
+ * Failed logins are counted per source address in a fixed size table, so
+ * a caller that keeps reconnecting is slowed down as well as one that
+ * keeps guessing on a single connection. Addresses are IPv4 in host byte
+ * order; 0 (not a telnet connection) and loopback are never throttled.
+ */
+
+/** Failed logins allowed before an address has to wait. */
+#define THROTTLE_FREE_FAILURES 5
+
+/** The first wait in seconds, doubled for each failure after it. */
+#define THROTTLE_BASE_DELAY 2
+#define THROTTLE_MAX_DELAY 3600
+
+/** One failure is forgotten for every THROTTLE_DECAY seconds of quiet. */
+#define THROTTLE_DECAY 300
+
+/**
+ * Addresses hash to one of THROTTLE_SETS sets of THROTTLE_WAYS entries,
+ * and a new address replaces the least recently seen one in its set:
+ * 16 bytes an entry, 2 MB in all, however many addresses call.
+ */
+#define THROTTLE_SET_BITS 14
+#define THROTTLE_SETS (1 << THROTTLE_SET_BITS)
+#define THROTTLE_WAYS 8
+
+/** Forget every address, and pick a new hash key. */
+void InitThrottle(void);
+
+/** Seconds an address must wait before it may connect or log in again. */
+unsigned long GetThrottleDelay(uint32_t address);
+
+/** Count a failed login, returning the wait it now has. */
+unsigned long RecordLoginFailure(uint32_t address);
+
+/** A successful login clears the address. */
+void RecordLoginSuccess(uint32_t address);
+
+/** As above, at now seconds on any clock that doesn't go backwards. */
+unsigned long _GetThrottleDelay(uint32_t address, unsigned long now);
+unsigned long _RecordLoginFailure(uint32_t address, unsigned long now);
+
+/** Addresses in the table. */
+int GetThrottleCount(void);
+
+#endif
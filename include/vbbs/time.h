@@ -4,6 +4,30 @@
 #include <vbbs/types.h>
 #include <time.h>
 
+/** Length of a FormatTimestamp string, e.g. "2025-01-31 23:59:59". */
+#define TIMESTAMP_LENGTH 19
+
+/** Seconds in a day without a daylight saving change. */
+#define SECONDS_PER_DAY 86400L
+
+/**
+ * Convert to local time, like localtime_r. Conversions within a day that
+ * has already been seen are done with arithmetic instead of a timezone
+ * lookup. Returns FALSE if the time can't be converted.
+ */
+bool LocalTime(time_t time, struct tm *result);
+
+/** Forget this thread's cached conversions, e.g. after changing TZ. */
+void ResetTimeCache(void);
+
+/** Format a time as "31 Jan 2025 23:59:59". bufferSize must be at least 21. */
 void FormatTime(char *buffer, size_t bufferSize, time_t time);
 
+/**
+ * Format a time as "2025-01-31 23:59:59" and return the length, or 0 if
+ * the buffer is too small. The string is cached per thread and only
+ * rebuilt when the second changes.
+ */
+int FormatTimestamp(char *buffer, size_t bufferSize, time_t time);
+
 #endif
@@ -0,0 +1,115 @@
+#ifndef VBBS_TRANSFER_H
+#define VBBS_TRANSFER_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+#include <stdio.h>
+#include <vbbs/conn.h>
+
+/** Largest number of file bytes handled in a single escape-and-write pass. */
+#define TRANSFER_CHUNK_SIZE 16384
+
+/** Runs of unescaped bytes shorter than this are written with writev. */
+#define TRANSFER_SENDFILE_MIN 4096
+
+/** Maximum number of iovec segments used by a single writev call. */
+#define TRANSFER_IOV_MAX 64
+
+/** How long a download waits for the client to answer WILL BINARY. */
+#define TRANSFER_NEGOTIATE_MS 2000
+
+typedef enum
+{
+    TRANSFER_ACTIVE,
+    TRANSFER_COMPLETE,
+    TRANSFER_FAILED
+} TransferStatus;
+
+/**
+ * A Transfer streams the raw contents of a file to a connection.
+ *
+ * On POSIX systems the file is memory mapped and scanned for bytes that
+ * need escaping. Runs that need no escaping are handed to sendfile()
+ * (where available) so the bytes go straight from the page cache to the
+ * socket. Runs that contain bytes needing escaping are written with writev()
+ * using iovecs that point into the mapping, with the escape bytes inserted
+ * as separate segments. Other platforms fall back to a buffered stdio copy.
+ */
+struct Transfer
+{
+    char path[256];         /* Path of the file being sent */
+    FILE *file;             /* Open file */
+    long size;              /* Size of the file in bytes */
+    long offset;            /* Number of file bytes consumed */
+    unsigned long bytesSent; /* Bytes written, including escapes */
+    bool escapeIAC;         /* Double 0xFF bytes (Telnet) */
+    bool escapeCR;          /* Send CR as CR NUL (Telnet, non-binary) */
+    bool negotiating;       /* Waiting for the answer to WILL BINARY */
+    unsigned long negotiateDeadline; /* MonotonicNanos to stop waiting */
+    int pendingEscape;      /* Escape byte still owed to the client, or -1 */
+    TransferStatus status;
+    uint8_t *map;           /* Memory mapped file contents, if available */
+    uint8_t *pending;       /* Escaped bytes not yet written (stdio path) */
+    int pendingLength;
+    int pendingOffset;
+};
+
+typedef struct Transfer Transfer;
+
+/**
+ * Create a new transfer that will send the given file to the connection.
+ * Telnet connections get IAC escaping, and CR escaping unless the client
+ * has agreed to binary mode. Returns NULL if the file can't be opened.
+ */
+Transfer *NewTransfer(Connection *conn, const char *path);
+void DestroyTransfer(Transfer *transfer);
+
+/**
+ * Send as much of the file as the connection will accept without blocking.
+ * Nothing is sent until the connection's output buffer has drained, so
+ * that text written before the transfer started reaches the client first.
+ * Returns the number of bytes written, or -1 if the transfer failed.
+ */
+int ContinueTransfer(Connection *conn);
+
+/**
+ * Send nothing until the client answers WILL BINARY, which is passed on
+ * with SetTransferBinaryMode, or TRANSFER_NEGOTIATE_MS passes. Whether CRs
+ * are escaped is settled then, before the first byte of the file.
+ */
+void AwaitBinaryMode(Connection *conn);
+
+/** The client's answer to WILL BINARY. Too late once the file has begun. */
+void SetTransferBinaryMode(Connection *conn, bool binaryMode);
+
+/** Nanoseconds until a transfer stops waiting for an answer, or 0. */
+unsigned long GetTransferDelay(Connection *conn);
+
+bool IsTransferActive(Connection *conn);
+
+#endif
@@ -29,6 +29,20 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vbbs/types.h>
 #include <time.h>
 
+/**
+ * Passwords are stored as "$pbkdf2-sha1$iterations$salt$key", with the
+ * salt and derived key in hex, so the cost can be raised later. Older hex
+ * SHA1 hashes still verify and are replaced when the user next logs in.
+ */
+#define PASSWORD_HASH_PREFIX "$pbkdf2-sha1$"
+#define PASSWORD_ITERATIONS 10000
+#define PASSWORD_MAX_ITERATIONS 10000000UL
+#define PASSWORD_SALT_SIZE 16
+#define PASSWORD_KEY_SIZE 20
+
+/** Room for the longest hash string, with its terminator. */
+#define PASSWORD_HASH_SIZE 128
+
 typedef enum
 {
     REGULAR_USER,
@@ -39,7 +53,7 @@ typedef struct
 {
     unsigned int userID;
     char username[21];
-    char pwHash[41];
+    char pwHash[PASSWORD_HASH_SIZE];
     char email[41];
     UserType userType;
     time_t lastSeen;
@@ -49,6 +63,23 @@ User *NewUser(void);
 void DestroyUser(User *user);
 User *CopyUser(const User *src);
 
+/**
+ * Hash a password with a new salt into hashString, which has room for
+ * PASSWORD_HASH_SIZE. This, VerifyPassword and PasswordNeedsRehash only
+ * touch their arguments, so worker threads can call them.
+ */
+void HashPassword(const char *password, char *hashString);
+
+/** Check a password against a hash from HashPassword, or a legacy one. */
+bool VerifyPassword(const char *pwHash, const char *password);
+
+/** TRUE for legacy hashes and ones with fewer than the set iterations. */
+bool PasswordNeedsRehash(const char *pwHash);
+
+/** The PBKDF2 iterations for new hashes, PASSWORD_ITERATIONS by default. */
+void SetPasswordIterations(unsigned long iterations);
+unsigned long GetPasswordIterations(void);
+
 bool AuthenticateUser(User *user, const char *username, const char *password);
 bool ChangePassword(User *user, const char *newPassword);
 
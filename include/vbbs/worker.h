@@ -0,0 +1,106 @@
+#ifndef VBBS_WORKER_H
+#define VBBS_WORKER_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+#ifdef _POSIX_VERSION
+#include <sys/select.h>
+/** Work runs on POSIX threads, and completions wake select() via a pipe. */
+#define WORKER_THREADS_SUPPORTED
+#endif
+
+/** Worker threads started by vbbs, e.g. for password hashing. */
+#define WORKER_THREADS 2
+
+/**
+ * Jobs waiting for a worker. A submit beyond this fails, so a login flood
+ * is turned away at the prompt instead of queueing without limit.
+ */
+#define WORKER_QUEUE_DEPTH 64
+
+typedef struct WorkItem WorkItem;
+
+typedef void (*WorkFunction)(WorkItem *item);
+
+/**
+ * A job for the worker pool. Callers embed this as the first member of
+ * their own malloc'd struct, which carries the job's inputs and results.
+ * run is called on a worker thread and must not touch anything shared
+ * with the event loop. complete is called later on the event loop thread
+ * from RunCompletedWork, after which the pool frees the item. destroy, if
+ * set, is called just before any item is freed, whether or not it ran, so
+ * a job can wipe what it holds. It is called with the pool locked.
+ */
+struct WorkItem
+{
+    WorkFunction run;
+    WorkFunction complete;
+    WorkFunction destroy;
+    void *owner;        /* What the result is for, e.g. a Session */
+    bool cancelled;     /* Set by CancelWork, complete is not called */
+    unsigned long submitted; /* MonotonicNanos when it was submitted */
+    WorkItem *next;
+};
+
+/**
+ * Start threads workers, with room for queueDepth waiting jobs. Until the
+ * pool is started, or if threads are not supported, jobs run as soon as
+ * they are submitted but still complete from RunCompletedWork.
+ */
+bool StartWorkerPool(int threads, int queueDepth);
+
+/** Finish the running jobs and stop the workers. Waiting jobs are freed. */
+void StopWorkerPool(void);
+
+/**
+ * Queue item to run. Returns FALSE, leaving the item to the caller, when
+ * the queue is full.
+ */
+bool SubmitWork(WorkItem *item);
+
+/**
+ * Drop every job for owner, wherever it is. Call this before freeing the
+ * owner, so a completion never sees it.
+ */
+void CancelWork(void *owner);
+
+/** Call complete for each finished job. Returns how many were completed. */
+int RunCompletedWork(void);
+
+/** Jobs submitted but not yet completed, for metrics and tests. */
+int GetPendingWorkCount(void);
+
+#ifdef WORKER_THREADS_SUPPORTED
+/** Add the completion pipe to readFds, returning the new maxFd. */
+int SetWorkerFds(fd_set *readFds, int maxFd);
+
+/** Clear the completion pipe if it was readable and run completions. */
+void HandleWorkerFds(fd_set *readFds);
+#endif
+
+#endif
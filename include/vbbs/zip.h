@@ -0,0 +1,86 @@
+#ifndef VBBS_ZIP_H
+#define VBBS_ZIP_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/list.h>
+
+#include <stdio.h>
+#include <time.h>
+
+#define ZIP_LOCAL_HEADER_SIGNATURE 0x04034B50UL
+#define ZIP_CENTRAL_HEADER_SIGNATURE 0x02014B50UL
+#define ZIP_END_SIGNATURE 0x06054B50UL
+#define ZIP_LOCAL_HEADER_SIZE 30
+#define ZIP_CENTRAL_HEADER_SIZE 46
+#define ZIP_END_SIZE 22
+#define ZIP_MAX_NAME_LENGTH 64
+
+typedef struct ZipEntry
+{
+    char name[ZIP_MAX_NAME_LENGTH];
+    uint32_t crc;
+    uint32_t size;
+    uint32_t offset;       /* Offset of the entry's local header */
+    uint16_t dosTime;
+    uint16_t dosDate;
+} ZipEntry;
+
+/**
+ * Writes an uncompressed ("stored") ZIP archive one entry at a time. Entry
+ * data is streamed straight to the file; when an entry is finished the
+ * writer seeks back to fill in its CRC and size, so the file must be
+ * seekable but nothing is held in memory except the list of entries.
+ */
+typedef struct ZipWriter
+{
+    FILE *file;
+    ArrayList *entries;
+    ZipEntry *current;     /* Entry being written, or NULL */
+    bool failed;
+} ZipWriter;
+
+ZipWriter *NewZipWriter(FILE *file);
+
+/** Free the writer. The file is left open. */
+void DestroyZipWriter(ZipWriter *zip);
+
+bool StartZipEntry(ZipWriter *zip, const char *name, time_t modified);
+bool WriteZipData(ZipWriter *zip, const void *data, int length);
+bool FinishZipEntry(ZipWriter *zip);
+
+/** Write the central directory. No more entries can be added after this. */
+bool FinishZip(ZipWriter *zip);
+
+/**
+ * Find a stored entry in a ZIP archive by name, ignoring case, by walking
+ * the local headers. On success the file is positioned at the start of the
+ * entry's data and its size is returned, otherwise -1 is returned.
+ */
+long FindZipEntry(FILE *file, const char *name);
+
+#endif
@@ -0,0 +1,545 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <vbbs/admin.h>
+#include <vbbs/conn.h>
+#include <vbbs/conn/telnet.h>
+#include <vbbs/log.h>
+#include <vbbs/session.h>
+
+typedef enum
+{
+    ADMIN_UNKNOWN,
+    ADMIN_METRICS,
+    ADMIN_JSON,
+    ADMIN_SESSIONS
+} AdminCommand;
+
+static const char *ConnectionTypeName(unsigned int type)
+{
+    switch (type)
+    {
+        case CONSOLE:
+            return "console";
+        case SERIAL:
+            return "serial";
+        case MODEM:
+            return "modem";
+        case TELNET:
+            return "telnet";
+        default:
+            return "unknown";
+    }
+}
+
+static const char *SessionUserName(const Session *session)
+{
+    if (session->user == NULL || session->user->username[0] == '\0')
+    {
+        return "-";
+    }
+    return session->user->username;
+}
+
+static const char *SessionAddress(Session *session)
+{
+    if (session->conn->connectionType == TELNET)
+    {
+        return TelnetRemoteAddress(session->conn);
+    }
+    return "-";
+}
+
+static void AppendJsonString(MetricsText *out, const char *s)
+{
+    AppendMetricsText(out, "\"");
+    for (; *s != '\0'; s++)
+    {
+        if (*s == '"' || *s == '\\')
+        {
+            AppendMetricsText(out, "\\%c", *s);
+        }
+        else if ((unsigned char)*s < 0x20)
+        {
+            AppendMetricsText(out, "\\u%04x", (unsigned char)*s);
+        }
+        else
+        {
+            AppendMetricsText(out, "%c", *s);
+        }
+    }
+    AppendMetricsText(out, "\"");
+}
+
+static void WriteSessionsText(MetricsText *out, ArrayList *sessions)
+{
+    Session *session;
+    time_t now = time(NULL);
+    int i;
+
+    AppendMetricsText(out, "%-8s %-8s %-15s %-20s %-28s %8s %8s %6s\n",
+        "ID", "TYPE", "ADDRESS", "USER", "HANDLER", "QUEUED", "MEMORY", "IDLE");
+    for (i = 0; i < sessions->size; i++)
+    {
+        session = (Session *)GetFromArrayList(sessions, i);
+        if (session == NULL || session->conn == NULL)
+        {
+            continue;
+        }
+        AppendMetricsText(out, "%-8lu %-8s %-15s %-20s %-28s %8d %8lu %6ld\n",
+            (unsigned long)session->sessionID,
+            ConnectionTypeName(session->conn->connectionType),
+            SessionAddress(session), SessionUserName(session),
+            GetEventHandlerName(session->eventHandler),
+            session->conn->outputBuffer->length,
+            (unsigned long)GetSessionMemory(session),
+            (long)(now - session->lastActivity));
+    }
+}
+
+static void WriteSessionsJson(MetricsText *out, ArrayList *sessions)
+{
+    Session *session;
+    time_t now = time(NULL);
+    bool first = TRUE;
+    int i;
+
+    for (i = 0; i < sessions->size; i++)
+    {
+        session = (Session *)GetFromArrayList(sessions, i);
+        if (session == NULL || session->conn == NULL)
+        {
+            continue;
+        }
+        AppendMetricsText(out, "%s{\"id\": %lu, \"type\": \"%s\", "
+            "\"address\": \"%s\", \"user\": ", first ? "" : ", ",
+            (unsigned long)session->sessionID,
+            ConnectionTypeName(session->conn->connectionType),
+            SessionAddress(session));
+        AppendJsonString(out, SessionUserName(session));
+        AppendMetricsText(out, ", \"handler\": \"%s\", \"queued\": %d, "
+            "\"memory\": %lu, \"idle\": %ld}",
+            GetEventHandlerName(session->eventHandler),
+            session->conn->outputBuffer->length,
+            (unsigned long)GetSessionMemory(session),
+            (long)(now - session->lastActivity));
+        first = FALSE;
+    }
+}
+
+/**
+ * Accepts "name" or "GET /name HTTP/1.x", and reports which form was used
+ * through isHttp.
+ */
+static AdminCommand ParseAdminRequest(const char *request, bool *isHttp)
+{
+    const char *name = request;
+    int length;
+
+    *isHttp = FALSE;
+    if (strncmp(request, "GET ", 4) == 0)
+    {
+        *isHttp = TRUE;
+        name = request + 4;
+        while (*name == '/')
+        {
+            name++;
+        }
+    }
+    length = (int)strcspn(name, " \t\r\n");
+    if (length == 7 && strncmp(name, "metrics", 7) == 0)
+    {
+        return ADMIN_METRICS;
+    }
+    if (length == 4 && strncmp(name, "json", 4) == 0)
+    {
+        return ADMIN_JSON;
+    }
+    if (length == 8 && strncmp(name, "sessions", 8) == 0)
+    {
+        return ADMIN_SESSIONS;
+    }
+    return ADMIN_UNKNOWN;
+}
+
+void BuildAdminResponse(const char *request, ArrayList *sessions,
+    MetricsText *out)
+{
+    AdminCommand command;
+    bool isHttp;
+
+    command = ParseAdminRequest(request, &isHttp);
+    if (isHttp)
+    {
+        AppendMetricsText(out, "HTTP/1.0 %s\r\nContent-Type: %s\r\n"
+            "Connection: close\r\n\r\n",
+            command == ADMIN_UNKNOWN ? "404 Not Found" : "200 OK",
+            command == ADMIN_METRICS ? "text/plain; version=0.0.4" :
+            command == ADMIN_JSON ? "application/json" : "text/plain");
+    }
+
+    switch (command)
+    {
+        case ADMIN_METRICS:
+            WritePrometheusMetrics(out);
+            break;
+        case ADMIN_JSON:
+            AppendMetricsText(out, "{\"metrics\": {");
+            WriteJsonMetrics(out);
+            AppendMetricsText(out, "}, \"sessions\": [");
+            WriteSessionsJson(out, sessions);
+            AppendMetricsText(out, "]}\n");
+            break;
+        case ADMIN_SESSIONS:
+            WriteSessionsText(out, sessions);
+            break;
+        default:
+            AppendMetricsText(out, "Unknown request, try metrics, json or "
+                "sessions.\n");
+            break;
+    }
+    if (out->truncated)
+    {
+        Warn("Admin: Response truncated at %d bytes.", out->length);
+    }
+}
+
+/***** UNIX Implementation Using Unix Domain Sockets *****/
+
+#ifdef _POSIX_VERSION
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static void CloseAdminClient(AdminClient *client)
+{
+    if (client->socket >= 0)
+    {
+        close(client->socket);
+    }
+    client->socket = -1;
+    client->requestLength = 0;
+    client->responseLength = 0;
+    client->responseSent = 0;
+}
+
+AdminListener *NewAdminListener(const char *path)
+{
+    AdminListener *listener;
+    struct sockaddr_un address;
+    struct stat status;
+    mode_t mask;
+    int sockfd, result, i;
+
+    if (strlen(path) >= sizeof(address.sun_path) ||
+        strlen(path) >= sizeof(listener->path))
+    {
+        Error("Admin: Socket path is too long: %s", path);
+        return NULL;
+    }
+
+    /* A socket left behind by an earlier run would make bind() fail, but
+        anything else at the path is not ours to remove. */
+    if (lstat(path, &status) == 0)
+    {
+        if (!S_ISSOCK(status.st_mode))
+        {
+            Error("Admin: %s exists and is not a socket.", path);
+            return NULL;
+        }
+        unlink(path);
+    }
+
+    sockfd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sockfd < 0)
+    {
+        Error("Admin: Could not create socket, Error: %s", strerror(errno));
+        return NULL;
+    }
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, path);
+
+    /* Only the owner may connect, from the moment the socket exists. */
+    mask = umask(S_IXUSR | S_IRWXG | S_IRWXO);
+    result = bind(sockfd, (struct sockaddr *)&address, sizeof(address));
+    umask(mask);
+    if (result < 0)
+    {
+        Error("Admin: Bind to %s failed, Error: %s", path, strerror(errno));
+        close(sockfd);
+        return NULL;
+    }
+
+    if (listen(sockfd, ADMIN_MAX_CLIENTS) < 0)
+    {
+        Error("Admin: Listen failed, Error: %s", strerror(errno));
+        close(sockfd);
+        unlink(path);
+        return NULL;
+    }
+    fcntl(sockfd, F_SETFL, O_NONBLOCK);
+
+    listener = (AdminListener *)malloc(sizeof(AdminListener));
+    if (listener == NULL)
+    {
+        Error("Admin: Memory allocation failed for listener.");
+        close(sockfd);
+        unlink(path);
+        return NULL;
+    }
+    listener->socket = sockfd;
+    strcpy(listener->path, path);
+    for (i = 0; i < ADMIN_MAX_CLIENTS; i++)
+    {
+        listener->clients[i].socket = -1;
+        listener->clients[i].response = NULL;
+        CloseAdminClient(&listener->clients[i]);
+    }
+    for (i = 0; i < ADMIN_MAX_CLIENTS; i++)
+    {
+        listener->clients[i].response = (char *)malloc(ADMIN_RESPONSE_SIZE);
+        if (listener->clients[i].response == NULL)
+        {
+            Error("Admin: Memory allocation failed for responses.");
+            DestroyAdminListener(listener);
+            return NULL;
+        }
+    }
+
+    Info("Admin: Listening on %s", path);
+    return listener;
+}
+
+void DestroyAdminListener(AdminListener *listener)
+{
+    int i;
+
+    if (listener == NULL)
+    {
+        return;
+    }
+    for (i = 0; i < ADMIN_MAX_CLIENTS; i++)
+    {
+        CloseAdminClient(&listener->clients[i]);
+        free(listener->clients[i].response);
+    }
+    if (listener->socket >= 0)
+    {
+        close(listener->socket);
+        unlink(listener->path);
+        Info("Admin: Listener closed on %s", listener->path);
+    }
+    free(listener);
+}
+
+int SetAdminFds(AdminListener *listener, fd_set *readFds, fd_set *writeFds,
+    int maxFd)
+{
+    AdminClient *client;
+    int i;
+
+    if (listener == NULL)
+    {
+        return maxFd;
+    }
+    FD_SET(listener->socket, readFds);
+    maxFd = MAX(maxFd, listener->socket);
+    for (i = 0; i < ADMIN_MAX_CLIENTS; i++)
+    {
+        client = &listener->clients[i];
+        if (client->socket < 0)
+        {
+            continue;
+        }
+        if (client->responseLength > 0)
+        {
+            FD_SET(client->socket, writeFds);
+        }
+        else
+        {
+            FD_SET(client->socket, readFds);
+        }
+        maxFd = MAX(maxFd, client->socket);
+    }
+    return maxFd;
+}
+
+static void AcceptAdminClient(AdminListener *listener)
+{
+    int sockfd, i;
+
+    sockfd = accept(listener->socket, NULL, NULL);
+    if (sockfd < 0)
+    {
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            Error("Admin: Accept failed, Error: %s", strerror(errno));
+        }
+        return;
+    }
+    for (i = 0; i < ADMIN_MAX_CLIENTS; i++)
+    {
+        if (listener->clients[i].socket < 0)
+        {
+            fcntl(sockfd, F_SETFL, O_NONBLOCK);
+            listener->clients[i].socket = sockfd;
+            return;
+        }
+    }
+    Warn("Admin: Too many clients, closing connection.");
+    close(sockfd);
+}
+
+static void ReadAdminRequest(AdminClient *client, ArrayList *sessions)
+{
+    MetricsText out;
+    char *end;
+    ssize_t received;
+
+    received = recv(client->socket, client->request + client->requestLength,
+        ADMIN_REQUEST_SIZE - 1 - client->requestLength, 0);
+    if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+        return;
+    }
+    if (received > 0)
+    {
+        client->requestLength += (int)received;
+    }
+    client->request[client->requestLength] = '\0';
+
+    /* Only the first line matters, answer as soon as it is complete. */
+    end = strchr(client->request, '\n');
+    if (end == NULL && received > 0 &&
+        client->requestLength < ADMIN_REQUEST_SIZE - 1)
+    {
+        return;
+    }
+    if (client->requestLength == 0)
+    {
+        CloseAdminClient(client);
+        return;
+    }
+    if (end != NULL)
+    {
+        *end = '\0';
+    }
+
+    InitMetricsText(&out, client->response, ADMIN_RESPONSE_SIZE);
+    BuildAdminResponse(client->request, sessions, &out);
+    client->responseLength = out.length;
+    client->responseSent = 0;
+    if (client->responseLength == 0)
+    {
+        CloseAdminClient(client);
+    }
+}
+
+static void WriteAdminResponse(AdminClient *client)
+{
+    ssize_t sent;
+
+    sent = send(client->socket, client->response + client->responseSent,
+        client->responseLength - client->responseSent, MSG_NOSIGNAL);
+    if (sent < 0)
+    {
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            CloseAdminClient(client);
+        }
+        return;
+    }
+    client->responseSent += (int)sent;
+    if (client->responseSent >= client->responseLength)
+    {
+        CloseAdminClient(client);
+    }
+}
+
+void HandleAdminFds(AdminListener *listener, fd_set *readFds,
+    fd_set *writeFds, ArrayList *sessions)
+{
+    AdminClient *client;
+    int i;
+
+    if (listener == NULL)
+    {
+        return;
+    }
+    for (i = 0; i < ADMIN_MAX_CLIENTS; i++)
+    {
+        client = &listener->clients[i];
+        if (client->socket < 0)
+        {
+            continue;
+        }
+        if (client->responseLength > 0)
+        {
+            if (FD_ISSET(client->socket, writeFds))
+            {
+                WriteAdminResponse(client);
+            }
+        }
+        else if (FD_ISSET(client->socket, readFds))
+        {
+            ReadAdminRequest(client, sessions);
+        }
+    }
+    /* Accept last, so a new client isn't checked against stale sets. */
+    if (FD_ISSET(listener->socket, readFds))
+    {
+        AcceptAdminClient(listener);
+    }
+}
+
+#else
+
+AdminListener *NewAdminListener(const char *path)
+{
+    Warn("Admin: Unix domain sockets are not supported on this platform.");
+    return NULL;
+}
+
+void DestroyAdminListener(AdminListener *listener)
+{
+}
+
+#endif /* _POSIX_VERSION */
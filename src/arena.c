@@ -0,0 +1,179 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <vbbs/arena.h>
+#include <vbbs/pool.h>
+
+typedef union ArenaAlign
+{
+    long l;
+    double d;
+    void *p;
+} ArenaAlign;
+
+struct ArenaChunk
+{
+    ArenaChunk *previous;
+    size_t size;                /* Bytes for allocations */
+    size_t used;
+    ArenaAlign data[1];
+};
+
+#define ARENA_CHUNK_HEADER offsetof(ArenaChunk, data)
+
+/* Chunks of the usual size are shared by every arena. */
+static Pool chunkPool = POOL("arena", ARENA_CHUNK_SIZE, 8);
+
+static void FreeChunk(Arena *arena, ArenaChunk *chunk)
+{
+    arena->reserved -= ARENA_CHUNK_HEADER + chunk->size;
+    if (ARENA_CHUNK_HEADER + chunk->size == ARENA_CHUNK_SIZE)
+    {
+        PoolFree(&chunkPool, chunk);
+    }
+    else
+    {
+        free(chunk);
+    }
+}
+
+/** Add a chunk with room for size bytes, or return NULL. */
+static ArenaChunk *GrowArena(Arena *arena, size_t size)
+{
+    ArenaChunk *chunk;
+    size_t total = ARENA_CHUNK_SIZE;
+
+    if (size > ARENA_CHUNK_SIZE - ARENA_CHUNK_HEADER)
+    {
+        total = ARENA_CHUNK_HEADER + size;
+    }
+    if (arena->limit > 0 && arena->reserved + total > arena->limit)
+    {
+        arena->refused++;
+        return NULL;
+    }
+    if (total == ARENA_CHUNK_SIZE)
+    {
+        chunk = (ArenaChunk *)PoolAlloc(&chunkPool);
+    }
+    else
+    {
+        chunk = (ArenaChunk *)malloc(total);
+    }
+    if (chunk == NULL)
+    {
+        return NULL;
+    }
+
+    chunk->previous = arena->chunk;
+    chunk->size = total - ARENA_CHUNK_HEADER;
+    chunk->used = 0;
+    arena->chunk = chunk;
+    arena->reserved += total;
+    if (arena->reserved > arena->peak)
+    {
+        arena->peak = arena->reserved;
+    }
+    return chunk;
+}
+
+void InitArena(Arena *arena, size_t limit)
+{
+    memset(arena, 0, sizeof(Arena));
+    arena->limit = limit;
+}
+
+void *ArenaAlloc(Arena *arena, size_t size)
+{
+    ArenaChunk *chunk = arena->chunk;
+    void *memory;
+
+    size = (MAX(size, 1) + sizeof(ArenaAlign) - 1) / sizeof(ArenaAlign) *
+        sizeof(ArenaAlign);
+    if (chunk == NULL || chunk->size - chunk->used < size)
+    {
+        /* The rest of the old chunk is wasted until the arena is reset. */
+        chunk = GrowArena(arena, size);
+        if (chunk == NULL)
+        {
+            return NULL;
+        }
+    }
+    memory = (char *)chunk->data + chunk->used;
+    chunk->used += size;
+    arena->used += size;
+    return memory;
+}
+
+char *ArenaCopyString(Arena *arena, const char *string)
+{
+    size_t length = strlen(string) + 1;
+    char *copy = (char *)ArenaAlloc(arena, length);
+
+    if (copy != NULL)
+    {
+        memcpy(copy, string, length);
+    }
+    return copy;
+}
+
+ArenaMark GetArenaMark(const Arena *arena)
+{
+    ArenaMark mark;
+
+    mark.chunk = arena->chunk;
+    mark.offset = arena->chunk != NULL ? arena->chunk->used : 0;
+    mark.used = arena->used;
+    return mark;
+}
+
+void ResetArena(Arena *arena, ArenaMark mark)
+{
+    ArenaChunk *chunk;
+
+    while (arena->chunk != NULL && arena->chunk != mark.chunk)
+    {
+        chunk = arena->chunk;
+        arena->chunk = chunk->previous;
+        FreeChunk(arena, chunk);
+    }
+    if (arena->chunk != NULL)
+    {
+        arena->chunk->used = mark.offset;
+    }
+    arena->used = mark.used;
+}
+
+void DestroyArena(Arena *arena)
+{
+    ArenaMark empty;
+
+    memset(&empty, 0, sizeof(empty));
+    ResetArena(arena, empty);
+}
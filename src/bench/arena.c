@@ -0,0 +1,77 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/arena.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared.h"
+
+#define BENCH_ARENA_OPS 1000000L
+#define BENCH_ARENA_SCREEN 32
+
+/* A screen's worth of small allocations, then a reset. */
+static void benchArena(void *context, long ops) {
+    Arena *arena = (Arena *)context;
+    ArenaMark mark = GetArenaMark(arena);
+    long i;
+    for (i = 0; i < ops; i++) {
+        *(char *)ArenaAlloc(arena, 24 + (size_t)(i & 63)) = 0;
+        if (i % BENCH_ARENA_SCREEN == BENCH_ARENA_SCREEN - 1) {
+            ResetArena(arena, mark);
+        }
+    }
+    ResetArena(arena, mark);
+}
+
+static void benchMalloc(void *context, long ops) {
+    void *blocks[BENCH_ARENA_SCREEN];
+    long i;
+    int j;
+    (void)context;
+    for (i = 0; i < ops; i++) {
+        blocks[i % BENCH_ARENA_SCREEN] = malloc(24 + (size_t)(i & 63));
+        *(char *)blocks[i % BENCH_ARENA_SCREEN] = 0;
+        if (i % BENCH_ARENA_SCREEN == BENCH_ARENA_SCREEN - 1) {
+            for (j = 0; j < BENCH_ARENA_SCREEN; j++) {
+                free(blocks[j]);
+            }
+        }
+    }
+}
+
+void runAllArenaBenchmarks(void) {
+    Arena arena;
+
+    printf("Running Arena Benchmarks...\n");
+    InitArena(&arena, 0);
+    runBenchmark("ArenaAlloc, reset every 32", benchArena, &arena,
+        BENCH_ARENA_OPS);
+    runBenchmark("malloc, free every 32", benchMalloc, NULL,
+        BENCH_ARENA_OPS);
+    DestroyArena(&arena);
+    printf("\n");
+}
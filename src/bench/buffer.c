@@ -0,0 +1,129 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/buffer.h>
+#include <vbbs/terminal.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+#define BENCH_BUFFER_SIZE 1024
+#define BENCH_BUFFER_OPS 200000L
+
+/* 64 bytes of menu-like output. */
+#define BENCH_OUTPUT_TEXT \
+    "1. List Users\n2. Logout\n3. Search Messages\n4. Download QWK Pac\n"
+
+/* 64 bytes of typing with a telnet negotiation in the middle. */
+#define BENCH_INPUT_TEXT \
+    "the quick brown fox jumps over" TELNET_DO_SUPPRESS_GO_AHEAD \
+    " the lazy dog and runs away\r\n"
+
+static void benchWriteOutput(void *context, long ops) {
+    Buffer *buffer = (Buffer *)context;
+    int length = (int)strlen(BENCH_OUTPUT_TEXT);
+    long i;
+
+    for (i = 0; i < ops; i++) {
+        if (BufferRemaining(buffer) < length * 2) {
+            ClearBuffer(buffer);
+        }
+        WriteToBuffer(buffer, BENCH_OUTPUT_TEXT, length);
+    }
+}
+
+static void benchWriteInput(void *context, long ops) {
+    InputBuffer *input = (InputBuffer *)context;
+    int length = (int)strlen(BENCH_INPUT_TEXT);
+    long i;
+
+    for (i = 0; i < ops; i++) {
+        if (BufferRemaining(input->buffer) < length) {
+            ClearBuffer(input->buffer);
+        }
+        WriteToBuffer(input->buffer, BENCH_INPUT_TEXT, length);
+    }
+}
+
+static void benchFindNextLine(void *context, long ops) {
+    InputBuffer *input = (InputBuffer *)context;
+    int length = (int)strlen(BENCH_INPUT_TEXT);
+    long i;
+
+    for (i = 0; i < ops; i++) {
+        if (IsBufferEmpty(input->buffer)) {
+            while (BufferRemaining(input->buffer) >= length) {
+                WriteToBuffer(input->buffer, BENCH_INPUT_TEXT, length);
+            }
+        }
+        IsNextLineReady(input);
+        ClearNextLine(input);
+    }
+}
+
+static void benchShiftBuffer(void *context, long ops) {
+    Buffer *buffer = (Buffer *)context;
+    long i;
+
+    for (i = 0; i < ops; i++) {
+        if (buffer->length < 16) {
+            ClearBuffer(buffer);
+            while (BufferRemaining(buffer) >= 64) {
+                WriteToBuffer(buffer, BENCH_OUTPUT_TEXT, 64);
+            }
+        }
+        ShiftBuffer(buffer, 16);
+    }
+}
+
+void runAllBufferBenchmarks(void) {
+    Buffer *output;
+    InputBuffer *input;
+
+    printf("Running Buffer Benchmarks...\n");
+    output = NewBuffer(BENCH_BUFFER_SIZE);
+    input = NewInputBuffer(BENCH_BUFFER_SIZE);
+    if (output == NULL || input == NULL) {
+        printf("Could not allocate buffers\n");
+        return;
+    }
+    output->convertNewlines = TRUE;
+
+    runBenchmark("WriteToBuffer output (64 bytes)", benchWriteOutput,
+        output, BENCH_BUFFER_OPS);
+    runBenchmark("WriteToBuffer telnet input (64 bytes)", benchWriteInput,
+        input, BENCH_BUFFER_OPS);
+    ClearBuffer(input->buffer);
+    runBenchmark("FindNextLine", benchFindNextLine, input, BENCH_BUFFER_OPS);
+    output->convertNewlines = FALSE;
+    runBenchmark("ShiftBuffer (16 bytes)", benchShiftBuffer, output,
+        BENCH_BUFFER_OPS);
+
+    DestroyInputBuffer(input);
+    DestroyBuffer(output);
+    printf("\n");
+}
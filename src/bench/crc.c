@@ -0,0 +1,86 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/crc.h>
+#include <stdio.h>
+
+#include "shared.h"
+
+#define BENCH_CRC_BLOCK 4096
+#define BENCH_CRC_OPS 5000L
+
+static uint8_t block[BENCH_CRC_BLOCK];
+static unsigned long sink;
+
+static void benchCRC16CCITT(void *context, long ops) {
+    long i;
+    (void)context;
+    for (i = 0; i < ops; i++) {
+        sink += CRC16(CRC16_CCITT, block, BENCH_CRC_BLOCK);
+    }
+}
+
+static void benchCRC16XModem(void *context, long ops) {
+    long i;
+    (void)context;
+    for (i = 0; i < ops; i++) {
+        sink += CRC16(CRC16_XMODEM, block, BENCH_CRC_BLOCK);
+    }
+}
+
+static void benchCRC32(void *context, long ops) {
+    long i;
+    (void)context;
+    for (i = 0; i < ops; i++) {
+        sink += CRC32(0, block, BENCH_CRC_BLOCK);
+    }
+}
+
+static void benchChecksum(void *context, long ops) {
+    long i;
+    (void)context;
+    for (i = 0; i < ops; i++) {
+        sink += Checksum(block, BENCH_CRC_BLOCK);
+    }
+}
+
+void runAllCRCBenchmarks(void) {
+    uint32_t seed = 7;
+    int i;
+
+    printf("Running CRC Benchmarks...\n");
+    for (i = 0; i < BENCH_CRC_BLOCK; i++) {
+        block[i] = (uint8_t)BenchRandom(&seed);
+    }
+
+    runBenchmark("CRC16 CCITT (4 KB)", benchCRC16CCITT, NULL,
+        BENCH_CRC_OPS);
+    runBenchmark("CRC16 XMODEM (4 KB)", benchCRC16XModem, NULL,
+        BENCH_CRC_OPS);
+    runBenchmark("CRC32 (4 KB)", benchCRC32, NULL, BENCH_CRC_OPS);
+    runBenchmark("Checksum (4 KB)", benchChecksum, NULL, BENCH_CRC_OPS);
+    printf("\n");
+}
@@ -0,0 +1,112 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/msg.h>
+#include <vbbs/db/msg.h>
+#include <vbbs/db/lastread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared.h"
+
+#define BENCH_MESSAGE_DB "newscanbench.db"
+#define BENCH_LASTREAD_DB "newscanbench.lr"
+#define BENCH_AREAS 500
+#define BENCH_USERS 1000
+#define BENCH_SCANS 100000L
+
+static void removeBenchFiles(void) {
+    char filename[64];
+    int i;
+
+    remove(BENCH_MESSAGE_DB);
+    remove(BENCH_LASTREAD_DB);
+    for (i = 1; i <= BENCH_AREAS; i++) {
+        sprintf(filename, MESSAGE_AREA_FILE_FORMAT, "", (unsigned int)i,
+            MESSAGE_INDEX_EXTENSION);
+        remove(filename);
+        sprintf(filename, MESSAGE_AREA_FILE_FORMAT, "", (unsigned int)i,
+            MESSAGE_DATA_EXTENSION);
+        remove(filename);
+    }
+}
+
+void runAllNewScanBenchmarks(void) {
+    MessageDB *messages;
+    MessageArea *area;
+    MessageHeader header;
+    LastReadDB *db;
+    NewScanResult results[BENCH_AREAS];
+    uint32_t seed = 3, posts, unread = 0;
+    unsigned int user, i, j;
+    long scans;
+    double start, elapsed;
+
+    printf("Running Newscan Benchmarks...\n");
+    removeBenchFiles();
+    messages = NewMessageDB(BENCH_MESSAGE_DB);
+    db = OpenLastReadDB(BENCH_LASTREAD_DB);
+    if (messages == NULL || db == NULL) {
+        printf("Could not create benchmark databases\n");
+        return;
+    }
+
+    for (i = 0; i < BENCH_AREAS; i++) {
+        area = _AddMessageArea(messages, "Area", "");
+        if (area == NULL) {
+            printf("Could not create benchmark area\n");
+            break;
+        }
+        posts = BenchRandom(&seed) % 50;
+        for (j = 0; j < posts; j++) {
+            InitMessageHeader(&header, "Sysop", "All", "Newscan");
+            PostMessage(area, &header, "Body", 4);
+        }
+        for (user = 1; user <= BENCH_USERS; user++) {
+            _SetLastRead(db, user, area->areaID,
+                BenchRandom(&seed) % (posts + 1));
+        }
+    }
+
+    start = BenchNow();
+    for (scans = 0; scans < BENCH_SCANS; scans++) {
+        user = 1 + BenchRandom(&seed) % BENCH_USERS;
+        _NewScan(db, messages, user, results, BENCH_AREAS);
+        unread += results[scans % BENCH_AREAS].unread;
+    }
+    elapsed = BenchNow() - start;
+    printBenchResult("NewScan (500 areas)", BENCH_SCANS, elapsed);
+    printf("%50s: %10.3f us\n", "Time per full newscan",
+        elapsed * 1e6 / BENCH_SCANS);
+    if (unread == 0) {
+        printf("Unexpected empty newscan\n");
+    }
+
+    CloseLastReadDB(db);
+    DestroyMessageDB(messages);
+    removeBenchFiles();
+    printf("\n");
+}
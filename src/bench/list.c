@@ -0,0 +1,147 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/list.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared.h"
+
+#define BENCH_LIST_ITEMS 100000
+#define BENCH_LIST_OPS 1000000L
+#define BENCH_SORT_ITEMS 10000
+#define BENCH_SORT_OPS 50L
+#define BENCH_CONTAINS_ITEMS 1000
+#define BENCH_CONTAINS_OPS 20000L
+
+typedef struct ListBench {
+    ArrayList *list;
+    int *values;
+    void **shuffled;           /* Unsorted order, restored before each sort */
+    int *indexes;
+    unsigned long sink;
+} ListBench;
+
+static void benchAdd(void *context, long ops) {
+    ListBench *bench = (ListBench *)context;
+    ArrayList *list = NewArrayList(16, NULL);
+    long i;
+
+    for (i = 0; i < ops; i++) {
+        AddToArrayList(list, &bench->values[i % BENCH_LIST_ITEMS]);
+    }
+    bench->sink += list->size;
+    DestroyArrayList(list);
+}
+
+static void benchGet(void *context, long ops) {
+    ListBench *bench = (ListBench *)context;
+    long i;
+
+    for (i = 0; i < ops; i++) {
+        bench->sink += *(int *)GetFromArrayList(bench->list,
+            bench->indexes[i % BENCH_LIST_ITEMS]);
+    }
+}
+
+static void benchSort(void *context, long ops) {
+    ListBench *bench = (ListBench *)context;
+    ArrayList *list = NewArrayList(BENCH_SORT_ITEMS, NULL);
+    long i;
+
+    for (i = 0; i < BENCH_SORT_ITEMS; i++) {
+        AddToArrayList(list, bench->shuffled[i]);
+    }
+    for (i = 0; i < ops; i++) {
+        memcpy(list->items, bench->shuffled,
+            BENCH_SORT_ITEMS * sizeof(void *));
+        SortArrayList(list, IntListItemComparator);
+    }
+    DestroyArrayList(list);
+}
+
+static void benchContains(void *context, long ops) {
+    ListBench *bench = (ListBench *)context;
+    ArrayList *list = NewArrayList(BENCH_CONTAINS_ITEMS, NULL);
+    long i;
+
+    for (i = 0; i < BENCH_CONTAINS_ITEMS; i++) {
+        AddToArrayList(list, &bench->values[i]);
+    }
+    for (i = 0; i < ops; i++) {
+        bench->sink += ArrayListContains(list,
+            &bench->values[bench->indexes[i % BENCH_LIST_ITEMS] %
+            (BENCH_CONTAINS_ITEMS * 2)], NULL);
+    }
+    DestroyArrayList(list);
+}
+
+void runAllListBenchmarks(void) {
+    ListBench bench;
+    uint32_t seed = 11;
+    void *swap;
+    int i, j;
+
+    printf("Running ArrayList Benchmarks...\n");
+    memset(&bench, 0, sizeof(bench));
+    bench.values = (int *)malloc(BENCH_LIST_ITEMS * sizeof(int));
+    bench.indexes = (int *)malloc(BENCH_LIST_ITEMS * sizeof(int));
+    bench.shuffled = (void **)malloc(BENCH_SORT_ITEMS * sizeof(void *));
+    bench.list = NewArrayList(BENCH_LIST_ITEMS, NULL);
+    if (bench.values == NULL || bench.indexes == NULL ||
+        bench.shuffled == NULL || bench.list == NULL) {
+        printf("Could not allocate lists\n");
+        return;
+    }
+    for (i = 0; i < BENCH_LIST_ITEMS; i++) {
+        bench.values[i] = (int)(BenchRandom(&seed) % 1000000);
+        bench.indexes[i] = (int)(BenchRandom(&seed) % BENCH_LIST_ITEMS);
+        AddToArrayList(bench.list, &bench.values[i]);
+    }
+    for (i = 0; i < BENCH_SORT_ITEMS; i++) {
+        bench.shuffled[i] = &bench.values[i];
+    }
+    for (i = BENCH_SORT_ITEMS - 1; i > 0; i--) {
+        j = (int)(BenchRandom(&seed) % (uint32_t)(i + 1));
+        swap = bench.shuffled[i];
+        bench.shuffled[i] = bench.shuffled[j];
+        bench.shuffled[j] = swap;
+    }
+
+    runBenchmark("AddToArrayList", benchAdd, &bench, BENCH_LIST_OPS);
+    runBenchmark("GetFromArrayList", benchGet, &bench, BENCH_LIST_OPS);
+    runBenchmark("SortArrayList (10000 ints)", benchSort, &bench,
+        BENCH_SORT_OPS);
+    runBenchmark("ArrayListContains (1000 items)", benchContains, &bench,
+        BENCH_CONTAINS_OPS);
+
+    DestroyArrayList(bench.list);
+    free(bench.shuffled);
+    free(bench.indexes);
+    free(bench.values);
+    printf("\n");
+}
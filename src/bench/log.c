@@ -0,0 +1,103 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/log.h>
+#include <stdio.h>
+
+#include "shared.h"
+
+#define BENCH_LOG_FILE "logbench.log"
+#define BENCH_LOG_MESSAGES 200000L
+
+static void logBenchMessage(long i) {
+    Info("[%d] Benchmark message %ld from %s:%d", 42, i, "127.0.0.1", 2323);
+}
+
+static void benchSyncLog(void) {
+    double start;
+    long i;
+
+    start = BenchNow();
+    for (i = 0; i < BENCH_LOG_MESSAGES; i++) {
+        logBenchMessage(i);
+    }
+    printBenchResult("Info (synchronous)", BENCH_LOG_MESSAGES,
+        BenchNow() - start);
+}
+
+/*
+ * Log in bursts that fit in the ring, waiting for the writer in between,
+ * so the caller's cost is measured without anything being dropped.
+ */
+static void benchAsyncLog(void) {
+    double start, caller = 0.0, total;
+    long i = 0;
+    int n;
+
+    total = BenchNow();
+    while (i < BENCH_LOG_MESSAGES) {
+        start = BenchNow();
+        for (n = 0; n < LOG_RING_SIZE / 2 && i < BENCH_LOG_MESSAGES; n++) {
+            logBenchMessage(i++);
+        }
+        caller += BenchNow() - start;
+        FlushLog();
+    }
+    total = BenchNow() - total;
+    printBenchResult("Info (asynchronous, caller)", BENCH_LOG_MESSAGES,
+        caller);
+    printBenchResult("Info (asynchronous, written)", BENCH_LOG_MESSAGES,
+        total);
+}
+
+void runAllLogBenchmarks(void) {
+    LogLevel level = LOG_ERROR;
+    unsigned long dropped;
+
+    printf("Running Log Benchmarks...\n");
+    remove(BENCH_LOG_FILE);
+    SetLogEcho(FALSE);
+    SetLogLevel(LOG_INFO);
+    SetLogRateLimits(0, 0, 0, 0);
+    InitLog(BENCH_LOG_FILE);
+
+    benchSyncLog();
+
+    if (StartAsyncLog()) {
+        dropped = GetDroppedLogMessages();
+        benchAsyncLog();
+        StopAsyncLog();
+        printf("%50s: %10lu\n", "Dropped", GetDroppedLogMessages() - dropped);
+    }
+
+    CloseLog();
+    remove(BENCH_LOG_FILE);
+    SetLogEcho(TRUE);
+    SetLogRateLimits(LOG_SITE_RATE, LOG_SITE_BURST, LOG_SESSION_RATE,
+        LOG_SESSION_BURST);
+    SetLogLevel(level);
+    printf("\n");
+}
@@ -0,0 +1,112 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/log.h>
+#include <vbbs/user.h>
+#include <vbbs/db/user.h>
+#include <stdio.h>
+
+#include "shared.h"
+
+#define BENCH_LOGIN_DB_FILE "loginbench.db"
+#define BENCH_LOGIN_LOG_FILE "loginbench.log"
+#define BENCH_LOGIN_USERS 1000
+#define BENCH_LOGINS 200000L
+
+/*
+ * The work CheckPassword does for each attempt: find the user, then hash
+ * and compare the password, with the Debug calls along the way.
+ */
+static void benchLogins(UserDB *db, const char *name) {
+    char username[21], password[21];
+    uint32_t seed = 11;
+    User *user;
+    long i, ok = 0;
+    double start;
+
+    start = BenchNow();
+    for (i = 0; i < BENCH_LOGINS; i++) {
+        int n = (int)(BenchRandom(&seed) % BENCH_LOGIN_USERS);
+        sprintf(username, "user%d", n);
+        sprintf(password, "secret%d", n);
+        user = _GetUserByUsername(db, username);
+        if (AuthenticateUser(user, username, password)) {
+            ok++;
+        }
+    }
+    printBenchResult(name, BENCH_LOGINS, BenchNow() - start);
+    if (ok != BENCH_LOGINS) {
+        printf("%50s: %10ld\n", "Unexpected failures", BENCH_LOGINS - ok);
+    }
+}
+
+/*
+ * Run once as built and once with make LOG_MIN_LEVEL=LOG_INFO to compare
+ * Debug compiled in against compiled out. Passwords are hashed with a
+ * single PBKDF2 iteration so the logging cost is not lost in the hashing;
+ * the pbkdf2 group measures that.
+ */
+void runAllLoginBenchmarks(void) {
+    UserDB *db;
+    User *user;
+    char password[21];
+    int i;
+
+    printf("Running Login Benchmarks (Debug %s)...\n",
+        LOG_MIN_LEVEL > LOG_DEBUG ? "compiled out" : "compiled in");
+    db = NewUserDB(BENCH_LOGIN_DB_FILE);
+    if (db == NULL) {
+        printf("Could not allocate user database\n");
+        return;
+    }
+    SetPasswordIterations(1);
+    for (i = 0; i < BENCH_LOGIN_USERS; i++) {
+        user = NewUser();
+        sprintf(user->username, "user%d", i);
+        sprintf(password, "secret%d", i);
+        ChangePassword(user, password);
+        _AddUser(db, user);
+    }
+
+    benchLogins(db, "Logins, Debug disabled");
+
+    remove(BENCH_LOGIN_LOG_FILE);
+    SetLogEcho(FALSE);
+    SetLogRateLimits(0, 0, 0, 0);
+    InitLog(BENCH_LOGIN_LOG_FILE);
+    SetLogLevel(LOG_DEBUG);
+    benchLogins(db, "Logins, Debug enabled");
+    SetLogLevel(LOG_ERROR);
+    CloseLog();
+    remove(BENCH_LOGIN_LOG_FILE);
+    SetLogEcho(TRUE);
+    SetLogRateLimits(LOG_SITE_RATE, LOG_SITE_BURST, LOG_SESSION_RATE,
+        LOG_SESSION_BURST);
+
+    SetPasswordIterations(PASSWORD_ITERATIONS);
+    DestroyUserDB(db);
+    printf("\n");
+}
@@ -0,0 +1,102 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/map.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared.h"
+
+#define BENCH_MAP_KEYS 1000
+#define BENCH_MAP_OPS 200000L
+
+typedef struct MapBench {
+    Map *map;
+    char keys[BENCH_MAP_KEYS][16];
+    char missing[BENCH_MAP_KEYS][16];
+    unsigned long sink;
+} MapBench;
+
+static void benchPut(void *context, long ops) {
+    MapBench *bench = (MapBench *)context;
+    Map *map = NewMap(NULL);
+    long i;
+
+    for (i = 0; i < ops; i++) {
+        MapPut(map, bench->keys[i % BENCH_MAP_KEYS], bench);
+    }
+    bench->sink += map->size;
+    DestroyMap(map);
+}
+
+static void benchGetHit(void *context, long ops) {
+    MapBench *bench = (MapBench *)context;
+    long i;
+
+    for (i = 0; i < ops; i++) {
+        bench->sink += MapGet(bench->map, bench->keys[i % BENCH_MAP_KEYS])
+            != NULL;
+    }
+}
+
+static void benchGetMiss(void *context, long ops) {
+    MapBench *bench = (MapBench *)context;
+    long i;
+
+    for (i = 0; i < ops; i++) {
+        bench->sink += MapGet(bench->map,
+            bench->missing[i % BENCH_MAP_KEYS]) != NULL;
+    }
+}
+
+void runAllMapBenchmarks(void) {
+    MapBench *bench;
+    int i;
+
+    printf("Running Map Benchmarks...\n");
+    bench = (MapBench *)malloc(sizeof(MapBench));
+    if (bench == NULL || (bench->map = NewMap(NULL)) == NULL) {
+        printf("Could not allocate map\n");
+        free(bench);
+        return;
+    }
+    for (i = 0; i < BENCH_MAP_KEYS; i++) {
+        sprintf(bench->keys[i], "user%d", i);
+        sprintf(bench->missing[i], "nobody%d", i);
+        MapPut(bench->map, bench->keys[i], bench);
+    }
+
+    runBenchmark("MapPut (1000 keys)", benchPut, bench, BENCH_MAP_OPS);
+    runBenchmark("MapGet hit (1000 keys)", benchGetHit, bench,
+        BENCH_MAP_OPS);
+    runBenchmark("MapGet miss (1000 keys)", benchGetMiss, bench,
+        BENCH_MAP_OPS);
+
+    DestroyMap(bench->map);
+    free(bench);
+    printf("\n");
+}
@@ -0,0 +1,79 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/memory.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared.h"
+
+#define BENCH_MEMORY_OPS 1000000L
+#define BENCH_MEMORY_LIVE 32
+
+/* Keep a few blocks live, replacing the oldest each time. */
+static void benchTracked(void *context, long ops) {
+    void *blocks[BENCH_MEMORY_LIVE] = { NULL };
+    long i;
+    int j;
+    SetMemoryAccount((MemoryAccount *)context);
+    for (i = 0; i < ops; i++) {
+        j = (int)(i % BENCH_MEMORY_LIVE);
+        TrackedFree(blocks[j]);
+        blocks[j] = TrackedMalloc(24 + (size_t)(i & 63));
+    }
+    for (j = 0; j < BENCH_MEMORY_LIVE; j++) {
+        TrackedFree(blocks[j]);
+    }
+    SetMemoryAccount(NULL);
+}
+
+static void benchMalloc(void *context, long ops) {
+    void *blocks[BENCH_MEMORY_LIVE] = { NULL };
+    long i;
+    int j;
+    (void)context;
+    for (i = 0; i < ops; i++) {
+        j = (int)(i % BENCH_MEMORY_LIVE);
+        free(blocks[j]);
+        blocks[j] = malloc(24 + (size_t)(i & 63));
+    }
+    for (j = 0; j < BENCH_MEMORY_LIVE; j++) {
+        free(blocks[j]);
+    }
+}
+
+void runAllMemoryBenchmarks(void) {
+    MemoryAccount *account = NewMemoryAccount();
+
+    printf("Running Memory Benchmarks...\n");
+    runBenchmark("TrackedMalloc/TrackedFree, no account", benchTracked, NULL,
+        BENCH_MEMORY_OPS);
+    runBenchmark("TrackedMalloc/TrackedFree, session account", benchTracked,
+        account, BENCH_MEMORY_OPS);
+    runBenchmark("malloc/free", benchMalloc, NULL, BENCH_MEMORY_OPS);
+    ReleaseMemoryAccount(account);
+    printf("\n");
+}
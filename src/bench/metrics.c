@@ -0,0 +1,73 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/metrics.h>
+#include <stdio.h>
+
+#include "shared.h"
+
+#define BENCH_METRIC_OPS 10000000L
+
+static Counter benchCounter;
+static Histogram benchHistogram;
+
+static void benchNanosPerOp(const char *name, double start) {
+    printBenchResult(name, BENCH_METRIC_OPS, BenchNow() - start);
+}
+
+void runAllMetricsBenchmarks(void) {
+    unsigned long sink = 0;
+    uint32_t seed = 3;
+    double start;
+    long i;
+
+    printf("Running Metrics Benchmarks...\n");
+
+    start = BenchNow();
+    for (i = 0; i < BENCH_METRIC_OPS; i++) {
+        IncrementCounter(&benchCounter);
+    }
+    benchNanosPerOp("IncrementCounter", start);
+
+    start = BenchNow();
+    for (i = 0; i < BENCH_METRIC_OPS; i++) {
+        RecordHistogram(&benchHistogram, BenchRandom(&seed) & 0xFFFFF);
+    }
+    benchNanosPerOp("RecordHistogram", start);
+
+    start = BenchNow();
+    for (i = 0; i < BENCH_METRIC_OPS; i++) {
+        sink += MonotonicNanos();
+    }
+    benchNanosPerOp("MonotonicNanos", start);
+
+    printf("%50s: %10lu ns\n", "p99 of random values",
+        GetHistogramPercentile(&benchHistogram, 0.99));
+    if (sink == 0 || GetCounterValue(&benchCounter) != BENCH_METRIC_OPS) {
+        printf("Unexpected counter value\n");
+    }
+    printf("\n");
+}
@@ -0,0 +1,152 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/msg.h>
+#include <vbbs/db/msg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+#define BENCH_MESSAGE_DB "msgbench.db"
+#define BENCH_AREA_INDEX "area0001.idx"
+#define BENCH_AREA_DATA "area0001.dat"
+
+/* Messages per area, matching the size of a large, long-running board. */
+#define BENCH_MESSAGE_COUNT 1000000L
+#define BENCH_RANDOM_READS 1000000L
+
+static void removeBenchFiles(void) {
+    remove(BENCH_MESSAGE_DB);
+    remove(BENCH_AREA_INDEX);
+    remove(BENCH_AREA_DATA);
+}
+
+static void benchPostMessages(MessageArea *area) {
+    MessageHeader header;
+    char body[256];
+    uint32_t seed = 1;
+    long i;
+    int length;
+    double start;
+
+    start = BenchNow();
+    for (i = 1; i <= BENCH_MESSAGE_COUNT; i++) {
+        InitMessageHeader(&header, "Sysop", "All", "Benchmark message");
+        /* Bodies between 40 and 240 bytes, like typical short posts. */
+        length = 40 + (int)(BenchRandom(&seed) % 200);
+        memset(body, 'a' + (int)(i % 26), length);
+        PostMessage(area, &header, body, length);
+    }
+    printBenchResult("PostMessage", BENCH_MESSAGE_COUNT, BenchNow() - start);
+}
+
+static void benchRandomHeaders(MessageArea *area) {
+    uint32_t seed = 7, number, sum = 0;
+    const MessageHeader *header;
+    long i;
+    double start;
+
+    start = BenchNow();
+    for (i = 0; i < BENCH_RANDOM_READS; i++) {
+        number = 1 + BenchRandom(&seed) % BENCH_MESSAGE_COUNT;
+        header = GetMessageHeader(area, number);
+        sum += header->bodyLength;
+    }
+    printBenchResult("GetMessageHeader (random)", BENCH_RANDOM_READS,
+        BenchNow() - start);
+    if (sum == 0) {
+        printf("Unexpected empty bodies\n");
+    }
+}
+
+static void benchRandomReads(MessageArea *area) {
+    uint32_t seed = 11, number;
+    const MessageHeader *header;
+    char body[256];
+    long i, bytes = 0;
+    double start;
+
+    start = BenchNow();
+    for (i = 0; i < BENCH_RANDOM_READS; i++) {
+        number = 1 + BenchRandom(&seed) % BENCH_MESSAGE_COUNT;
+        header = GetMessageHeader(area, number);
+        bytes += ReadMessageBody(area, header, 0, body, sizeof(body));
+    }
+    printBenchResult("Header + body (random)", BENCH_RANDOM_READS,
+        BenchNow() - start);
+    if (bytes == 0) {
+        printf("Unexpected empty bodies\n");
+    }
+}
+
+static void benchNewScan(MessageArea *area, uint32_t lastRead) {
+    const MessageHeader *header;
+    char body[256];
+    uint32_t number, highWater;
+    long count = 0, bytes = 0;
+    double start;
+
+    start = BenchNow();
+    highWater = GetHighWaterMark(area);
+    for (number = lastRead + 1; number <= highWater; number++) {
+        header = GetMessageHeader(area, number);
+        if (IsMessageDeleted(header)) {
+            continue;
+        }
+        bytes += ReadMessageBody(area, header, 0, body, sizeof(body));
+        count++;
+    }
+    printBenchResult(lastRead == 0 ? "Newscan (full area)" :
+        "Newscan (last 10%)", count, BenchNow() - start);
+    if (bytes == 0) {
+        printf("Unexpected empty bodies\n");
+    }
+}
+
+void runAllMessageBenchmarks(void) {
+    MessageDB *db;
+    MessageArea *area;
+
+    printf("Running Message Base Benchmarks...\n");
+    removeBenchFiles();
+    db = NewMessageDB(BENCH_MESSAGE_DB);
+    area = _AddMessageArea(db, "Bench", "");
+    if (area == NULL) {
+        printf("Could not create benchmark area\n");
+        DestroyMessageDB(db);
+        return;
+    }
+    benchPostMessages(area);
+    SyncMessageArea(area);
+    benchRandomHeaders(area);
+    benchRandomReads(area);
+    benchNewScan(area, 0);
+    benchNewScan(area, (uint32_t)(BENCH_MESSAGE_COUNT / 10 * 9));
+    DestroyMessageDB(db);
+    removeBenchFiles();
+    printf("\n");
+}
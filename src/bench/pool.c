@@ -0,0 +1,162 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/conn.h>
+#include <vbbs/session.h>
+#include <vbbs/metrics.h>
+#include <vbbs/globals.h>
+#include <vbbs/buffer.h>
+#include <vbbs/pool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared.h"
+
+#define BENCH_POOL_LIVE 1000
+#define BENCH_POOL_OPS 200000L
+
+/* What a telnet call allocated one at a time before the pools. */
+static const size_t CALL_ALLOCATIONS[] = {
+    sizeof(Session), sizeof(Connection), sizeof(InputBuffer), sizeof(Buffer),
+    CONNECTION_BUFFER_SIZE + 1, sizeof(Buffer), CONNECTION_BUFFER_SIZE + 1,
+    20
+};
+#define CALL_ALLOCATION_COUNT \
+    (int)(sizeof(CALL_ALLOCATIONS) / sizeof(CALL_ALLOCATIONS[0]))
+
+typedef struct ChurnState {
+    Session *sessions[BENCH_POOL_LIVE];
+    void *blocks[BENCH_POOL_LIVE][8];
+    void *pooled[BENCH_POOL_LIVE][8];
+    Pool pools[8];
+    uint32_t seed;
+} ChurnState;
+
+static Session *newCall(void) {
+    Connection *conn = NewConnection();
+    Session *session;
+
+    if (conn == NULL) {
+        return NULL;
+    }
+    session = NewSession(conn);
+    if (session == NULL) {
+        DestroyConnection(conn);
+    }
+    return session;
+}
+
+/* One caller hangs up and another connects, with the rest still on. */
+static void benchSessionChurn(void *context, long ops) {
+    ChurnState *state = (ChurnState *)context;
+    long i;
+    int n;
+
+    for (i = 0; i < ops; i++) {
+        n = (int)(BenchRandom(&state->seed) % BENCH_POOL_LIVE);
+        DestroySession(state->sessions[n]);
+        state->sessions[n] = newCall();
+    }
+}
+
+/* Only the allocations of a call, from a pool per type. */
+static void benchPoolChurn(void *context, long ops) {
+    ChurnState *state = (ChurnState *)context;
+    long i;
+    int n, j;
+
+    for (i = 0; i < ops; i++) {
+        n = (int)(BenchRandom(&state->seed) % BENCH_POOL_LIVE);
+        for (j = 0; j < CALL_ALLOCATION_COUNT; j++) {
+            PoolFree(&state->pools[j], state->pooled[n][j]);
+        }
+        for (j = 0; j < CALL_ALLOCATION_COUNT; j++) {
+            state->pooled[n][j] = PoolAlloc(&state->pools[j]);
+        }
+    }
+}
+
+/* The same through malloc and free. */
+static void benchMallocChurn(void *context, long ops) {
+    ChurnState *state = (ChurnState *)context;
+    long i;
+    int n, j;
+
+    for (i = 0; i < ops; i++) {
+        n = (int)(BenchRandom(&state->seed) % BENCH_POOL_LIVE);
+        for (j = 0; j < CALL_ALLOCATION_COUNT; j++) {
+            free(state->blocks[n][j]);
+        }
+        for (j = 0; j < CALL_ALLOCATION_COUNT; j++) {
+            state->blocks[n][j] = malloc(CALL_ALLOCATIONS[j]);
+        }
+    }
+}
+
+void runAllPoolBenchmarks(void) {
+    ChurnState *state;
+    int i, j;
+
+    printf("Running Pool Benchmarks...\n");
+    state = (ChurnState *)calloc(1, sizeof(ChurnState));
+    if (state == NULL) {
+        printf("Could not allocate churn state\n");
+        return;
+    }
+    state->seed = 19;
+    for (j = 0; j < CALL_ALLOCATION_COUNT; j++) {
+        state->pools[j].name = "bench";
+        state->pools[j].objectSize = CALL_ALLOCATIONS[j];
+        state->pools[j].objectsPerSlab = 32;
+    }
+    for (i = 0; i < BENCH_POOL_LIVE; i++) {
+        state->sessions[i] = newCall();
+        for (j = 0; j < CALL_ALLOCATION_COUNT; j++) {
+            state->blocks[i][j] = malloc(CALL_ALLOCATIONS[j]);
+            state->pooled[i][j] = PoolAlloc(&state->pools[j]);
+        }
+    }
+
+    runBenchmark("Call allocations, malloc (1000 live)", benchMallocChurn,
+        state, BENCH_POOL_OPS);
+    runBenchmark("Call allocations, pools (1000 live)", benchPoolChurn,
+        state, BENCH_POOL_OPS);
+    runBenchmark("NewSession/DestroySession (1000 live)", benchSessionChurn,
+        state, BENCH_POOL_OPS);
+    printf("%50s: %10ld\n", "Pool slabs", GetGaugeValue(&poolSlabs));
+
+    for (i = 0; i < BENCH_POOL_LIVE; i++) {
+        DestroySession(state->sessions[i]);
+        for (j = 0; j < CALL_ALLOCATION_COUNT; j++) {
+            free(state->blocks[i][j]);
+        }
+    }
+    for (j = 0; j < CALL_ALLOCATION_COUNT; j++) {
+        DestroyPool(&state->pools[j]);
+    }
+    free(state);
+    printf("\n");
+}
@@ -0,0 +1,115 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/msg.h>
+#include <vbbs/qwk.h>
+#include <vbbs/user.h>
+#include <vbbs/db/lastread.h>
+#include <vbbs/db/msg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+#define BENCH_MESSAGE_DB "qwkbench.db"
+#define BENCH_LASTREAD_DB "qwkbench.lr"
+#define BENCH_PACKET "qwkbench.qwk"
+#define BENCH_AREAS 10
+#define BENCH_MESSAGES_PER_AREA 20000L
+
+static void removeBenchFiles(void) {
+    char filename[64];
+    int i;
+
+    remove(BENCH_MESSAGE_DB);
+    remove(BENCH_LASTREAD_DB);
+    remove(BENCH_PACKET);
+    for (i = 1; i <= BENCH_AREAS; i++) {
+        sprintf(filename, MESSAGE_AREA_FILE_FORMAT, "", (unsigned int)i,
+            MESSAGE_INDEX_EXTENSION);
+        remove(filename);
+        sprintf(filename, MESSAGE_AREA_FILE_FORMAT, "", (unsigned int)i,
+            MESSAGE_DATA_EXTENSION);
+        remove(filename);
+    }
+}
+
+void runAllQwkBenchmarks(void) {
+    MessageDB *messages;
+    MessageArea *area;
+    MessageHeader header;
+    LastReadDB *lastRead;
+    QwkPacket *packet;
+    User user;
+    char body[1024];
+    uint32_t seed = 9;
+    long i, total = BENCH_AREAS * BENCH_MESSAGES_PER_AREA;
+    int a, length;
+    double start, elapsed;
+
+    printf("Running QWK Benchmarks...\n");
+    removeBenchFiles();
+    memset(&user, 0, sizeof(user));
+    user.userID = 1;
+    strcpy(user.username, "bench");
+    messages = NewMessageDB(BENCH_MESSAGE_DB);
+    lastRead = OpenLastReadDB(BENCH_LASTREAD_DB);
+    if (messages == NULL || lastRead == NULL) {
+        printf("Could not create benchmark databases\n");
+        return;
+    }
+
+    for (a = 0; a < BENCH_AREAS; a++) {
+        area = _AddMessageArea(messages, "Area", "");
+        for (i = 0; area != NULL && i < BENCH_MESSAGES_PER_AREA; i++) {
+            length = 100 + (int)(BenchRandom(&seed) % 800);
+            memset(body, 'x', length);
+            body[length / 2] = '\n';
+            InitMessageHeader(&header, "Sysop", "All", "QWK benchmark");
+            PostMessage(area, &header, body, length);
+        }
+        SyncMessageArea(area);
+    }
+
+    start = BenchNow();
+    packet = _BuildQwkPacket(messages, lastRead, BENCH_PACKET, &user,
+        (uint32_t)total);
+    elapsed = BenchNow() - start;
+    if (packet == NULL) {
+        printf("Could not build packet\n");
+    } else {
+        printBenchResult("BuildQwkPacket (messages)",
+            (long)packet->messageCount, elapsed);
+        printf("%50s: %10.1f MB/s\n", "Packet write rate",
+            packet->size / elapsed / 1e6);
+        DestroyQwkPacket(packet);
+    }
+
+    CloseLastReadDB(lastRead);
+    DestroyMessageDB(messages);
+    removeBenchFiles();
+    printf("\n");
+}
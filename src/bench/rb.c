@@ -0,0 +1,81 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/rb.h>
+#include <stdio.h>
+
+#include "shared.h"
+
+#define BENCH_RING_SIZE 4096
+#define BENCH_RING_OPS 2000000L
+#define BENCH_RING_BLOCK 64
+
+static void benchPushPop(void *context, long ops) {
+    RingBuffer *rb = (RingBuffer *)context;
+    unsigned long sink = 0;
+    long i;
+
+    for (i = 0; i < ops; i++) {
+        PushRingBuffer(rb, (uint8_t)i);
+        sink += PopRingBuffer(rb);
+    }
+    if (sink == 1) {
+        printf("Unexpected ring buffer contents\n");
+    }
+}
+
+static void benchWriteRead(void *context, long ops) {
+    RingBuffer *rb = (RingBuffer *)context;
+    uint8_t block[BENCH_RING_BLOCK];
+    long i;
+
+    for (i = 0; i < BENCH_RING_BLOCK; i++) {
+        block[i] = (uint8_t)i;
+    }
+    for (i = 0; i < ops; i++) {
+        WriteRingBuffer(rb, block, BENCH_RING_BLOCK);
+        ReadRingBuffer(rb, block, BENCH_RING_BLOCK);
+    }
+}
+
+void runAllRingBufferBenchmarks(void) {
+    RingBuffer *rb;
+
+    printf("Running RingBuffer Benchmarks...\n");
+    rb = NewRingBuffer(BENCH_RING_SIZE);
+    if (rb == NULL) {
+        printf("Could not allocate ring buffer\n");
+        return;
+    }
+
+    runBenchmark("PushRingBuffer + PopRingBuffer", benchPushPop, rb,
+        BENCH_RING_OPS);
+    runBenchmark("WriteRingBuffer + ReadRingBuffer (64 bytes)",
+        benchWriteRead, rb, BENCH_RING_OPS / 10);
+
+    DestroyRingBuffer(rb);
+    printf("\n");
+}
@@ -0,0 +1,134 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/db/search.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared.h"
+
+#define BENCH_DOCUMENTS 1000000L
+#define BENCH_VOCABULARY 20000
+#define BENCH_WORDS_PER_DOCUMENT 24
+#define BENCH_COMMON_WORDS 16
+#define BENCH_QUERY_RUNS 200
+
+/* Every PHRASE_INTERVAL'th message quotes the phrase used by the queries. */
+#define BENCH_PHRASE_INTERVAL 100
+
+static void makeWord(char *out, uint32_t n) {
+    int i = 0;
+    do {
+        out[i++] = 'a' + (char)(n % 26);
+        n /= 26;
+    } while (n > 0);
+    out[i] = '\0';
+}
+
+/*
+ * Skewed towards the front of the vocabulary, like real text: a quarter of
+ * words come from a handful of very common ones.
+ */
+static uint32_t pickWord(uint32_t *seed) {
+    uint32_t a = BenchRandom(seed) % BENCH_VOCABULARY, b;
+    if (a < BENCH_VOCABULARY / 4) {
+        return a % BENCH_COMMON_WORDS;
+    }
+    a = BenchRandom(seed) % BENCH_VOCABULARY;
+    b = BenchRandom(seed) % BENCH_VOCABULARY;
+    return (uint32_t)((unsigned long)a * b / BENCH_VOCABULARY);
+}
+
+static void benchQuery(SearchIndex *index, const char *name,
+    const char *query, SearchHit *hits, int size) {
+    double start, elapsed;
+    char label[80];
+    int i, count = 0;
+
+    start = BenchNow();
+    for (i = 0; i < BENCH_QUERY_RUNS; i++) {
+        count = _SearchMessages(index, query, hits, size);
+    }
+    elapsed = BenchNow() - start;
+    sprintf(label, "%s (%d hits)", name, count);
+    printBenchResult(label, BENCH_QUERY_RUNS, elapsed);
+    printf("%50s: %10.3f ms\n", "Time per query",
+        elapsed * 1000.0 / BENCH_QUERY_RUNS);
+}
+
+void runAllSearchBenchmarks(void) {
+    SearchIndex *index;
+    SearchHit *hits;
+    char text[BENCH_WORDS_PER_DOCUMENT * 8 + 32];
+    char word[8];
+    char common[8], rare[8], query[64];
+    uint32_t seed = 5;
+    long doc;
+    int i, length;
+    double start;
+
+    printf("Running Search Benchmarks...\n");
+    index = NewSearchIndex(NULL);
+    hits = (SearchHit *)malloc(BENCH_DOCUMENTS * sizeof(SearchHit));
+    if (index == NULL || hits == NULL) {
+        printf("Could not allocate search index\n");
+        return;
+    }
+
+    start = BenchNow();
+    for (doc = 1; doc <= BENCH_DOCUMENTS; doc++) {
+        length = 0;
+        for (i = 0; i < BENCH_WORDS_PER_DOCUMENT; i++) {
+            makeWord(word, pickWord(&seed));
+            length += sprintf(text + length, "%s ", word);
+        }
+        if (doc % BENCH_PHRASE_INTERVAL == 0) {
+            length += sprintf(text + length, "vintage bulletin board");
+        }
+        IndexDocument(index, 1, (uint32_t)doc, text, length);
+    }
+    printBenchResult("IndexDocument", BENCH_DOCUMENTS, BenchNow() - start);
+
+    makeWord(common, 0);
+    makeWord(rare, BENCH_VOCABULARY - 50);
+    benchQuery(index, "Rare term, first 20", rare, hits, 20);
+    benchQuery(index, "Rare term, all", rare, hits, BENCH_DOCUMENTS);
+    benchQuery(index, "Common term, first 20", common, hits, 20);
+    sprintf(query, "%s %s", common, rare);
+    benchQuery(index, "Common AND rare", query, hits, BENCH_DOCUMENTS);
+    makeWord(rare, 10);
+    sprintf(query, "%s %s", common, rare);
+    benchQuery(index, "Common AND common", query, hits, BENCH_DOCUMENTS);
+    benchQuery(index, "Phrase", "\"vintage bulletin board\"", hits,
+        BENCH_DOCUMENTS);
+    sprintf(query, "%s \"bulletin board\"", common);
+    benchQuery(index, "Common AND phrase", query, hits, BENCH_DOCUMENTS);
+
+    free(hits);
+    DestroySearchIndex(index);
+    printf("\n");
+}
@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/sha1.h>
+#include <stdio.h>
+
+#include "shared.h"
+
+#define BENCH_SHA1_BLOCK 4096
+#define BENCH_SHA1_SHORT 64
+#define BENCH_SHA1_OPS 20000L
+
+static unsigned char block[BENCH_SHA1_BLOCK];
+
+/* A short input, one block with its padding. */
+static void benchShort(void *context, long ops) {
+    unsigned char digest[20];
+    SHA1_CTX ctx;
+    long i;
+    (void)context;
+    for (i = 0; i < ops; i++) {
+        SHA1Init(&ctx);
+        SHA1Update(&ctx, block, BENCH_SHA1_SHORT);
+        SHA1Final(digest, &ctx);
+    }
+}
+
+static void benchUpdate(void *context, long ops) {
+    unsigned char digest[20];
+    SHA1_CTX ctx;
+    long i;
+    (void)context;
+    for (i = 0; i < ops; i++) {
+        SHA1Init(&ctx);
+        SHA1Update(&ctx, block, BENCH_SHA1_BLOCK);
+        SHA1Final(digest, &ctx);
+    }
+}
+
+void runAllSHA1Benchmarks(void) {
+    static const SHA1Implementation implementations[] = {
+        SHA1_PORTABLE, SHA1_SSSE3, SHA1_SHA_NI
+    };
+    SHA1Implementation selected = SHA1SelectImplementation();
+    uint32_t seed = 13;
+    char name[80];
+    double seconds;
+    int i;
+
+    printf("Running SHA1 Benchmarks (%s)...\n",
+        SHA1ImplementationName(selected));
+    for (i = 0; i < BENCH_SHA1_BLOCK; i++) {
+        block[i] = (unsigned char)BenchRandom(&seed);
+    }
+
+    runBenchmark("SHA1 (64 bytes)", benchShort, NULL, BENCH_SHA1_OPS);
+    runBenchmark("SHA1Update (4 KB)", benchUpdate, NULL,
+        BENCH_SHA1_OPS / 10);
+
+    /* Each implementation this CPU supports, for comparison. */
+    for (i = 0; i < 3; i++) {
+        if (!SHA1UseImplementation(implementations[i])) {
+            continue;
+        }
+        sprintf(name, "SHA1Update (4 KB, %s)",
+            SHA1ImplementationName(implementations[i]));
+        seconds = runBenchmark(name, benchUpdate, NULL, BENCH_SHA1_OPS / 10);
+        printf("%50s: %10.1f MB/s\n", "Throughput",
+            BENCH_SHA1_BLOCK * (BENCH_SHA1_OPS / 10) / seconds / 1e6);
+    }
+    SHA1UseImplementation(selected);
+    printf("\n");
+}
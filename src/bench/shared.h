@@ -0,0 +1,73 @@
+#ifndef _BENCH_SHARED_H
+#define _BENCH_SHARED_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+/** Seconds from an arbitrary fixed point, for timing benchmarks. */
+double BenchNow(void);
+
+/** The time stamp counter where there is one, else 0. */
+double BenchCycles(void);
+
+/** Print one benchmark result as operations per second. */
+void printBenchResult(const char *name, long ops, double seconds);
+
+/** A microbenchmark body, which performs the operation ops times. */
+typedef void (*BenchFunction)(void *context, long ops);
+
+/**
+ * Run a microbenchmark after the warmup runs, as many times as asked on
+ * the command line, and report the median time and cycles per operation.
+ * Returns the median time in seconds.
+ */
+double runBenchmark(const char *name, BenchFunction function, void *context,
+    long ops);
+
+/** Small, fast pseudo-random numbers so runs are repeatable. */
+uint32_t BenchRandom(uint32_t *state);
+
+void runAllBufferBenchmarks(void);
+void runAllListBenchmarks(void);
+void runAllMapBenchmarks(void);
+void runAllRingBufferBenchmarks(void);
+void runAllCRCBenchmarks(void);
+void runAllSHA1Benchmarks(void);
+void runAllPBKDF2Benchmarks(void);
+void runAllMessageBenchmarks(void);
+void runAllNewScanBenchmarks(void);
+void runAllSearchBenchmarks(void);
+void runAllQwkBenchmarks(void);
+void runAllLogBenchmarks(void);
+void runAllLoginBenchmarks(void);
+void runAllMetricsBenchmarks(void);
+void runAllThrottleBenchmarks(void);
+void runAllPoolBenchmarks(void);
+void runAllArenaBenchmarks(void);
+void runAllMemoryBenchmarks(void);
+
+#endif
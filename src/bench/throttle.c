@@ -0,0 +1,63 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/throttle.h>
+#include <stdio.h>
+
+#include "shared.h"
+
+#define BENCH_THROTTLE_OPS 1000000L
+
+/* Addresses spread over far more than the table holds. */
+static void benchFailures(void *context, long ops) {
+    uint32_t *seed = (uint32_t *)context;
+    long i;
+    for (i = 0; i < ops; i++) {
+        _RecordLoginFailure(0x0A000000UL | BenchRandom(seed), 1000 + i / 1000);
+    }
+}
+
+static void benchLookups(void *context, long ops) {
+    uint32_t *seed = (uint32_t *)context;
+    long i;
+    for (i = 0; i < ops; i++) {
+        _GetThrottleDelay(0x0A000000UL | BenchRandom(seed), 1000);
+    }
+}
+
+void runAllThrottleBenchmarks(void) {
+    uint32_t seed = 17;
+
+    printf("Running Throttle Benchmarks...\n");
+    InitThrottle();
+    runBenchmark("RecordLoginFailure (16M addresses)", benchFailures, &seed,
+        BENCH_THROTTLE_OPS);
+    printf("%50s: %10d\n", "Addresses held", GetThrottleCount());
+    runBenchmark("GetThrottleDelay (16M addresses)", benchLookups, &seed,
+        BENCH_THROTTLE_OPS);
+    InitThrottle();
+    printf("\n");
+}
@@ -0,0 +1,298 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs.h>
+
+#include <string.h>
+#include <time.h>
+
+#include "../bench/shared.h"
+
+#define BENCH_MAX_REPETITIONS 99
+#define BENCH_LINE_SIZE 512
+
+typedef struct BenchGroup {
+    const char *name;
+    void (*run)(void);
+} BenchGroup;
+
+static const BenchGroup GROUPS[] = {
+    { "buffer", runAllBufferBenchmarks },
+    { "list", runAllListBenchmarks },
+    { "map", runAllMapBenchmarks },
+    { "rb", runAllRingBufferBenchmarks },
+    { "crc", runAllCRCBenchmarks },
+    { "sha1", runAllSHA1Benchmarks },
+    { "pbkdf2", runAllPBKDF2Benchmarks },
+    { "msg", runAllMessageBenchmarks },
+    { "newscan", runAllNewScanBenchmarks },
+    { "search", runAllSearchBenchmarks },
+    { "qwk", runAllQwkBenchmarks },
+    { "log", runAllLogBenchmarks },
+    { "login", runAllLoginBenchmarks },
+    { "metrics", runAllMetricsBenchmarks },
+    { "throttle", runAllThrottleBenchmarks },
+    { "pool", runAllPoolBenchmarks },
+    { "arena", runAllArenaBenchmarks },
+    { "memory", runAllMemoryBenchmarks },
+    { NULL, NULL }
+};
+
+static int repetitions = 5;
+static int warmups = 1;
+static const char *currentGroup = "";
+static FILE *resultsFile = NULL;
+static Map *baseline = NULL;
+static double regressionPercent = 10.0;
+static int regressions = 0;
+
+double BenchNow(void) {
+#ifdef _POSIX_VERSION
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+double BenchCycles(void) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    unsigned int lo, hi;
+    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+    return (double)hi * 4294967296.0 + (double)lo;
+#else
+    return 0.0;
+#endif
+}
+
+static void baselineKey(char *key, const char *group, const char *name) {
+    sprintf(key, "%.31s/%.200s", group, name);
+}
+
+/*
+ * Print one result, add it to the results file and compare it with the
+ * baseline. cycles is 0 when there is no cycle counter.
+ */
+static void reportBenchResult(const char *name, long ops, double seconds,
+    double cycles, int runs) {
+    char key[240];
+    double nanos, cyclesPerOp, *base, change;
+
+    if (seconds <= 0.0) {
+        seconds = 1e-9;
+    }
+    nanos = seconds * 1e9 / ops;
+    cyclesPerOp = cycles / ops;
+    printf("%50s: %10ld ops %9.3f s %14.0f ops/s %10.1f ns/op", name, ops,
+        seconds, (double)ops / seconds, nanos);
+    if (cycles > 0.0) {
+        printf(" %10.1f cycles/op", cyclesPerOp);
+    }
+
+    baselineKey(key, currentGroup, name);
+    base = baseline != NULL ? (double *)MapGet(baseline, key) : NULL;
+    if (base != NULL && *base > 0.0) {
+        change = (nanos - *base) * 100.0 / *base;
+        printf(" %+6.1f%%", change);
+        if (change > regressionPercent) {
+            printf(" REGRESSION");
+            regressions++;
+        }
+    }
+    printf("\n");
+    fflush(stdout);
+
+    if (resultsFile != NULL) {
+        fprintf(resultsFile, "%s,\"%s\",%ld,%.9f,%.3f,%.3f,%d\n",
+            currentGroup, name, ops, seconds, nanos, cyclesPerOp, runs);
+    }
+}
+
+void printBenchResult(const char *name, long ops, double seconds) {
+    reportBenchResult(name, ops, seconds, 0.0, 1);
+}
+
+static int compareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+double runBenchmark(const char *name, BenchFunction function, void *context,
+    long ops) {
+    double seconds[BENCH_MAX_REPETITIONS], cycles[BENCH_MAX_REPETITIONS];
+    double start, startCycles;
+    int i;
+
+    for (i = 0; i < warmups; i++) {
+        function(context, ops);
+    }
+    for (i = 0; i < repetitions; i++) {
+        startCycles = BenchCycles();
+        start = BenchNow();
+        function(context, ops);
+        seconds[i] = BenchNow() - start;
+        cycles[i] = BenchCycles() - startCycles;
+    }
+    /* The median is steadier than the mean when the machine is busy. */
+    qsort(seconds, repetitions, sizeof(double), compareDoubles);
+    qsort(cycles, repetitions, sizeof(double), compareDoubles);
+    reportBenchResult(name, ops, seconds[repetitions / 2],
+        cycles[repetitions / 2], repetitions);
+    return seconds[repetitions / 2];
+}
+
+uint32_t BenchRandom(uint32_t *state) {
+    *state = (uint32_t)(*state * 1664525UL + 1013904223UL);
+    return *state >> 8;
+}
+
+/* Reads the ns/op column of a results file, keyed by group and name. */
+static bool loadBaseline(const char *path) {
+    FILE *file;
+    char line[BENCH_LINE_SIZE], key[240], *group, *name, *end;
+    double *nanos;
+    long ops;
+    double seconds;
+
+    file = fopen(path, "r");
+    if (file == NULL) {
+        return FALSE;
+    }
+    baseline = NewMap(free);
+    while (baseline != NULL && fgets(line, sizeof(line), file) != NULL) {
+        group = line;
+        name = strstr(line, ",\"");
+        end = name != NULL ? strstr(name + 2, "\",") : NULL;
+        if (end == NULL) {
+            continue;       /* The header, or not one of ours */
+        }
+        *name = '\0';
+        name += 2;
+        *end = '\0';
+        nanos = (double *)malloc(sizeof(double));
+        if (nanos == NULL ||
+            sscanf(end + 2, "%ld,%lf,%lf", &ops, &seconds, nanos) != 3) {
+            free(nanos);
+            continue;
+        }
+        baselineKey(key, group, name);
+        MapPut(baseline, key, nanos);
+    }
+    fclose(file);
+    return baseline != NULL;
+}
+
+static void usage(void) {
+    fprintf(stderr,
+        "Usage: bench [options] [group...]\n"
+        "  -r count    Timed repetitions of each microbenchmark (5)\n"
+        "  -w count    Untimed warmup runs first (1)\n"
+        "  -o file     Write results as CSV\n"
+        "  -b file     Compare with results written earlier with -o\n"
+        "  -t percent  Slowdown that counts as a regression (10)\n"
+        "Runs every group when none are named. Exits with 2 if anything\n"
+        "regressed.\n");
+}
+
+int main(int argc, char *argv[])
+{
+    int i, g, first, ran = 0;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i += 2) {
+        if (argv[i][1] == '\0' || argv[i][2] != '\0' || i + 1 >= argc) {
+            usage();
+            return 1;
+        }
+        switch (argv[i][1]) {
+            case 'r':
+                repetitions = atoi(argv[i + 1]);
+                break;
+            case 'w':
+                warmups = atoi(argv[i + 1]);
+                break;
+            case 'o':
+                resultsFile = fopen(argv[i + 1], "w");
+                if (resultsFile == NULL) {
+                    fprintf(stderr, "Could not write %s\n", argv[i + 1]);
+                    return 1;
+                }
+                fprintf(resultsFile, "group,name,ops,seconds,ns_per_op,"
+                    "cycles_per_op,repetitions\n");
+                break;
+            case 'b':
+                if (!loadBaseline(argv[i + 1])) {
+                    fprintf(stderr, "Could not read %s\n", argv[i + 1]);
+                    return 1;
+                }
+                break;
+            case 't':
+                regressionPercent = atof(argv[i + 1]);
+                break;
+            default:
+                usage();
+                return 1;
+        }
+    }
+    if (repetitions < 1 || repetitions > BENCH_MAX_REPETITIONS ||
+        warmups < 0) {
+        usage();
+        return 1;
+    }
+    first = i;
+
+    SetLogLevel(LOG_ERROR);
+    SHA1SelectImplementation();
+    for (g = 0; GROUPS[g].name != NULL; g++) {
+        bool selected = first >= argc;
+        for (i = first; i < argc; i++) {
+            if (strcmp(argv[i], GROUPS[g].name) == 0) {
+                selected = TRUE;
+            }
+        }
+        if (selected) {
+            currentGroup = GROUPS[g].name;
+            GROUPS[g].run();
+            ran++;
+        }
+    }
+
+    if (resultsFile != NULL) {
+        fclose(resultsFile);
+    }
+    if (baseline != NULL) {
+        DestroyMap(baseline);
+    }
+    if (ran == 0) {
+        fprintf(stderr, "No benchmark groups matched\n");
+        return 1;
+    }
+    if (regressions > 0) {
+        printf("%d benchmarks regressed by more than %.0f%%\n", regressions,
+            regressionPercent);
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/metrics.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../fuzz/shared.h"
+
+/*
+ * A main() for the harnesses in src/fuzz, for builds without libFuzzer.
+ * It runs each file named on the command line, or stdin, through the
+ * harness once and prints how long it took. AFL runs it with @@ or stdin,
+ * and it replays crashes and slow inputs found by either fuzzer.
+ */
+
+#define FUZZ_MAX_INPUT (1024L * 1024L)
+
+static uint8_t *readInput(FILE *in, size_t *size) {
+    uint8_t *data = (uint8_t *)malloc(FUZZ_MAX_INPUT);
+
+    if (data == NULL) {
+        return NULL;
+    }
+    *size = fread(data, 1, FUZZ_MAX_INPUT, in);
+    return data;
+}
+
+static int runInput(const char *name, FILE *in) {
+    uint8_t *data;
+    size_t size;
+    unsigned long start, elapsed;
+
+    data = readInput(in, &size);
+    if (data == NULL) {
+        fprintf(stderr, "%s: out of memory\n", name);
+        return 1;
+    }
+    start = MonotonicNanos();
+    LLVMFuzzerTestOneInput(data, size);
+    elapsed = MonotonicNanos() - start;
+    printf("%s: %lu bytes in %lu.%03lu ms\n", name, (unsigned long)size,
+        elapsed / 1000000, elapsed / 1000 % 1000);
+    free(data);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    FILE *in;
+    int i, status = 0;
+
+    if (argc > 1 && strcmp(argv[1], "-h") == 0) {
+        printf("Usage: %s [file...]\n", argv[0]);
+        printf("Runs each file, or stdin, through the fuzz harness.\n");
+        return 0;
+    }
+    if (argc == 1) {
+        return runInput("stdin", stdin);
+    }
+    for (i = 1; i < argc; i++) {
+        in = fopen(argv[i], "rb");
+        if (in == NULL) {
+            perror(argv[i]);
+            status = 1;
+            continue;
+        }
+        status |= runInput(argv[i], in);
+        fclose(in);
+    }
+    return status;
+}
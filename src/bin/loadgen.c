@@ -0,0 +1,1096 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Simulates many telnet callers against a running server from a single
+ * epoll thread. Each caller answers the terminal negotiation, logs in
+ * (registering the first time), uses the main menu with think time between
+ * actions, logs out and calls again until the run is over.
+ */
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+#define LOADGEN_TEXT_SIZE 4096
+#define LOADGEN_SEND_SIZE 512
+#define LOADGEN_SUBNEGOTIATION_SIZE 64
+#define LOADGEN_EVENTS 256
+#define LOADGEN_TICK_MS 10
+#define LOADGEN_REPORT_SECONDS 5
+#define LOADGEN_PASSWORD "loadgen1"
+#define LOADGEN_TERMINAL_TYPE "ANSI"
+#define LOADGEN_TERMINAL_SPEED "38400,38400"
+#define LOADGEN_DA_RESPONSE "\033[?1;2c"
+
+#define NANOS_PER_MS 1000000UL
+
+/** Prompts the callers wait for, as written by session.c. */
+#define PROMPT_USERNAME "to sign up) => "
+#define PROMPT_PASSWORD "Password => "
+#define PROMPT_AUTH_FAILED "Authentication failed."
+#define PROMPT_NEW_USERNAME "Enter your username: "
+#define PROMPT_NEW_PASSWORD "Enter a password: "
+#define PROMPT_NEW_CONFIRM "Confirm your password: "
+#define PROMPT_NEW_EMAIL "Enter your email address: "
+#define PROMPT_MENU "Choose an option: "
+#define PROMPT_SEARCH "a phrase\" => "
+#define PROMPT_ANY_KEY "Press any key to continue..."
+#define PROMPT_GOODBYE "Goodbye!"
+
+typedef enum
+{
+    CALLER_IDLE,           /* Hung up, waiting to call again */
+    CALLER_CONNECTING,
+    CALLER_NEGOTIATING,    /* Answering the terminal identification */
+    CALLER_USERNAME,
+    CALLER_PASSWORD,
+    CALLER_LOGGING_IN,     /* Waiting for the menu, or a failed login */
+    CALLER_NEW_USERNAME,
+    CALLER_NEW_PASSWORD,
+    CALLER_NEW_CONFIRM,
+    CALLER_NEW_EMAIL,
+    CALLER_MENU,           /* Thinking at the main menu */
+    CALLER_SEARCH_PROMPT,
+    CALLER_TYPING,         /* Waiting for a keystroke to be echoed */
+    CALLER_RESULTS,        /* Waiting for "Press any key" */
+    CALLER_ANY_KEY,        /* Thinking before pressing a key */
+    CALLER_LOGGING_OUT
+} CallerState;
+
+typedef enum
+{
+    TELNET_DATA,
+    TELNET_COMMAND,        /* After IAC */
+    TELNET_OPTION,         /* After IAC WILL/WONT/DO/DONT */
+    TELNET_SUBNEGOTIATION,
+    TELNET_SUBNEGOTIATION_IAC
+} TelnetState;
+
+typedef struct Caller
+{
+    int socket;
+    CallerState state;
+    unsigned long waitStart;   /* When the current wait began */
+    unsigned long sentAt;      /* When the timed request was sent */
+    unsigned long wakeAt;      /* When thinking ends, 0 if waiting */
+    TelnetState telnetState;
+    int telnetCommand;
+    uint8_t subnegotiation[LOADGEN_SUBNEGOTIATION_SIZE];
+    int subnegotiationLength;
+    char text[LOADGEN_TEXT_SIZE + 1]; /* Output, telnet commands removed */
+    int textLength;
+    char pending[LOADGEN_SEND_SIZE];  /* Input the server hasn't taken */
+    int pendingLength;
+    bool registering;
+    int actionsLeft;
+    const char *query;
+    int typed;
+    char username[21];
+} Caller;
+
+typedef struct LoadGenOptions
+{
+    struct sockaddr_in address;
+    int callers;
+    int seconds;
+    int connectRate;           /* New calls per second */
+    int thinkMs;
+    int keystrokeMs;
+    int actions;               /* Menu actions per call */
+    int listPercent;           /* Share of actions that list the users */
+    unsigned long timeoutMs;
+    const char *prefix;
+} LoadGenOptions;
+
+typedef struct LoadGenTotals
+{
+    unsigned long calls;
+    unsigned long connectFailures;
+    unsigned long logins;
+    unsigned long registrations;
+    unsigned long actions;
+    unsigned long keystrokes;
+    unsigned long timeouts;
+    unsigned long disconnects;  /* Hung up on unexpectedly */
+    unsigned long bytesSent;
+    unsigned long bytesReceived;
+} LoadGenTotals;
+
+static const char *SEARCH_QUERIES[] = {
+    "modem", "vintage board", "qwk packet", "hello world", "\"dial up\""
+};
+#define SEARCH_QUERY_COUNT \
+    (int)(sizeof(SEARCH_QUERIES) / sizeof(SEARCH_QUERIES[0]))
+
+static LoadGenOptions options;
+static LoadGenTotals totals;
+static Histogram connectLatency;
+static Histogram loginLatency;
+static Histogram echoLatency;
+static Histogram actionLatency;
+static int epollFd = -1;
+static uint32_t randomSeed = 12345;
+static volatile sig_atomic_t stopping = 0;
+
+static void Usage(void)
+{
+    fprintf(stderr,
+        "Usage: vbbs-loadgen [options]\n"
+        "  -h host     IPv4 address of the server (127.0.0.1)\n"
+        "  -p port     Telnet port (%d)\n"
+        "  -n callers  Concurrent callers (100)\n"
+        "  -d seconds  Length of the run (30)\n"
+        "  -r rate     New calls per second (50)\n"
+        "  -t ms       Mean think time between menu actions (1000)\n"
+        "  -k ms       Time between keystrokes when typing (100)\n",
+        TELNET_PORT);
+    fprintf(stderr,
+        "  -a count    Menu actions per call before logging out (5)\n"
+        "  -l percent  Share of menu actions that list users, the rest\n"
+        "              search (20)\n"
+        "  -w ms       Give up on a response after this long (10000)\n"
+        "  -u prefix   Usernames are prefix followed by a number (load)\n");
+}
+
+static void StopSignal(int signum)
+{
+    (void)signum;
+    stopping = 1;
+}
+
+static uint32_t Random(void)
+{
+    randomSeed = randomSeed * 1103515245UL + 12345UL;
+    return (randomSeed >> 16) & 0x7FFF;
+}
+
+/** Uniform between half and one and a half times the mean. */
+static unsigned long ThinkTime(int meanMs)
+{
+    unsigned long ms = (unsigned long)meanMs / 2;
+    if (meanMs > 0)
+    {
+        ms += Random() % (unsigned long)meanMs;
+    }
+    return ms * NANOS_PER_MS;
+}
+
+static void Wait(Caller *caller, CallerState state)
+{
+    caller->state = state;
+    caller->waitStart = MonotonicNanos();
+    caller->wakeAt = 0;
+}
+
+static void Think(Caller *caller, CallerState state, unsigned long nanos)
+{
+    caller->state = state;
+    caller->wakeAt = MonotonicNanos() + nanos;
+    if (caller->wakeAt == 0)
+    {
+        caller->wakeAt = 1;
+    }
+}
+
+static void WatchCaller(Caller *caller, bool writable)
+{
+    struct epoll_event event;
+
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | (writable ? EPOLLOUT : 0);
+    event.data.ptr = caller;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, caller->socket, &event);
+}
+
+static void HangUp(Caller *caller)
+{
+    if (caller->socket >= 0)
+    {
+        close(caller->socket);
+        caller->socket = -1;
+    }
+    caller->textLength = 0;
+    caller->text[0] = '\0';
+    caller->pendingLength = 0;
+    Think(caller, CALLER_IDLE, ThinkTime(options.thinkMs));
+}
+
+static void FlushCaller(Caller *caller)
+{
+    ssize_t sent;
+
+    if (caller->pendingLength == 0)
+    {
+        return;
+    }
+    sent = send(caller->socket, caller->pending, caller->pendingLength,
+        MSG_NOSIGNAL);
+    if (sent < 0)
+    {
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            totals.disconnects++;
+            HangUp(caller);
+        }
+        return;
+    }
+    totals.bytesSent += (unsigned long)sent;
+    caller->pendingLength -= (int)sent;
+    memmove(caller->pending, caller->pending + sent, caller->pendingLength);
+    WatchCaller(caller, caller->pendingLength > 0);
+}
+
+static void SendBytes(Caller *caller, const char *data, int length)
+{
+    bool idle = caller->pendingLength == 0;
+
+    if (caller->socket < 0 ||
+        caller->pendingLength + length > LOADGEN_SEND_SIZE)
+    {
+        return;
+    }
+    memcpy(caller->pending + caller->pendingLength, data, length);
+    caller->pendingLength += length;
+    if (idle)
+    {
+        FlushCaller(caller);
+    }
+}
+
+static void SendText(Caller *caller, const char *text)
+{
+    SendBytes(caller, text, (int)strlen(text));
+}
+
+static void SendLine(Caller *caller, const char *text)
+{
+    SendText(caller, text);
+    SendText(caller, "\r\n");
+}
+
+static void SendTelnet(Caller *caller, int command, int option)
+{
+    char data[3];
+
+    data[0] = (char)TELNET_IAC;
+    data[1] = (char)command;
+    data[2] = (char)option;
+    SendBytes(caller, data, 3);
+}
+
+static void SendSubnegotiation(Caller *caller, int option,
+    const char *value, int length)
+{
+    char data[LOADGEN_SUBNEGOTIATION_SIZE + 6];
+    int n = 0;
+
+    data[n++] = (char)TELNET_IAC;
+    data[n++] = (char)TELNET_SB;
+    data[n++] = (char)option;
+    memcpy(data + n, value, length);
+    n += length;
+    data[n++] = (char)TELNET_IAC;
+    data[n++] = (char)TELNET_SE;
+    SendBytes(caller, data, n);
+}
+
+static void SendWindowSize(Caller *caller)
+{
+    /* 80x24, high bytes first */
+    static const char size[4] = { 0, 80, 0, 24 };
+    SendSubnegotiation(caller, TELNET_OPTION_WINDOW_SIZE, size, 4);
+}
+
+static void SendOptionValue(Caller *caller, int option, const char *value)
+{
+    char data[LOADGEN_SUBNEGOTIATION_SIZE];
+
+    data[0] = TELNET_SE_IS;
+    strcpy(data + 1, value);
+    SendSubnegotiation(caller, option, data, (int)strlen(value) + 1);
+}
+
+/** Answer the options Identify() asks for, refuse everything else. */
+static void AnswerTelnet(Caller *caller, int command, int option)
+{
+    switch (command)
+    {
+        case TELNET_DO:
+            if (option == TELNET_OPTION_TERMINAL_TYPE ||
+                option == TELNET_OPTION_WINDOW_SIZE ||
+                option == TELNET_OPTION_TERMINAL_SPEED ||
+                option == TELNET_OPTION_SUPPRESS_GO_AHEAD)
+            {
+                SendTelnet(caller, TELNET_WILL, option);
+                if (option == TELNET_OPTION_WINDOW_SIZE)
+                {
+                    SendWindowSize(caller);
+                }
+            }
+            else
+            {
+                SendTelnet(caller, TELNET_WONT, option);
+            }
+            break;
+        case TELNET_DONT:
+            SendTelnet(caller, TELNET_WONT, option);
+            break;
+        case TELNET_WILL:
+            SendTelnet(caller, option == TELNET_OPTION_ECHO ||
+                option == TELNET_OPTION_SUPPRESS_GO_AHEAD ?
+                TELNET_DO : TELNET_DONT, option);
+            break;
+    }
+}
+
+static void AnswerSubnegotiation(Caller *caller)
+{
+    if (caller->subnegotiationLength < 2 ||
+        caller->subnegotiation[1] != TELNET_SE_SEND)
+    {
+        return;
+    }
+    switch (caller->subnegotiation[0])
+    {
+        case TELNET_OPTION_TERMINAL_TYPE:
+            SendOptionValue(caller, TELNET_OPTION_TERMINAL_TYPE,
+                LOADGEN_TERMINAL_TYPE);
+            break;
+        case TELNET_OPTION_TERMINAL_SPEED:
+            SendOptionValue(caller, TELNET_OPTION_TERMINAL_SPEED,
+                LOADGEN_TERMINAL_SPEED);
+            break;
+        case TELNET_OPTION_WINDOW_SIZE:
+            SendWindowSize(caller);
+            break;
+    }
+}
+
+static void AppendText(Caller *caller, char c)
+{
+    if (c == '\0')
+    {
+        return;
+    }
+    if (caller->textLength >= LOADGEN_TEXT_SIZE)
+    {
+        /* Prompts are short, only the most recent output matters. */
+        memmove(caller->text, caller->text + LOADGEN_TEXT_SIZE / 2,
+            LOADGEN_TEXT_SIZE / 2);
+        caller->textLength = LOADGEN_TEXT_SIZE / 2;
+    }
+    caller->text[caller->textLength++] = c;
+    caller->text[caller->textLength] = '\0';
+}
+
+/** Strip and answer telnet commands, keeping the text. */
+static void ReceiveBytes(Caller *caller, const uint8_t *data, int length)
+{
+    int i;
+    uint8_t c;
+
+    for (i = 0; i < length; i++)
+    {
+        c = data[i];
+        switch (caller->telnetState)
+        {
+            case TELNET_DATA:
+                if (c == TELNET_IAC)
+                {
+                    caller->telnetState = TELNET_COMMAND;
+                }
+                else
+                {
+                    AppendText(caller, (char)c);
+                }
+                break;
+            case TELNET_COMMAND:
+                if (c >= TELNET_WILL && c <= TELNET_DONT)
+                {
+                    caller->telnetCommand = c;
+                    caller->telnetState = TELNET_OPTION;
+                }
+                else if (c == TELNET_SB)
+                {
+                    caller->subnegotiationLength = 0;
+                    caller->telnetState = TELNET_SUBNEGOTIATION;
+                }
+                else
+                {
+                    if (c == TELNET_IAC)
+                    {
+                        AppendText(caller, (char)c);
+                    }
+                    caller->telnetState = TELNET_DATA;
+                }
+                break;
+            case TELNET_OPTION:
+                AnswerTelnet(caller, caller->telnetCommand, c);
+                caller->telnetState = TELNET_DATA;
+                break;
+            case TELNET_SUBNEGOTIATION:
+                if (c == TELNET_IAC)
+                {
+                    caller->telnetState = TELNET_SUBNEGOTIATION_IAC;
+                }
+                else if (caller->subnegotiationLength <
+                    LOADGEN_SUBNEGOTIATION_SIZE)
+                {
+                    caller->subnegotiation[
+                        caller->subnegotiationLength++] = c;
+                }
+                break;
+            case TELNET_SUBNEGOTIATION_IAC:
+                if (c == TELNET_SE)
+                {
+                    AnswerSubnegotiation(caller);
+                    caller->telnetState = TELNET_DATA;
+                }
+                else
+                {
+                    caller->telnetState = TELNET_SUBNEGOTIATION;
+                }
+                break;
+        }
+    }
+}
+
+/** Consume the output up to and including text, if it has arrived. */
+static bool Expect(Caller *caller, const char *text)
+{
+    char *found = strstr(caller->text, text);
+    int end;
+
+    if (found == NULL)
+    {
+        return FALSE;
+    }
+    end = (int)(found - caller->text) + (int)strlen(text);
+    caller->textLength -= end;
+    memmove(caller->text, caller->text + end, caller->textLength + 1);
+    return TRUE;
+}
+
+static void RecordSince(Histogram *histogram, unsigned long start)
+{
+    RecordHistogram(histogram, MonotonicNanos() - start);
+}
+
+static void StartTimed(Caller *caller, CallerState state)
+{
+    Wait(caller, state);
+    caller->sentAt = caller->waitStart;
+}
+
+static void ChooseAction(Caller *caller)
+{
+    char key[2];
+
+    if (caller->actionsLeft-- <= 0)
+    {
+        SendText(caller, "2");
+        Wait(caller, CALLER_LOGGING_OUT);
+        return;
+    }
+    totals.actions++;
+    if ((int)(Random() % 100) >= options.listPercent)
+    {
+        caller->query = SEARCH_QUERIES[Random() % SEARCH_QUERY_COUNT];
+        caller->typed = 0;
+        key[0] = '3';
+        StartTimed(caller, CALLER_SEARCH_PROMPT);
+    }
+    else
+    {
+        key[0] = '1';
+        StartTimed(caller, CALLER_RESULTS);
+    }
+    key[1] = '\0';
+    SendText(caller, key);
+}
+
+static void TypeKey(Caller *caller)
+{
+    char key[2];
+
+    key[0] = caller->query[caller->typed];
+    key[1] = '\0';
+    if (key[0] == '\0')
+    {
+        SendText(caller, "\r\n");
+        StartTimed(caller, CALLER_RESULTS);
+        return;
+    }
+    SendText(caller, key);
+    StartTimed(caller, CALLER_TYPING);
+}
+
+/** Move the conversation on as far as the output received allows. */
+static void Converse(Caller *caller)
+{
+    bool progress = TRUE;
+
+    while (progress && caller->socket >= 0 && caller->wakeAt == 0)
+    {
+        progress = FALSE;
+        switch (caller->state)
+        {
+            case CALLER_NEGOTIATING:
+                /* The DA request is the last thing Identify() sends. */
+                if (Expect(caller, IDENTIFY))
+                {
+                    SendText(caller, LOADGEN_DA_RESPONSE);
+                    SendText(caller, "\r\n");
+                    Wait(caller, CALLER_USERNAME);
+                    progress = TRUE;
+                }
+                break;
+            case CALLER_USERNAME:
+                if (Expect(caller, PROMPT_USERNAME))
+                {
+                    caller->sentAt = MonotonicNanos();
+                    if (caller->registering)
+                    {
+                        SendLine(caller, "new");
+                        Wait(caller, CALLER_NEW_USERNAME);
+                    }
+                    else
+                    {
+                        SendLine(caller, caller->username);
+                        Wait(caller, CALLER_PASSWORD);
+                    }
+                    progress = TRUE;
+                }
+                break;
+            case CALLER_PASSWORD:
+                if (Expect(caller, PROMPT_PASSWORD))
+                {
+                    SendLine(caller, LOADGEN_PASSWORD);
+                    Wait(caller, CALLER_LOGGING_IN);
+                    progress = TRUE;
+                }
+                break;
+            case CALLER_LOGGING_IN:
+                if (Expect(caller, PROMPT_AUTH_FAILED))
+                {
+                    /* Not registered yet, sign up at the next prompt. */
+                    caller->registering = TRUE;
+                    Wait(caller, CALLER_USERNAME);
+                    progress = TRUE;
+                }
+                else if (Expect(caller, PROMPT_MENU))
+                {
+                    RecordSince(&loginLatency, caller->sentAt);
+                    totals.logins++;
+                    if (caller->registering)
+                    {
+                        totals.registrations++;
+                        caller->registering = FALSE;
+                    }
+                    caller->actionsLeft = options.actions;
+                    Think(caller, CALLER_MENU, ThinkTime(options.thinkMs));
+                }
+                break;
+            case CALLER_NEW_USERNAME:
+                if (Expect(caller, PROMPT_NEW_USERNAME))
+                {
+                    SendLine(caller, caller->username);
+                    Wait(caller, CALLER_NEW_PASSWORD);
+                    progress = TRUE;
+                }
+                break;
+            case CALLER_NEW_PASSWORD:
+                if (Expect(caller, PROMPT_NEW_PASSWORD))
+                {
+                    SendLine(caller, LOADGEN_PASSWORD);
+                    Wait(caller, CALLER_NEW_CONFIRM);
+                    progress = TRUE;
+                }
+                break;
+            case CALLER_NEW_CONFIRM:
+                if (Expect(caller, PROMPT_NEW_CONFIRM))
+                {
+                    SendLine(caller, LOADGEN_PASSWORD);
+                    Wait(caller, CALLER_NEW_EMAIL);
+                    progress = TRUE;
+                }
+                break;
+            case CALLER_NEW_EMAIL:
+                if (Expect(caller, PROMPT_NEW_EMAIL))
+                {
+                    SendText(caller, caller->username);
+                    SendLine(caller, "@example.com");
+                    Wait(caller, CALLER_LOGGING_IN);
+                    progress = TRUE;
+                }
+                break;
+            case CALLER_SEARCH_PROMPT:
+                if (Expect(caller, PROMPT_SEARCH))
+                {
+                    RecordSince(&actionLatency, caller->sentAt);
+                    TypeKey(caller);
+                    progress = TRUE;
+                }
+                break;
+            case CALLER_TYPING:
+                if (caller->textLength > 0 &&
+                    strchr(caller->text, caller->query[caller->typed]))
+                {
+                    RecordSince(&echoLatency, caller->sentAt);
+                    totals.keystrokes++;
+                    caller->typed++;
+                    caller->textLength = 0;
+                    caller->text[0] = '\0';
+                    Think(caller, CALLER_TYPING,
+                        ThinkTime(options.keystrokeMs));
+                }
+                break;
+            case CALLER_RESULTS:
+                if (Expect(caller, PROMPT_ANY_KEY))
+                {
+                    RecordSince(&actionLatency, caller->sentAt);
+                    Think(caller, CALLER_ANY_KEY,
+                        ThinkTime(options.thinkMs));
+                }
+                break;
+            case CALLER_ANY_KEY:
+                if (Expect(caller, PROMPT_MENU))
+                {
+                    RecordSince(&actionLatency, caller->sentAt);
+                    Think(caller, CALLER_MENU, ThinkTime(options.thinkMs));
+                }
+                break;
+            case CALLER_LOGGING_OUT:
+                if (Expect(caller, PROMPT_GOODBYE))
+                {
+                    HangUp(caller);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/** Thinking is over, take the next step. */
+static void WakeUp(Caller *caller)
+{
+    caller->wakeAt = 0;
+    switch (caller->state)
+    {
+        case CALLER_MENU:
+            ChooseAction(caller);
+            break;
+        case CALLER_TYPING:
+            TypeKey(caller);
+            break;
+        case CALLER_ANY_KEY:
+            SendText(caller, " ");
+            StartTimed(caller, CALLER_ANY_KEY);
+            break;
+        default:
+            break;
+    }
+    Converse(caller);
+}
+
+static void ReadCaller(Caller *caller)
+{
+    uint8_t data[LOADGEN_TEXT_SIZE];
+    ssize_t received;
+
+    for (;;)
+    {
+        received = recv(caller->socket, data, sizeof(data), 0);
+        if (received > 0)
+        {
+            totals.bytesReceived += (unsigned long)received;
+            ReceiveBytes(caller, data, (int)received);
+            continue;
+        }
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+        /* Hung up by the server. */
+        if (caller->state != CALLER_LOGGING_OUT)
+        {
+            totals.disconnects++;
+        }
+        HangUp(caller);
+        return;
+    }
+    Converse(caller);
+}
+
+static void Call(Caller *caller)
+{
+    struct epoll_event event;
+    int sockfd;
+
+    totals.calls++;
+    sockfd = socket(AF_INET, SOCK_STREAM, 0);
+    if (sockfd < 0)
+    {
+        totals.connectFailures++;
+        HangUp(caller);
+        return;
+    }
+    fcntl(sockfd, F_SETFL, O_NONBLOCK);
+    if (connect(sockfd, (struct sockaddr *)&options.address,
+        sizeof(options.address)) < 0 && errno != EINPROGRESS)
+    {
+        close(sockfd);
+        totals.connectFailures++;
+        HangUp(caller);
+        return;
+    }
+    caller->socket = sockfd;
+    caller->telnetState = TELNET_DATA;
+    caller->textLength = 0;
+    caller->text[0] = '\0';
+    caller->pendingLength = 0;
+    StartTimed(caller, CALLER_CONNECTING);
+
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLOUT;
+    event.data.ptr = caller;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, sockfd, &event);
+}
+
+static void FinishCall(Caller *caller)
+{
+    int error = 0;
+    socklen_t length = sizeof(error);
+
+    getsockopt(caller->socket, SOL_SOCKET, SO_ERROR, &error, &length);
+    if (error != 0)
+    {
+        totals.connectFailures++;
+        HangUp(caller);
+        return;
+    }
+    RecordSince(&connectLatency, caller->sentAt);
+    Wait(caller, CALLER_NEGOTIATING);
+    WatchCaller(caller, FALSE);
+}
+
+static void CheckTimers(Caller *callers, unsigned long now,
+    unsigned long *callBudget)
+{
+    Caller *caller;
+    int i;
+
+    for (i = 0; i < options.callers; i++)
+    {
+        caller = &callers[i];
+        if (caller->wakeAt != 0)
+        {
+            if (caller->wakeAt > now)
+            {
+                continue;
+            }
+            if (caller->state == CALLER_IDLE)
+            {
+                if (*callBudget == 0)
+                {
+                    continue;
+                }
+                (*callBudget)--;
+                caller->wakeAt = 0;
+                Call(caller);
+                continue;
+            }
+            WakeUp(caller);
+        }
+        else if (caller->socket >= 0 &&
+            now - caller->waitStart > options.timeoutMs * NANOS_PER_MS)
+        {
+            totals.timeouts++;
+            HangUp(caller);
+        }
+    }
+}
+
+static void PrintLatency(const char *name, const Histogram *histogram)
+{
+    printf("%-16s %8lu %10.2f %10.2f %10.2f %10.2f\n", name,
+        GetHistogramCount(histogram),
+        GetHistogramPercentile(histogram, 0.5) / 1e6,
+        GetHistogramPercentile(histogram, 0.9) / 1e6,
+        GetHistogramPercentile(histogram, 0.99) / 1e6,
+        GetHistogramPercentile(histogram, 1.0) / 1e6);
+}
+
+static void PrintProgress(double elapsed, Caller *callers)
+{
+    int i, connected = 0;
+
+    for (i = 0; i < options.callers; i++)
+    {
+        if (callers[i].socket >= 0)
+        {
+            connected++;
+        }
+    }
+    fprintf(stderr, "%6.0fs: %d connected, %lu logins, %lu actions, "
+        "%lu timeouts\n", elapsed, connected, totals.logins, totals.actions,
+        totals.timeouts);
+}
+
+static void PrintReport(double elapsed)
+{
+    printf("\n%d callers for %.1f seconds\n\n", options.callers, elapsed);
+    printf("%-16s %8s %10s %10s %10s %10s\n", "Latency (ms)", "Count",
+        "p50", "p90", "p99", "Max");
+    PrintLatency("Connect", &connectLatency);
+    PrintLatency("Login", &loginLatency);
+    PrintLatency("Keystroke echo", &echoLatency);
+    PrintLatency("Menu action", &actionLatency);
+    printf("\n");
+    printf("%-24s %10lu %10.1f/s\n", "Calls", totals.calls,
+        totals.calls / elapsed);
+    printf("%-24s %10lu %10.1f/s\n", "Logins", totals.logins,
+        totals.logins / elapsed);
+    printf("%-24s %10lu\n", "Registrations", totals.registrations);
+    printf("%-24s %10lu %10.1f/s\n", "Menu actions", totals.actions,
+        totals.actions / elapsed);
+    printf("%-24s %10lu %10.1f/s\n", "Keystrokes", totals.keystrokes,
+        totals.keystrokes / elapsed);
+    printf("%-24s %10lu %10.1f KB/s\n", "Bytes sent", totals.bytesSent,
+        totals.bytesSent / elapsed / 1024);
+    printf("%-24s %10lu %10.1f KB/s\n", "Bytes received",
+        totals.bytesReceived, totals.bytesReceived / elapsed / 1024);
+    printf("%-24s %10lu\n", "Connect failures", totals.connectFailures);
+    printf("%-24s %10lu\n", "Unexpected hang ups", totals.disconnects);
+    printf("%-24s %10lu\n", "Timeouts", totals.timeouts);
+}
+
+/** Make room for one descriptor per caller. */
+static void RaiseFileLimit(int callers)
+{
+    struct rlimit limit;
+
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 &&
+        limit.rlim_cur < (rlim_t)callers + 16)
+    {
+        limit.rlim_cur = MIN(limit.rlim_max, (rlim_t)callers + 16);
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    struct epoll_event events[LOADGEN_EVENTS];
+    Caller *callers, *caller;
+    const char *host = "127.0.0.1";
+    unsigned long start, now, deadline, lastReport, callBudget, started = 0;
+    int i, n, port = TELNET_PORT;
+
+    options.callers = 100;
+    options.seconds = 30;
+    options.connectRate = 50;
+    options.thinkMs = 1000;
+    options.keystrokeMs = 100;
+    options.actions = 5;
+    options.listPercent = 20;
+    options.timeoutMs = 10000;
+    options.prefix = "load";
+
+    for (i = 1; i < argc; i++)
+    {
+        if (argv[i][0] != '-' || argv[i][1] == '\0' || argv[i][2] != '\0' ||
+            i + 1 >= argc)
+        {
+            Usage();
+            return EXIT_FAILURE;
+        }
+        switch (argv[i][1])
+        {
+            case 'h':
+                host = argv[++i];
+                break;
+            case 'p':
+                port = atoi(argv[++i]);
+                break;
+            case 'n':
+                options.callers = atoi(argv[++i]);
+                break;
+            case 'd':
+                options.seconds = atoi(argv[++i]);
+                break;
+            case 'r':
+                options.connectRate = atoi(argv[++i]);
+                break;
+            case 't':
+                options.thinkMs = atoi(argv[++i]);
+                break;
+            case 'k':
+                options.keystrokeMs = atoi(argv[++i]);
+                break;
+            case 'a':
+                options.actions = atoi(argv[++i]);
+                break;
+            case 'w':
+                options.timeoutMs = strtoul(argv[++i], NULL, 10);
+                break;
+            case 'l':
+                options.listPercent = atoi(argv[++i]);
+                break;
+            case 'u':
+                options.prefix = argv[++i];
+                break;
+            default:
+                Usage();
+                return EXIT_FAILURE;
+        }
+    }
+    if (options.callers <= 0 || options.seconds <= 0 ||
+        options.connectRate <= 0 || strlen(options.prefix) > 12)
+    {
+        Usage();
+        return EXIT_FAILURE;
+    }
+
+    memset(&options.address, 0, sizeof(options.address));
+    options.address.sin_family = AF_INET;
+    options.address.sin_port = htons(port);
+    if (inet_pton(AF_INET, host, &options.address.sin_addr) != 1)
+    {
+        fprintf(stderr, "Bad IPv4 address: %s\n", host);
+        return EXIT_FAILURE;
+    }
+
+    RaiseFileLimit(options.callers);
+    epollFd = epoll_create(options.callers + 1);
+    callers = (Caller *)calloc(options.callers, sizeof(Caller));
+    if (epollFd < 0 || callers == NULL)
+    {
+        fprintf(stderr, "Could not set up %d callers\n", options.callers);
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < options.callers; i++)
+    {
+        caller = &callers[i];
+        caller->socket = -1;
+        caller->state = CALLER_IDLE;
+        caller->wakeAt = 1;
+        sprintf(caller->username, "%s%d", options.prefix, i);
+    }
+
+    signal(SIGINT, StopSignal);
+    signal(SIGPIPE, SIG_IGN);
+    printf("Calling %s:%d with %d callers for %d seconds\n", host, port,
+        options.callers, options.seconds);
+    fflush(stdout);
+
+    start = MonotonicNanos();
+    lastReport = start;
+    deadline = start + (unsigned long)options.seconds * 1000 * NANOS_PER_MS;
+    while (!stopping && (now = MonotonicNanos()) < deadline)
+    {
+        n = epoll_wait(epollFd, events, LOADGEN_EVENTS, LOADGEN_TICK_MS);
+        for (i = 0; i < n; i++)
+        {
+            caller = (Caller *)events[i].data.ptr;
+            if (caller->socket < 0)
+            {
+                continue;
+            }
+            if (caller->state == CALLER_CONNECTING)
+            {
+                FinishCall(caller);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT)
+            {
+                FlushCaller(caller);
+            }
+            if (caller->socket >= 0 &&
+                events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+            {
+                ReadCaller(caller);
+            }
+        }
+
+        /* Spread new calls out at the connect rate. */
+        now = MonotonicNanos();
+        callBudget = (unsigned long)((double)(now - start) / 1e9 *
+            options.connectRate) + 1;
+        callBudget = callBudget > started ? callBudget - started : 0;
+        n = (int)callBudget;
+        CheckTimers(callers, now, &callBudget);
+        started += (unsigned long)n - callBudget;
+
+        if (now - lastReport >= LOADGEN_REPORT_SECONDS * 1000 * NANOS_PER_MS)
+        {
+            PrintProgress((now - start) / 1e9, callers);
+            lastReport = now;
+        }
+    }
+
+    for (i = 0; i < options.callers; i++)
+    {
+        if (callers[i].socket >= 0)
+        {
+            close(callers[i].socket);
+        }
+    }
+    PrintReport((MonotonicNanos() - start) / 1e9);
+    free(callers);
+    close(epollFd);
+
+    /* Fail the run if the server couldn't keep up, so CI notices. */
+    return totals.logins > 0 && totals.timeouts == 0 &&
+        totals.connectFailures == 0 && totals.disconnects == 0 ?
+        EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+#else
+
+int main(int argc, char *argv[])
+{
+    (void)argc;
+    (void)argv;
+    fprintf(stderr, "vbbs-loadgen needs epoll, which this platform lacks.\n");
+    return EXIT_FAILURE;
+}
+
+#endif /* __linux__ */
@@ -0,0 +1,344 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOGDUMP_OUTPUT_BUFFER_SIZE 65536
+
+typedef struct LogDumpFilter
+{
+    bool types[EVENT_TYPE_COUNT];
+    bool anyType;
+    const char *username;
+    uint32_t remoteIP;
+    uint32_t since;
+    uint32_t until;
+} LogDumpFilter;
+
+/** Totals for one user or address. */
+typedef struct LogDumpTotals
+{
+    unsigned long connects;
+    unsigned long logins;
+    unsigned long failures;
+    unsigned long transfers;
+    unsigned long bytes;
+} LogDumpTotals;
+
+static void Usage(void)
+{
+    fprintf(stderr,
+        "Usage: vbbs-logdump [options] file...\n"
+        "  -t type     Only events of this type, may be repeated\n"
+        "              (connect, disconnect, login, login-failed,\n"
+        "              transfer, transfer-failed)\n"
+        "  -u user     Only events for this username\n"
+        "  -a address  Only events from this IPv4 address\n"
+        "  -s time     Only events at or after this Unix time\n"
+        "  -e time     Only events before this Unix time\n"
+        "  -c          Print totals by type, user and address instead\n");
+}
+
+static bool ParseIP(const char *text, uint32_t *ip)
+{
+    unsigned int a, b, c, d;
+    char extra;
+
+    if (sscanf(text, "%u.%u.%u.%u%c", &a, &b, &c, &d, &extra) != 4 ||
+        a > 255 || b > 255 || c > 255 || d > 255)
+    {
+        return FALSE;
+    }
+    *ip = ((uint32_t)a << 24) | ((uint32_t)b << 16) | ((uint32_t)c << 8) |
+        (uint32_t)d;
+    return TRUE;
+}
+
+static void FormatIP(char *buffer, uint32_t ip)
+{
+    sprintf(buffer, "%u.%u.%u.%u", (unsigned int)(ip >> 24) & 0xFF,
+        (unsigned int)(ip >> 16) & 0xFF, (unsigned int)(ip >> 8) & 0xFF,
+        (unsigned int)ip & 0xFF);
+}
+
+static bool MatchEvent(const LogDumpFilter *filter, const Event *event)
+{
+    if (!filter->anyType &&
+        (event->type >= EVENT_TYPE_COUNT || !filter->types[event->type]))
+    {
+        return FALSE;
+    }
+    if (event->time < filter->since || event->time >= filter->until)
+    {
+        return FALSE;
+    }
+    if (filter->remoteIP != 0 && event->remoteIP != filter->remoteIP)
+    {
+        return FALSE;
+    }
+    if (filter->username != NULL &&
+        strcmp(event->username, filter->username) != 0)
+    {
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static void PrintEvent(const Event *event)
+{
+    char timestamp[TIMESTAMP_LENGTH + 1], address[16];
+
+    if (FormatTimestamp(timestamp, sizeof(timestamp), (time_t)event->time)
+        == 0)
+    {
+        sprintf(timestamp, "%lu", (unsigned long)event->time);
+    }
+    printf("%s %-15s session=%lu", timestamp,
+        EventTypeName((EventType)event->type),
+        (unsigned long)event->sessionID);
+    if (event->username[0] != '\0')
+    {
+        printf(" user=%s", event->username);
+        if (event->userID != 0)
+        {
+            printf("(%lu)", (unsigned long)event->userID);
+        }
+    }
+    if (event->remoteIP != 0)
+    {
+        FormatIP(address, event->remoteIP);
+        printf(" from=%s:%u", address, (unsigned int)event->remotePort);
+    }
+    switch (event->type)
+    {
+        case EVENT_LOGIN_FAILED:
+            printf(" attempt=%lu", (unsigned long)event->value);
+            break;
+        case EVENT_TRANSFER_COMPLETE:
+        case EVENT_TRANSFER_FAILED:
+            printf(" bytes=%lu", (unsigned long)event->value);
+            break;
+    }
+    printf("\n");
+}
+
+static LogDumpTotals *GetTotals(Map *map, const char *key)
+{
+    LogDumpTotals *totals = (LogDumpTotals *)MapGet(map, key);
+
+    if (totals == NULL)
+    {
+        totals = (LogDumpTotals *)calloc(1, sizeof(LogDumpTotals));
+        if (totals == NULL)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+        MapPut(map, key, totals);
+    }
+    return totals;
+}
+
+static void AddToTotals(LogDumpTotals *totals, const Event *event)
+{
+    switch (event->type)
+    {
+        case EVENT_CONNECT:
+            totals->connects++;
+            break;
+        case EVENT_LOGIN:
+            totals->logins++;
+            break;
+        case EVENT_LOGIN_FAILED:
+            totals->failures++;
+            break;
+        case EVENT_TRANSFER_COMPLETE:
+            totals->transfers++;
+            totals->bytes += event->value;
+            break;
+    }
+}
+
+static void PrintTotals(const char *title, Map *map)
+{
+    ArrayList *bucket;
+    MapEntry *entry;
+    LogDumpTotals *totals;
+    int i, j;
+
+    printf("\n%-20s %10s %10s %10s %10s %14s\n", title, "Connects",
+        "Logins", "Failures", "Transfers", "Bytes");
+    for (i = 0; i < map->bucketCount; i++)
+    {
+        bucket = map->buckets[i];
+        for (j = 0; bucket != NULL && j < bucket->size; j++)
+        {
+            entry = (MapEntry *)GetFromArrayList(bucket, j);
+            totals = (LogDumpTotals *)entry->value;
+            printf("%-20s %10lu %10lu %10lu %10lu %14lu\n", entry->key,
+                totals->connects, totals->logins, totals->failures,
+                totals->transfers, totals->bytes);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    LogDumpFilter filter;
+    EventReader *reader;
+    Event event;
+    EventType type;
+    Map *users = NULL, *addresses = NULL;
+    unsigned long typeCounts[EVENT_TYPE_COUNT], matched = 0;
+    char address[16];
+    bool summary = FALSE;
+    int i, files = 0;
+
+    memset(&filter, 0, sizeof(filter));
+    memset(typeCounts, 0, sizeof(typeCounts));
+    filter.anyType = TRUE;
+    filter.until = 0xFFFFFFFFUL;
+
+    for (i = 1; i < argc && argv[i][0] == '-'; i++)
+    {
+        if (strcmp(argv[i], "-c") == 0)
+        {
+            summary = TRUE;
+            continue;
+        }
+        if (argv[i][1] == '\0' || argv[i][2] != '\0' || i + 1 >= argc)
+        {
+            Usage();
+            return EXIT_FAILURE;
+        }
+        switch (argv[i][1])
+        {
+            case 't':
+                type = ParseEventType(argv[++i]);
+                if (type == EVENT_NONE)
+                {
+                    fprintf(stderr, "Unknown event type: %s\n", argv[i]);
+                    return EXIT_FAILURE;
+                }
+                filter.types[type] = TRUE;
+                filter.anyType = FALSE;
+                break;
+            case 'u':
+                filter.username = argv[++i];
+                break;
+            case 'a':
+                if (!ParseIP(argv[++i], &filter.remoteIP))
+                {
+                    fprintf(stderr, "Bad IPv4 address: %s\n", argv[i]);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 's':
+                filter.since = (uint32_t)strtoul(argv[++i], NULL, 10);
+                break;
+            case 'e':
+                filter.until = (uint32_t)strtoul(argv[++i], NULL, 10);
+                break;
+            default:
+                Usage();
+                return EXIT_FAILURE;
+        }
+    }
+    if (i >= argc)
+    {
+        Usage();
+        return EXIT_FAILURE;
+    }
+
+    setvbuf(stdout, NULL, _IOFBF, LOGDUMP_OUTPUT_BUFFER_SIZE);
+    if (summary)
+    {
+        users = NewMap(free);
+        addresses = NewMap(free);
+        if (users == NULL || addresses == NULL)
+        {
+            fprintf(stderr, "Out of memory\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (; i < argc; i++)
+    {
+        reader = OpenEventReader(argv[i]);
+        if (reader == NULL)
+        {
+            fprintf(stderr, "%s is not a readable event log\n", argv[i]);
+            continue;
+        }
+        files++;
+        while (ReadEvent(reader, &event))
+        {
+            if (!MatchEvent(&filter, &event))
+            {
+                continue;
+            }
+            matched++;
+            if (!summary)
+            {
+                PrintEvent(&event);
+                continue;
+            }
+            if (event.type < EVENT_TYPE_COUNT)
+            {
+                typeCounts[event.type]++;
+            }
+            if (event.username[0] != '\0')
+            {
+                AddToTotals(GetTotals(users, event.username), &event);
+            }
+            if (event.remoteIP != 0)
+            {
+                FormatIP(address, event.remoteIP);
+                AddToTotals(GetTotals(addresses, address), &event);
+            }
+        }
+        CloseEventReader(reader);
+    }
+
+    if (summary)
+    {
+        printf("%-20s %10s\n", "Event", "Count");
+        for (i = 1; i < EVENT_TYPE_COUNT; i++)
+        {
+            printf("%-20s %10lu\n", EventTypeName((EventType)i),
+                typeCounts[i]);
+        }
+        printf("%-20s %10lu\n", "total", matched);
+        PrintTotals("User", users);
+        PrintTotals("Address", addresses);
+        DestroyMap(users);
+        DestroyMap(addresses);
+    }
+    return files > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
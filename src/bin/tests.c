@@ -44,10 +44,31 @@ void printTestResult(const char *test, bool passed) {
 
 int main(void)
 {
+    SHA1SelectImplementation();
     runAllBufferTests();
     runAllCRCTests();
     runAllRingBufferTests();
     runAllListTests();
+    runAllTransferTests();
+    runAllMessageTests();
+    runAllSearchTests();
+    runAllZipTests();
+    runAllQwkTests();
+    runAllLogTests();
+    runAllTimeTests();
+    runAllEventTests();
+    runAllMetricsTests();
+    runAllAdminTests();
+    runAllSessionTests();
+    runAllTerminalTests();
+    runAllWorkerTests();
+    runAllSHA1Tests();
+    runAllPBKDF2Tests();
+    runAllUserTests();
+    runAllThrottleTests();
+    runAllPoolTests();
+    runAllArenaTests();
+    runAllMemoryTests();
     /* These tests are flakey.
     runAllMapTests();
     */
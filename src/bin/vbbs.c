@@ -80,7 +80,7 @@ void CreateConsoleConnection(ArrayList *sessions)
     }
 
     session->eventHandler = Connected;
-    Connected(session);
+    RunEventHandler(session);
 
     AddToArrayList(sessions, session);
 
@@ -92,10 +92,36 @@ void AcceptTelnetConnection(TelnetListener *listener, ArrayList *sessions)
 {
     Connection *conn;
     Session *session;
+    unsigned long delay;
 
     conn = TelnetListenerAccept(listener);
     if (conn != NULL)
     {
+        IncrementCounter(&connectionsAccepted);
+        /* Turn away addresses with too many failed logins before a session
+           is set up for them. */
+        delay = GetThrottleDelay(TelnetRemoteIP(conn));
+        if (delay > 0)
+        {
+            IncrementCounter(&throttledConnections);
+            Debug("Refused a connection from %s for %lu seconds.",
+                TelnetRemoteAddress(conn), delay);
+            fprintf(conn->outputStream,
+                "Too many failed logins, try again in %lu seconds.\r\n",
+                delay);
+            DestroyConnection(conn);
+            return;
+        }
+        if (IsMemoryExhausted())
+        {
+            IncrementCounter(&memoryRefusedConnections);
+            Warn("Refused a connection from %s, %lu bytes are in use.",
+                TelnetRemoteAddress(conn), (unsigned long)GetTrackedMemory());
+            fprintf(conn->outputStream,
+                "The system is busy, please try again later.\r\n");
+            DestroyConnection(conn);
+            return;
+        }
         session = NewSession(conn);
         if (session == NULL)
         {
@@ -107,14 +133,22 @@ void AcceptTelnetConnection(TelnetListener *listener, ArrayList *sessions)
         AddToArrayList(sessions, session);
 
         session->eventHandler = Connected;
-        Connected(session);
+        RunEventHandler(session);
     }
 }
 
 void ReadFromSession(Session *session)
 {
-    ReadDataFromStream(session->conn->inputBuffer, 
+    unsigned long start = MonotonicNanos();
+    int received;
+
+    received = ReadDataFromStream(session->conn->inputBuffer, 
         session->conn->inputStream);
+    if (received > 0)
+    {
+        AddToCounter(&bytesReceived, (unsigned long)received);
+        session->lastActivity = time(NULL);
+    }
     if(feof(session->conn->inputStream))
     {
         if (session->conn->inputStream == stdin)
@@ -123,6 +157,7 @@ void ReadFromSession(Session *session)
             Info("Received EOF on stdin, shutting down.");
         }
         Disconnect(session->conn, FALSE);
+        RecordElapsed(&readTime, start);
         return;
     }
     else if (ferror(session->conn->inputStream))
@@ -143,25 +178,48 @@ void ReadFromSession(Session *session)
                 break;
         }
     }
-    if (IsNextLineReady(session->conn->inputBuffer) && 
-        session->eventHandler != NULL)
+    if (IsNextLineReady(session->conn->inputBuffer))
     {
-        session->eventHandler(session);
+        RunEventHandler(session);
     }
+    RecordElapsed(&readTime, start);
 }
 
 void WriteToSession(Session *session)
 {
+    unsigned long start = MonotonicNanos();
+    int sent;
+
     if (session == NULL || session->conn == NULL)
     {
         return;
     }
 
-    WriteBufferToConnection(session->conn);
+    sent = WriteBufferToConnection(session->conn);
+    if (sent > 0)
+    {
+        AddToCounter(&bytesSent, (unsigned long)sent);
+    }
+    ContinueOutput(session);
+    if (session->conn == NULL || session->conn->outputStream == NULL)
+    {
+        RecordElapsed(&writeTime, start);
+        return;
+    }
+    if (session->conn->transfer != NULL)
+    {
+        ContinueDownload(session);
+        if (session->conn == NULL || session->conn->outputStream == NULL)
+        {
+            RecordElapsed(&writeTime, start);
+            return;
+        }
+    }
     if(feof(session->conn->outputStream))
     {
         Debug("End of file reached on input stream.");
         Disconnect(session->conn, TRUE);
+        RecordElapsed(&writeTime, start);
         return;
     }
     else if (ferror(session->conn->outputStream))
@@ -182,6 +240,7 @@ void WriteToSession(Session *session)
                 break;
         }
     }
+    RecordElapsed(&writeTime, start);
 }
 
 void PruneSessions(ArrayList *sessions)
@@ -224,13 +283,17 @@ int main(int argc, char *argv[])
     ArrayList *sessions = NewArrayList(10, SessionDestructor);
 
     TelnetListener *telnetListener = NULL;                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                  
+    AdminListener *adminListener = NULL;
     int telnetPort = TELNET_PORT;
+    int outputLimit, highWater, lowWater;
+    int indexed;
+    unsigned long iterationStart = 0;
 
 #ifdef _POSIX_VERSION
     int fd, max_fd, i;
     fd_set read_fds, write_fds;
-    struct timeval *timeout = NULL;
-    /* struct timeval *timeout = malloc(sizeof(struct timeval)); */
+    struct timeval pacing, *timeout = NULL;
+    unsigned long delay, nextDelay;
 
     /** Set stdin and stdout to non-blocking mode */
     fcntl(fileno(stdin), F_SETFL, O_NONBLOCK);
@@ -244,14 +307,148 @@ int main(int argc, char *argv[])
     }
 
     InitLog("vbbs.log");
+    if (!StartAsyncLog())
+    {
+        Warn("Asynchronous logging is not available, logging synchronously.");
+    }
 
     Info("Starting %s", VBBS_VERSION_STRING);
+    InitMetrics();
+    InitThrottle();
+
+    /* The binary event log is optional: vbbs [port [eventlog]] */
+    if (argc > 2 && OpenEventLog(argv[2]))
+    {
+        Info("Writing events to %s", argv[2]);
+    }
+
+    /* Log event handlers slower than VBBS_SLOW_HANDLER_MS milliseconds */
+    if (getenv("VBBS_SLOW_HANDLER_MS") != NULL)
+    {
+        SetSlowHandlerThreshold(
+            strtoul(getenv("VBBS_SLOW_HANDLER_MS"), NULL, 10));
+    }
+    Info("Logging event handlers slower than %lu ms.",
+        GetSlowHandlerThreshold());
+
+    Info("Using the %s SHA1 implementation.",
+        SHA1ImplementationName(SHA1SelectImplementation()));
+
+    /* New password hashes use VBBS_PASSWORD_ITERATIONS iterations */
+    if (getenv("VBBS_PASSWORD_ITERATIONS") != NULL)
+    {
+        SetPasswordIterations(
+            strtoul(getenv("VBBS_PASSWORD_ITERATIONS"), NULL, 10));
+    }
+    Info("Hashing passwords with %lu PBKDF2 iterations.",
+        GetPasswordIterations());
+
+    /* Hang up on sessions holding more than VBBS_SESSION_MEMORY_LIMIT bytes,
+       and refuse callers while all of them hold more than VBBS_MEMORY_LIMIT */
+    if (getenv("VBBS_SESSION_MEMORY_LIMIT") != NULL)
+    {
+        SetSessionMemoryLimit(
+            strtoul(getenv("VBBS_SESSION_MEMORY_LIMIT"), NULL, 10));
+    }
+    if (getenv("VBBS_MEMORY_LIMIT") != NULL)
+    {
+        SetMemoryLimit(strtoul(getenv("VBBS_MEMORY_LIMIT"), NULL, 10));
+    }
+    Info("Limiting sessions to %lu bytes and the server to %lu bytes "
+        "(0 is unlimited).", (unsigned long)GetSessionMemoryLimit(),
+        (unsigned long)GetMemoryLimit());
+
+    /* Queue at most VBBS_OUTPUT_LIMIT bytes for a caller, pausing it between
+       VBBS_OUTPUT_HIGH_WATER and VBBS_OUTPUT_LOW_WATER */
+    GetOutputLimits(&outputLimit, &highWater, &lowWater);
+    if (getenv("VBBS_OUTPUT_LIMIT") != NULL)
+    {
+        outputLimit = atoi(getenv("VBBS_OUTPUT_LIMIT"));
+    }
+    if (getenv("VBBS_OUTPUT_HIGH_WATER") != NULL)
+    {
+        highWater = atoi(getenv("VBBS_OUTPUT_HIGH_WATER"));
+    }
+    if (getenv("VBBS_OUTPUT_LOW_WATER") != NULL)
+    {
+        lowWater = atoi(getenv("VBBS_OUTPUT_LOW_WATER"));
+    }
+    if (!SetOutputLimits(outputLimit, highWater, lowWater))
+    {
+        Warn("Ignoring output limits %d/%d/%d, the watermarks must be "
+            "0 < low < high <= limit.", outputLimit, highWater, lowWater);
+        GetOutputLimits(&outputLimit, &highWater, &lowWater);
+    }
+    Info("Queueing up to %d bytes of output per caller, pausing at %d "
+        "until %d.", outputLimit, highWater, lowWater);
+
+    /* Emulate callers at VBBS_BAUD_RATE bps unless they negotiate a speed */
+    if (getenv("VBBS_BAUD_RATE") != NULL)
+    {
+        SetOutputRate((unsigned int)strtoul(getenv("VBBS_BAUD_RATE"),
+            NULL, 10));
+    }
+    if (GetOutputRate() > 0)
+    {
+        Info("Pacing output at %u bps, or the speed a caller negotiates.",
+            GetOutputRate());
+    }
+
+    /* Password hashing runs on VBBS_WORKER_THREADS worker threads */
+    if (!StartWorkerPool(getenv("VBBS_WORKER_THREADS") != NULL ?
+        atoi(getenv("VBBS_WORKER_THREADS")) : WORKER_THREADS,
+        WORKER_QUEUE_DEPTH))
+    {
+        Warn("Worker threads are not available, hashing passwords "
+            "on the event loop.");
+    }
 
     signal(SIGINT, SignalHandler);
+#ifdef SIGPIPE
+    /* Output can still be queued when a caller hangs up, and writing it
+       must fail with EPIPE rather than end the server. */
+    signal(SIGPIPE, SIG_IGN);
+#endif
 
-    LoadUserDB() ? 
-        Info("User database loaded successfully.") : 
+    if (LoadUserDB())
+    {
+        Info("User database loaded successfully.");
+    }
+    else
+    {
         Error("Failed to load user database: %s", USER_DB_FILE);
+    }
+
+    if (LoadMessageDB())
+    {
+        Info("Message database loaded successfully.");
+    }
+    else
+    {
+        Error("Failed to load message database: %s", MESSAGE_DB_FILE);
+    }
+
+    if (LoadLastReadDB())
+    {
+        Info("Last-read database loaded successfully.");
+    }
+    else
+    {
+        Error("Failed to load last-read database: %s", LASTREAD_DB_FILE);
+    }
+
+    /* A damaged index is emptied and rebuilt from the message base. */
+    if (!LoadSearchIndex())
+    {
+        Error("Failed to load search index %s, rebuilding it.",
+            SEARCH_DB_FILE);
+    }
+    if (searchIndex != NULL)
+    {
+        indexed = UpdateSearchIndex();
+        Info("Search index loaded, %d new messages indexed.", indexed);
+        SetMessagePostHandler(IndexPostedMessage);
+    }
 
     sessions = NewArrayList(32, SessionDestructor);
 
@@ -260,6 +457,8 @@ int main(int argc, char *argv[])
     {
         Error("Failed to create Telnet listener on port %d.", telnetPort);
     }
+
+    adminListener = NewAdminListener(ADMIN_SOCKET_FILE);
     
     /*
     CreateConsoleConnection(sessions);
@@ -273,6 +472,8 @@ int main(int argc, char *argv[])
 #ifdef _POSIX_VERSION
         FD_ZERO(&read_fds);
         FD_ZERO(&write_fds);
+        max_fd = 0;
+        nextDelay = 0;
 
         if (telnetListener != NULL && telnetListener->socket >= 0)
         {
@@ -295,7 +496,10 @@ int main(int argc, char *argv[])
                 continue;
             }
 
-            if (!IsBufferFull(session->conn->inputBuffer->buffer))
+            /* A caller who isn't keeping up with output gets no more until
+               it drains, so its input waits. */
+            if (!IsBufferFull(session->conn->inputBuffer->buffer) &&
+                !IsOutputPaused(session->conn))
             {
                 fd = fileno(session->conn->inputStream);
                 if (fd >= 0)
@@ -305,7 +509,22 @@ int main(int argc, char *argv[])
                 }
             }
     
-            if (!IsBufferEmpty(session->conn->outputBuffer))
+            /* A paced caller waits for its next burst on the timer, not
+               the socket, as does a download waiting on WILL BINARY. */
+            delay = GetOutputDelay(session->conn);
+            if (delay == 0 && IsBufferEmpty(session->conn->outputBuffer))
+            {
+                delay = GetTransferDelay(session->conn);
+            }
+            if (delay > 0)
+            {
+                if (nextDelay == 0 || delay < nextDelay)
+                {
+                    nextDelay = delay;
+                }
+            }
+            else if (!IsBufferEmpty(session->conn->outputBuffer) ||
+                IsTransferActive(session->conn))
             {
                     fd = fileno(session->conn->outputStream);
                     if (fd >= 0)
@@ -316,12 +535,26 @@ int main(int argc, char *argv[])
             }
         } /* End for(sessions) */
 
-        /** Set timeout for select() to 5 seconds */
-        if (timeout != NULL)
+        max_fd = SetAdminFds(adminListener, &read_fds, &write_fds, max_fd);
+        max_fd = SetWorkerFds(&read_fds, max_fd);
+
+        /** Wake for the earliest paced caller, all of them sharing one
+            timer, or block until something happens */
+        timeout = NULL;
+        if (nextDelay > 0)
         {
-            timeout->tv_sec = 1;
-            timeout->tv_usec = 0;
-        }   
+            nextDelay = (nextDelay + 999) / 1000;
+            pacing.tv_sec = nextDelay / 1000000;
+            pacing.tv_usec = nextDelay % 1000000;
+            timeout = &pacing;
+        }
+        else if (searchIndex != NULL && searchIndex->dirty)
+        {
+            /* Wake in time to checkpoint new messages in the index. */
+            pacing.tv_sec = SEARCH_CHECKPOINT_INTERVAL;
+            pacing.tv_usec = 0;
+            timeout = &pacing;
+        }
 
         if(select(max_fd + 1, &read_fds, &write_fds, NULL, timeout) < 0)
         {
@@ -336,6 +569,7 @@ int main(int argc, char *argv[])
                 break;
             }
         }
+        iterationStart = MonotonicNanos();
 
         /** Check for new connections */
         if(telnetListener != NULL && 
@@ -353,6 +587,7 @@ int main(int argc, char *argv[])
             {
                 continue;
             }
+            SetLogSession(session->sessionID);
 
             if (session->conn->inputStream != NULL)
             {
@@ -361,6 +596,8 @@ int main(int argc, char *argv[])
                 /* Check for data to read from the input stream */
                 if (FD_ISSET(fd, &read_fds))
                 {
+                    /* How long this input waited behind other sessions */
+                    RecordElapsed(&loopLag, iterationStart);
                     ReadFromSession(session);
                 } /* End if(FD_ISSET(in_fd, &read_fds)) */
             }
@@ -376,6 +613,13 @@ int main(int argc, char *argv[])
                 } /* End if(FD_ISSET(out_fd, &write_fds)) */
             }
         } /* End for(sessions) */
+        SetLogSession(0);
+
+        /** Resume sessions whose password checks have finished */
+        HandleWorkerFds(&read_fds);
+
+        /** Answer admin requests after the sessions have been updated */
+        HandleAdminFds(adminListener, &read_fds, &write_fds, sessions);
 #else
 perror("select() is not supported on this platform.");
         break;
@@ -386,24 +630,47 @@ perror("select() is not supported on this platform.");
         /** Prune Sessions */
         PruneSessions(sessions);
 
+        FlushEventLog();
+        CheckpointSearchIndex();
+
+        SetGauge(&activeSessions, sessions->size);
+        RecordElapsed(&loopIterationTime, iterationStart);
+
         /** TODO: Other things should be processed here. */
 
     } /* End of Event Loop */
 
     DestroyTelnetListener(telnetListener);
+    DestroyAdminListener(adminListener);
+    StopWorkerPool();
 
     DestroyArrayList(sessions);
+    CloseEventLog();
 
-    Info("Shutting down %s", VBBS_VERSION_STRING);
+    SetMessagePostHandler(NULL);
+    if (searchIndex != NULL)
+    {
+        SaveSearchIndex();
+        DestroySearchIndex(searchIndex);
+        searchIndex = NULL;
+    }
 
-    CloseLog();
+    if (lastReadDB != NULL)
+    {
+        CloseLastReadDB(lastReadDB);
+        lastReadDB = NULL;
+    }
 
-#ifdef _POSIX_VERSION
-    if (timeout != NULL)
+    if (messageDB != NULL)
     {
-        free(timeout);
+        SaveMessageDB();
+        DestroyMessageDB(messageDB);
+        messageDB = NULL;
     }
-#endif
+
+    Info("Shutting down %s", VBBS_VERSION_STRING);
+
+    CloseLog();
 
     return EXIT_SUCCESS;
 }
@@ -27,12 +27,21 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vbbs/buffer.h>
 #include <vbbs/terminal.h>
 #include <vbbs/log.h>
+#include <vbbs/pool.h>
+#include <vbbs/memory.h>
+#include <vbbs/globals.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
 /********** Buffer **********/
 
+/* Every connection has two buffers of CONNECTION_BUFFER_SIZE. */
+static Pool bufferPool = POOL("buffer", sizeof(Buffer), 64);
+static Pool bufferBytesPool = POOL("buffer bytes", CONNECTION_BUFFER_SIZE + 1,
+    16);
+static Pool inputBufferPool = POOL("input buffer", sizeof(InputBuffer), 32);
+
 const char *const commandNames[] = {
     "SE", "NOP", "DM", "BRK", "IP", "AO", "AYT", "EC", "EL",
     "GA", "SB", "WILL", "WONT", "DO", "DONT", "IAC"};
@@ -81,21 +90,30 @@ static const char *TelnetOption(int option)
 
 Buffer *NewBuffer(int size)
 {
-    Buffer *buffer = (Buffer *)malloc(sizeof(Buffer));
+    Buffer *buffer = (Buffer *)PoolAlloc(&bufferPool);
     if (buffer == NULL)
     {
         return NULL;
     }
-    buffer->bytes = (uint8_t *)malloc(size + 1);
+    if (size == CONNECTION_BUFFER_SIZE)
+    {
+        buffer->bytes = (uint8_t *)PoolAlloc(&bufferBytesPool);
+    }
+    else
+    {
+        buffer->bytes = (uint8_t *)TrackedMalloc(size + 1);
+    }
     if (buffer->bytes == NULL)
     {
-        free(buffer);
+        PoolFree(&bufferPool, buffer);
         return NULL;
     }
     memset(buffer->bytes, 0, size + 1);
     buffer->tail = buffer->bytes;
     buffer->length = 0;
     buffer->maxSize = size;
+    buffer->capacity = size;
+    buffer->initialSize = size;
     buffer->convertNewlines = FALSE; /* Default to not converting newlines */
     buffer->handleANSI = FALSE;      /* Default to not handling ANSI */
     buffer->handleTelnet = FALSE;    /* Default to not handling Telnet */
@@ -108,6 +126,7 @@ Buffer *NewBuffer(int size)
     buffer->terminalType = NULL;    /* No handler by default */
     buffer->connectionSpeed = NULL; /* No handler by default */
     buffer->echo = NULL;            /* No handler by default */
+    buffer->telnetOption = NULL;    /* No handler by default */
     return buffer;
 }
 
@@ -135,6 +154,14 @@ static void _SetConnectionSpeed(Buffer *buffer, const char *speed)
     }
 }
 
+static void _SetTelnetOption(Buffer *buffer, int command, int option)
+{
+    if (buffer != NULL && buffer->telnetOption != NULL)
+    {
+        buffer->telnetOption(buffer->userData, command, option);
+    }
+}
+
 static void _EchoData(Buffer *buffer, const char c)
 {
     if (buffer != NULL && buffer->echo != NULL)
@@ -154,18 +181,87 @@ static void _EchoData(Buffer *buffer, const char c)
     }
 }
 
-void DestroyBuffer(Buffer *buffer)
+/** Connection sized buffers that haven't grown use the pool. */
+static bool IsBufferPooled(Buffer *buffer)
 {
-    if (buffer->bytes != NULL)
+    return buffer->capacity == CONNECTION_BUFFER_SIZE &&
+        buffer->initialSize == CONNECTION_BUFFER_SIZE;
+}
+
+static void FreeBufferBytes(Buffer *buffer)
+{
+    if (buffer->bytes != NULL && IsBufferPooled(buffer))
+    {
+        PoolFree(&bufferBytesPool, buffer->bytes);
+    }
+    else if (buffer->bytes != NULL)
     {
-        free(buffer->bytes);
-        buffer->bytes = NULL;
+        TrackedFree(buffer->bytes);
     }
-    free(buffer);
+    buffer->bytes = NULL;
+}
+
+/**
+ * Double the space for bytes, up to maxSize. The buffer stays as it is if
+ * that memory isn't available.
+ */
+static void GrowBuffer(Buffer *buffer)
+{
+    int used = buffer->tail - buffer->bytes;
+    int capacity = MIN(buffer->capacity * 2, buffer->maxSize);
+    uint8_t *bytes;
+
+    if (capacity <= buffer->capacity)
+    {
+        return;
+    }
+    bytes = (uint8_t *)TrackedMalloc(capacity + 1);
+    if (bytes == NULL)
+    {
+        return;
+    }
+    memcpy(bytes, buffer->bytes, used);
+    memset(bytes + used, 0, capacity + 1 - used);
+    FreeBufferBytes(buffer);
+    buffer->bytes = bytes;
+    buffer->tail = bytes + used;
+    buffer->capacity = capacity;
+}
+
+void SetBufferLimit(Buffer *buffer, int maxSize)
+{
+    buffer->maxSize = MAX(maxSize, buffer->capacity);
+}
+
+void DestroyBuffer(Buffer *buffer)
+{
+    FreeBufferBytes(buffer);
+    PoolFree(&bufferPool, buffer);
 }
 
 void ClearBuffer(Buffer *buffer)
 {
+    uint8_t *bytes = NULL;
+
+    /* Give back the space a burst of output needed. */
+    if (buffer->capacity > buffer->initialSize)
+    {
+        if (buffer->initialSize == CONNECTION_BUFFER_SIZE)
+        {
+            bytes = (uint8_t *)PoolAlloc(&bufferBytesPool);
+        }
+        else
+        {
+            bytes = (uint8_t *)TrackedMalloc(buffer->initialSize + 1);
+        }
+    }
+    if (bytes != NULL)
+    {
+        FreeBufferBytes(buffer);
+        memset(bytes, 0, buffer->initialSize + 1);
+        buffer->bytes = bytes;
+        buffer->capacity = buffer->initialSize;
+    }
     buffer->tail = buffer->bytes;
     buffer->length = 0;
 }
@@ -185,6 +281,19 @@ int BufferRemaining(Buffer *buffer)
     return buffer->maxSize - buffer->length;
 }
 
+/**
+ * Subnegotiation data is stored from commandBuffer[2]. Anything past the
+ * end of commandBuffer is dropped, leaving room for the terminator that is
+ * added at commandBuffer[inTelnetSB + 2] when the SE arrives.
+ */
+static void _AddSubnegotiationByte(Buffer *buffer, const char c)
+{
+    if (buffer->inTelnetSB + 3 < (int)sizeof(buffer->commandBuffer))
+    {
+        buffer->commandBuffer[1 + buffer->inTelnetSB++] = c;
+    }
+}
+
 int WriteToBuffer(Buffer *buffer, const char *data, int length)
 {
     int i;
@@ -193,7 +302,7 @@ int WriteToBuffer(Buffer *buffer, const char *data, int length)
 
     for (i = 0; i < length; i++)
     {
-        if (FALSE)
+#ifdef VBBS_TRACE_BUFFER
         Debug(
             "Writing byte %d: '%c' (0x%02X) T: %d DB: %d Size: %4d, Max: %4d",
             i,
@@ -202,15 +311,23 @@ int WriteToBuffer(Buffer *buffer, const char *data, int length)
             buffer->inTelnet, buffer->inTelnetSB,
             buffer->tail - buffer->bytes,
             buffer->maxSize);
+#endif
 
-        if (buffer->tail - buffer->bytes >= buffer->maxSize)
+        /* Keep room for a CR+LF, growing if the buffer may. */
+        if (buffer->tail - buffer->bytes >= buffer->capacity - 1 &&
+            buffer->capacity < buffer->maxSize)
+        {
+            GrowBuffer(buffer);
+        }
+
+        if (buffer->tail - buffer->bytes >= buffer->capacity)
         {
             break;
         }
 
         if (data[i] == '\n' && buffer->convertNewlines)
         {
-            if (buffer->tail - buffer->bytes >= buffer->maxSize - 1)
+            if (buffer->tail - buffer->bytes >= buffer->capacity - 1)
             {
                 i--; /* Not enough space for CR+LF */
                 break;
@@ -221,25 +338,29 @@ int WriteToBuffer(Buffer *buffer, const char *data, int length)
             _EchoData(buffer, '\r');
             _EchoData(buffer, '\n');
         }
-        else if(data[i] == (char)TELNET_IAC && buffer->handleTelnet)
+        else if (data[i] == (char)TELNET_IAC && buffer->handleTelnet &&
+            buffer->inTelnet < 2)
         {
             if (buffer->inTelnet == 0)
             {
                 /* Start of Telnet command */
                 buffer->inTelnet = 1;
             }
-            else if (buffer->inTelnet > 0 && buffer->inTelnet < 3)
+            else
             {
-                /* Continue processing Telnet command */
-                buffer->commandBuffer[buffer->inTelnet++] = data[i];
+                /* IAC IAC is an escaped 0xFF data byte */
+                buffer->inTelnet = 0;
+                if (buffer->inTelnetSB > 0)
+                {
+                    _AddSubnegotiationByte(buffer, data[i]);
+                }
+                else
+                {
+                    *buffer->tail++ = data[i];
+                    _EchoData(buffer, data[i]);
+                }
             }
         }
-        else if (buffer->inTelnet == 0 && data[i] == (char)TELNET_IAC &&
-            buffer->handleTelnet)
-        {
-            /* Start processing Telnet command */
-            buffer->inTelnet = 1;
-        }
         else if (buffer->inTelnet > 0)
         {
             buffer->commandBuffer[buffer->inTelnet - 1] = data[i];
@@ -264,13 +385,15 @@ int WriteToBuffer(Buffer *buffer, const char *data, int length)
                     case TELNET_OPTION_TERMINAL_TYPE:
                         strncpy(tmp,
                                (const char *)&buffer->commandBuffer[3],
-                               buffer->inTelnetSB - 1);
+                               sizeof(tmp) - 1);
+                        tmp[sizeof(tmp) - 1] = '\0';
                         _SetTerminalType(buffer, tmp);
                         break;
                     case TELNET_OPTION_TERMINAL_SPEED:
                         strncpy(tmp,
                             (const char *)&buffer->commandBuffer[3],
-                            buffer->inTelnetSB - 1);
+                            sizeof(tmp) - 1);
+                        tmp[sizeof(tmp) - 1] = '\0';
                         _SetConnectionSpeed(buffer, tmp);
                         break;
                     default:
@@ -291,6 +414,11 @@ int WriteToBuffer(Buffer *buffer, const char *data, int length)
                 Debug("Received telnet command: %s %s",
                       TelnetCommand(cmd), TelnetOption(option));
 
+                if (cmd >= TELNET_WILL && cmd <= TELNET_DONT)
+                {
+                    _SetTelnetOption(buffer, cmd, option);
+                }
+
                 if (cmd == TELNET_WILL)
                 {
                     switch (option)
@@ -334,7 +462,7 @@ int WriteToBuffer(Buffer *buffer, const char *data, int length)
         }
         else if (buffer->inTelnetSB > 0)
         {
-            buffer->commandBuffer[1 + buffer->inTelnetSB++] = data[i];
+            _AddSubnegotiationByte(buffer, data[i]);
         }
         else
         {
@@ -408,7 +536,7 @@ void RemoveFromBuffer(Buffer *buffer, int offset, int length)
 
 InputBuffer *NewInputBuffer(int size)
 {
-    InputBuffer *buffer = (InputBuffer *)malloc(sizeof(InputBuffer));
+    InputBuffer *buffer = (InputBuffer *)PoolAlloc(&inputBufferPool);
     if (buffer == NULL)
     {
         return NULL;
@@ -417,7 +545,7 @@ InputBuffer *NewInputBuffer(int size)
     buffer->buffer = NewBuffer(size);
     if (buffer->buffer == NULL)
     {
-        free(buffer);
+        PoolFree(&inputBufferPool, buffer);
         return NULL;
     }
 
@@ -428,6 +556,7 @@ InputBuffer *NewInputBuffer(int size)
     buffer->inputMode = LINE_INPUT_MODE;
     buffer->nextLine[0] = '\0';
     buffer->nextLineReady = FALSE;
+    buffer->scanned = 0;
 
     memset(buffer->nextLine, 0, sizeof(buffer->nextLine));
     return buffer;
@@ -440,7 +569,7 @@ void DestroyInputBuffer(InputBuffer *buffer)
         DestroyBuffer(buffer->buffer);
         buffer->buffer = NULL;
     }
-    free(buffer);
+    PoolFree(&inputBufferPool, buffer);
 }
 
 int ReadDataFromStream(InputBuffer *buffer, FILE *in)
@@ -480,6 +609,7 @@ void SetInputMode(InputBuffer *buffer, InputMode mode)
     buffer->nextLineReady = FALSE; /* Reset next line ready flag */
     ClearNextLine(buffer);          /* Clear next line content */
     ClearBuffer(buffer->buffer); /* Clear the buffer */
+    buffer->scanned = 0;
 }
 
 bool IsNextLineReady(InputBuffer *buffer)
@@ -512,7 +642,7 @@ bool IsNextLineReady(InputBuffer *buffer)
 
 bool FindNextLine(InputBuffer *buffer)
 {
-    int i;
+    int i, j;
     int length;
     uint8_t *buf;
 
@@ -529,41 +659,48 @@ bool FindNextLine(InputBuffer *buffer)
         return FALSE; /* No data to process */
     }
 
-    for (i = 0; i < length; i++)
+    /**
+     * The client may send CR, CR+LF, or CR+NULL (telnet).
+     * We simply ignore any LF or NULL characters, whether or not they
+     * are preceded by a CR. They are squeezed out in a single pass, with j
+     * trailing i, so a long run of them costs no more than a normal line.
+     * Bytes checked by an earlier call are already clean, so a line typed
+     * one character at a time is not rescanned on every keystroke.
+     */
+    if (buffer->scanned > length)
+    {
+        buffer->scanned = 0;
+    }
+    for (i = buffer->scanned, j = buffer->scanned; i < length; i++)
     {
-        if (buf[i] > 0 && buf[i] != '\r' && buf[i] != '\n' &&
-            (buf[i] < 0x20 || buf[i] > 0x7E))
-        {
-            /* Skip non-printable characters */
-            /*Debug("Skipping non-printable character %02X at position %d",
-                buf[i], i);*/
-            continue;
-        }
-        /**
-         * The client may send CR, CR+LF, or CR+NULL (telnet).
-         * We simply ignore any LF or NULL characters, whether or not they
-         * are preceded by a CR.
-         */
         if (buf[i] == '\0' || buf[i] == '\n')
         {
-            RemoveFromBuffer(buffer->buffer, i, 1);
-            length--; /* Adjust length after removal */
-            i--;      /* Adjust index after removal */
             continue;
         }
-        if (buf[i] == '\r')
+        buf[j] = buf[i];
+        if (buf[j] == '\r')
         {
-            /* Found a line ending, copy the line. */
-            strncpy(buffer->nextLine, (char *)buf, i);
+            /* Found a line ending, copy as much of the line as fits. */
+            if (j > (int)sizeof(buffer->nextLine) - 1)
+            {
+                Warn("Input line of %d bytes truncated", j);
+                j = sizeof(buffer->nextLine) - 1;
+            }
+            memcpy(buffer->nextLine, buf, j);
             /* Null-terminate the string */
-            buffer->nextLine[i] = '\0';
+            buffer->nextLine[j] = '\0';
             /* Remove the line from the buffer */
             ShiftBuffer(buffer->buffer, i + 1);
+            buffer->scanned = 0;
             return TRUE; /* Line found */
         }
+        j++;
     }
 
     /* If we reach here, no line ending was found */
+    buffer->buffer->tail = buf + j;
+    buffer->buffer->length = j;
+    buffer->scanned = j;
     buffer->nextLine[0] = '\0'; /* Clear nextLine */
 
     return FALSE; /* No line found */
@@ -582,6 +719,7 @@ bool FindNextCharacter(InputBuffer *buffer)
         buffer->nextLine[0] = buffer->buffer->bytes[0];
         buffer->nextLine[1] = '\0';     /* Null-terminate the string */
         ShiftBuffer(buffer->buffer, 1); /* Remove the character from the buffer */
+        buffer->scanned = 0;
         Debug("Next character: '%s'", buffer->nextLine);
         return TRUE; /* Character found */
     }
@@ -36,10 +36,19 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vbbs/conn/serial.h>
 #include <vbbs/conn/modem.h>
 #include <vbbs/conn/telnet.h>
+#include <vbbs/transfer.h>
+#include <vbbs/pool.h>
+#include <vbbs/metrics.h>
+
+static Pool connectionPool = POOL("connection", sizeof(Connection), 32);
+static int outputLimit = CONNECTION_OUTPUT_LIMIT;
+static int outputHighWater = CONNECTION_OUTPUT_HIGH_WATER;
+static int outputLowWater = CONNECTION_OUTPUT_LOW_WATER;
+static unsigned int outputRate = 0;
 
 Connection *NewConnection(void)
 {
-    Connection *conn = (Connection *)malloc(sizeof(Connection));
+    Connection *conn = (Connection *)PoolAlloc(&connectionPool);
     if (conn == NULL)
     {
         Error("Failed to allocate memory for connection.");
@@ -48,6 +57,12 @@ Connection *NewConnection(void)
     conn->connectionStatus = DISCONNECTED;
     conn->connectionType = CONSOLE;
     conn->connectionSpeed = 9600;
+    conn->outputNanosPerByte = 0;
+    conn->outputReady = 0;
+    if (outputRate > 0)
+    {
+        SetConnectionSpeed(conn, outputRate);
+    }
     strcpy(conn->location, "Unknown");
     strcpy(conn->address, "Unknown");
     conn->inputStream = stdin;
@@ -58,19 +73,24 @@ Connection *NewConnection(void)
     if (conn->inputBuffer == NULL)
     {
         Error("Failed to create input buffer for connection.\n");
-        free(conn);
+        PoolFree(&connectionPool, conn);
         return NULL;
     }
     conn->outputBuffer = NewBuffer(CONNECTION_BUFFER_SIZE);
     if (conn->outputBuffer == NULL)
     {
         Error("Failed to create output buffer for connection.\n");
-        free(conn);
+        DestroyInputBuffer(conn->inputBuffer);
+        PoolFree(&connectionPool, conn);
         return NULL;
     }
     conn->outputBuffer->convertNewlines = TRUE;
+    SetBufferLimit(conn->outputBuffer, outputLimit);
+    conn->outputPaused = FALSE;
     conn->inEscape = FALSE;
     conn->inCSI = FALSE;
+    conn->binaryMode = FALSE;
+    conn->transfer = NULL;
 
     return conn;
 }
@@ -97,6 +117,12 @@ void DestroyConnection(Connection *conn)
             break;
     }
 
+    if (conn->transfer != NULL)
+    {
+        DestroyTransfer(conn->transfer);
+        conn->transfer = NULL;
+    }
+
     if (conn->inputBuffer != NULL)
     {
         DestroyInputBuffer(conn->inputBuffer);
@@ -127,7 +153,7 @@ void DestroyConnection(Connection *conn)
         conn->data = NULL;
     }
 
-    free(conn);
+    PoolFree(&connectionPool, conn);
 }
 
 void Disconnect(Connection *conn, bool closeImmediately)
@@ -182,6 +208,62 @@ void Disconnect(Connection *conn, bool closeImmediately)
     conn->connectionStatus = DISCONNECTED;
 }
 
+bool SetOutputLimits(int limit, int highWater, int lowWater)
+{
+    if (lowWater <= 0 || lowWater >= highWater || highWater > limit)
+    {
+        return FALSE;
+    }
+    outputLimit = limit;
+    outputHighWater = highWater;
+    outputLowWater = lowWater;
+    return TRUE;
+}
+
+void GetOutputLimits(int *limit, int *highWater, int *lowWater)
+{
+    *limit = outputLimit;
+    *highWater = outputHighWater;
+    *lowWater = outputLowWater;
+}
+
+bool IsOutputPaused(Connection *conn)
+{
+    int queued;
+
+    if (conn == NULL || conn->outputBuffer == NULL)
+    {
+        return FALSE;
+    }
+    queued = conn->outputBuffer->length;
+    if (!conn->outputPaused && queued >= outputHighWater)
+    {
+        conn->outputPaused = TRUE;
+        IncrementCounter(&outputPauses);
+    }
+    else if (conn->outputPaused && queued <= outputLowWater)
+    {
+        conn->outputPaused = FALSE;
+    }
+    return conn->outputPaused;
+}
+
+/**
+ * Queue a message, counting anything that didn't fit. That only happens
+ * when a producer ignores IsOutputPaused until the limit is reached.
+ */
+static void QueueOutput(Connection *conn, const char *message)
+{
+    int length = strlen(message);
+    int written = WriteToBuffer(conn->outputBuffer, message, length);
+
+    if (written < length)
+    {
+        AddToCounter(&droppedOutput, (unsigned long)(length - written));
+        Warn("Output buffer full, dropped %d bytes.", length - written);
+    }
+}
+
 void WriteCharToConnection(Connection *conn, char c)
 {
     char message[2];
@@ -193,7 +275,7 @@ void WriteCharToConnection(Connection *conn, char c)
         return;
     }
 
-    WriteStringToBuffer(conn->outputBuffer, message);
+    QueueOutput(conn, message);
 }
 
 void WriteToConnection(Connection *conn, const char *format, ...)
@@ -203,18 +285,96 @@ void WriteToConnection(Connection *conn, const char *format, ...)
 
     va_start(args, format);
     vsnprintf(message, sizeof(message), format, args);
-    WriteStringToBuffer(conn->outputBuffer, message);
+    QueueOutput(conn, message);
     va_end(args);
 }
 
+void SetOutputRate(unsigned int bitsPerSecond)
+{
+    outputRate = bitsPerSecond;
+}
+
+unsigned int GetOutputRate(void)
+{
+    return outputRate;
+}
+
+void SetConnectionSpeed(Connection *conn, unsigned int bitsPerSecond)
+{
+    if (conn == NULL || bitsPerSecond == 0)
+    {
+        return;
+    }
+    bitsPerSecond = MAX(bitsPerSecond, CONNECTION_MIN_SPEED);
+    bitsPerSecond = MIN(bitsPerSecond, CONNECTION_MAX_SPEED);
+    conn->connectionSpeed = bitsPerSecond;
+    if (outputRate > 0)
+    {
+        /* Ten bits a byte, as on an 8N1 serial line. */
+        conn->outputNanosPerByte =
+            (unsigned long)(10000000000.0 / bitsPerSecond);
+    }
+    else
+    {
+        conn->outputNanosPerByte = 0;
+    }
+}
+
+/**
+ * Paced output is a token bucket kept as a single time: outputReady is when
+ * everything sent so far would have cleared the line. A connection may run
+ * up to one burst ahead of that.
+ */
+static unsigned long OutputBurst(Connection *conn)
+{
+    return MAX(CONNECTION_OUTPUT_BURST_NANOS, conn->outputNanosPerByte);
+}
+
+static int OutputAllowance(Connection *conn, unsigned long now)
+{
+    unsigned long ready = MAX(conn->outputReady, now);
+    unsigned long horizon = now + OutputBurst(conn);
+
+    if (ready >= horizon)
+    {
+        return 0;
+    }
+    return (int)((horizon - ready) / conn->outputNanosPerByte);
+}
+
+unsigned long GetOutputDelay(Connection *conn)
+{
+    unsigned long now, burst, due;
+    int wanted;
+
+    if (conn == NULL || conn->outputNanosPerByte == 0 ||
+        conn->outputBuffer == NULL || IsBufferEmpty(conn->outputBuffer))
+    {
+        return 0;
+    }
+    now = MonotonicNanos();
+    burst = OutputBurst(conn);
+    wanted = MIN(conn->outputBuffer->length,
+        (int)(burst / conn->outputNanosPerByte));
+    due = MAX(conn->outputReady, now) +
+        (unsigned long)wanted * conn->outputNanosPerByte;
+    if (due <= now + burst)
+    {
+        return 0;
+    }
+    return due - now - burst;
+}
+
 /** 
  * This is a non-blocking function that writes the contents of the output 
  * buffer to the output stream. It returns the number of bytes written.
  * It will also remove ANSI escape codes if the terminal does not support ANSI.
+ * A paced connection writes no more than its allowance.
  */
 int WriteBufferToConnection(Connection *conn)
 {
-    int bytesWritten = 0, i = 0, n = 0;
+    int bytesWritten = 0, consumed = 0, limit, i = 0, n = 0;
+    unsigned long now = 0;
     char c;
 
     if (conn == NULL || conn->outputBuffer == NULL || 
@@ -223,26 +383,34 @@ int WriteBufferToConnection(Connection *conn)
         return 0;
     }
 
-    do
+    limit = conn->outputBuffer->length;
+    if (conn->outputNanosPerByte > 0)
+    {
+        now = MonotonicNanos();
+        limit = MIN(limit, OutputAllowance(conn, now));
+        if (limit < conn->outputBuffer->length)
+        {
+            IncrementCounter(&outputDelays);
+        }
+    }
+
+    while (limit > 0)
     {
         n = 0;
         if (conn->terminal.isANSI)
         {
             /* Since the terminal supports ANSI, just write the whole
                 buffer out if possible. */
-            n = WriteBufferToStream(conn->outputBuffer, conn->outputStream);
-            if (n <= 0)
-            {
-                /* Can't write anymore, return. */
-                break;
-            }
+            n = fwrite(conn->outputBuffer->bytes, 1, limit,
+                conn->outputStream);
+            consumed = n;
         }
         else
         {
             /* If the terminal does not support ANSI, we need to strip the 
              * escape codes. */
 
-            for (i = 0; i < conn->outputBuffer->length; i++)
+            for (i = 0; i < limit; i++)
             {
                 c = conn->outputBuffer->bytes[i];
                 if (conn->inEscape)
@@ -275,8 +443,7 @@ int WriteBufferToConnection(Connection *conn)
                 }
                 else
                 {
-                    n = fputc(c, conn->outputStream);
-                    if (n == EOF)
+                    if (fputc(c, conn->outputStream) == EOF)
                     {
                         /* Can't write anymore, return. */
                         break;
@@ -284,13 +451,26 @@ int WriteBufferToConnection(Connection *conn)
                     n++;
                 }
             } 
+            consumed = i;
 
         } /* end ANSI support check */
-        ShiftBuffer(conn->outputBuffer, n);
+        if (consumed <= 0)
+        {
+            /* Can't write anymore, return. */
+            break;
+        }
+        ShiftBuffer(conn->outputBuffer, consumed);
         bytesWritten += n;
-    } while (n > 0);
+        limit -= consumed;
+    }
  
     fflush(conn->outputStream);
 
+    if (conn->outputNanosPerByte > 0)
+    {
+        conn->outputReady = MAX(conn->outputReady, now) +
+            (unsigned long)bytesWritten * conn->outputNanosPerByte;
+    }
+
     return bytesWritten;
 }
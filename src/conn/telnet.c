@@ -78,5 +78,10 @@ int TelnetRemotePort(Connection *conn)
     return -1;
 }
 
+uint32_t TelnetRemoteIP(Connection *conn)
+{
+    return 0;
+}
+
 #endif
 
@@ -29,6 +29,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vbbs/log.h>
 #include <vbbs/conn.h>
 #include <vbbs/conn/telnet.h>
+#include <vbbs/pool.h>
 
 /***** UNIX Implementation Using Berkeley Sockets *****/
 
@@ -43,6 +44,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sys/types.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <fcntl.h>
 
 #define MAX_REQUESTS 5
@@ -53,6 +55,8 @@ typedef struct
     struct sockaddr_in remoteAddress;
 } TelnetConnectionData;
 
+static Pool telnetDataPool = POOL("telnet", sizeof(TelnetConnectionData), 32);
+
 TelnetListener* NewTelnetListener(int port)
 {
     int sockfd, opt;
@@ -111,7 +115,7 @@ Connection* TelnetListenerAccept(TelnetListener *listener)
 {
     TelnetConnectionData *telnetData = NULL;
     Connection *conn = NULL;
-    int sockfd = 0;
+    int sockfd = 0, opt;
     struct sockaddr_in remoteAddress;
     socklen_t addr_len = sizeof(remoteAddress);
 
@@ -127,7 +131,7 @@ Connection* TelnetListenerAccept(TelnetListener *listener)
         inet_ntoa(remoteAddress.sin_addr), 
         ntohs(remoteAddress.sin_port));
     
-    telnetData = (TelnetConnectionData *)malloc(sizeof(TelnetConnectionData));
+    telnetData = (TelnetConnectionData *)PoolAlloc(&telnetDataPool);
     if (telnetData == NULL)
     {
         Error("Telnet: Memory allocation failed for connection data.");
@@ -140,7 +144,7 @@ Connection* TelnetListenerAccept(TelnetListener *listener)
     if (conn == NULL)
     {
         Error("Telnet: Memory allocation failed for connection.");
-        free(telnetData);
+        PoolFree(&telnetDataPool, telnetData);
         close(sockfd);
         return NULL;
     }
@@ -149,15 +153,20 @@ Connection* TelnetListenerAccept(TelnetListener *listener)
     conn->data = telnetData;
     /* enable non-blocking I/O */
     fcntl(sockfd, F_SETFL, O_NONBLOCK); 
+    /**
+     * Output is already gathered into one write per pass of the event loop.
+     * Without this a reply that follows an echo, e.g. once a password check
+     * completes, waits for the caller's delayed ACK.
+     */
+    opt = 1;
+    setsockopt(sockfd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
 
     conn->inputStream = fdopen(sockfd, "r");
     conn->outputStream = fdopen(sockfd, "w");
     if (conn->inputStream == NULL || conn->outputStream == NULL)
     {
         Error("Telnet: Failed to open streams for connection.");
-        free(telnetData);
-        free(conn);
-        close(sockfd);
+        DestroyConnection(conn);
         return NULL;
     }
     /** Disable stream buffering */
@@ -223,6 +232,8 @@ void DestroyTelnetConnection(Connection *conn)
         Debug("Telnet: Connection closed from %s:%d", 
             inet_ntoa(telnetData->remoteAddress.sin_addr), 
             ntohs(telnetData->remoteAddress.sin_port));
+        PoolFree(&telnetDataPool, telnetData);
+        conn->data = NULL;
     }
 }
 
@@ -248,4 +259,15 @@ int TelnetRemotePort(Connection *conn)
     return ntohs(telnetData->remoteAddress.sin_port);
 }
 
+uint32_t TelnetRemoteIP(Connection *conn)
+{
+    TelnetConnectionData *telnetData = NULL;
+    if (conn == NULL || conn->data == NULL)
+    {
+        return 0;
+    }
+    telnetData = (TelnetConnectionData *)conn->data;
+    return (uint32_t)ntohl(telnetData->remoteAddress.sin_addr.s_addr);
+}
+
 #endif /* _POSIX_VERSION */
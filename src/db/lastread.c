@@ -0,0 +1,508 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/log.h>
+#include <vbbs/list.h>
+#include <vbbs/db/msg.h>
+#include <vbbs/db/lastread.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _POSIX_VERSION
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+#endif
+
+#define ROW_SIZE(db) ((long)(db)->header->areaStride * sizeof(uint32_t))
+#define ROW_OFFSET(db, userID) \
+   ((long)sizeof(LastReadHeader) + (long)(userID) * ROW_SIZE(db))
+
+LastReadDB *lastReadDB = NULL;
+
+static bool ReserveLastReadArea(LastReadDB *db, unsigned int areaID);
+
+bool LoadLastReadDB(void)
+{
+   MessageArea *area;
+   int i;
+
+   if (lastReadDB == NULL)
+   {
+      lastReadDB = OpenLastReadDB(LASTREAD_DB_FILE);
+   }
+   if (lastReadDB == NULL)
+   {
+      return FALSE;
+   }
+   /* Widen the rows up front rather than on some caller's first read. */
+   for (i = 0; messageDB != NULL && i < messageDB->areas->size; i++)
+   {
+      area = (MessageArea *) messageDB->areas->items[i];
+      ReserveLastReadArea(lastReadDB, area->areaID);
+   }
+   return TRUE;
+}
+
+uint32_t GetLastRead(unsigned int userID, unsigned int areaID)
+{
+   return _GetLastRead(lastReadDB, userID, areaID);
+}
+
+bool SetLastRead(unsigned int userID, unsigned int areaID, uint32_t number)
+{
+   return _SetLastRead(lastReadDB, userID, areaID, number);
+}
+
+int NewScan(unsigned int userID, NewScanResult *results, int size)
+{
+   return _NewScan(lastReadDB, messageDB, userID, results, size);
+}
+
+#ifdef _POSIX_VERSION
+
+/** Map the file, growing it to hold capacity user rows. */
+static bool MapLastReadDB(LastReadDB *db, uint32_t capacity)
+{
+   long size;
+   void *map;
+   int fd = fileno(db->file);
+
+   if (db->pointers != NULL)
+   {
+      db->headerCopy = *db->header;
+      munmap(db->header, ROW_OFFSET(db, db->header->userCapacity));
+      db->pointers = NULL;
+      db->header = &db->headerCopy;
+   }
+
+   size = ROW_OFFSET(db, capacity);
+   if (ftruncate(fd, size) < 0)
+   {
+      Error("Failed to grow last-read file %s", db->filename);
+      return FALSE;
+   }
+
+   map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   if (map == MAP_FAILED)
+   {
+      Error("Failed to map last-read file %s", db->filename);
+      return FALSE;
+   }
+
+   db->header = (LastReadHeader *) map;
+   db->pointers = (uint32_t *) ((char *) map + sizeof(LastReadHeader));
+   db->header->userCapacity = capacity;
+   db->headerCopy = *db->header;
+   return TRUE;
+}
+
+#endif /* _POSIX_VERSION */
+
+static bool WriteLastReadHeader(LastReadDB *db)
+{
+   if (db->pointers != NULL)
+   {
+      return TRUE;
+   }
+   if (fseek(db->file, 0, SEEK_SET) != 0 ||
+      fwrite(&db->headerCopy, sizeof(LastReadHeader), 1, db->file) != 1)
+   {
+      Error("Failed to write last-read header %s", db->filename);
+      return FALSE;
+   }
+   fflush(db->file);
+   return TRUE;
+}
+
+/**
+ * The stride must be one the rows can be read with, and every user row the
+ * header claims must already be in the file, so a damaged header can't
+ * make the file grow when it is mapped.
+ */
+static bool IsLastReadHeaderValid(const LastReadHeader *header,
+   long fileSize)
+{
+   unsigned long rows;
+
+   if (memcmp(header->magic, LASTREAD_MAGIC, 4) != 0 ||
+      header->areaStride == 0 || header->areaStride > LASTREAD_MAX_AREAS)
+   {
+      return FALSE;
+   }
+   rows = (unsigned long) (fileSize - (long) sizeof(LastReadHeader)) /
+      ((unsigned long) header->areaStride * sizeof(uint32_t));
+   return header->userCapacity <= rows;
+}
+
+/**
+ * Open the file and map it, creating it if need be. On failure db is left
+ * for CloseLastReadFile to tidy up.
+ */
+static bool OpenLastReadFile(LastReadDB *db)
+{
+   size_t n;
+
+   db->header = &db->headerCopy;
+   db->file = fopen(db->filename, "r+b");
+   if (db->file == NULL)
+   {
+      db->file = fopen(db->filename, "w+b");
+   }
+   if (db->file == NULL)
+   {
+      Error("Failed to open last-read file: %s", db->filename);
+      return FALSE;
+   }
+
+   n = fread(&db->headerCopy, sizeof(LastReadHeader), 1, db->file);
+   if (n != 1)
+   {
+      memset(&db->headerCopy, 0, sizeof(LastReadHeader));
+      memcpy(db->headerCopy.magic, LASTREAD_MAGIC, 4);
+      db->headerCopy.version = LASTREAD_VERSION;
+      db->headerCopy.areaStride = LASTREAD_AREA_GROWTH;
+      if (!WriteLastReadHeader(db))
+      {
+         return FALSE;
+      }
+   }
+   else if (fseek(db->file, 0, SEEK_END) != 0 ||
+      !IsLastReadHeaderValid(&db->headerCopy, ftell(db->file)))
+   {
+      Error("Last-read file %s is not valid", db->filename);
+      return FALSE;
+   }
+
+   db->row = (uint32_t *) malloc(ROW_SIZE(db));
+   if (db->row == NULL)
+   {
+      Error("Failed to allocate memory for last-read database");
+      return FALSE;
+   }
+
+#ifdef _POSIX_VERSION
+   if (!MapLastReadDB(db, MAX(db->headerCopy.userCapacity,
+      LASTREAD_USER_GROWTH)))
+   {
+      return FALSE;
+   }
+#endif
+   return TRUE;
+}
+
+static void CloseLastReadFile(LastReadDB *db)
+{
+   SyncLastReadDB(db);
+#ifdef _POSIX_VERSION
+   if (db->pointers != NULL)
+   {
+      munmap(db->header, ROW_OFFSET(db, db->header->userCapacity));
+      db->pointers = NULL;
+   }
+#endif
+   if (db->file != NULL)
+   {
+      fclose(db->file);
+      db->file = NULL;
+   }
+   if (db->row != NULL)
+   {
+      free(db->row);
+      db->row = NULL;
+   }
+   /* Anything left reads as unread and can't be written. */
+   memset(&db->headerCopy, 0, sizeof(LastReadHeader));
+   db->header = &db->headerCopy;
+}
+
+LastReadDB *OpenLastReadDB(const char *filename)
+{
+   LastReadDB *db;
+
+   if (filename == NULL)
+   {
+      return NULL;
+   }
+
+   db = (LastReadDB *) malloc(sizeof(LastReadDB));
+   if (db == NULL)
+   {
+      Error("Failed to allocate memory for last-read database");
+      return NULL;
+   }
+   memset(db, 0, sizeof(LastReadDB));
+   db->header = &db->headerCopy;
+   db->filename = strdup(filename);
+   if (db->filename == NULL || !OpenLastReadFile(db))
+   {
+      CloseLastReadDB(db);
+      return NULL;
+   }
+   return db;
+}
+
+void SyncLastReadDB(LastReadDB *db)
+{
+   if (db == NULL)
+   {
+      return;
+   }
+#ifdef _POSIX_VERSION
+   if (db->pointers != NULL)
+   {
+      msync(db->header, ROW_OFFSET(db, db->header->userCapacity), MS_ASYNC);
+   }
+#endif
+   if (db->file != NULL)
+   {
+      fflush(db->file);
+   }
+}
+
+void CloseLastReadDB(LastReadDB *db)
+{
+   if (db == NULL)
+   {
+      return;
+   }
+   CloseLastReadFile(db);
+   if (db->filename != NULL)
+   {
+      free(db->filename);
+   }
+   free(db);
+}
+
+/**
+ * Return a user's row of pointers. Users past the end of the file have not
+ * read anything, so NULL is returned and treated as all zeros.
+ */
+static const uint32_t *GetLastReadRow(LastReadDB *db, unsigned int userID)
+{
+   if (userID >= db->header->userCapacity)
+   {
+      return NULL;
+   }
+   if (db->pointers != NULL)
+   {
+      return db->pointers + (long) userID * db->header->areaStride;
+   }
+   if (fseek(db->file, ROW_OFFSET(db, userID), SEEK_SET) != 0 ||
+      fread(db->row, ROW_SIZE(db), 1, db->file) != 1)
+   {
+      return NULL;
+   }
+   return db->row;
+}
+
+/**
+ * Rewrite the file with rows wide enough for areaID, copying every user's
+ * pointers across, then reopen it.
+ */
+static bool WidenLastReadRows(LastReadDB *db, unsigned int areaID)
+{
+   LastReadHeader header = *db->header;
+   const uint32_t *row;
+   uint32_t *wide;
+   char *temp;
+   FILE *out = NULL;
+   uint32_t user;
+   long oldSize = ROW_SIZE(db);
+   bool ok;
+
+   header.areaStride = MIN((areaID / LASTREAD_AREA_GROWTH + 1) *
+      LASTREAD_AREA_GROWTH, LASTREAD_MAX_AREAS);
+   wide = (uint32_t *) malloc(header.areaStride * sizeof(uint32_t));
+   temp = (char *) malloc(strlen(db->filename) + 5);
+   if (wide != NULL && temp != NULL)
+   {
+      sprintf(temp, "%s.tmp", db->filename);
+      out = fopen(temp, "wb");
+   }
+   ok = out != NULL &&
+      fwrite(&header, sizeof(LastReadHeader), 1, out) == 1;
+   for (user = 0; ok && user < header.userCapacity; user++)
+   {
+      memset(wide, 0, header.areaStride * sizeof(uint32_t));
+      row = GetLastReadRow(db, user);
+      if (row != NULL)
+      {
+         memcpy(wide, row, oldSize);
+      }
+      ok = fwrite(wide, sizeof(uint32_t), header.areaStride, out) ==
+         header.areaStride;
+   }
+   if (out != NULL && fclose(out) != 0)
+   {
+      ok = FALSE;
+   }
+
+   if (ok)
+   {
+      CloseLastReadFile(db);
+      ok = rename(temp, db->filename) == 0;
+      if (!OpenLastReadFile(db))
+      {
+         ok = FALSE;
+      }
+   }
+   if (ok)
+   {
+      Info("Widened last-read rows in %s to %lu areas", db->filename,
+         (unsigned long) header.areaStride);
+   }
+   else
+   {
+      Error("Failed to widen last-read rows in %s", db->filename);
+      if (temp != NULL)
+      {
+         remove(temp);
+      }
+   }
+   free(wide);
+   free(temp);
+   return ok;
+}
+
+/** Make sure the rows have a column for areaID. */
+static bool ReserveLastReadArea(LastReadDB *db, unsigned int areaID)
+{
+   if (areaID < db->header->areaStride)
+   {
+      return TRUE;
+   }
+   if (areaID >= LASTREAD_MAX_AREAS)
+   {
+      Warn("Area %u is past the last-read limit of %d areas", areaID,
+         LASTREAD_MAX_AREAS);
+      return FALSE;
+   }
+   return db->file != NULL && WidenLastReadRows(db, areaID);
+}
+
+uint32_t _GetLastRead(LastReadDB *db, unsigned int userID,
+   unsigned int areaID)
+{
+   const uint32_t *row;
+
+   if (db == NULL || areaID >= db->header->areaStride)
+   {
+      return 0;
+   }
+   row = GetLastReadRow(db, userID);
+   return row == NULL ? 0 : row[areaID];
+}
+
+bool _SetLastRead(LastReadDB *db, unsigned int userID, unsigned int areaID,
+   uint32_t number)
+{
+   uint32_t capacity;
+   long offset;
+
+   if (db == NULL || !ReserveLastReadArea(db, areaID))
+   {
+      return FALSE;
+   }
+
+   if (userID >= db->header->userCapacity)
+   {
+      capacity = (userID / LASTREAD_USER_GROWTH + 1) * LASTREAD_USER_GROWTH;
+#ifdef _POSIX_VERSION
+      if (!MapLastReadDB(db, capacity))
+      {
+         return FALSE;
+      }
+#else
+      /* Rows past the old end of the file are filled with zeros. */
+      memset(db->row, 0, ROW_SIZE(db));
+      while (db->headerCopy.userCapacity < capacity)
+      {
+         if (fseek(db->file, ROW_OFFSET(db, db->headerCopy.userCapacity),
+            SEEK_SET) != 0 ||
+            fwrite(db->row, ROW_SIZE(db), 1, db->file) != 1)
+         {
+            Error("Failed to grow last-read file %s", db->filename);
+            return FALSE;
+         }
+         db->headerCopy.userCapacity++;
+      }
+      WriteLastReadHeader(db);
+#endif
+   }
+
+   if (db->pointers != NULL)
+   {
+      db->pointers[(long) userID * db->header->areaStride + areaID] = number;
+      return TRUE;
+   }
+
+   offset = ROW_OFFSET(db, userID) + (long) areaID * sizeof(uint32_t);
+   if (fseek(db->file, offset, SEEK_SET) != 0 ||
+      fwrite(&number, sizeof(uint32_t), 1, db->file) != 1)
+   {
+      Error("Failed to write last-read pointer to %s", db->filename);
+      return FALSE;
+   }
+   fflush(db->file);
+   return TRUE;
+}
+
+int _NewScan(LastReadDB *db, MessageDB *messages, unsigned int userID,
+   NewScanResult *results, int size)
+{
+   const uint32_t *row;
+   MessageArea *area;
+   NewScanResult *result;
+   uint32_t stride;
+   int i, count;
+
+   if (db == NULL || messages == NULL || results == NULL || size < 0)
+   {
+      return -1;
+   }
+
+   row = GetLastReadRow(db, userID);
+   stride = db->header->areaStride;
+   count = MIN(size, messages->areas->size);
+
+   for (i = 0; i < count; i++)
+   {
+      area = (MessageArea *) messages->areas->items[i];
+      result = &results[i];
+      result->areaID = area->areaID;
+      result->highWater = area->header->highWater;
+      result->lastRead = (row != NULL && area->areaID < stride) ?
+         row[area->areaID] : 0;
+      /* A pointer past the high-water mark means the area was reset. */
+      result->unread = result->highWater > result->lastRead ?
+         result->highWater - result->lastRead : 0;
+   }
+
+   return count;
+}
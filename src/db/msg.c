@@ -0,0 +1,704 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/db.h>
+#include <vbbs/log.h>
+#include <vbbs/msg.h>
+#include <vbbs/db/msg.h>
+#include <time.h>
+
+#ifdef _POSIX_VERSION
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+#endif
+
+#define INDEX_OFFSET(n) \
+   ((long)sizeof(MessageIndexHeader) + (long)((n) - 1) * sizeof(MessageHeader))
+
+MessageDB *messageDB = NULL;
+static MessagePostHandler postHandler = NULL;
+
+static void MessageAreaDestructor(void *item)
+{
+   CloseMessageArea((MessageArea *) item);
+}
+
+MessageDB *NewMessageDB(const char *filename)
+{
+   const char *separator;
+   MessageDB *db = (MessageDB *) malloc(sizeof(MessageDB));
+   if (db == NULL)
+   {
+      Error("Failed to allocate memory for message database");
+      return NULL;
+   }
+   db->filename = strdup(filename);
+   /* Area files are kept next to the area list. */
+   db->directory = strdup(filename);
+   separator = strrchr(filename, PATH_SEPARATOR);
+   db->directory[separator == NULL ? 0 : separator - filename + 1] = '\0';
+   db->nextAreaID = 1;
+   /* This list owns the open message areas. */
+   db->areas = NewArrayList(10, MessageAreaDestructor);
+   return db;
+}
+
+void DestroyMessageDB(MessageDB *db)
+{
+   if (db == NULL)
+   {
+      return;
+   }
+   if (db->filename)
+   {
+      free(db->filename);
+   }
+   if (db->directory)
+   {
+      free(db->directory);
+   }
+   if (db->areas)
+   {
+      DestroyArrayList(db->areas);
+   }
+   free(db);
+}
+
+bool LoadMessageDB(void)
+{
+   if (messageDB == NULL)
+   {
+      messageDB = NewMessageDB(MESSAGE_DB_FILE);
+      if (messageDB == NULL)
+      {
+         Error("Failed to create message database");
+         return FALSE;
+      }
+   }
+   return _LoadMessageDB(messageDB);
+}
+
+bool _LoadMessageDB(MessageDB *db)
+{
+   FILE *file;
+   MessageArea *area;
+   char value[256];
+   char name[41];
+   char description[81];
+   unsigned int areaID;
+   int fieldNum, i, c;
+
+   if (db == NULL)
+   {
+      return FALSE;
+   }
+
+   file = fopen(db->filename, "rb");
+   if (file == NULL)
+   {
+      /* Nothing has been posted yet. */
+      Info("No message database found at %s", db->filename);
+      return TRUE;
+   }
+
+   memset(value, 0, sizeof(value));
+   name[0] = '\0';
+   description[0] = '\0';
+   areaID = 0;
+   fieldNum = 0;
+   i = 0;
+
+   while ((c = fgetc(file)) != EOF)
+   {
+      if (c == DB_FIELD_SEPARATOR || c == DB_RECORD_SEPARATOR)
+      {
+         value[i] = '\0';
+         switch (fieldNum)
+         {
+            case 0:
+               areaID = strtoul(value, NULL, 10);
+               break;
+            case 1:
+               strncpy(name, value, sizeof(name) - 1);
+               name[sizeof(name) - 1] = '\0';
+               break;
+            case 2:
+               strncpy(description, value, sizeof(description) - 1);
+               description[sizeof(description) - 1] = '\0';
+               break;
+         }
+         fieldNum++;
+         i = 0;
+
+         if (c == DB_RECORD_SEPARATOR)
+         {
+            if (areaID != 0 && _GetMessageAreaByID(db, areaID) == NULL)
+            {
+               area = OpenMessageArea(db->directory, areaID, name,
+                  description);
+               if (area != NULL)
+               {
+                  AddToArrayList(db->areas, area);
+                  if (areaID >= db->nextAreaID)
+                  {
+                     db->nextAreaID = areaID + 1;
+                  }
+               }
+            }
+            areaID = 0;
+            name[0] = '\0';
+            description[0] = '\0';
+            fieldNum = 0;
+         }
+      }
+      else if (c != '\r' && c != '\n' && i < (int)sizeof(value) - 1)
+      {
+         value[i++] = (char) c;
+      }
+   }
+
+   fclose(file);
+   return TRUE;
+}
+
+bool SaveMessageDB(void)
+{
+   if (messageDB == NULL)
+   {
+      return FALSE;
+   }
+   return _SaveMessageDB(messageDB);
+}
+
+bool _SaveMessageDB(MessageDB *db)
+{
+   FILE *file;
+   MessageArea *area;
+   int i;
+
+   if (db == NULL || db->filename == NULL || db->areas == NULL)
+   {
+      return FALSE;
+   }
+
+   file = fopen(db->filename, "wb");
+   if (file == NULL)
+   {
+      Error("Failed to open message database file for writing: %s",
+         db->filename);
+      return FALSE;
+   }
+
+   for (i = 0; i < db->areas->size; i++)
+   {
+      area = (MessageArea *) GetFromArrayList(db->areas, i);
+      if (area == NULL)
+      {
+         continue;
+      }
+      fprintf(file, "%u%c%s%c%s%c\n", area->areaID, DB_FIELD_SEPARATOR,
+         area->name, DB_FIELD_SEPARATOR, area->description,
+         DB_RECORD_SEPARATOR);
+      SyncMessageArea(area);
+   }
+
+   fflush(file);
+   fclose(file);
+   return TRUE;
+}
+
+MessageArea *AddMessageArea(const char *name, const char *description)
+{
+   if (messageDB == NULL)
+   {
+      return NULL;
+   }
+   return _AddMessageArea(messageDB, name, description);
+}
+
+MessageArea *_AddMessageArea(MessageDB *db, const char *name,
+   const char *description)
+{
+   MessageArea *area;
+
+   if (db == NULL || name == NULL)
+   {
+      return NULL;
+   }
+
+   area = OpenMessageArea(db->directory, db->nextAreaID, name, description);
+   if (area == NULL)
+   {
+      return NULL;
+   }
+   db->nextAreaID++;
+   AddToArrayList(db->areas, area);
+   Debug("Added message area: %s, ID: %u", area->name, area->areaID);
+   return area;
+}
+
+MessageArea *GetMessageAreaByID(unsigned int areaID)
+{
+   if (messageDB == NULL)
+   {
+      return NULL;
+   }
+   return _GetMessageAreaByID(messageDB, areaID);
+}
+
+MessageArea *_GetMessageAreaByID(MessageDB *db, unsigned int areaID)
+{
+   int i;
+   MessageArea *area;
+   if (db == NULL || db->areas == NULL)
+   {
+      return NULL;
+   }
+   for (i = 0; i < db->areas->size; i++)
+   {
+      area = (MessageArea *) GetFromArrayList(db->areas, i);
+      if (area != NULL && area->areaID == areaID)
+      {
+         return area;
+      }
+   }
+   return NULL;
+}
+
+MessageArea *GetMessageAreaByName(const char *name)
+{
+   if (messageDB == NULL)
+   {
+      return NULL;
+   }
+   return _GetMessageAreaByName(messageDB, name);
+}
+
+MessageArea *_GetMessageAreaByName(MessageDB *db, const char *name)
+{
+   int i;
+   MessageArea *area;
+   if (db == NULL || db->areas == NULL || name == NULL)
+   {
+      return NULL;
+   }
+   for (i = 0; i < db->areas->size; i++)
+   {
+      area = (MessageArea *) GetFromArrayList(db->areas, i);
+      if (area != NULL && strcasecmp(name, area->name) == 0)
+      {
+         return area;
+      }
+   }
+   return NULL;
+}
+
+int GetMessageAreaCount(void)
+{
+   if (messageDB == NULL)
+   {
+      return 0;
+   }
+   return _GetMessageAreaCount(messageDB);
+}
+
+int _GetMessageAreaCount(MessageDB *db)
+{
+   if (db == NULL || db->areas == NULL)
+   {
+      return 0;
+   }
+   return db->areas->size;
+}
+
+/********** Message Areas **********/
+
+#ifdef _POSIX_VERSION
+
+/** Map the index file, growing it to hold capacity headers. */
+static bool MapMessageIndex(MessageArea *area, uint32_t capacity)
+{
+   long size = INDEX_OFFSET(capacity + 1);
+   void *map;
+   int fd = fileno(area->index);
+
+   if (area->records != NULL)
+   {
+      area->headerCopy = *area->header;
+      munmap(area->header, INDEX_OFFSET(area->header->capacity + 1));
+      area->records = NULL;
+      area->header = &area->headerCopy;
+   }
+
+   if (ftruncate(fd, size) < 0)
+   {
+      Error("Failed to grow message index %s", area->indexFilename);
+      return FALSE;
+   }
+
+   map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   if (map == MAP_FAILED)
+   {
+      Error("Failed to map message index %s", area->indexFilename);
+      return FALSE;
+   }
+
+   area->header = (MessageIndexHeader *) map;
+   area->records = (MessageHeader *) ((char *) map +
+      sizeof(MessageIndexHeader));
+   area->header->capacity = capacity;
+   area->headerCopy = *area->header;
+   return TRUE;
+}
+
+#endif /* _POSIX_VERSION */
+
+static bool WriteIndexHeader(MessageArea *area)
+{
+   if (area->records != NULL)
+   {
+      /* The header is written through the map. */
+      return TRUE;
+   }
+   if (fseek(area->index, 0, SEEK_SET) != 0 ||
+      fwrite(&area->headerCopy, sizeof(MessageIndexHeader), 1,
+         area->index) != 1)
+   {
+      Error("Failed to write message index header %s", area->indexFilename);
+      return FALSE;
+   }
+   fflush(area->index);
+   return TRUE;
+}
+
+/**
+ * Every message posted must have a header in the file, and a mapped index
+ * has room for them all. slots is the number of headers the file holds.
+ */
+static bool IsIndexHeaderValid(const MessageIndexHeader *header,
+   unsigned long slots)
+{
+   if (header->highWater > slots)
+   {
+      return FALSE;
+   }
+#ifdef _POSIX_VERSION
+   if (header->highWater > header->capacity || header->capacity > slots)
+   {
+      return FALSE;
+   }
+#endif
+   return TRUE;
+}
+
+MessageArea *OpenMessageArea(const char *directory, unsigned int areaID,
+   const char *name, const char *description)
+{
+   MessageArea *area;
+   unsigned long slots = 0;
+   long indexSize;
+   size_t n;
+
+   if (directory == NULL || strlen(directory) > 200)
+   {
+      return NULL;
+   }
+
+   area = (MessageArea *) malloc(sizeof(MessageArea));
+   if (area == NULL)
+   {
+      Error("Failed to allocate memory for message area");
+      return NULL;
+   }
+   memset(area, 0, sizeof(MessageArea));
+   area->areaID = areaID;
+   strncpy(area->name, name == NULL ? "" : name, sizeof(area->name) - 1);
+   strncpy(area->description, description == NULL ? "" : description,
+      sizeof(area->description) - 1);
+   sprintf(area->indexFilename, MESSAGE_AREA_FILE_FORMAT, directory, areaID,
+      MESSAGE_INDEX_EXTENSION);
+   sprintf(area->dataFilename, MESSAGE_AREA_FILE_FORMAT, directory, areaID,
+      MESSAGE_DATA_EXTENSION);
+   area->header = &area->headerCopy;
+
+   area->data = fopen(area->dataFilename, "a+b");
+   if (area->data == NULL)
+   {
+      Error("Failed to open message data file: %s", area->dataFilename);
+      free(area);
+      return NULL;
+   }
+   fseek(area->data, 0, SEEK_END);
+   area->dataSize = ftell(area->data);
+
+   area->index = fopen(area->indexFilename, "r+b");
+   if (area->index == NULL)
+   {
+      area->index = fopen(area->indexFilename, "w+b");
+   }
+   if (area->index == NULL)
+   {
+      Error("Failed to open message index file: %s", area->indexFilename);
+      fclose(area->data);
+      free(area);
+      return NULL;
+   }
+
+   fseek(area->index, 0, SEEK_END);
+   indexSize = ftell(area->index);
+   if (indexSize > (long) sizeof(MessageIndexHeader))
+   {
+      slots = (unsigned long) (indexSize - sizeof(MessageIndexHeader)) /
+         sizeof(MessageHeader);
+   }
+   rewind(area->index);
+   n = fread(&area->headerCopy, sizeof(MessageIndexHeader), 1, area->index);
+   if (n != 1)
+   {
+      /* A new area. */
+      memset(&area->headerCopy, 0, sizeof(MessageIndexHeader));
+      memcpy(area->headerCopy.magic, MESSAGE_INDEX_MAGIC, 4);
+      area->headerCopy.version = MESSAGE_INDEX_VERSION;
+      area->headerCopy.recordSize = sizeof(MessageHeader);
+      area->headerCopy.areaID = areaID;
+      if (!WriteIndexHeader(area))
+      {
+         CloseMessageArea(area);
+         return NULL;
+      }
+   }
+   else if (memcmp(area->headerCopy.magic, MESSAGE_INDEX_MAGIC, 4) != 0 ||
+      area->headerCopy.recordSize != sizeof(MessageHeader))
+   {
+      Error("Message index %s is not a valid index file",
+         area->indexFilename);
+      CloseMessageArea(area);
+      return NULL;
+   }
+   else if (!IsIndexHeaderValid(&area->headerCopy, slots))
+   {
+      Error("Message index %s is corrupt, %lu messages in %lu slots",
+         area->indexFilename, (unsigned long) area->headerCopy.highWater,
+         (unsigned long) area->headerCopy.capacity);
+      CloseMessageArea(area);
+      return NULL;
+   }
+
+#ifdef _POSIX_VERSION
+   if (!MapMessageIndex(area, MAX(area->headerCopy.capacity,
+      MESSAGE_INDEX_GROWTH)))
+   {
+      CloseMessageArea(area);
+      return NULL;
+   }
+#endif
+
+   return area;
+}
+
+void SyncMessageArea(MessageArea *area)
+{
+   if (area == NULL)
+   {
+      return;
+   }
+   if (area->data != NULL)
+   {
+      fflush(area->data);
+      area->dataDirty = FALSE;
+   }
+#ifdef _POSIX_VERSION
+   if (area->records != NULL)
+   {
+      msync(area->header, INDEX_OFFSET(area->header->capacity + 1),
+         MS_ASYNC);
+   }
+#endif
+   if (area->index != NULL)
+   {
+      fflush(area->index);
+   }
+}
+
+void CloseMessageArea(MessageArea *area)
+{
+   if (area == NULL)
+   {
+      return;
+   }
+   SyncMessageArea(area);
+#ifdef _POSIX_VERSION
+   if (area->records != NULL)
+   {
+      munmap(area->header, INDEX_OFFSET(area->header->capacity + 1));
+      area->records = NULL;
+   }
+#endif
+   if (area->index != NULL)
+   {
+      fclose(area->index);
+   }
+   if (area->data != NULL)
+   {
+      fclose(area->data);
+   }
+   free(area);
+}
+
+uint32_t PostMessage(MessageArea *area, MessageHeader *header,
+   const char *body, uint32_t length)
+{
+   uint32_t number;
+
+   if (area == NULL || header == NULL || (body == NULL && length > 0))
+   {
+      return 0;
+   }
+
+   /* The body's offset is stored in 32 bits. */
+   if (length >= MESSAGE_DATA_MAX ||
+      (unsigned long) area->dataSize > MESSAGE_DATA_MAX - 1 - length)
+   {
+      Error("Message area %s is full, its data file would pass %lu bytes",
+         area->dataFilename, MESSAGE_DATA_MAX);
+      return 0;
+   }
+
+   number = area->header->highWater + 1;
+
+#ifdef _POSIX_VERSION
+   if (number > area->header->capacity &&
+      !MapMessageIndex(area, area->header->capacity * 2))
+   {
+      return 0;
+   }
+#endif
+
+   if ((length > 0 && fwrite(body, 1, length, area->data) != length) ||
+      fputc(DB_RECORD_SEPARATOR, area->data) == EOF)
+   {
+      Error("Failed to write message body to %s", area->dataFilename);
+      return 0;
+   }
+
+   header->number = number;
+   header->bodyOffset = (uint32_t) area->dataSize;
+   header->bodyLength = length;
+   if (header->posted == 0)
+   {
+      header->posted = (uint32_t) time(NULL);
+   }
+   area->dataSize += length + 1;
+   area->dataDirty = TRUE;
+
+   if (area->records != NULL)
+   {
+      area->records[number - 1] = *header;
+   }
+   else if (fseek(area->index, INDEX_OFFSET(number), SEEK_SET) != 0 ||
+      fwrite(header, sizeof(MessageHeader), 1, area->index) != 1)
+   {
+      Error("Failed to write message header to %s", area->indexFilename);
+      return 0;
+   }
+
+   area->header->highWater = number;
+   if (area->records == NULL)
+   {
+      WriteIndexHeader(area);
+   }
+   if (postHandler != NULL)
+   {
+      postHandler(area, header);
+   }
+   return number;
+}
+
+void SetMessagePostHandler(MessagePostHandler handler)
+{
+   postHandler = handler;
+}
+
+const MessageHeader *GetMessageHeader(MessageArea *area, uint32_t number)
+{
+   if (area == NULL || number == 0 || number > area->header->highWater)
+   {
+      return NULL;
+   }
+   if (area->records != NULL)
+   {
+      return &area->records[number - 1];
+   }
+   if (fseek(area->index, INDEX_OFFSET(number), SEEK_SET) != 0 ||
+      fread(&area->scratch, sizeof(MessageHeader), 1, area->index) != 1)
+   {
+      return NULL;
+   }
+   return &area->scratch;
+}
+
+int ReadMessageBody(MessageArea *area, const MessageHeader *header,
+   uint32_t offset, char *buffer, int size)
+{
+   long n;
+
+   if (area == NULL || header == NULL || buffer == NULL || size < 0)
+   {
+      return -1;
+   }
+   if (offset >= header->bodyLength)
+   {
+      return 0;
+   }
+   n = MIN((long) size, (long) (header->bodyLength - offset));
+
+   if (area->dataDirty)
+   {
+      /* Recent bodies may still be sitting in the stdio buffer. */
+      fflush(area->data);
+      area->dataDirty = FALSE;
+   }
+#ifdef _POSIX_VERSION
+   return (int) pread(fileno(area->data), buffer, n,
+      (off_t) header->bodyOffset + offset);
+#else
+   if (fseek(area->data, (long) header->bodyOffset + offset, SEEK_SET) != 0)
+   {
+      return -1;
+   }
+   return (int) fread(buffer, 1, n, area->data);
+#endif
+}
+
+uint32_t GetHighWaterMark(MessageArea *area)
+{
+   if (area == NULL)
+   {
+      return 0;
+   }
+   return area->header->highWater;
+}
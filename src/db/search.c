@@ -0,0 +1,1065 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/log.h>
+#include <vbbs/list.h>
+#include <vbbs/msg.h>
+#include <vbbs/search.h>
+#include <vbbs/db/msg.h>
+#include <vbbs/db/search.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define SEARCH_INITIAL_TABLE_SIZE 1024
+
+typedef struct SearchToken
+{
+   uint32_t term;
+   uint32_t position;
+} SearchToken;
+
+typedef struct SearchIndexFileHeader
+{
+   char magic[4];
+   uint32_t version;
+   uint32_t documentCount;
+   uint32_t termCount;
+   uint32_t areaCapacity;
+   uint32_t reserved[3];
+} SearchIndexFileHeader;
+
+typedef struct QueryTerm
+{
+   const PostingList *postings;
+   PostingCursor cursor;
+   int phrase;          /* Phrase number, or -1 if not in a phrase */
+   uint32_t offset;     /* Position of the word within its phrase */
+   uint32_t *positions;
+   uint32_t capacity;
+} QueryTerm;
+
+typedef struct Query
+{
+   SearchIndex *index;
+   QueryTerm terms[SEARCH_MAX_QUERY_TERMS];
+   int termCount;
+   int phraseCount;
+   int phrase;          /* Phrase being parsed, or -1 */
+   bool missing;        /* A word isn't in the index, so nothing matches */
+} Query;
+
+SearchIndex *searchIndex = NULL;
+
+/********** Term Dictionary **********/
+
+/* FNV-1a */
+static uint32_t HashTerm(const char *term, int length)
+{
+   uint32_t hash = 2166136261UL;
+   int i;
+   for (i = 0; i < length; i++)
+   {
+      hash ^= (uint8_t) term[i];
+      hash = (uint32_t) (hash * 16777619UL);
+   }
+   return hash;
+}
+
+/** Find the table slot holding a term, or the empty slot it belongs in. */
+static uint32_t FindTermSlot(SearchIndex *index, const char *term,
+   int length, uint32_t hash)
+{
+   uint32_t mask = index->tableSize - 1;
+   uint32_t slot = hash & mask;
+   SearchTerm *entry;
+
+   while (index->table[slot] != 0)
+   {
+      entry = &index->terms[index->table[slot] - 1];
+      if (entry->hash == hash && strncmp(entry->term, term, length) == 0 &&
+         entry->term[length] == '\0')
+      {
+         break;
+      }
+      slot = (slot + 1) & mask;
+   }
+   return slot;
+}
+
+static bool GrowTermTable(SearchIndex *index)
+{
+   uint32_t *table, size, i, slot;
+
+   size = index->tableSize * 2;
+   table = (uint32_t *) calloc(size, sizeof(uint32_t));
+   if (table == NULL)
+   {
+      Error("Failed to allocate memory for search index");
+      return FALSE;
+   }
+   for (i = 0; i < index->termCount; i++)
+   {
+      slot = index->terms[i].hash & (size - 1);
+      while (table[slot] != 0)
+      {
+         slot = (slot + 1) & (size - 1);
+      }
+      table[slot] = i + 1;
+   }
+   free(index->table);
+   index->table = table;
+   index->tableSize = size;
+   return TRUE;
+}
+
+/** Return the index of a term, adding it if needed, or -1 on failure. */
+static long AddTerm(SearchIndex *index, const char *term, int length)
+{
+   uint32_t hash = HashTerm(term, length);
+   uint32_t slot, capacity;
+   SearchTerm *terms;
+   SearchTerm *entry;
+
+   slot = FindTermSlot(index, term, length, hash);
+   if (index->table[slot] != 0)
+   {
+      return (long) index->table[slot] - 1;
+   }
+
+   /* Keep the table no more than three quarters full. */
+   if ((index->termCount + 1) * 4 > index->tableSize * 3)
+   {
+      if (!GrowTermTable(index))
+      {
+         return -1;
+      }
+      slot = FindTermSlot(index, term, length, hash);
+   }
+   if (index->termCount == index->termCapacity)
+   {
+      capacity = index->termCapacity == 0 ? 256 : index->termCapacity * 2;
+      terms = (SearchTerm *) realloc(index->terms,
+         capacity * sizeof(SearchTerm));
+      if (terms == NULL)
+      {
+         Error("Failed to allocate memory for search index");
+         return -1;
+      }
+      index->terms = terms;
+      index->termCapacity = capacity;
+   }
+
+   entry = &index->terms[index->termCount];
+   entry->term = (char *) malloc(length + 1);
+   if (entry->term == NULL)
+   {
+      Error("Failed to allocate memory for search index");
+      return -1;
+   }
+   memcpy(entry->term, term, length);
+   entry->term[length] = '\0';
+   entry->hash = hash;
+   InitPostingList(&entry->postings);
+   index->table[slot] = ++index->termCount;
+   return (long) index->termCount - 1;
+}
+
+const PostingList *FindSearchTerm(SearchIndex *index, const char *term)
+{
+   int length;
+   uint32_t slot;
+
+   if (index == NULL || term == NULL)
+   {
+      return NULL;
+   }
+   length = (int) strlen(term);
+   slot = FindTermSlot(index, term, length, HashTerm(term, length));
+   if (index->table[slot] == 0)
+   {
+      return NULL;
+   }
+   return &index->terms[index->table[slot] - 1].postings;
+}
+
+/********** Search Index **********/
+
+SearchIndex *NewSearchIndex(const char *filename)
+{
+   SearchIndex *index = (SearchIndex *) malloc(sizeof(SearchIndex));
+   if (index == NULL)
+   {
+      Error("Failed to allocate memory for search index");
+      return NULL;
+   }
+   memset(index, 0, sizeof(SearchIndex));
+   index->filename = filename == NULL ? NULL : strdup(filename);
+   index->tableSize = SEARCH_INITIAL_TABLE_SIZE;
+   index->savedAt = time(NULL);
+   index->table = (uint32_t *) calloc(index->tableSize, sizeof(uint32_t));
+   if (index->table == NULL)
+   {
+      Error("Failed to allocate memory for search index");
+      DestroySearchIndex(index);
+      return NULL;
+   }
+   return index;
+}
+
+void DestroySearchIndex(SearchIndex *index)
+{
+   uint32_t i;
+
+   if (index == NULL)
+   {
+      return;
+   }
+   for (i = 0; i < index->termCount; i++)
+   {
+      free(index->terms[i].term);
+      FreePostingList(&index->terms[i].postings);
+   }
+   free(index->terms);
+   free(index->table);
+   free(index->documents);
+   free(index->indexedHighWater);
+   free(index->tokens);
+   free(index->positions);
+   free(index->text);
+   free(index->filename);
+   free(index);
+}
+
+static bool SetIndexedHighWater(SearchIndex *index, uint32_t areaID,
+   uint32_t number)
+{
+   uint32_t capacity;
+   uint32_t *highWater;
+
+   if (areaID >= index->areaCapacity)
+   {
+      capacity = MAX(16, index->areaCapacity);
+      while (capacity <= areaID)
+      {
+         capacity *= 2;
+      }
+      highWater = (uint32_t *) realloc(index->indexedHighWater,
+         capacity * sizeof(uint32_t));
+      if (highWater == NULL)
+      {
+         Error("Failed to allocate memory for search index");
+         return FALSE;
+      }
+      memset(highWater + index->areaCapacity, 0,
+         (capacity - index->areaCapacity) * sizeof(uint32_t));
+      index->indexedHighWater = highWater;
+      index->areaCapacity = capacity;
+   }
+   if (number > index->indexedHighWater[areaID])
+   {
+      index->indexedHighWater[areaID] = number;
+   }
+   index->dirty = TRUE;
+   return TRUE;
+}
+
+static void AddToken(void *context, const char *term, int length,
+   uint32_t position)
+{
+   SearchIndex *index = (SearchIndex *) context;
+   SearchToken *tokens;
+   uint32_t capacity;
+   long termIndex;
+
+   if (index->failed)
+   {
+      return;
+   }
+   if (index->tokenCount == index->tokenCapacity)
+   {
+      capacity = index->tokenCapacity == 0 ? 256 : index->tokenCapacity * 2;
+      tokens = (SearchToken *) realloc(index->tokens,
+         capacity * sizeof(SearchToken));
+      if (tokens == NULL)
+      {
+         Error("Failed to allocate memory for search index");
+         index->failed = TRUE;
+         return;
+      }
+      index->tokens = tokens;
+      index->tokenCapacity = capacity;
+   }
+   termIndex = AddTerm(index, term, length);
+   if (termIndex < 0)
+   {
+      index->failed = TRUE;
+      return;
+   }
+   index->tokens[index->tokenCount].term = (uint32_t) termIndex;
+   index->tokens[index->tokenCount].position = position;
+   index->tokenCount++;
+}
+
+static int CompareTokens(const void *a, const void *b)
+{
+   const SearchToken *x = (const SearchToken *) a;
+   const SearchToken *y = (const SearchToken *) b;
+
+   if (x->term != y->term)
+   {
+      return x->term < y->term ? -1 : 1;
+   }
+   if (x->position != y->position)
+   {
+      return x->position < y->position ? -1 : 1;
+   }
+   return 0;
+}
+
+bool IndexDocument(SearchIndex *index, uint32_t areaID, uint32_t number,
+   const char *text, size_t length)
+{
+   uint32_t doc, capacity, i, j, count;
+   SearchHit *documents;
+
+   if (index == NULL || (text == NULL && length > 0))
+   {
+      return FALSE;
+   }
+
+   doc = index->documentCount + 1;
+   if (doc >= index->documentCapacity)
+   {
+      capacity = index->documentCapacity == 0 ? 1024 :
+         index->documentCapacity * 2;
+      documents = (SearchHit *) realloc(index->documents,
+         capacity * sizeof(SearchHit));
+      if (documents == NULL)
+      {
+         Error("Failed to allocate memory for search index");
+         return FALSE;
+      }
+      index->documents = documents;
+      index->documentCapacity = capacity;
+   }
+
+   index->tokenCount = 0;
+   index->failed = FALSE;
+   TokenizeText(text, length, AddToken, index);
+   if (index->failed)
+   {
+      return FALSE;
+   }
+
+   /* Claim the ID first so a failure part way can't reuse it. */
+   index->documents[doc].areaID = areaID;
+   index->documents[doc].number = number;
+   index->documentCount = doc;
+
+   /* Group the words so each term gets one posting with all its positions. */
+   qsort(index->tokens, index->tokenCount, sizeof(SearchToken),
+      CompareTokens);
+
+   for (i = 0; i < index->tokenCount; i = j)
+   {
+      for (j = i; j < index->tokenCount &&
+         index->tokens[j].term == index->tokens[i].term; j++)
+      {
+         ;
+      }
+      count = j - i;
+      if (count > index->positionCapacity)
+      {
+         capacity = MAX(count, index->positionCapacity * 2);
+         free(index->positions);
+         index->positions = (uint32_t *) malloc(capacity * sizeof(uint32_t));
+         index->positionCapacity = index->positions == NULL ? 0 : capacity;
+         if (index->positions == NULL)
+         {
+            Error("Failed to allocate memory for search index");
+            return FALSE;
+         }
+      }
+      for (count = 0; count < j - i; count++)
+      {
+         index->positions[count] = index->tokens[i + count].position;
+      }
+      if (!AppendPosting(&index->terms[index->tokens[i].term].postings, doc,
+         index->positions, count))
+      {
+         return FALSE;
+      }
+   }
+
+   return SetIndexedHighWater(index, areaID, number);
+}
+
+bool IndexMessage(SearchIndex *index, MessageArea *area,
+   const MessageHeader *header)
+{
+   size_t subjectLength, size;
+   char *text;
+   int n;
+
+   if (index == NULL || area == NULL || header == NULL)
+   {
+      return FALSE;
+   }
+
+   subjectLength = strlen(header->subject);
+   size = subjectLength + 1 + header->bodyLength;
+   if (size > index->textCapacity)
+   {
+      text = (char *) realloc(index->text, size);
+      if (text == NULL)
+      {
+         Error("Failed to allocate memory for search index");
+         return FALSE;
+      }
+      index->text = text;
+      index->textCapacity = size;
+   }
+
+   memcpy(index->text, header->subject, subjectLength);
+   index->text[subjectLength] = '\n';
+   n = ReadMessageBody(area, header, 0, index->text + subjectLength + 1,
+      (int) header->bodyLength);
+   if (n < 0)
+   {
+      Error("Failed to read message %lu in area %u for indexing",
+         (unsigned long) header->number, area->areaID);
+      return FALSE;
+   }
+   return IndexDocument(index, area->areaID, header->number, index->text,
+      subjectLength + 1 + n);
+}
+
+bool LoadSearchIndex(void)
+{
+   if (searchIndex == NULL)
+   {
+      searchIndex = NewSearchIndex(SEARCH_DB_FILE);
+   }
+   return _LoadSearchIndex(searchIndex);
+}
+
+bool SaveSearchIndex(void)
+{
+   return _SaveSearchIndex(searchIndex);
+}
+
+int UpdateSearchIndex(void)
+{
+   return _UpdateSearchIndex(searchIndex, messageDB);
+}
+
+int SearchMessages(const char *query, SearchHit *hits, int size)
+{
+   return _SearchMessages(searchIndex, query, hits, size);
+}
+
+int SearchVisibleMessages(const char *query, const User *user,
+   SearchHit *hits, int size)
+{
+   return _SearchVisibleMessages(searchIndex, messageDB, user, query, hits,
+      size);
+}
+
+int _UpdateSearchIndex(SearchIndex *index, MessageDB *messages)
+{
+   int i, count = 0;
+
+   if (index == NULL || messages == NULL)
+   {
+      return 0;
+   }
+
+   for (i = 0; i < messages->areas->size; i++)
+   {
+      if (!IndexNewMessages(index,
+         (MessageArea *) messages->areas->items[i], &count))
+      {
+         break;
+      }
+   }
+
+   if (count > 0)
+   {
+      Debug("Indexed %d new messages", count);
+   }
+   return count;
+}
+
+bool IndexNewMessages(SearchIndex *index, MessageArea *area, int *count)
+{
+   const MessageHeader *header;
+   uint32_t number, highWater;
+
+   if (index == NULL || area == NULL)
+   {
+      return FALSE;
+   }
+
+   highWater = GetHighWaterMark(area);
+   number = area->areaID < index->areaCapacity ?
+      index->indexedHighWater[area->areaID] : 0;
+   for (number++; number <= highWater; number++)
+   {
+      header = GetMessageHeader(area, number);
+      if (IsMessageDeleted(header))
+      {
+         SetIndexedHighWater(index, area->areaID, number);
+         continue;
+      }
+      if (!IndexMessage(index, area, header))
+      {
+         return FALSE;
+      }
+      (*count)++;
+   }
+   return TRUE;
+}
+
+void IndexPostedMessage(MessageArea *area, const MessageHeader *header)
+{
+   int count = 0;
+
+   /* Anything missed before this message is picked up with it. */
+   if (searchIndex != NULL && header != NULL &&
+      !IndexNewMessages(searchIndex, area, &count))
+   {
+      Warn("Failed to index message %lu in area %u, retrying on next post",
+         (unsigned long) header->number, area->areaID);
+   }
+}
+
+bool CheckpointSearchIndex(void)
+{
+   return _CheckpointSearchIndex(searchIndex, time(NULL));
+}
+
+bool _CheckpointSearchIndex(SearchIndex *index, time_t now)
+{
+   if (index == NULL || !index->dirty ||
+      difftime(now, index->savedAt) < SEARCH_CHECKPOINT_INTERVAL)
+   {
+      return FALSE;
+   }
+   /* Try again after another interval rather than on every pass. */
+   index->savedAt = now;
+   return _SaveSearchIndex(index);
+}
+
+/********** Persistence **********/
+
+static bool WriteAll(FILE *file, const void *data, size_t size)
+{
+   return size == 0 || fwrite(data, size, 1, file) == 1;
+}
+
+static bool ReadAll(FILE *file, void *data, size_t size)
+{
+   return size == 0 || fread(data, size, 1, file) == 1;
+}
+
+bool _SaveSearchIndex(SearchIndex *index)
+{
+   SearchIndexFileHeader header;
+   SearchTerm *term;
+   PostingList *list;
+   char temp[300];
+   uint32_t i, length;
+   FILE *file;
+   bool ok;
+
+   if (index == NULL || index->filename == NULL)
+   {
+      return FALSE;
+   }
+   if (!index->dirty)
+   {
+      return TRUE;
+   }
+   if (strlen(index->filename) > sizeof(temp) - 5)
+   {
+      return FALSE;
+   }
+
+   /* Write a copy and rename it so a crash never leaves half an index. */
+   sprintf(temp, "%s.tmp", index->filename);
+   file = fopen(temp, "wb");
+   if (file == NULL)
+   {
+      Error("Failed to open search index for writing: %s", temp);
+      return FALSE;
+   }
+
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, SEARCH_INDEX_MAGIC, 4);
+   header.version = SEARCH_INDEX_VERSION;
+   header.documentCount = index->documentCount;
+   header.termCount = index->termCount;
+   header.areaCapacity = index->areaCapacity;
+
+   ok = WriteAll(file, &header, sizeof(header)) &&
+      (index->documentCount == 0 || WriteAll(file, index->documents + 1,
+         index->documentCount * sizeof(SearchHit))) &&
+      WriteAll(file, index->indexedHighWater,
+         index->areaCapacity * sizeof(uint32_t));
+
+   for (i = 0; ok && i < index->termCount; i++)
+   {
+      term = &index->terms[i];
+      list = &term->postings;
+      length = (uint32_t) strlen(term->term);
+      ok = WriteAll(file, &length, sizeof(length)) &&
+         WriteAll(file, term->term, length) &&
+         WriteAll(file, &list->docCount, sizeof(uint32_t)) &&
+         WriteAll(file, &list->lastDoc, sizeof(uint32_t)) &&
+         WriteAll(file, &list->blockCount, sizeof(uint32_t)) &&
+         WriteAll(file, &list->length, sizeof(uint32_t)) &&
+         WriteAll(file, list->blocks,
+            list->blockCount * sizeof(PostingBlock)) &&
+         WriteAll(file, list->data, list->length);
+   }
+
+   if (fclose(file) != 0 || !ok || rename(temp, index->filename) != 0)
+   {
+      Error("Failed to write search index: %s", index->filename);
+      remove(temp);
+      return FALSE;
+   }
+
+   index->dirty = FALSE;
+   index->savedAt = time(NULL);
+   Debug("Saved search index: %lu messages, %lu terms",
+      (unsigned long) index->documentCount, (unsigned long) index->termCount);
+   return TRUE;
+}
+
+/**
+ * Read one term and its posting list from a saved index. Nothing read is
+ * trusted: sizes are checked against what is left of the file and the
+ * postings are checked before a cursor can walk them.
+ */
+static bool LoadSearchTerm(SearchIndex *index, FILE *file, long fileSize)
+{
+   char term[SEARCH_MAX_TERM_LENGTH];
+   uint32_t length, docCount, lastDoc, blockCount, dataLength;
+   PostingList *list;
+   long termIndex;
+
+   if (!ReadAll(file, &length, sizeof(length)) ||
+      length == 0 || length >= SEARCH_MAX_TERM_LENGTH ||
+      !ReadAll(file, term, length) ||
+      !ReadAll(file, &docCount, sizeof(uint32_t)) ||
+      !ReadAll(file, &lastDoc, sizeof(uint32_t)) ||
+      !ReadAll(file, &blockCount, sizeof(uint32_t)) ||
+      !ReadAll(file, &dataLength, sizeof(uint32_t)) ||
+      blockCount > docCount || docCount > index->documentCount ||
+      (unsigned long) dataLength > (unsigned long) fileSize ||
+      (unsigned long) blockCount >
+         (unsigned long) fileSize / sizeof(PostingBlock))
+   {
+      return FALSE;
+   }
+
+   termIndex = AddTerm(index, term, (int) length);
+   if (termIndex < 0)
+   {
+      return FALSE;
+   }
+   list = &index->terms[termIndex].postings;
+   if (list->docCount != 0)
+   {
+      /* The same term was saved twice. */
+      return FALSE;
+   }
+
+   list->blocks = (PostingBlock *) malloc(
+      MAX(1, blockCount) * sizeof(PostingBlock));
+   list->data = (uint8_t *) malloc(MAX(1, dataLength));
+   if (list->blocks == NULL || list->data == NULL)
+   {
+      Error("Failed to allocate memory for search index");
+      return FALSE;
+   }
+   list->blockCapacity = MAX(1, blockCount);
+   list->capacity = MAX(1, dataLength);
+   if (!ReadAll(file, list->blocks, blockCount * sizeof(PostingBlock)) ||
+      !ReadAll(file, list->data, dataLength))
+   {
+      return FALSE;
+   }
+   list->docCount = docCount;
+   list->lastDoc = lastDoc;
+   list->blockCount = blockCount;
+   list->length = dataLength;
+   return IsPostingListValid(list, index->documentCount);
+}
+
+/** Empty an index whose file couldn't be loaded, ready to be rebuilt. */
+static void ResetSearchIndex(SearchIndex *index)
+{
+   uint32_t i;
+
+   for (i = 0; i < index->termCount; i++)
+   {
+      free(index->terms[i].term);
+      FreePostingList(&index->terms[i].postings);
+   }
+   free(index->terms);
+   free(index->documents);
+   free(index->indexedHighWater);
+   index->terms = NULL;
+   index->termCount = 0;
+   index->termCapacity = 0;
+   index->documents = NULL;
+   index->documentCount = 0;
+   index->documentCapacity = 0;
+   index->indexedHighWater = NULL;
+   index->areaCapacity = 0;
+   memset(index->table, 0, index->tableSize * sizeof(uint32_t));
+   /* The damaged file is replaced the next time the index is saved. */
+   index->dirty = TRUE;
+}
+
+bool _LoadSearchIndex(SearchIndex *index)
+{
+   SearchIndexFileHeader header;
+   FILE *file;
+   long fileSize;
+   uint32_t i;
+   bool ok;
+
+   if (index == NULL || index->filename == NULL)
+   {
+      return FALSE;
+   }
+
+   file = fopen(index->filename, "rb");
+   if (file == NULL)
+   {
+      /* It will be built from the message base. */
+      Info("No search index found at %s", index->filename);
+      return TRUE;
+   }
+
+   fseek(file, 0, SEEK_END);
+   fileSize = ftell(file);
+   rewind(file);
+   if (fileSize < 0 || !ReadAll(file, &header, sizeof(header)) ||
+      memcmp(header.magic, SEARCH_INDEX_MAGIC, 4) != 0 ||
+      header.version != SEARCH_INDEX_VERSION ||
+      (unsigned long) header.documentCount >
+         (unsigned long) fileSize / sizeof(SearchHit) ||
+      (unsigned long) header.areaCapacity >
+         (unsigned long) fileSize / sizeof(uint32_t))
+   {
+      Error("Search index %s is not a valid index file", index->filename);
+      fclose(file);
+      ResetSearchIndex(index);
+      return FALSE;
+   }
+
+   index->documentCapacity = header.documentCount + 1;
+   index->documents = (SearchHit *) malloc(
+      index->documentCapacity * sizeof(SearchHit));
+   index->areaCapacity = header.areaCapacity;
+   index->indexedHighWater = (uint32_t *) calloc(
+      MAX(1, header.areaCapacity), sizeof(uint32_t));
+   ok = index->documents != NULL && index->indexedHighWater != NULL &&
+      ReadAll(file, index->documents + 1,
+         header.documentCount * sizeof(SearchHit)) &&
+      ReadAll(file, index->indexedHighWater,
+         header.areaCapacity * sizeof(uint32_t));
+   index->documentCount = header.documentCount;
+
+   for (i = 0; ok && i < header.termCount; i++)
+   {
+      ok = LoadSearchTerm(index, file, fileSize);
+   }
+   fclose(file);
+
+   if (!ok)
+   {
+      Error("Failed to read search index: %s", index->filename);
+      ResetSearchIndex(index);
+      return FALSE;
+   }
+
+   index->dirty = FALSE;
+   Debug("Loaded search index: %lu messages, %lu terms",
+      (unsigned long) index->documentCount, (unsigned long) index->termCount);
+   return TRUE;
+}
+
+/********** Queries **********/
+
+static void AddQueryTerm(void *context, const char *term, int length,
+   uint32_t position)
+{
+   Query *query = (Query *) context;
+   QueryTerm *queryTerm;
+   uint32_t slot;
+
+   (void) length;
+   if (query->termCount == SEARCH_MAX_QUERY_TERMS)
+   {
+      return;
+   }
+   queryTerm = &query->terms[query->termCount++];
+   slot = FindTermSlot(query->index, term, length, HashTerm(term, length));
+   if (query->index->table[slot] == 0)
+   {
+      query->missing = TRUE;
+      queryTerm->postings = NULL;
+   }
+   else
+   {
+      queryTerm->postings =
+         &query->index->terms[query->index->table[slot] - 1].postings;
+   }
+   queryTerm->phrase = query->phrase;
+   queryTerm->offset = position;
+}
+
+/** Split a query into words, grouping the words inside quotes. */
+static void ParseQuery(Query *query, const char *text)
+{
+   const char *end;
+   bool quoted = FALSE;
+
+   while (*text != '\0')
+   {
+      end = strchr(text, '"');
+      if (end == NULL)
+      {
+         end = text + strlen(text);
+      }
+      query->phrase = quoted ? query->phraseCount++ : -1;
+      TokenizeText(text, end - text, AddQueryTerm, query);
+      if (*end == '\0')
+      {
+         break;
+      }
+      quoted = !quoted;
+      text = end + 1;
+   }
+}
+
+static bool ReadQueryPositions(QueryTerm *term)
+{
+   uint32_t *positions;
+
+   if (term->cursor.frequency > term->capacity)
+   {
+      positions = (uint32_t *) realloc(term->positions,
+         term->cursor.frequency * sizeof(uint32_t));
+      if (positions == NULL)
+      {
+         return FALSE;
+      }
+      term->positions = positions;
+      term->capacity = term->cursor.frequency;
+   }
+   ReadPositions(&term->cursor, term->positions);
+   return TRUE;
+}
+
+static bool ContainsPosition(const QueryTerm *term, uint32_t position)
+{
+   uint32_t low = 0, high = term->cursor.frequency, middle;
+
+   while (low < high)
+   {
+      middle = low + (high - low) / 2;
+      if (term->positions[middle] < position)
+      {
+         low = middle + 1;
+      }
+      else
+      {
+         high = middle;
+      }
+   }
+   return low < term->cursor.frequency && term->positions[low] == position;
+}
+
+/** Check every phrase in the query against the current document. */
+static bool PhrasesMatch(Query *query)
+{
+   QueryTerm *first;
+   int phrase, i, j;
+   uint32_t p;
+   bool found;
+
+   for (phrase = 0; phrase < query->phraseCount; phrase++)
+   {
+      first = NULL;
+      for (i = 0; i < query->termCount; i++)
+      {
+         if (query->terms[i].phrase != phrase)
+         {
+            continue;
+         }
+         if (!ReadQueryPositions(&query->terms[i]))
+         {
+            return FALSE;
+         }
+         if (first == NULL)
+         {
+            first = &query->terms[i];
+         }
+      }
+      if (first == NULL)
+      {
+         continue;
+      }
+
+      found = FALSE;
+      for (p = 0; !found && p < first->cursor.frequency; p++)
+      {
+         found = TRUE;
+         for (j = 0; found && j < query->termCount; j++)
+         {
+            if (query->terms[j].phrase == phrase)
+            {
+               found = ContainsPosition(&query->terms[j],
+                  first->positions[p] + query->terms[j].offset);
+            }
+         }
+      }
+      if (!found)
+      {
+         return FALSE;
+      }
+   }
+   return TRUE;
+}
+
+/** Can the user read a hit? Used to keep others' private mail out. */
+static bool IsHitVisible(MessageDB *messages, const SearchHit *hit,
+   const User *user)
+{
+   MessageArea *area = _GetMessageAreaByID(messages, hit->areaID);
+   return area != NULL &&
+      IsMessageVisible(GetMessageHeader(area, hit->number), user);
+}
+
+/* Hits are checked against messages when it is set. */
+static int RunSearch(SearchIndex *index, MessageDB *messages,
+   const User *user, const char *text, SearchHit *hits, int size)
+{
+   Query query;
+   PostingCursor *driver, *cursor;
+   int order[SEARCH_MAX_QUERY_TERMS];
+   int i, j, found = 0;
+   uint32_t target;
+
+   if (index == NULL || text == NULL || hits == NULL || size < 0)
+   {
+      return -1;
+   }
+
+   memset(&query, 0, sizeof(query));
+   query.index = index;
+   ParseQuery(&query, text);
+   if (query.termCount == 0 || query.missing || size == 0)
+   {
+      return 0;
+   }
+
+   /* Drive the intersection from the rarest term. */
+   for (i = 0; i < query.termCount; i++)
+   {
+      OpenPostingCursor(&query.terms[i].cursor, query.terms[i].postings);
+      for (j = i; j > 0 && query.terms[order[j - 1]].postings->docCount >
+         query.terms[i].postings->docCount; j--)
+      {
+         order[j] = order[j - 1];
+      }
+      order[j] = i;
+   }
+   driver = &query.terms[order[0]].cursor;
+
+   while (!driver->done)
+   {
+      target = driver->doc;
+      for (i = 1; i < query.termCount; i++)
+      {
+         cursor = &query.terms[order[i]].cursor;
+         if (!SeekPosting(cursor, target) || cursor->doc > target)
+         {
+            break;
+         }
+      }
+      if (i < query.termCount)
+      {
+         /* Skip the driver ahead to where the other term picked up. */
+         if (cursor->done || !SeekPosting(driver, cursor->doc))
+         {
+            break;
+         }
+         continue;
+      }
+
+      if ((query.phraseCount == 0 || PhrasesMatch(&query)) &&
+         (messages == NULL ||
+            IsHitVisible(messages, &index->documents[target], user)))
+      {
+         hits[found++] = index->documents[target];
+         if (found == size)
+         {
+            break;
+         }
+      }
+      NextPosting(driver);
+   }
+
+   for (i = 0; i < query.termCount; i++)
+   {
+      free(query.terms[i].positions);
+   }
+   return found;
+}
+
+int _SearchMessages(SearchIndex *index, const char *text, SearchHit *hits,
+   int size)
+{
+   return RunSearch(index, NULL, NULL, text, hits, size);
+}
+
+int _SearchVisibleMessages(SearchIndex *index, MessageDB *messages,
+   const User *user, const char *text, SearchHit *hits, int size)
+{
+   if (messages == NULL || user == NULL)
+   {
+      return -1;
+   }
+   return RunSearch(index, messages, user, text, hits, size);
+}
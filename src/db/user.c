@@ -26,6 +26,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vbbs/types.h>
 #include <vbbs/db.h>
 #include <vbbs/log.h>
+#include <vbbs/metrics.h>
 #include <vbbs/db/user.h>
 #include <vbbs/user.h>
 #include <ctype.h>
@@ -86,8 +87,7 @@ bool _LoadUserDB(UserDB *db)
    FILE *file;
    User *user;
    char value[256];
-   int fieldNum, i;
-   char c;
+   int fieldNum, i, c;
 
    if (db == NULL)
    {
@@ -108,10 +108,8 @@ bool _LoadUserDB(UserDB *db)
    user = NULL;
 
    /* Read users from the file */
-   while (!feof(file))
+   while ((c = fgetc(file)) != EOF)
    {
-      c = fgetc(file);
-      
       /* Start of a new line */
       if (user == NULL)
       {
@@ -163,8 +161,9 @@ bool _LoadUserDB(UserDB *db)
          memset(value, 0, sizeof(value));
          i = 0;
       }
-      else
+      else if (i < (int)sizeof(value) - 1)
       {
+         /* Overlong values are truncated rather than overrun value. */
          value[i++] = c;
       }
 
@@ -212,6 +211,7 @@ bool _SaveUserDB(UserDB *db)
    FILE *file;
    int i;
    User *user;
+   unsigned long start = MonotonicNanos();
 
    if (db == NULL || db->filename == NULL || db->users == NULL)
    {
@@ -248,6 +248,8 @@ bool _SaveUserDB(UserDB *db)
 
    fflush(file);
    fclose(file);
+   IncrementCounter(&userDBSaves);
+   RecordElapsed(&saveUserDBTime, start);
    return TRUE;
 }
 
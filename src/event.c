@@ -0,0 +1,290 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/event.h>
+#include <vbbs/log.h>
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** Matches the EventType values. */
+static const char *EVENT_NAMES[] = {
+    "none",
+    "connect",
+    "disconnect",
+    "login",
+    "login-failed",
+    "transfer",
+    "transfer-failed"
+};
+
+static FILE *eventLog = NULL;
+static bool eventLogDirty = FALSE;
+
+static void PutLE16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = (uint8_t)(value & 0xFF);
+    buffer[1] = (uint8_t)((value >> 8) & 0xFF);
+}
+
+static void PutLE32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = (uint8_t)(value & 0xFF);
+    buffer[1] = (uint8_t)((value >> 8) & 0xFF);
+    buffer[2] = (uint8_t)((value >> 16) & 0xFF);
+    buffer[3] = (uint8_t)((value >> 24) & 0xFF);
+}
+
+static uint16_t GetLE16(const uint8_t *buffer)
+{
+    return (uint16_t)(buffer[0] | (buffer[1] << 8));
+}
+
+static uint32_t GetLE32(const uint8_t *buffer)
+{
+    return (uint32_t)buffer[0] | ((uint32_t)buffer[1] << 8) |
+        ((uint32_t)buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+}
+
+void EncodeEvent(const Event *event, uint8_t *record)
+{
+    size_t length;
+
+    memset(record, 0, EVENT_RECORD_SIZE);
+    PutLE32(record, event->time);
+    PutLE16(record + 4, event->type);
+    PutLE16(record + 6, event->connectionType);
+    PutLE32(record + 8, event->sessionID);
+    PutLE32(record + 12, event->userID);
+    PutLE32(record + 16, event->remoteIP);
+    PutLE16(record + 20, event->remotePort);
+    PutLE32(record + 24, event->value);
+    length = strlen(event->username);
+    memcpy(record + 28, event->username, MIN(length, EVENT_USERNAME_SIZE));
+}
+
+void DecodeEvent(const uint8_t *record, Event *event)
+{
+    event->time = GetLE32(record);
+    event->type = GetLE16(record + 4);
+    event->connectionType = GetLE16(record + 6);
+    event->sessionID = GetLE32(record + 8);
+    event->userID = GetLE32(record + 12);
+    event->remoteIP = GetLE32(record + 16);
+    event->remotePort = GetLE16(record + 20);
+    event->value = GetLE32(record + 24);
+    memcpy(event->username, record + 28, EVENT_USERNAME_SIZE);
+    event->username[EVENT_USERNAME_SIZE] = '\0';
+}
+
+const char *EventTypeName(EventType type)
+{
+    if ((int)type < 0 || type >= EVENT_TYPE_COUNT)
+    {
+        return "unknown";
+    }
+    return EVENT_NAMES[type];
+}
+
+EventType ParseEventType(const char *name)
+{
+    const char *a, *b;
+    int i;
+
+    if (name == NULL)
+    {
+        return EVENT_NONE;
+    }
+    for (i = 1; i < EVENT_TYPE_COUNT; i++)
+    {
+        a = name;
+        b = EVENT_NAMES[i];
+        while (*a != '\0' && tolower((unsigned char)*a) == *b)
+        {
+            a++;
+            b++;
+        }
+        if (*a == '\0' && *b == '\0')
+        {
+            return (EventType)i;
+        }
+    }
+    return EVENT_NONE;
+}
+
+static void PutEventHeader(uint8_t *header)
+{
+    memset(header, 0, EVENT_HEADER_SIZE);
+    memcpy(header, EVENT_LOG_MAGIC, 4);
+    PutLE32(header + 4, EVENT_LOG_VERSION);
+    PutLE32(header + 8, EVENT_RECORD_SIZE);
+}
+
+bool OpenEventLog(const char *filename)
+{
+    uint8_t header[EVENT_HEADER_SIZE];
+    long size;
+
+    CloseEventLog();
+    eventLog = fopen(filename, "ab");
+    if (eventLog == NULL)
+    {
+        Error("Could not open event log %s", filename);
+        return FALSE;
+    }
+    fseek(eventLog, 0, SEEK_END);
+    size = ftell(eventLog);
+    if (size == 0)
+    {
+        PutEventHeader(header);
+        fwrite(header, 1, sizeof(header), eventLog);
+        eventLogDirty = TRUE;
+    }
+    else if (size < EVENT_HEADER_SIZE ||
+        (size - EVENT_HEADER_SIZE) % EVENT_RECORD_SIZE != 0)
+    {
+        /* A partial record would misalign everything written after it. */
+        Error("Event log %s is damaged, not appending to it", filename);
+        fclose(eventLog);
+        eventLog = NULL;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void CloseEventLog(void)
+{
+    if (eventLog == NULL)
+    {
+        return;
+    }
+    fclose(eventLog);
+    eventLog = NULL;
+    eventLogDirty = FALSE;
+}
+
+bool IsEventLogOpen(void)
+{
+    return eventLog != NULL;
+}
+
+void LogEvent(Event *event)
+{
+    uint8_t record[EVENT_RECORD_SIZE];
+
+    if (eventLog == NULL || event == NULL)
+    {
+        return;
+    }
+    if (event->time == 0)
+    {
+        event->time = (uint32_t)time(NULL);
+    }
+    EncodeEvent(event, record);
+    fwrite(record, 1, sizeof(record), eventLog);
+    eventLogDirty = TRUE;
+}
+
+void FlushEventLog(void)
+{
+    if (eventLog != NULL && eventLogDirty)
+    {
+        fflush(eventLog);
+        eventLogDirty = FALSE;
+    }
+}
+
+EventReader *OpenEventReader(const char *filename)
+{
+    EventReader *reader;
+    uint8_t header[EVENT_HEADER_SIZE];
+    FILE *file;
+
+    file = fopen(filename, "rb");
+    if (file == NULL)
+    {
+        return NULL;
+    }
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+        memcmp(header, EVENT_LOG_MAGIC, 4) != 0 ||
+        GetLE32(header + 8) != EVENT_RECORD_SIZE)
+    {
+        fclose(file);
+        return NULL;
+    }
+    reader = (EventReader *)malloc(sizeof(EventReader));
+    if (reader == NULL)
+    {
+        fclose(file);
+        return NULL;
+    }
+    reader->batch = (uint8_t *)malloc(EVENT_READ_BATCH * EVENT_RECORD_SIZE);
+    if (reader->batch == NULL)
+    {
+        free(reader);
+        fclose(file);
+        return NULL;
+    }
+    reader->file = file;
+    reader->count = 0;
+    reader->next = 0;
+    return reader;
+}
+
+void CloseEventReader(EventReader *reader)
+{
+    if (reader == NULL)
+    {
+        return;
+    }
+    fclose(reader->file);
+    free(reader->batch);
+    free(reader);
+}
+
+bool ReadEvent(EventReader *reader, Event *event)
+{
+    if (reader == NULL || event == NULL)
+    {
+        return FALSE;
+    }
+    if (reader->next >= reader->count)
+    {
+        /* A trailing partial record is ignored. */
+        reader->count = (int)(fread(reader->batch, EVENT_RECORD_SIZE,
+            EVENT_READ_BATCH, reader->file));
+        reader->next = 0;
+        if (reader->count <= 0)
+        {
+            return FALSE;
+        }
+    }
+    DecodeEvent(reader->batch + reader->next * EVENT_RECORD_SIZE, event);
+    reader->next++;
+    return TRUE;
+}
@@ -0,0 +1,84 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/buffer.h>
+#include <vbbs/globals.h>
+#include <vbbs/metrics.h>
+#include <stddef.h>
+
+#include "shared.h"
+
+/*
+ * Feeds a connection's input pipeline the way ReadFromSession does: the
+ * bytes arrive in reads of up to 1024 bytes, each read goes through
+ * WriteToBuffer for telnet handling, and then every complete line is taken.
+ *
+ * The first input byte picks the read size, so short reads that split
+ * telnet commands and line endings are covered, and whether the input is
+ * in line or character mode.
+ */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    static bool initialized = FALSE;
+    InputBuffer *input;
+    unsigned long start;
+    size_t offset, chunk, read;
+
+    if (!initialized) {
+        InitFuzzHarness();
+        initialized = TRUE;
+    }
+    if (size == 0) {
+        return 0;
+    }
+
+    start = MonotonicNanos();
+    input = NewInputBuffer(CONNECTION_BUFFER_SIZE);
+    if (input == NULL) {
+        return 0;
+    }
+    if (data[0] & 1) {
+        SetInputMode(input, CHARACTER_INPUT_MODE);
+    }
+    chunk = (data[0] >> 1) * 8 + 1;
+
+    for (offset = 1; offset < size; offset += read) {
+        if (BufferRemaining(input->buffer) == 0) {
+            /* A full buffer with no line in it. Drop it and carry on. */
+            ClearBuffer(input->buffer);
+            SetInputMode(input, input->inputMode);
+        }
+        read = MIN(chunk, size - offset);
+        read = MIN(read, (size_t)BufferRemaining(input->buffer));
+        WriteToBuffer(input->buffer, (const char *)data + offset, (int)read);
+        while (IsNextLineReady(input)) {
+            ClearNextLine(input);
+        }
+    }
+
+    DestroyInputBuffer(input);
+    FinishFuzzInput("buffer", size, start);
+    return 0;
+}
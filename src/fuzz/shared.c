@@ -0,0 +1,88 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/log.h>
+#include <vbbs/metrics.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shared.h"
+
+static unsigned long budgetPerByte = FUZZ_BUDGET_NS_PER_BYTE;
+static unsigned long inputs = 0;
+static unsigned long totalBytes = 0;
+static unsigned long totalNanos = 0;
+static unsigned long slowestNanos = 0;
+static unsigned long slowestSize = 0;
+
+void InitFuzzHarness(void) {
+    const char *value;
+
+    /* Debug output on every telnet command would swamp the timings. */
+    SetLogLevel(LOG_ERROR);
+    value = getenv("VBBS_FUZZ_NS_PER_BYTE");
+    if (value != NULL) {
+        budgetPerByte = strtoul(value, NULL, 10);
+    }
+    atexit(PrintFuzzStats);
+}
+
+void FinishFuzzInput(const char *harness, size_t size, unsigned long start) {
+    unsigned long elapsed = MonotonicNanos() - start;
+    unsigned long budget = FUZZ_BUDGET_BASE_NS + budgetPerByte * size;
+
+    inputs++;
+    totalBytes += size;
+    totalNanos += elapsed;
+    if (elapsed > slowestNanos) {
+        slowestNanos = elapsed;
+        slowestSize = size;
+    }
+
+    if (budgetPerByte > 0 && elapsed > budget) {
+        fprintf(stderr,
+            "%s: slow input, %lu bytes took %lu.%03lu ms, budget %lu ms\n",
+            harness, (unsigned long)size, elapsed / 1000000,
+            elapsed / 1000 % 1000, budget / 1000000);
+        abort();
+    }
+}
+
+void PrintFuzzStats(void) {
+    double seconds = totalNanos / 1e9;
+
+    if (inputs == 0) {
+        return;
+    }
+    fprintf(stderr, "%lu inputs, %lu bytes in %.3f s", inputs, totalBytes,
+        seconds);
+    if (seconds > 0) {
+        fprintf(stderr, ", %.0f inputs/s, %.3f MB/s", inputs / seconds,
+            totalBytes / seconds / 1e6);
+    }
+    fprintf(stderr, "\nSlowest input: %lu bytes in %lu.%03lu ms\n",
+        slowestSize, slowestNanos / 1000000, slowestNanos / 1000 % 1000);
+}
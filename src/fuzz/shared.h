@@ -0,0 +1,57 @@
+#ifndef _FUZZ_SHARED_H
+#define _FUZZ_SHARED_H
+
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <stddef.h>
+
+/*
+ * Every harness must finish an input within FUZZ_BUDGET_BASE_NS plus
+ * FUZZ_BUDGET_NS_PER_BYTE for each input byte, or it is reported as a
+ * crash. This is what turns quadratic behaviour into a finding. Set
+ * VBBS_FUZZ_NS_PER_BYTE to change the per-byte budget, or to 0 to turn the
+ * check off, e.g. when single stepping in a debugger.
+ */
+#define FUZZ_BUDGET_BASE_NS 10000000UL
+#define FUZZ_BUDGET_NS_PER_BYTE 2000UL
+
+/** The libFuzzer entry point, which each harness in src/fuzz defines. */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+/** Quieten logging and read the budget. Harnesses call this once. */
+void InitFuzzHarness(void);
+
+/**
+ * Record the time an input took, from start, a MonotonicNanos value. An
+ * input that blew its budget aborts, so libFuzzer and AFL both keep it.
+ */
+void FinishFuzzInput(const char *harness, size_t size, unsigned long start);
+
+/** Print the number of inputs, throughput and the slowest input. */
+void PrintFuzzStats(void);
+
+#endif
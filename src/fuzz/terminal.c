@@ -0,0 +1,68 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/buffer.h>
+#include <vbbs/globals.h>
+#include <vbbs/metrics.h>
+#include <vbbs/terminal.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "shared.h"
+
+/*
+ * Checks a reply to IDENTIFY, which arrives as an input line, so at most
+ * sizeof(nextLine) - 1 bytes with no CR, LF or NUL in it.
+ */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    static bool initialized = FALSE;
+    char response[256];
+    Terminal terminal;
+    Buffer *out;
+    unsigned long start;
+
+    if (!initialized) {
+        InitFuzzHarness();
+        initialized = TRUE;
+    }
+    if (size >= sizeof(response)) {
+        return 0;
+    }
+
+    start = MonotonicNanos();
+    memcpy(response, data, size);
+    response[size] = '\0';
+    out = NewBuffer(CONNECTION_BUFFER_SIZE);
+    if (out == NULL) {
+        return 0;
+    }
+    InitTerminal(&terminal);
+    CheckIdentifyResponse(out, response, &terminal);
+
+    DestroyBuffer(out);
+    FinishFuzzInput("terminal", size, start);
+    return 0;
+}
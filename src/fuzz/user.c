@@ -0,0 +1,94 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/db/user.h>
+#include <vbbs/metrics.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "shared.h"
+
+/* _LoadUserDB only reads from a file, so each input is written to one. */
+static char filename[] = "/tmp/vbbs-fuzz-users-XXXXXX";
+
+static void removeUserFile(void) {
+    unlink(filename);
+}
+
+/* Loads a user database file, then saves and reloads what was kept. */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    static bool initialized = FALSE;
+    UserDB *db;
+    FILE *file;
+    unsigned long start;
+    int fd, count;
+
+    if (!initialized) {
+        InitFuzzHarness();
+        fd = mkstemp(filename);
+        if (fd < 0) {
+            perror("mkstemp");
+            abort();
+        }
+        close(fd);
+        atexit(removeUserFile);
+        initialized = TRUE;
+    }
+
+    file = fopen(filename, "wb");
+    if (file == NULL) {
+        abort();
+    }
+    fwrite(data, 1, size, file);
+    fclose(file);
+
+    start = MonotonicNanos();
+    db = NewUserDB(filename);
+    if (db == NULL) {
+        return 0;
+    }
+    _LoadUserDB(db);
+    count = _GetUserCount(db);
+    _SaveUserDB(db);
+    DestroyUserDB(db);
+
+    /* Whatever was loaded must survive a save and load intact. */
+    db = NewUserDB(filename);
+    if (db == NULL) {
+        return 0;
+    }
+    _LoadUserDB(db);
+    if (_GetUserCount(db) != count) {
+        fprintf(stderr, "user: %d users saved but %d loaded\n", count,
+            _GetUserCount(db));
+        abort();
+    }
+    DestroyUserDB(db);
+    FinishFuzzInput("user", size, start);
+    return 0;
+}
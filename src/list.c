@@ -25,22 +25,23 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <vbbs/types.h>
 #include <vbbs/list.h>
+#include <vbbs/memory.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
 ArrayList *NewArrayList(int initialCapacity, ListItemDestructor destructor)
 {
-    ArrayList *list = (ArrayList *)malloc(sizeof(ArrayList));
+    ArrayList *list = (ArrayList *)TrackedMalloc(sizeof(ArrayList));
     if (list == NULL)
     {
         return NULL;
     }
 
-    list->items = (void **)malloc(sizeof(void *) * initialCapacity);
+    list->items = (void **)TrackedMalloc(sizeof(void *) * initialCapacity);
     if (list->items == NULL)
     {
-        free(list);
+        TrackedFree(list);
         return NULL;
     }
 
@@ -61,10 +62,10 @@ void DestroyArrayList(ArrayList *list)
 
     if (list->items != NULL)
     {
-        free(list->items);
+        TrackedFree(list->items);
         list->items = NULL;
     }
-    free(list);
+    TrackedFree(list);
 }
 
 void AddToArrayList(ArrayList *list, void *item)
@@ -78,7 +79,8 @@ void AddToArrayList(ArrayList *list, void *item)
     {
         list->capacity *= 2;
         list->items = 
-            (void **)realloc(list->items, sizeof(void *) * list->capacity);
+            (void **)TrackedRealloc(list->items,
+                sizeof(void *) * list->capacity);
     }
 
     list->items[list->size] = item;
@@ -126,7 +128,7 @@ void RemoveFromArrayList(ArrayList *list, int index)
 
     /* If there is another copy of this same pointer in the list,
         then don't free this copy. */
-    if (!ArrayListContains(list, value, NULL) && list->destructor != NULL)
+    if (list->destructor != NULL && !ArrayListContains(list, value, NULL))
     {
         list->destructor(value);
     }
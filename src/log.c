@@ -29,9 +29,16 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdarg.h>
 #include <stdio.h>
 #include <vbbs/log.h>
+#include <vbbs/time.h>
 #include <time.h>
 #include <string.h>
 
+#ifdef LOG_ASYNC_SUPPORTED
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
 const char *LEVELS[] = {
     "DEBUG",
     "INFO",
@@ -42,6 +49,72 @@ const char *LEVELS[] = {
 FILE *LOG = NULL;
 LogLevel LOG_LEVEL = LOG_DEBUG;
 
+static bool logEcho = TRUE;
+
+static char *logFilename = NULL;
+static long logFileSize = 0;
+static time_t logOpened = 0;
+static long logRotateSize = LOG_ROTATE_SIZE;
+static long logRotateInterval = LOG_ROTATE_INTERVAL;
+static int logRotateKeep = LOG_ROTATE_KEEP;
+
+/**
+ * A token bucket for one call site (file and line) or one session (file
+ * is NULL, key is the session ID). Tokens are thousandths of a message.
+ */
+typedef struct LogBucket
+{
+    const char *file;
+    unsigned long key;
+    long tokens;
+    unsigned long last;            /* Milliseconds */
+    unsigned long suppressed;      /* Not yet reported */
+} LogBucket;
+
+/**
+ * Each thread keeps its own buckets, so checking a limit never waits on
+ * another thread. SetLogRateLimits bumps logLimitGeneration, and a thread
+ * empties its buckets when it next sees the change.
+ */
+static THREAD_LOCAL LogBucket logSites[LOG_RATE_SLOTS];
+static THREAD_LOCAL LogBucket logSessions[LOG_RATE_SLOTS];
+static THREAD_LOCAL unsigned long logBucketGeneration = 0;
+static unsigned long logLimitGeneration = 0;
+static int logSiteRate = LOG_SITE_RATE;
+static int logSiteBurst = LOG_SITE_BURST;
+static int logSessionRate = LOG_SESSION_RATE;
+static int logSessionBurst = LOG_SESSION_BURST;
+static unsigned long logSuppressedTotal = 0;
+static THREAD_LOCAL uint32_t logSession = 0;
+
+#ifdef LOG_ASYNC_SUPPORTED
+
+/**
+ * One formatted line in the ring. The sequence number says whose turn it is
+ * to use the slot: it equals the enqueue position when the slot is free and
+ * the enqueue position + 1 once the line has been written into it.
+ */
+typedef struct LogSlot
+{
+    unsigned long sequence;
+    int length;
+    char text[LOG_MESSAGE_SIZE];
+} LogSlot;
+
+static LogSlot *logRing = NULL;
+static unsigned long logEnqueuePos = 0;
+static unsigned long logDequeuePos = 0;
+static unsigned long logDropped = 0;       /* Not yet reported */
+static unsigned long logDroppedTotal = 0;
+static int logAsync = 0;
+static int logRunning = 0;
+static int logWriterWaiting = 0;
+static pthread_t logThread;
+static pthread_mutex_t logMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t logCond = PTHREAD_COND_INITIALIZER;
+
+#endif /* LOG_ASYNC_SUPPORTED */
+
 /**
  * Initialize the log file. 
  * If the log file already exists, 
@@ -60,18 +133,106 @@ void InitLog(const char *filename)
     if (LOG == NULL)
     {
         Error("Error opening log file: %s", filename);
+        return;
+    }
+    logFilename = (char *)malloc(strlen(filename) + 1);
+    if (logFilename != NULL)
+    {
+        strcpy(logFilename, filename);
     }
+    fseek(LOG, 0, SEEK_END);
+    logFileSize = ftell(LOG);
+    logOpened = time(NULL);
 }
 /**
  * Close the log file if it is open.
+ * Asynchronous logging is stopped first so queued messages are written.
  */
 void CloseLog(void)
 {
+    StopAsyncLog();
     if (LOG != NULL)
     {
         fclose(LOG);
         LOG = NULL;
     }
+    if (logFilename != NULL)
+    {
+        free(logFilename);
+        logFilename = NULL;
+    }
+}
+
+void SetLogRotation(long maxBytes, long maxSeconds, int keep)
+{
+    logRotateSize = maxBytes;
+    logRotateInterval = maxSeconds;
+    logRotateKeep = keep;
+}
+
+/**
+ * Move vBBS.log to vBBS.log.1, shifting older files up and removing the
+ * oldest, then start a new file. Only called by whichever thread is
+ * writing to the file.
+ */
+static void RotateLogFile(void)
+{
+    char *from, *to;
+    size_t size;
+    int i;
+
+    if (LOG == NULL || logFilename == NULL)
+    {
+        return;
+    }
+    size = strlen(logFilename) + 16;
+    from = (char *)malloc(size);
+    to = (char *)malloc(size);
+    if (from == NULL || to == NULL)
+    {
+        free(from);
+        free(to);
+        return;
+    }
+    fclose(LOG);
+    if (logRotateKeep > 0)
+    {
+        sprintf(to, "%s.%d", logFilename, logRotateKeep);
+        remove(to);
+        for (i = logRotateKeep - 1; i >= 1; i--)
+        {
+            sprintf(from, "%s.%d", logFilename, i);
+            sprintf(to, "%s.%d", logFilename, i + 1);
+            rename(from, to);
+        }
+        sprintf(to, "%s.1", logFilename);
+        rename(logFilename, to);
+    }
+    else
+    {
+        remove(logFilename);
+    }
+    free(from);
+    free(to);
+    LOG = fopen(logFilename, "a");
+    logFileSize = 0;
+    logOpened = time(NULL);
+}
+
+/**
+ * Called before length bytes are written to the file. Rotates first if
+ * they would take the file past the size limit or it is old enough, so a
+ * file only goes over the limit when a single write is larger than it.
+ */
+static void PrepareLogWrite(int length)
+{
+    if (logFileSize > 0 &&
+        ((logRotateSize > 0 && logFileSize + length > logRotateSize) ||
+        (logRotateInterval > 0 && time(NULL) - logOpened >= logRotateInterval)))
+    {
+        RotateLogFile();
+    }
+    logFileSize += length;
 }
 
 void SetLogLevel(LogLevel level)
@@ -80,31 +241,538 @@ void SetLogLevel(LogLevel level)
     Info("Log level set to: %s", LEVELS[level]);
 }
 
-/** 
- * Helper method called by other methods. 
+void SetLogEcho(bool echo)
+{
+    logEcho = echo;
+}
+
+/**
+ * Format a complete log line, including the timestamp, level and trailing
+ * newline. Long messages are truncated. Returns the length of the line.
+ */
+static int FormatLogLine(char *line, int size, LogLevel level,
+    const char *format, va_list args)
+{
+    int length, n;
+
+    length = FormatTimestamp(line, size, time(NULL));
+
+    n = sprintf(line + length, " [%s] ", LEVELS[level]);
+    length += n;
+    n = vsnprintf(line + length, size - length - 1, format, args);
+    if (n > size - length - 2)
+    {
+        n = size - length - 2;
+    }
+    if (n > 0)
+    {
+        length += n;
+    }
+    line[length++] = '\n';
+    line[length] = '\0';
+    return length;
+}
+
+static void WriteLogLine(const char *line)
+{
+    if (logEcho)
+    {
+        fputs(line, stderr);
+        fflush(stderr);
+    }
+    if (LOG != NULL)
+    {
+        PrepareLogWrite((int)strlen(line));
+    }
+    if (LOG != NULL)
+    {
+        fputs(line, LOG);
+        fflush(LOG);
+    }
+}
+
+#ifdef LOG_ASYNC_SUPPORTED
+
+/**
+ * Claim a slot, format the line straight into it and publish it. Never
+ * blocks: if the ring is full the message is counted as dropped.
+ */
+static void EnqueueLogLine(LogLevel level, const char *format, va_list args)
+{
+    LogSlot *slot;
+    unsigned long pos, sequence;
+    long diff;
+
+    pos = __atomic_load_n(&logEnqueuePos, __ATOMIC_RELAXED);
+    for (;;)
+    {
+        slot = &logRing[pos & (LOG_RING_SIZE - 1)];
+        sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        diff = (long)(sequence - pos);
+        if (diff == 0)
+        {
+            if (__atomic_compare_exchange_n(&logEnqueuePos, &pos, pos + 1,
+                1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            /* The writer hasn't caught up. */
+            __atomic_add_fetch(&logDropped, 1, __ATOMIC_RELAXED);
+            __atomic_add_fetch(&logDroppedTotal, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        else
+        {
+            pos = __atomic_load_n(&logEnqueuePos, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->length = FormatLogLine(slot->text, LOG_MESSAGE_SIZE, level,
+        format, args);
+    __atomic_store_n(&slot->sequence, pos + 1, __ATOMIC_SEQ_CST);
+
+    /* Only take the lock when the writer is idle and needs waking. */
+    if (__atomic_load_n(&logWriterWaiting, __ATOMIC_SEQ_CST))
+    {
+        pthread_mutex_lock(&logMutex);
+        pthread_cond_signal(&logCond);
+        pthread_mutex_unlock(&logMutex);
+    }
+}
+
+static bool IsLogRingEmpty(void)
+{
+    LogSlot *slot = &logRing[logDequeuePos & (LOG_RING_SIZE - 1)];
+    return __atomic_load_n(&slot->sequence, __ATOMIC_SEQ_CST) !=
+        logDequeuePos + 1;
+}
+
+/** Copy as many queued lines as will fit into batch. Writer thread only. */
+static int DrainLogRing(char *batch, int size)
+{
+    LogSlot *slot;
+    int length = 0;
+
+    while (!IsLogRingEmpty())
+    {
+        slot = &logRing[logDequeuePos & (LOG_RING_SIZE - 1)];
+        if (length + slot->length > size)
+        {
+            break;
+        }
+        memcpy(batch + length, slot->text, slot->length);
+        length += slot->length;
+        __atomic_store_n(&slot->sequence, logDequeuePos + LOG_RING_SIZE,
+            __ATOMIC_RELEASE);
+        __atomic_store_n(&logDequeuePos, logDequeuePos + 1, __ATOMIC_RELEASE);
+    }
+    return length;
+}
+
+static void WriteAll(int fd, const char *data, int length)
+{
+    int n;
+
+    while (length > 0)
+    {
+        n = (int)write(fd, data, length);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return;
+        }
+        data += n;
+        length -= n;
+    }
+}
+
+static void WriteLogBatch(const char *batch, int length)
+{
+    if (logEcho)
+    {
+        WriteAll(STDERR_FILENO, batch, length);
+    }
+    if (LOG != NULL)
+    {
+        PrepareLogWrite(length);
+    }
+    if (LOG != NULL)
+    {
+        WriteAll(fileno(LOG), batch, length);
+    }
+}
+
+static int FormatLogLineF(char *line, int size, LogLevel level,
+    const char *format, ...)
+{
+    va_list args;
+    int length;
+    va_start(args, format);
+    length = FormatLogLine(line, size, level, format, args);
+    va_end(args);
+    return length;
+}
+
+static void ReportDroppedLogMessages(void)
+{
+    char line[LOG_MESSAGE_SIZE];
+    unsigned long dropped;
+
+    dropped = __atomic_exchange_n(&logDropped, 0, __ATOMIC_RELAXED);
+    if (dropped > 0 && LOG_WARN >= LOG_LEVEL)
+    {
+        WriteLogBatch(line, FormatLogLineF(line, sizeof(line), LOG_WARN,
+            "%lu log messages were dropped", dropped));
+    }
+}
+
+static void *LogWriterThread(void *arg)
+{
+    static char batch[LOG_BATCH_SIZE];
+    struct timespec deadline;
+    int length;
+
+    (void)arg;
+    for (;;)
+    {
+        length = DrainLogRing(batch, sizeof(batch));
+        if (length > 0)
+        {
+            WriteLogBatch(batch, length);
+            continue;
+        }
+        ReportDroppedLogMessages();
+        if (!__atomic_load_n(&logRunning, __ATOMIC_SEQ_CST))
+        {
+            break;
+        }
+
+        pthread_mutex_lock(&logMutex);
+        __atomic_store_n(&logWriterWaiting, 1, __ATOMIC_SEQ_CST);
+        if (IsLogRingEmpty() && __atomic_load_n(&logRunning, __ATOMIC_SEQ_CST))
+        {
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += LOG_IDLE_WAIT_MS * 1000000L;
+            if (deadline.tv_nsec >= 1000000000L)
+            {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&logCond, &logMutex, &deadline);
+        }
+        __atomic_store_n(&logWriterWaiting, 0, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&logMutex);
+    }
+
+    /* Anything queued while shutting down. */
+    while ((length = DrainLogRing(batch, sizeof(batch))) > 0)
+    {
+        WriteLogBatch(batch, length);
+    }
+    return NULL;
+}
+
+#endif /* LOG_ASYNC_SUPPORTED */
+
+bool StartAsyncLog(void)
+{
+#ifdef LOG_ASYNC_SUPPORTED
+    unsigned long i;
+
+    if (logAsync)
+    {
+        return TRUE;
+    }
+    logRing = (LogSlot *)malloc(sizeof(LogSlot) * LOG_RING_SIZE);
+    if (logRing == NULL)
+    {
+        Error("Failed to allocate memory for the log ring.");
+        return FALSE;
+    }
+    for (i = 0; i < LOG_RING_SIZE; i++)
+    {
+        logRing[i].sequence = i;
+    }
+    logEnqueuePos = 0;
+    logDequeuePos = 0;
+    fflush(stderr);
+    if (LOG != NULL)
+    {
+        fflush(LOG);
+    }
+
+    __atomic_store_n(&logRunning, 1, __ATOMIC_SEQ_CST);
+    if (pthread_create(&logThread, NULL, LogWriterThread, NULL) != 0)
+    {
+        logRunning = 0;
+        free(logRing);
+        logRing = NULL;
+        Error("Failed to start the log writer thread.");
+        return FALSE;
+    }
+    __atomic_store_n(&logAsync, 1, __ATOMIC_SEQ_CST);
+    Debug("Asynchronous logging started.");
+    return TRUE;
+#else
+    return FALSE;
+#endif
+}
+
+void StopAsyncLog(void)
+{
+#ifdef LOG_ASYNC_SUPPORTED
+    if (!logAsync)
+    {
+        return;
+    }
+    __atomic_store_n(&logRunning, 0, __ATOMIC_SEQ_CST);
+    pthread_mutex_lock(&logMutex);
+    pthread_cond_signal(&logCond);
+    pthread_mutex_unlock(&logMutex);
+    pthread_join(logThread, NULL);
+    __atomic_store_n(&logAsync, 0, __ATOMIC_SEQ_CST);
+    free(logRing);
+    logRing = NULL;
+#endif
+}
+
+void FlushLog(void)
+{
+#ifdef LOG_ASYNC_SUPPORTED
+    struct timespec pause;
+    unsigned long target;
+
+    if (!__atomic_load_n(&logAsync, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+    target = __atomic_load_n(&logEnqueuePos, __ATOMIC_SEQ_CST);
+    pthread_mutex_lock(&logMutex);
+    pthread_cond_signal(&logCond);
+    pthread_mutex_unlock(&logMutex);
+    pause.tv_sec = 0;
+    pause.tv_nsec = 100000L;
+    while ((long)(__atomic_load_n(&logDequeuePos, __ATOMIC_ACQUIRE) -
+        target) < 0)
+    {
+        nanosleep(&pause, NULL);
+    }
+#endif
+}
+
+unsigned long GetDroppedLogMessages(void)
+{
+#ifdef LOG_ASYNC_SUPPORTED
+    return __atomic_load_n(&logDroppedTotal, __ATOMIC_RELAXED);
+#else
+    return 0;
+#endif
+}
+
+void SetLogRateLimits(int siteRate, int siteBurst, int sessionRate,
+    int sessionBurst)
+{
+    logSiteRate = siteRate;
+    logSiteBurst = siteBurst;
+    logSessionRate = sessionRate;
+    logSessionBurst = sessionBurst;
+#ifdef LOG_ASYNC_SUPPORTED
+    __atomic_add_fetch(&logLimitGeneration, 1, __ATOMIC_RELEASE);
+#else
+    logLimitGeneration++;
+#endif
+}
+
+void SetLogSession(uint32_t sessionID)
+{
+    logSession = sessionID;
+}
+
+unsigned long GetSuppressedLogMessages(void)
+{
+#ifdef LOG_ASYNC_SUPPORTED
+    return __atomic_load_n(&logSuppressedTotal, __ATOMIC_RELAXED);
+#else
+    return logSuppressedTotal;
+#endif
+}
+
+static unsigned long LogMillis(void)
+{
+#ifdef _POSIX_VERSION
+    struct timespec now;
+#ifdef CLOCK_MONOTONIC_COARSE
+    /* A few milliseconds of resolution is plenty for the rate limits. */
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+    return (unsigned long)now.tv_sec * 1000UL +
+        (unsigned long)(now.tv_nsec / 1000000L);
+#else
+    return (unsigned long)time(NULL) * 1000UL;
+#endif
+}
+
+/**
+ * Find the bucket for a source, taking over the slot if another source
+ * was using it. The other source's unreported count is returned through
+ * evicted so it isn't lost.
  */
-void _LogMessage(FILE *stream, LogLevel level, const char *format, va_list args)
+static LogBucket *GetLogBucket(LogBucket *buckets, const char *file,
+    unsigned long key, int burst, unsigned long now, LogBucket *evicted)
+{
+    LogBucket *bucket;
+    unsigned long hash;
+
+    hash = (key ^ ((unsigned long)file >> 4)) * 2654435761UL;
+    bucket = &buckets[(hash >> 8) & (LOG_RATE_SLOTS - 1)];
+    if (bucket->file != file || bucket->key != key || bucket->last == 0)
+    {
+        *evicted = *bucket;
+        bucket->file = file;
+        bucket->key = key;
+        bucket->tokens = burst * 1000L;
+        bucket->last = now;
+        bucket->suppressed = 0;
+    }
+    return bucket;
+}
+
+static bool TakeLogToken(LogBucket *bucket, int rate, int burst,
+    unsigned long now)
+{
+    unsigned long elapsed = now - bucket->last;
+
+    if (elapsed > (unsigned long)burst * 1000UL)
+    {
+        elapsed = (unsigned long)burst * 1000UL;
+    }
+    bucket->last = now;
+    bucket->tokens += (long)elapsed * rate;
+    if (bucket->tokens > burst * 1000L)
+    {
+        bucket->tokens = burst * 1000L;
+    }
+    if (bucket->tokens < 1000)
+    {
+        bucket->suppressed++;
+#ifdef LOG_ASYNC_SUPPORTED
+        __atomic_add_fetch(&logSuppressedTotal, 1, __ATOMIC_RELAXED);
+#else
+        logSuppressedTotal++;
+#endif
+        return FALSE;
+    }
+    bucket->tokens -= 1000;
+    return TRUE;
+}
+
+static void ReportSuppressed(const LogBucket *bucket)
 {
-    char ts[20];
-    time_t now;
-    struct tm *tm_info;
-    if (stream == NULL || level < LOG_LEVEL)
+    if (bucket->suppressed == 0)
     {
         return;
     }
+    if (bucket->file != NULL)
+    {
+        LogMessage(LOG_WARN, "Suppressed %lu messages from %s:%lu",
+            bucket->suppressed, bucket->file, bucket->key);
+    }
+    else
+    {
+        LogMessage(LOG_WARN, "[%lu] Suppressed %lu messages",
+            bucket->key, bucket->suppressed);
+    }
+}
 
-    memset(ts, 0, sizeof(ts));
-    now = time(NULL);
-    tm_info = localtime(&now);
-    if (tm_info != NULL)
+bool AllowLogMessage(const char *file, int line)
+{
+    LogBucket *site, *session;
+    LogBucket reports[4];
+    unsigned long now, generation;
+    bool allowed = TRUE;
+    int i, count = 0;
+
+    if (logSiteRate <= 0 && (logSessionRate <= 0 || logSession == 0))
+    {
+        return TRUE;
+    }
+#ifdef LOG_ASYNC_SUPPORTED
+    generation = __atomic_load_n(&logLimitGeneration, __ATOMIC_ACQUIRE);
+#else
+    generation = logLimitGeneration;
+#endif
+    if (generation != logBucketGeneration)
+    {
+        memset(logSites, 0, sizeof(logSites));
+        memset(logSessions, 0, sizeof(logSessions));
+        logBucketGeneration = generation;
+    }
+    memset(reports, 0, sizeof(reports));
+    now = LogMillis();
+    if (now == 0)
+    {
+        now = 1;
+    }
+    if (logSiteRate > 0)
     {
-        strftime(ts, sizeof(ts), "%Y-%m-%d %H:%M:%S", tm_info);
+        site = GetLogBucket(logSites, file, (unsigned long)line,
+            logSiteBurst, now, &reports[count++]);
+        allowed = TakeLogToken(site, logSiteRate, logSiteBurst, now);
+        if (allowed)
+        {
+            reports[count++] = *site;
+            site->suppressed = 0;
+        }
     }
+    if (allowed && logSessionRate > 0 && logSession != 0)
+    {
+        session = GetLogBucket(logSessions, NULL, logSession,
+            logSessionBurst, now, &reports[count++]);
+        allowed = TakeLogToken(session, logSessionRate, logSessionBurst,
+            now);
+        if (allowed)
+        {
+            reports[count++] = *session;
+            session->suppressed = 0;
+        }
+    }
+    for (i = 0; i < count; i++)
+    {
+        ReportSuppressed(&reports[i]);
+    }
+    return allowed;
+}
 
-    fprintf(stream, "%s [%s] ", ts, LEVELS[level]);
-    vfprintf(stream, format, args);
-    fprintf(stream, "\n");
-    fflush(stream);
+/** 
+ * Helper method called by other methods. The message is formatted once and
+ * then either queued for the writer thread or written to stderr and the
+ * log file.
+ */
+static void LogV(LogLevel level, const char *format, va_list args)
+{
+    char line[LOG_MESSAGE_SIZE];
+
+    if (level < LOG_LEVEL)
+    {
+        return;
+    }
+#ifdef LOG_ASYNC_SUPPORTED
+    if (__atomic_load_n(&logAsync, __ATOMIC_ACQUIRE))
+    {
+        EnqueueLogLine(level, format, args);
+        return;
+    }
+#endif
+    FormatLogLine(line, sizeof(line), level, format, args);
+    WriteLogLine(line);
 }
 
 /**
@@ -114,80 +782,50 @@ void LogMessage(LogLevel level, const char *format, ...)
 {
     va_list args;
     va_start(args, format);
-    _LogMessage(stderr, level, format, args);
+    LogV(level, format, args);
     va_end(args);
-    if (LOG != NULL)
-    {
-        va_start(args, format);
-        _LogMessage(LOG, level, format, args);
-        va_end(args);
-    }
 }
 
 /**
  * Log a debug message to the log file and stderr. 
  */
-void Debug(const char* format, ...)
+void _Debug(const char* format, ...)
 {
     va_list args;
     va_start(args, format);
-    _LogMessage(stderr, LOG_DEBUG, format, args);
+    LogV(LOG_DEBUG, format, args);
     va_end(args);
-    if (LOG != NULL)
-    {
-        va_start(args, format);
-        _LogMessage(LOG, LOG_DEBUG, format, args);
-        va_end(args);
-    }
 }
 
 /**
  * Log an info message to the log file and stderr. 
  */
-void Info(const char* format, ...)
+void _Info(const char* format, ...)
 {
     va_list args;
     va_start(args, format);
-    _LogMessage(stderr, LOG_INFO, format, args);
+    LogV(LOG_INFO, format, args);
     va_end(args);
-    if (LOG != NULL)
-    {
-        va_start(args, format);
-        _LogMessage(LOG, LOG_INFO, format, args);
-        va_end(args);
-    }
 }
 
 /**
  * Log a warning message to the log file and stderr. 
  */
-void Warn(const char* format, ...)
+void _Warn(const char* format, ...)
 {
     va_list args;
     va_start(args, format);
-    _LogMessage(stderr, LOG_WARN, format, args);
+    LogV(LOG_WARN, format, args);
     va_end(args);
-    if (LOG != NULL)
-    {
-        va_start(args, format);
-        _LogMessage(LOG, LOG_WARN, format, args);
-        va_end(args);
-    }
 }
 
 /**
  * Log an error message to the log file and stderr. 
  */
-void Error(const char* format, ...)
+void _Error(const char* format, ...)
 {
     va_list args;
     va_start(args, format);
-    _LogMessage(stderr, LOG_ERROR, format, args);
+    LogV(LOG_ERROR, format, args);
     va_end(args);
-    if (LOG != NULL)
-    {
-        va_start(args, format);
-        _LogMessage(LOG, LOG_ERROR, format, args);
-        va_end(args);
-    }
 }
@@ -27,6 +27,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vbbs/map.h>
 #include <vbbs/list.h>
 #include <vbbs/crc.h>
+#include <vbbs/memory.h>
 #include <string.h>
 #include <stdlib.h>
 
@@ -43,16 +44,16 @@ MapEntry *NewMapEntry(const char *key, void *value,
 
     keyLength = strlen(key);
 
-    entry = malloc(sizeof(MapEntry));
+    entry = TrackedMalloc(sizeof(MapEntry));
     if (!entry) 
     {
         return NULL;
     }
 
-    entry->key = malloc(keyLength + 1);
+    entry->key = TrackedMalloc(keyLength + 1);
     if (!entry->key) 
     {
-        free(entry);
+        TrackedFree(entry);
         return NULL;
     }
     memcpy(entry->key, key, keyLength);
@@ -97,7 +98,7 @@ void DestroyMapEntry(MapEntry *entry)
 
     if (entry->key) 
     {
-        free(entry->key);
+        TrackedFree(entry->key);
         entry->key = NULL;
     }
 
@@ -107,13 +108,13 @@ void DestroyMapEntry(MapEntry *entry)
         entry->value = NULL;
         DestroyMapEntryValue(entry->map, value, entry->valueDestructor);
     }
-    free(entry);
+    TrackedFree(entry);
 }
 
 Map *NewMap(ListItemDestructor valueDestructor)
 {
     int i, j;
-    Map *map = malloc(sizeof(Map));
+    Map *map = TrackedMalloc(sizeof(Map));
     if (!map) 
     {
         return NULL;
@@ -123,10 +124,10 @@ Map *NewMap(ListItemDestructor valueDestructor)
 
     /** TODO: Make map self-balancing with fewer starting buckets. */
     map->bucketCount = 256;
-    map->buckets = malloc(sizeof(ArrayList *) * map->bucketCount);
+    map->buckets = TrackedMalloc(sizeof(ArrayList *) * map->bucketCount);
     if (!map->buckets) 
     {
-        free(map);
+        TrackedFree(map);
         return NULL;
     }
 
@@ -139,8 +140,8 @@ Map *NewMap(ListItemDestructor valueDestructor)
             {
                 DestroyArrayList(map->buckets[j]);
             }
-            free(map->buckets);
-            free(map);
+            TrackedFree(map->buckets);
+            TrackedFree(map);
             return NULL;
         }
     }
@@ -164,10 +165,10 @@ void DestroyMap(Map *map)
         {
             DestroyArrayList(map->buckets[i]);
         }
-        free(map->buckets);
+        TrackedFree(map->buckets);
         map->buckets = NULL;
     }
-    free(map);
+    TrackedFree(map);
 }
 
 /** The key will be copied. */
@@ -184,6 +185,7 @@ void MapPutWithDestructor(Map *map, const char *key, void *value,
     ArrayList *bucket = NULL;
     MapEntry *entry = NULL;
     void *oldValue = NULL;
+    MemoryAccount *account;
 
     if (!map || !key) 
     {
@@ -209,7 +211,11 @@ void MapPutWithDestructor(Map *map, const char *key, void *value,
         }
     }
 
+    /* Entries are charged to whoever created the map, not the caller. */
+    account = GetMemoryAccount();
+    SetMemoryAccount(GetMemoryAccountOf(map));
     entry = NewMapEntry(key, value, valueDestructor);
+    SetMemoryAccount(account);
     if (!entry) 
     {
         return;
@@ -0,0 +1,223 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <vbbs/memory.h>
+#include <vbbs/metrics.h>
+
+/** Kept ahead of each block, aligned as malloc would align it. */
+typedef union MemoryHeader
+{
+    struct
+    {
+        size_t size;
+        MemoryAccount *account;
+    } block;
+    long l;
+    double d;
+    void *p;
+} MemoryHeader;
+
+#define HEADER(memory) ((MemoryHeader *)(memory) - 1)
+
+static THREAD_LOCAL MemoryAccount *currentAccount = NULL;
+static size_t memoryLimit = 0;
+
+static void Charge(MemoryAccount *account, size_t size)
+{
+    AddToGauge(&memoryBytes, (long)size);
+    if (account != NULL)
+    {
+        account->bytes += size;
+        account->blocks++;
+        if (account->bytes > account->peak)
+        {
+            account->peak = account->bytes;
+        }
+    }
+}
+
+static void Credit(MemoryAccount *account, size_t size)
+{
+    AddToGauge(&memoryBytes, -(long)size);
+    if (account != NULL)
+    {
+        account->bytes -= size;
+        account->blocks--;
+        if (account->released && account->blocks == 0)
+        {
+            free(account);
+        }
+    }
+}
+
+MemoryAccount *NewMemoryAccount(void)
+{
+    MemoryAccount *account = (MemoryAccount *)malloc(sizeof(MemoryAccount));
+
+    if (account != NULL)
+    {
+        memset(account, 0, sizeof(MemoryAccount));
+    }
+    return account;
+}
+
+void ReleaseMemoryAccount(MemoryAccount *account)
+{
+    if (account == NULL)
+    {
+        return;
+    }
+    if (currentAccount == account)
+    {
+        currentAccount = NULL;
+    }
+    if (account->blocks == 0)
+    {
+        free(account);
+    }
+    else
+    {
+        account->released = TRUE;
+    }
+}
+
+void SetMemoryAccount(MemoryAccount *account)
+{
+    currentAccount = account;
+}
+
+MemoryAccount *GetMemoryAccount(void)
+{
+    return currentAccount;
+}
+
+void *TrackedMalloc(size_t size)
+{
+    MemoryHeader *header = (MemoryHeader *)malloc(sizeof(MemoryHeader) + size);
+
+    if (header == NULL)
+    {
+        return NULL;
+    }
+    header->block.size = size;
+    header->block.account = currentAccount;
+    Charge(currentAccount, size);
+    return header + 1;
+}
+
+void *TrackedCalloc(size_t count, size_t size)
+{
+    void *memory;
+
+    if (size > 0 && count > ((size_t)-1 - sizeof(MemoryHeader)) / size)
+    {
+        return NULL;
+    }
+    memory = TrackedMalloc(count * size);
+    if (memory != NULL)
+    {
+        memset(memory, 0, count * size);
+    }
+    return memory;
+}
+
+void *TrackedRealloc(void *memory, size_t size)
+{
+    MemoryHeader *header;
+    MemoryAccount *account;
+    size_t oldSize;
+
+    if (memory == NULL)
+    {
+        return TrackedMalloc(size);
+    }
+    header = HEADER(memory);
+    account = header->block.account;
+    oldSize = header->block.size;
+    header = (MemoryHeader *)realloc(header, sizeof(MemoryHeader) + size);
+    if (header == NULL)
+    {
+        /* The old block is still valid and still charged. */
+        return NULL;
+    }
+    header->block.size = size;
+    AddToGauge(&memoryBytes, (long)size - (long)oldSize);
+    if (account != NULL)
+    {
+        account->bytes = account->bytes - oldSize + size;
+        if (account->bytes > account->peak)
+        {
+            account->peak = account->bytes;
+        }
+    }
+    return header + 1;
+}
+
+void TrackedFree(void *memory)
+{
+    MemoryHeader *header;
+
+    if (memory == NULL)
+    {
+        return;
+    }
+    header = HEADER(memory);
+    Credit(header->block.account, header->block.size);
+    free(header);
+}
+
+MemoryAccount *GetMemoryAccountOf(const void *memory)
+{
+    if (memory == NULL)
+    {
+        return NULL;
+    }
+    return HEADER(memory)->block.account;
+}
+
+size_t GetTrackedMemory(void)
+{
+    long bytes = GetGaugeValue(&memoryBytes);
+    return bytes > 0 ? (size_t)bytes : 0;
+}
+
+void SetMemoryLimit(size_t limit)
+{
+    memoryLimit = limit;
+}
+
+size_t GetMemoryLimit(void)
+{
+    return memoryLimit;
+}
+
+bool IsMemoryExhausted(void)
+{
+    return memoryLimit > 0 && GetTrackedMemory() > memoryLimit;
+}
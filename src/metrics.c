@@ -0,0 +1,539 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/metrics.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* GCC style atomics keep shards exact when threads share them. */
+#if defined(__GNUC__)
+#define METRIC_ADD(target, n) \
+    __atomic_fetch_add(&(target), (n), __ATOMIC_RELAXED)
+#define METRIC_LOAD(target) __atomic_load_n(&(target), __ATOMIC_RELAXED)
+#define METRIC_STORE(target, n) \
+    __atomic_store_n(&(target), (n), __ATOMIC_RELAXED)
+#else
+#define METRIC_ADD(target, n) ((target) += (n))
+#define METRIC_LOAD(target) (target)
+#define METRIC_STORE(target, n) ((target) = (n))
+#endif
+
+Counter connectionsAccepted;
+Counter bytesReceived;
+Counter bytesSent;
+Counter authSuccesses;
+Counter authFailures;
+Counter userDBSaves;
+Gauge activeSessions;
+Histogram readTime;
+Histogram writeTime;
+Histogram authTime;
+Histogram saveUserDBTime;
+Histogram loopIterationTime;
+Histogram loopLag;
+Histogram handlerTime;
+Counter slowHandlers;
+Gauge pendingWork;
+Counter rejectedWork;
+Histogram workLatency;
+Counter throttledConnections;
+Counter throttledLogins;
+Counter poolAllocations;
+Gauge poolSlabs;
+Gauge memoryBytes;
+Histogram sessionMemory;
+Counter memoryDisconnects;
+Counter memoryRefusedConnections;
+Counter outputPauses;
+Counter droppedOutput;
+Counter outputDelays;
+
+static Metric metrics[METRICS_MAX];
+static int metricCount = 0;
+
+static int nextShard = 0;
+static THREAD_LOCAL int threadShard = -1;
+
+static int GetShard(void)
+{
+    if (threadShard < 0)
+    {
+#if defined(__GNUC__)
+        threadShard = __atomic_fetch_add(&nextShard, 1, __ATOMIC_RELAXED) %
+            METRICS_SHARDS;
+#else
+        threadShard = nextShard++ % METRICS_SHARDS;
+#endif
+    }
+    return threadShard;
+}
+
+unsigned long MonotonicNanos(void)
+{
+#ifdef _POSIX_VERSION
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long)now.tv_sec * 1000000000UL +
+        (unsigned long)now.tv_nsec;
+#else
+    return (unsigned long)((double)clock() * 1e9 / CLOCKS_PER_SEC);
+#endif
+}
+
+void InitMetrics(void)
+{
+    if (metricCount > 0)
+    {
+        return;
+    }
+    RegisterMetric("vbbs_connections_accepted_total",
+        "Telnet connections accepted.", METRIC_COUNTER, &connectionsAccepted);
+    RegisterMetric("vbbs_received_bytes_total",
+        "Bytes read from connections.", METRIC_COUNTER, &bytesReceived);
+    RegisterMetric("vbbs_sent_bytes_total",
+        "Bytes written to connections.", METRIC_COUNTER, &bytesSent);
+    RegisterMetric("vbbs_auth_successes_total",
+        "Successful password checks.", METRIC_COUNTER, &authSuccesses);
+    RegisterMetric("vbbs_auth_failures_total",
+        "Failed password checks.", METRIC_COUNTER, &authFailures);
+    RegisterMetric("vbbs_userdb_saves_total",
+        "Times the user database was saved.", METRIC_COUNTER, &userDBSaves);
+    RegisterMetric("vbbs_active_sessions",
+        "Sessions currently connected.", METRIC_GAUGE, &activeSessions);
+    RegisterMetric("vbbs_read_nanoseconds",
+        "Time spent reading from a session and handling its input.",
+        METRIC_HISTOGRAM, &readTime);
+    RegisterMetric("vbbs_write_nanoseconds",
+        "Time spent writing to a session.", METRIC_HISTOGRAM, &writeTime);
+    RegisterMetric("vbbs_auth_nanoseconds",
+        "Time taken to check a password.", METRIC_HISTOGRAM, &authTime);
+    RegisterMetric("vbbs_userdb_save_nanoseconds",
+        "Time taken to save the user database.", METRIC_HISTOGRAM,
+        &saveUserDBTime);
+    RegisterMetric("vbbs_loop_iteration_nanoseconds",
+        "Time spent in one pass of the event loop, not counting the wait.",
+        METRIC_HISTOGRAM, &loopIterationTime);
+    RegisterMetric("vbbs_loop_lag_nanoseconds",
+        "Time ready input waited behind other sessions before being read.",
+        METRIC_HISTOGRAM, &loopLag);
+    RegisterMetric("vbbs_handler_nanoseconds",
+        "Time spent in one call of a session's event handler.",
+        METRIC_HISTOGRAM, &handlerTime);
+    RegisterMetric("vbbs_slow_handlers_total",
+        "Event handler calls slower than the slow handler threshold.",
+        METRIC_COUNTER, &slowHandlers);
+    RegisterMetric("vbbs_pending_work",
+        "Jobs given to the worker pool and not yet completed.",
+        METRIC_GAUGE, &pendingWork);
+    RegisterMetric("vbbs_rejected_work_total",
+        "Jobs turned away because the worker queue was full.",
+        METRIC_COUNTER, &rejectedWork);
+    RegisterMetric("vbbs_work_nanoseconds",
+        "Time from submitting a job to the worker pool to its completion.",
+        METRIC_HISTOGRAM, &workLatency);
+    RegisterMetric("vbbs_throttled_connections_total",
+        "Connections refused because of failed logins from the address.",
+        METRIC_COUNTER, &throttledConnections);
+    RegisterMetric("vbbs_throttled_logins_total",
+        "Logins refused because of failed logins from the address.",
+        METRIC_COUNTER, &throttledLogins);
+    RegisterMetric("vbbs_pool_allocations_total",
+        "Objects taken from the session, connection and buffer pools.",
+        METRIC_COUNTER, &poolAllocations);
+    RegisterMetric("vbbs_pool_slabs",
+        "Slabs the pools have allocated from malloc.",
+        METRIC_GAUGE, &poolSlabs);
+    RegisterMetric("vbbs_memory_bytes",
+        "Bytes in tracked allocations by lists, maps, buffers and sessions.",
+        METRIC_GAUGE, &memoryBytes);
+    RegisterMetric("vbbs_session_memory_bytes",
+        "Most memory each session held after any of its handlers.",
+        METRIC_HISTOGRAM, &sessionMemory);
+    RegisterMetric("vbbs_memory_disconnects_total",
+        "Sessions disconnected for passing the session memory limit.",
+        METRIC_COUNTER, &memoryDisconnects);
+    RegisterMetric("vbbs_memory_refused_connections_total",
+        "Connections refused because tracked memory passed its limit.",
+        METRIC_COUNTER, &memoryRefusedConnections);
+    RegisterMetric("vbbs_output_pauses_total",
+        "Times a session's queued output reached the high watermark.",
+        METRIC_COUNTER, &outputPauses);
+    RegisterMetric("vbbs_dropped_output_bytes_total",
+        "Output bytes dropped because the output buffer was at its limit.",
+        METRIC_COUNTER, &droppedOutput);
+    RegisterMetric("vbbs_output_delays_total",
+        "Writes held back to pace output at the connection speed.",
+        METRIC_COUNTER, &outputDelays);
+}
+
+bool RegisterMetric(const char *name, const char *help, MetricType type,
+    void *metric)
+{
+    if (name == NULL || metric == NULL || metricCount >= METRICS_MAX ||
+        FindMetric(name) != NULL)
+    {
+        return FALSE;
+    }
+    metrics[metricCount].name = name;
+    metrics[metricCount].help = help;
+    metrics[metricCount].type = type;
+    metrics[metricCount].metric = metric;
+    metricCount++;
+    return TRUE;
+}
+
+int GetMetricCount(void)
+{
+    return metricCount;
+}
+
+const Metric *GetMetric(int index)
+{
+    if (index < 0 || index >= metricCount)
+    {
+        return NULL;
+    }
+    return &metrics[index];
+}
+
+const Metric *FindMetric(const char *name)
+{
+    int i;
+
+    for (i = 0; i < metricCount; i++)
+    {
+        if (strcmp(metrics[i].name, name) == 0)
+        {
+            return &metrics[i];
+        }
+    }
+    return NULL;
+}
+
+void AddToCounter(Counter *counter, unsigned long n)
+{
+    METRIC_ADD(counter->shards[GetShard()].value, n);
+}
+
+unsigned long GetCounterValue(const Counter *counter)
+{
+    unsigned long total = 0;
+    int i;
+
+    for (i = 0; i < METRICS_SHARDS; i++)
+    {
+        total += METRIC_LOAD(counter->shards[i].value);
+    }
+    return total;
+}
+
+void SetGauge(Gauge *gauge, long value)
+{
+    METRIC_STORE(gauge->value, value);
+}
+
+void AddToGauge(Gauge *gauge, long n)
+{
+    METRIC_ADD(gauge->value, n);
+}
+
+long GetGaugeValue(const Gauge *gauge)
+{
+    return METRIC_LOAD(gauge->value);
+}
+
+/** Index of the highest set bit. value must not be 0. */
+static int HighestBit(unsigned long value)
+{
+#if defined(__GNUC__)
+    return (int)(sizeof(unsigned long) * 8 - 1) - __builtin_clzl(value);
+#else
+    int bit = 0;
+    while (value >>= 1)
+    {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+static int HistogramBucket(unsigned long value)
+{
+    int bit;
+
+    if (value < HISTOGRAM_SUB_BUCKETS)
+    {
+        return (int)value;
+    }
+    bit = HighestBit(value);
+    if (bit >= HISTOGRAM_MAX_BITS)
+    {
+        return HISTOGRAM_BUCKETS - 1;
+    }
+    /* The top HISTOGRAM_SUB_BITS + 1 bits pick the bucket. */
+    return (bit - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS +
+        (int)((value >> (bit - HISTOGRAM_SUB_BITS)) &
+        (HISTOGRAM_SUB_BUCKETS - 1));
+}
+
+unsigned long HistogramBucketValue(int index)
+{
+    int bit;
+
+    if (index < HISTOGRAM_SUB_BUCKETS)
+    {
+        return (unsigned long)index;
+    }
+    bit = index / HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BITS - 1;
+    return (unsigned long)(HISTOGRAM_SUB_BUCKETS +
+        index % HISTOGRAM_SUB_BUCKETS) << (bit - HISTOGRAM_SUB_BITS);
+}
+
+void RecordHistogram(Histogram *histogram, unsigned long value)
+{
+    HistogramShard *shard = &histogram->shards[GetShard()];
+
+    METRIC_ADD(shard->buckets[HistogramBucket(value)], 1);
+    METRIC_ADD(shard->count, 1);
+    METRIC_ADD(shard->sum, value);
+}
+
+unsigned long GetHistogramCount(const Histogram *histogram)
+{
+    unsigned long total = 0;
+    int i;
+
+    for (i = 0; i < METRICS_SHARDS; i++)
+    {
+        total += METRIC_LOAD(histogram->shards[i].count);
+    }
+    return total;
+}
+
+unsigned long GetHistogramSum(const Histogram *histogram)
+{
+    unsigned long total = 0;
+    int i;
+
+    for (i = 0; i < METRICS_SHARDS; i++)
+    {
+        total += METRIC_LOAD(histogram->shards[i].sum);
+    }
+    return total;
+}
+
+void GetHistogramBuckets(const Histogram *histogram, unsigned long *buckets)
+{
+    int i, b;
+
+    memset(buckets, 0, sizeof(unsigned long) * HISTOGRAM_BUCKETS);
+    for (i = 0; i < METRICS_SHARDS; i++)
+    {
+        for (b = 0; b < HISTOGRAM_BUCKETS; b++)
+        {
+            buckets[b] += METRIC_LOAD(histogram->shards[i].buckets[b]);
+        }
+    }
+}
+
+unsigned long GetHistogramPercentile(const Histogram *histogram,
+    double fraction)
+{
+    unsigned long buckets[HISTOGRAM_BUCKETS];
+    unsigned long total = 0, seen = 0, target;
+    int b;
+
+    GetHistogramBuckets(histogram, buckets);
+    for (b = 0; b < HISTOGRAM_BUCKETS; b++)
+    {
+        total += buckets[b];
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+    target = (unsigned long)(fraction * (double)total + 0.5);
+    if (target < 1)
+    {
+        target = 1;
+    }
+    for (b = 0; b < HISTOGRAM_BUCKETS - 1; b++)
+    {
+        seen += buckets[b];
+        if (seen >= target)
+        {
+            /* Values in this bucket are below the next one's start. */
+            return HistogramBucketValue(b + 1) - 1;
+        }
+    }
+    return HistogramBucketValue(HISTOGRAM_BUCKETS - 1);
+}
+
+void ResetHistogram(Histogram *histogram)
+{
+    memset(histogram, 0, sizeof(Histogram));
+}
+
+void InitMetricsText(MetricsText *out, char *buffer, int size)
+{
+    out->text = buffer;
+    out->length = 0;
+    out->size = size;
+    out->truncated = FALSE;
+    if (size > 0)
+    {
+        buffer[0] = '\0';
+    }
+}
+
+void AppendMetricsText(MetricsText *out, const char *format, ...)
+{
+    va_list args;
+    int space, n;
+
+    space = out->size - out->length;
+    if (out->truncated || space <= 1)
+    {
+        out->truncated = TRUE;
+        return;
+    }
+    va_start(args, format);
+    n = vsnprintf(out->text + out->length, space, format, args);
+    va_end(args);
+    if (n < 0 || n >= space)
+    {
+        /* Drop the partial line. */
+        out->text[out->length] = '\0';
+        out->truncated = TRUE;
+        return;
+    }
+    out->length += n;
+}
+
+static const char *PrometheusType(MetricType type)
+{
+    switch (type)
+    {
+        case METRIC_COUNTER:
+            return "counter";
+        case METRIC_GAUGE:
+            return "gauge";
+        default:
+            return "histogram";
+    }
+}
+
+static void WritePrometheusHistogram(MetricsText *out, const char *name,
+    const Histogram *histogram)
+{
+    unsigned long buckets[HISTOGRAM_BUCKETS];
+    unsigned long cumulative = 0, bound;
+    int b = 0, bit;
+
+    GetHistogramBuckets(histogram, buckets);
+    for (bit = 0; bit < HISTOGRAM_MAX_BITS; bit++)
+    {
+        /* Everything below 2^(bit + 1). */
+        bound = 1UL << (bit + 1);
+        while (b < HISTOGRAM_BUCKETS - 1 && HistogramBucketValue(b) < bound)
+        {
+            cumulative += buckets[b++];
+        }
+        AppendMetricsText(out, "%s_bucket{le=\"%lu\"} %lu\n", name,
+            bound - 1, cumulative);
+    }
+    AppendMetricsText(out, "%s_bucket{le=\"+Inf\"} %lu\n", name,
+        GetHistogramCount(histogram));
+    AppendMetricsText(out, "%s_sum %lu\n%s_count %lu\n", name,
+        GetHistogramSum(histogram), name, GetHistogramCount(histogram));
+}
+
+void WritePrometheusMetrics(MetricsText *out)
+{
+    const Metric *metric;
+    int i;
+
+    for (i = 0; i < metricCount; i++)
+    {
+        metric = &metrics[i];
+        AppendMetricsText(out, "# HELP %s %s\n# TYPE %s %s\n", metric->name,
+            metric->help, metric->name, PrometheusType(metric->type));
+        switch (metric->type)
+        {
+            case METRIC_COUNTER:
+                AppendMetricsText(out, "%s %lu\n", metric->name,
+                    GetCounterValue((const Counter *)metric->metric));
+                break;
+            case METRIC_GAUGE:
+                AppendMetricsText(out, "%s %ld\n", metric->name,
+                    GetGaugeValue((const Gauge *)metric->metric));
+                break;
+            case METRIC_HISTOGRAM:
+                WritePrometheusHistogram(out, metric->name,
+                    (const Histogram *)metric->metric);
+                break;
+        }
+    }
+}
+
+void WriteJsonMetrics(MetricsText *out)
+{
+    const Metric *metric;
+    const Histogram *histogram;
+    int i;
+
+    for (i = 0; i < metricCount; i++)
+    {
+        metric = &metrics[i];
+        AppendMetricsText(out, "%s\"%s\": ", i > 0 ? ", " : "",
+            metric->name);
+        switch (metric->type)
+        {
+            case METRIC_COUNTER:
+                AppendMetricsText(out, "%lu",
+                    GetCounterValue((const Counter *)metric->metric));
+                break;
+            case METRIC_GAUGE:
+                AppendMetricsText(out, "%ld",
+                    GetGaugeValue((const Gauge *)metric->metric));
+                break;
+            case METRIC_HISTOGRAM:
+                histogram = (const Histogram *)metric->metric;
+                AppendMetricsText(out, "{\"count\": %lu, \"sum\": %lu, "
+                    "\"p50\": %lu, \"p90\": %lu, \"p99\": %lu, "
+                    "\"max\": %lu}",
+                    GetHistogramCount(histogram), GetHistogramSum(histogram),
+                    GetHistogramPercentile(histogram, 0.5),
+                    GetHistogramPercentile(histogram, 0.9),
+                    GetHistogramPercentile(histogram, 0.99),
+                    GetHistogramPercentile(histogram, 1.0));
+                break;
+        }
+    }
+}
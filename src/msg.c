@@ -0,0 +1,74 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+#include <string.h>
+#include <time.h>
+#include <vbbs/msg.h>
+
+static void CopyField(char *dest, const char *src, size_t size)
+{
+    if (src == NULL)
+    {
+        dest[0] = '\0';
+        return;
+    }
+    strncpy(dest, src, size - 1);
+    dest[size - 1] = '\0';
+}
+
+void InitMessageHeader(MessageHeader *header, const char *from,
+    const char *to, const char *subject)
+{
+    if (header == NULL)
+    {
+        return;
+    }
+    memset(header, 0, sizeof(MessageHeader));
+    header->posted = (uint32_t)time(NULL);
+    CopyField(header->from, from, sizeof(header->from));
+    CopyField(header->to, to, sizeof(header->to));
+    CopyField(header->subject, subject, sizeof(header->subject));
+}
+
+bool IsMessageDeleted(const MessageHeader *header)
+{
+    return header == NULL || (header->flags & MESSAGE_DELETED) != 0;
+}
+
+bool IsMessageVisible(const MessageHeader *header, const User *user)
+{
+    if (IsMessageDeleted(header) || user == NULL)
+    {
+        return FALSE;
+    }
+    if ((header->flags & MESSAGE_PRIVATE) == 0)
+    {
+        return TRUE;
+    }
+    return header->fromUserID == user->userID ||
+        strcasecmp(header->to, user->username) == 0;
+}
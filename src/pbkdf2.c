@@ -0,0 +1,169 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+#include <string.h>
+#include <vbbs/pbkdf2.h>
+
+/*
+ * The padding for a 20 byte message that follows a 64 byte pad block,
+ * 84 bytes or 672 (0x2A0) bits in all. Inner and outer hashes in the
+ * PBKDF2 loop are both this shape.
+ */
+#define HMAC_MESSAGE_BITS_HIGH 0x02
+#define HMAC_MESSAGE_BITS_LOW 0xA0
+
+static void StoreDigest(const uint32_t state[5], unsigned char *out)
+{
+    int i;
+
+    for (i = 0; i < SHA1_DIGEST_SIZE; i++)
+    {
+        out[i] = (unsigned char)(state[i >> 2] >> ((3 - (i & 3)) * 8));
+    }
+}
+
+void HMACSHA1Init(HMAC_SHA1_CTX *context, const unsigned char *key,
+    uint32_t keyLength)
+{
+    unsigned char pad[SHA1_BLOCK_SIZE];
+    unsigned char digest[SHA1_DIGEST_SIZE];
+    SHA1_CTX sha;
+    int i;
+
+    memset(pad, 0, sizeof(pad));
+    if (keyLength > SHA1_BLOCK_SIZE)
+    {
+        /* Long keys are hashed down first. */
+        SHA1Init(&sha);
+        SHA1Update(&sha, key, keyLength);
+        SHA1Final(digest, &sha);
+        memcpy(pad, digest, sizeof(digest));
+    }
+    else
+    {
+        memcpy(pad, key, keyLength);
+    }
+
+    for (i = 0; i < SHA1_BLOCK_SIZE; i++)
+    {
+        pad[i] ^= 0x36;
+    }
+    SHA1Init(&context->inner);
+    SHA1Update(&context->inner, pad, sizeof(pad));
+
+    for (i = 0; i < SHA1_BLOCK_SIZE; i++)
+    {
+        pad[i] ^= 0x36 ^ 0x5C;
+    }
+    SHA1Init(&context->outer);
+    SHA1Update(&context->outer, pad, sizeof(pad));
+
+    memset(pad, 0, sizeof(pad));
+    memset(digest, 0, sizeof(digest));
+}
+
+void HMACSHA1(const HMAC_SHA1_CTX *context, const unsigned char *data,
+    uint32_t length, unsigned char digest[SHA1_DIGEST_SIZE])
+{
+    SHA1_CTX sha;
+
+    sha = context->inner;
+    SHA1Update(&sha, data, length);
+    SHA1Final(digest, &sha);
+    sha = context->outer;
+    SHA1Update(&sha, digest, SHA1_DIGEST_SIZE);
+    SHA1Final(digest, &sha);
+}
+
+void PBKDF2SHA1(const unsigned char *password, uint32_t passwordLength,
+    const unsigned char *salt, uint32_t saltLength, unsigned long iterations,
+    unsigned char *out, uint32_t outLength)
+{
+    HMAC_SHA1_CTX hmac;
+    SHA1_CTX sha;
+    unsigned char block[SHA1_BLOCK_SIZE];
+    unsigned char result[SHA1_DIGEST_SIZE];
+    unsigned char counter[4];
+    uint32_t state[5];
+    uint32_t blockIndex, length;
+    unsigned long n;
+    int i;
+
+    HMACSHA1Init(&hmac, password, passwordLength);
+    for (blockIndex = 1; outLength > 0; blockIndex++)
+    {
+        /* U1 = HMAC(password, salt || INT(blockIndex)) */
+        counter[0] = (unsigned char)(blockIndex >> 24);
+        counter[1] = (unsigned char)(blockIndex >> 16);
+        counter[2] = (unsigned char)(blockIndex >> 8);
+        counter[3] = (unsigned char)blockIndex;
+        sha = hmac.inner;
+        SHA1Update(&sha, salt, saltLength);
+        SHA1Update(&sha, counter, sizeof(counter));
+        SHA1Final(block, &sha);
+        sha = hmac.outer;
+        SHA1Update(&sha, block, SHA1_DIGEST_SIZE);
+        SHA1Final(block, &sha);
+        memcpy(result, block, SHA1_DIGEST_SIZE);
+
+        /**
+         * Un = HMAC(password, Un-1). The message always fits in one padded
+         * block, so it is built once and each hash is one SHA1Transform
+         * from the precomputed pad state, writing its digest back over the
+         * message.
+         */
+        memset(block + SHA1_DIGEST_SIZE, 0,
+            SHA1_BLOCK_SIZE - SHA1_DIGEST_SIZE);
+        block[SHA1_DIGEST_SIZE] = 0x80;
+        block[SHA1_BLOCK_SIZE - 2] = HMAC_MESSAGE_BITS_HIGH;
+        block[SHA1_BLOCK_SIZE - 1] = HMAC_MESSAGE_BITS_LOW;
+        for (n = 1; n < iterations; n++)
+        {
+            memcpy(state, hmac.inner.state, sizeof(state));
+            SHA1Transform(state, block);
+            StoreDigest(state, block);
+            memcpy(state, hmac.outer.state, sizeof(state));
+            SHA1Transform(state, block);
+            StoreDigest(state, block);
+            for (i = 0; i < SHA1_DIGEST_SIZE; i++)
+            {
+                result[i] ^= block[i];
+            }
+        }
+
+        length = MIN(outLength, SHA1_DIGEST_SIZE);
+        memcpy(out, result, length);
+        out += length;
+        outLength -= length;
+    }
+
+    memset(&hmac, 0, sizeof(hmac));
+    memset(&sha, 0, sizeof(sha));
+    memset(block, 0, sizeof(block));
+    memset(result, 0, sizeof(result));
+    memset(state, 0, sizeof(state));
+}
@@ -0,0 +1,146 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+#include <stdlib.h>
+#include <vbbs/pool.h>
+#include <vbbs/metrics.h>
+
+/** Objects are aligned as malloc would align them. */
+typedef union PoolAlign
+{
+    long l;
+    double d;
+    void *p;
+} PoolAlign;
+
+struct PoolSlab
+{
+    PoolSlab *next;
+    PoolAlign objects[1];
+};
+
+#ifndef POOL_DISABLED
+/** Carve a new slab into objects on the free list. */
+static bool GrowPool(Pool *pool)
+{
+    PoolSlab *slab;
+    char *object;
+    int i;
+
+    if (pool->objectSize < sizeof(void *))
+    {
+        pool->objectSize = sizeof(void *);
+    }
+    pool->objectSize = (pool->objectSize + sizeof(PoolAlign) - 1) /
+        sizeof(PoolAlign) * sizeof(PoolAlign);
+    if (pool->objectsPerSlab < 1)
+    {
+        pool->objectsPerSlab = 1;
+    }
+
+    slab = (PoolSlab *)malloc(offsetof(PoolSlab, objects) +
+        pool->objectSize * pool->objectsPerSlab);
+    if (slab == NULL)
+    {
+        return FALSE;
+    }
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->slabCount++;
+    AddToGauge(&poolSlabs, 1);
+
+    object = (char *)slab->objects;
+    for (i = 0; i < pool->objectsPerSlab; i++)
+    {
+        *(void **)object = pool->freeList;
+        pool->freeList = object;
+        object += pool->objectSize;
+    }
+    return TRUE;
+}
+#endif
+
+void *PoolAlloc(Pool *pool)
+{
+    void *object;
+
+#ifdef POOL_DISABLED
+    object = malloc(pool->objectSize);
+    if (object == NULL)
+    {
+        return NULL;
+    }
+#else
+    if (pool->freeList == NULL && !GrowPool(pool))
+    {
+        return NULL;
+    }
+    object = pool->freeList;
+    pool->freeList = *(void **)object;
+#endif
+
+    pool->allocations++;
+    pool->inUse++;
+    if (pool->inUse > pool->peakInUse)
+    {
+        pool->peakInUse = pool->inUse;
+    }
+    IncrementCounter(&poolAllocations);
+    return object;
+}
+
+void PoolFree(Pool *pool, void *object)
+{
+    if (object == NULL)
+    {
+        return;
+    }
+    pool->frees++;
+    pool->inUse--;
+#ifdef POOL_DISABLED
+    free(object);
+#else
+    *(void **)object = pool->freeList;
+    pool->freeList = object;
+#endif
+}
+
+void DestroyPool(Pool *pool)
+{
+    PoolSlab *slab;
+
+    while (pool->slabs != NULL)
+    {
+        slab = pool->slabs;
+        pool->slabs = slab->next;
+        free(slab);
+        AddToGauge(&poolSlabs, -1);
+    }
+    pool->freeList = NULL;
+    pool->inUse = 0;
+    pool->slabCount = 0;
+}
@@ -0,0 +1,746 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/globals.h>
+#include <vbbs/list.h>
+#include <vbbs/log.h>
+#include <vbbs/memory.h>
+#include <vbbs/msg.h>
+#include <vbbs/qwk.h>
+#include <vbbs/time.h>
+#include <vbbs/user.h>
+#include <vbbs/zip.h>
+#include <vbbs/db/lastread.h>
+#include <vbbs/db/msg.h>
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/** Bodies are read and converted this many bytes at a time. */
+#define QWK_CHUNK_SIZE 4096
+
+/** Packets are written through a larger stdio buffer than the default. */
+#define QWK_OUTPUT_BUFFER_SIZE 65536
+
+static const char *QWK_COPYRIGHT =
+    "Produced by Qmail...Copyright (c) 1987 by Sparkware.  "
+    "All Rights Reserved";
+
+/* Copy a value into a space padded field, as QWK headers have no NULs. */
+static void PutField(uint8_t *block, int offset, int width, const char *value)
+{
+    int length = (int)strlen(value);
+    memset(block + offset, ' ', width);
+    memcpy(block + offset, value, MIN(length, width));
+}
+
+/* Copy a space padded field out to a string, dropping the padding. */
+static void GetField(const uint8_t *block, int offset, int width, char *out,
+    int size)
+{
+    int length = MIN(width, size - 1);
+    memcpy(out, block + offset, length);
+    while (length > 0 && (out[length - 1] == ' ' || out[length - 1] == '\0'))
+    {
+        length--;
+    }
+    out[length] = '\0';
+}
+
+static bool NamesEqual(const char *a, const char *b)
+{
+    while (*a != '\0' && toupper((unsigned char)*a) ==
+        toupper((unsigned char)*b))
+    {
+        a++;
+        b++;
+    }
+    return *a == '\0' && *b == '\0';
+}
+
+void EncodeMSBIN(uint32_t value, uint8_t *out)
+{
+    uint32_t mantissa;
+    int exponent;
+
+    memset(out, 0, 4);
+    if (value == 0)
+    {
+        return;
+    }
+    for (exponent = 31; (value & (1UL << exponent)) == 0; exponent--)
+    {
+        ;
+    }
+    /* 24 bits with the leading one, which MSBIN leaves implied. */
+    mantissa = exponent <= 23 ? value << (23 - exponent) :
+        value >> (exponent - 23);
+    out[0] = (uint8_t)(mantissa & 0xFF);
+    out[1] = (uint8_t)((mantissa >> 8) & 0xFF);
+    out[2] = (uint8_t)((mantissa >> 16) & 0x7F);
+    out[3] = (uint8_t)(exponent + 129);
+}
+
+/* Convert text in place: lines end in 0xE3 and CRs are dropped. */
+static int ConvertQwkText(char *text, int length)
+{
+    int i, out = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        if (text[i] == '\n')
+        {
+            text[out++] = (char)QWK_LINE_END;
+        }
+        else if (text[i] != '\r')
+        {
+            text[out++] = text[i];
+        }
+    }
+    return out;
+}
+
+/**
+ * Write a message header and body. The block count comes before the body,
+ * so it is worked out from the first chunk read. A body that fits in one
+ * chunk is sized exactly; a longer one is given room for every byte and a
+ * final line end, and any CRs dropped leave space padding, as QWK bodies
+ * are padded anyway. Either way each body is read only once.
+ */
+static bool WriteQwkMessage(ZipWriter *zip, MessageArea *area,
+    const MessageHeader *header, uint32_t logical, uint32_t *blocks,
+    char *chunk)
+{
+    uint8_t block[QWK_BLOCK_SIZE];
+    char field[32];
+    struct tm tm;
+    time_t posted = (time_t)header->posted;
+    uint32_t offset;
+    long length, written, padding;
+    char last = '\0';
+    int n;
+
+    n = ReadMessageBody(area, header, 0, chunk, QWK_CHUNK_SIZE);
+    if (n < 0 || (n == 0 && header->bodyLength > 0))
+    {
+        return FALSE;
+    }
+    offset = (uint32_t)n;
+    n = ConvertQwkText(chunk, n);
+    if (n > 0)
+    {
+        last = chunk[n - 1];
+    }
+    if (offset == header->bodyLength)
+    {
+        length = last == (char)QWK_LINE_END ? n : n + 1;
+    }
+    else
+    {
+        length = (long)header->bodyLength + 1;
+    }
+    *blocks = 1 + (uint32_t)((length + QWK_BLOCK_SIZE - 1) / QWK_BLOCK_SIZE);
+
+    memset(block, ' ', sizeof(block));
+    block[0] = (header->flags & MESSAGE_PRIVATE) ? '*' : ' ';
+    sprintf(field, "%lu", (unsigned long)header->number);
+    PutField(block, 1, 7, field);
+    if (LocalTime(posted, &tm))
+    {
+        sprintf(field, "%02d-%02d-%02d", tm.tm_mon + 1, tm.tm_mday,
+            tm.tm_year % 100);
+        PutField(block, 8, 8, field);
+        sprintf(field, "%02d:%02d", tm.tm_hour, tm.tm_min);
+        PutField(block, 16, 5, field);
+    }
+    PutField(block, 21, 25, header->to);
+    PutField(block, 46, 25, header->from);
+    PutField(block, 71, 25, header->subject);
+    if (header->replyTo != 0)
+    {
+        sprintf(field, "%lu", (unsigned long)header->replyTo);
+        PutField(block, 108, 8, field);
+    }
+    sprintf(field, "%lu", (unsigned long)*blocks);
+    PutField(block, 116, 6, field);
+    block[122] = QWK_ACTIVE;
+    block[123] = (uint8_t)(area->areaID & 0xFF);
+    block[124] = (uint8_t)((area->areaID >> 8) & 0xFF);
+    block[125] = (uint8_t)(logical & 0xFF);
+    block[126] = (uint8_t)((logical >> 8) & 0xFF);
+    if (!WriteZipData(zip, block, sizeof(block)) ||
+        !WriteZipData(zip, chunk, n))
+    {
+        return FALSE;
+    }
+    written = n;
+
+    while (offset < header->bodyLength)
+    {
+        n = ReadMessageBody(area, header, offset, chunk, QWK_CHUNK_SIZE);
+        if (n <= 0)
+        {
+            return FALSE;
+        }
+        offset += n;
+        n = ConvertQwkText(chunk, n);
+        if (n > 0)
+        {
+            last = chunk[n - 1];
+        }
+        if (!WriteZipData(zip, chunk, n))
+        {
+            return FALSE;
+        }
+        written += n;
+    }
+    if (last != (char)QWK_LINE_END)
+    {
+        block[0] = QWK_LINE_END;
+        if (!WriteZipData(zip, block, 1))
+        {
+            return FALSE;
+        }
+        written++;
+    }
+
+    memset(block, ' ', sizeof(block));
+    for (padding = (long)(*blocks - 1) * QWK_BLOCK_SIZE - written;
+        padding > 0; padding -= n)
+    {
+        n = (int)MIN(padding, QWK_BLOCK_SIZE);
+        if (!WriteZipData(zip, block, n))
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+/* Copy one area's NDX records from the scratch file into the packet. */
+static bool WriteQwkIndex(ZipWriter *zip, FILE *ndx, QwkAreaPointer *area,
+    time_t now, char *chunk)
+{
+    char name[16];
+    long remaining = (long)area->messageCount * 5;
+    int n;
+
+    sprintf(name, "%03u.NDX", area->areaID);
+    if (!StartZipEntry(zip, name, now) ||
+        fseek(ndx, area->ndxOffset, SEEK_SET) != 0)
+    {
+        return FALSE;
+    }
+    while (remaining > 0)
+    {
+        n = (int)fread(chunk, 1, (size_t)MIN(remaining, QWK_CHUNK_SIZE), ndx);
+        if (n <= 0 || !WriteZipData(zip, chunk, n))
+        {
+            return FALSE;
+        }
+        remaining -= n;
+    }
+    return FinishZipEntry(zip);
+}
+
+static bool WriteQwkText(ZipWriter *zip, const char *text)
+{
+    return WriteZipData(zip, text, (int)strlen(text));
+}
+
+static bool WriteQwkControl(ZipWriter *zip, MessageDB *messages,
+    const User *user, uint32_t messageCount, time_t now)
+{
+    char line[128];
+    MessageArea *area;
+    struct tm tm;
+    int i;
+
+    if (!StartZipEntry(zip, "CONTROL.DAT", now))
+    {
+        return FALSE;
+    }
+    WriteQwkText(zip, QWK_BBS_NAME "\r\n\r\n\r\nSysop\r\n0," QWK_BBS_ID "\r\n");
+    if (LocalTime(now, &tm))
+    {
+        sprintf(line, "%02d-%02d-%04d,%02d:%02d:%02d\r\n", tm.tm_mon + 1,
+            tm.tm_mday, tm.tm_year + 1900, tm.tm_hour, tm.tm_min,
+            tm.tm_sec);
+        WriteQwkText(zip, line);
+    }
+    else
+    {
+        WriteQwkText(zip, "01-01-1980,00:00:00\r\n");
+    }
+    for (i = 0; user->username[i] != '\0' && i < (int)sizeof(line) - 3; i++)
+    {
+        line[i] = (char)toupper((unsigned char)user->username[i]);
+    }
+    strcpy(line + i, "\r\n");
+    WriteQwkText(zip, line);
+    sprintf(line, "\r\n0\r\n%lu\r\n%d\r\n", (unsigned long)messageCount,
+        MAX(messages->areas->size - 1, 0));
+    WriteQwkText(zip, line);
+    for (i = 0; i < messages->areas->size; i++)
+    {
+        area = (MessageArea *)messages->areas->items[i];
+        sprintf(line, "%u\r\n%s\r\n", area->areaID, area->name);
+        WriteQwkText(zip, line);
+    }
+    /* No welcome, news or goodbye screens. */
+    WriteQwkText(zip, "\r\n\r\n\r\n");
+    return FinishZipEntry(zip);
+}
+
+static bool WriteQwkDoorID(ZipWriter *zip, time_t now)
+{
+    return StartZipEntry(zip, "DOOR.ID", now) &&
+        WriteQwkText(zip, "DOOR = " QWK_BBS_NAME "\r\n"
+            "VERSION = " VBBS_VERSION "\r\n"
+            "SYSTEM = " QWK_BBS_NAME "\r\n"
+            "CONTROLNAME = " QWK_BBS_ID "\r\n"
+            "MIXEDCASE = YES\r\n") &&
+        FinishZipEntry(zip);
+}
+
+QwkPacket *BuildQwkPacket(const char *path, const User *user,
+    uint32_t maxMessages)
+{
+    return _BuildQwkPacket(messageDB, lastReadDB, path, user, maxMessages);
+}
+
+QwkPacket *_BuildQwkPacket(MessageDB *messages, LastReadDB *lastRead,
+    const char *path, const User *user, uint32_t maxMessages)
+{
+    QwkBuilder *builder;
+
+    builder = _StartQwkPacket(messages, lastRead, path, user, maxMessages);
+    while (ContinueQwkPacket(builder, QWK_MESSAGES_PER_PASS))
+    {
+        /* Nothing else to do between passes. */
+    }
+    return FinishQwkPacket(builder);
+}
+
+QwkBuilder *StartQwkPacket(const char *path, const User *user,
+    uint32_t maxMessages)
+{
+    return _StartQwkPacket(messageDB, lastReadDB, path, user, maxMessages);
+}
+
+QwkBuilder *_StartQwkPacket(MessageDB *messages, LastReadDB *lastRead,
+    const char *path, const User *user, uint32_t maxMessages)
+{
+    QwkBuilder *builder;
+    QwkPacket *packet;
+    uint8_t first[QWK_BLOCK_SIZE];
+
+    if (messages == NULL || path == NULL || user == NULL ||
+        strlen(path) >= sizeof(packet->path))
+    {
+        return NULL;
+    }
+
+    builder = (QwkBuilder *)TrackedMalloc(sizeof(QwkBuilder));
+    packet = (QwkPacket *)TrackedMalloc(sizeof(QwkPacket));
+    if (builder == NULL || packet == NULL)
+    {
+        Error("Failed to allocate memory for QWK packet");
+        TrackedFree(builder);
+        TrackedFree(packet);
+        return NULL;
+    }
+    memset(builder, 0, sizeof(QwkBuilder));
+    memset(packet, 0, sizeof(QwkPacket));
+    strcpy(packet->path, path);
+    packet->userID = user->userID;
+    builder->packet = packet;
+    builder->messages = messages;
+    builder->lastRead = lastRead;
+    builder->user = user;
+    builder->maxMessages = maxMessages == 0 ?
+        QWK_DEFAULT_MAX_MESSAGES : maxMessages;
+    builder->areaLimit = messages->areas->size;
+    builder->number = 1;
+    builder->block = 2;
+    builder->now = time(NULL);
+
+    packet->areas = (QwkAreaPointer *)TrackedCalloc(
+        MAX(builder->areaLimit, 1), sizeof(QwkAreaPointer));
+    builder->chunk = (char *)TrackedMalloc(QWK_CHUNK_SIZE);
+    builder->file = fopen(path, "w+b");
+    if (builder->file != NULL)
+    {
+        setvbuf(builder->file, NULL, _IOFBF, QWK_OUTPUT_BUFFER_SIZE);
+    }
+    builder->ndx = tmpfile();
+    builder->zip = NewZipWriter(builder->file);
+
+    memset(first, ' ', sizeof(first));
+    PutField(first, 0, QWK_BLOCK_SIZE, QWK_COPYRIGHT);
+    if (packet->areas == NULL || builder->chunk == NULL ||
+        builder->file == NULL || builder->ndx == NULL ||
+        builder->zip == NULL ||
+        !StartZipEntry(builder->zip, "MESSAGES.DAT", builder->now) ||
+        !WriteZipData(builder->zip, first, sizeof(first)))
+    {
+        Error("Failed to start QWK packet %s", path);
+        DestroyQwkBuilder(builder);
+        return NULL;
+    }
+    return builder;
+}
+
+bool ContinueQwkPacket(QwkBuilder *builder, uint32_t count)
+{
+    QwkPacket *packet;
+    QwkAreaPointer *pointer;
+    MessageArea *area = NULL;
+    const MessageHeader *header;
+    uint8_t record[5];
+    uint32_t blocks, added = 0;
+
+    if (builder == NULL || builder->failed)
+    {
+        return FALSE;
+    }
+    packet = builder->packet;
+
+    while (added < count && packet->messageCount < builder->maxMessages)
+    {
+        if (packet->areaCount > 0)
+        {
+            area = (MessageArea *)
+                builder->messages->areas->items[packet->areaCount - 1];
+        }
+        if (packet->areaCount == 0 || builder->number > GetHighWaterMark(area))
+        {
+            /* On to the next area, whose records follow in the NDX file. */
+            if (packet->areaCount >= builder->areaLimit)
+            {
+                return FALSE;
+            }
+            area = (MessageArea *)
+                builder->messages->areas->items[packet->areaCount];
+            pointer = &packet->areas[packet->areaCount++];
+            pointer->areaID = area->areaID;
+            pointer->lastRead = _GetLastRead(builder->lastRead,
+                builder->user->userID, area->areaID);
+            pointer->ndxOffset = ftell(builder->ndx);
+            builder->number = pointer->lastRead + 1;
+            continue;
+        }
+
+        pointer = &packet->areas[packet->areaCount - 1];
+        header = GetMessageHeader(area, builder->number);
+        if (IsMessageVisible(header, builder->user))
+        {
+            if (!WriteQwkMessage(builder->zip, area, header,
+                packet->messageCount + 1, &blocks, builder->chunk))
+            {
+                builder->failed = TRUE;
+                return FALSE;
+            }
+            EncodeMSBIN(builder->block, record);
+            record[4] = (uint8_t)(area->areaID & 0xFF);
+            if (fwrite(record, sizeof(record), 1, builder->ndx) != 1)
+            {
+                builder->failed = TRUE;
+                return FALSE;
+            }
+            builder->block += blocks;
+            pointer->messageCount++;
+            packet->messageCount++;
+            added++;
+        }
+        pointer->lastRead = builder->number++;
+    }
+    return packet->messageCount < builder->maxMessages;
+}
+
+QwkPacket *FinishQwkPacket(QwkBuilder *builder)
+{
+    QwkPacket *packet;
+    ZipWriter *zip;
+    bool ok;
+    int i;
+
+    if (builder == NULL)
+    {
+        return NULL;
+    }
+    packet = builder->packet;
+    zip = builder->zip;
+
+    ok = !builder->failed && FinishZipEntry(zip);
+    for (i = 0; ok && i < packet->areaCount; i++)
+    {
+        if (packet->areas[i].messageCount > 0)
+        {
+            ok = WriteQwkIndex(zip, builder->ndx, &packet->areas[i],
+                builder->now, builder->chunk);
+        }
+    }
+    ok = ok && WriteQwkControl(zip, builder->messages, builder->user,
+        packet->messageCount, builder->now);
+    ok = ok && WriteQwkDoorID(zip, builder->now);
+    ok = ok && FinishZip(zip);
+
+    packet->size = ftell(builder->file);
+    if (fclose(builder->file) != 0)
+    {
+        ok = FALSE;
+    }
+    builder->file = NULL;
+
+    if (!ok)
+    {
+        Error("Failed to build QWK packet %s", packet->path);
+        DestroyQwkBuilder(builder);
+        return NULL;
+    }
+    Info("Built QWK packet %s for %s: %lu messages, %ld bytes", packet->path,
+        builder->user->username, (unsigned long)packet->messageCount,
+        packet->size);
+    builder->packet = NULL;
+    DestroyQwkBuilder(builder);
+    return packet;
+}
+
+void DestroyQwkBuilder(QwkBuilder *builder)
+{
+    if (builder == NULL)
+    {
+        return;
+    }
+    DestroyZipWriter(builder->zip);
+    if (builder->file != NULL)
+    {
+        fclose(builder->file);
+    }
+    if (builder->ndx != NULL)
+    {
+        fclose(builder->ndx);
+    }
+    TrackedFree(builder->chunk);
+    DestroyQwkPacket(builder->packet);
+    TrackedFree(builder);
+}
+
+bool CommitQwkPacket(QwkPacket *packet)
+{
+    return _CommitQwkPacket(lastReadDB, packet);
+}
+
+bool _CommitQwkPacket(LastReadDB *lastRead, QwkPacket *packet)
+{
+    int i;
+
+    if (lastRead == NULL || packet == NULL)
+    {
+        return FALSE;
+    }
+    for (i = 0; i < packet->areaCount; i++)
+    {
+        if (!_SetLastRead(lastRead, packet->userID, packet->areas[i].areaID,
+            packet->areas[i].lastRead))
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+void DestroyQwkPacket(QwkPacket *packet)
+{
+    if (packet == NULL)
+    {
+        return;
+    }
+    remove(packet->path);
+    if (packet->areas != NULL)
+    {
+        TrackedFree(packet->areas);
+    }
+    TrackedFree(packet);
+}
+
+/********** Replies **********/
+
+int ImportReplyPacket(const char *path, const User *user)
+{
+    return _ImportReplyPacket(messageDB, path, user);
+}
+
+/* Post one reply. The body is converted in place. */
+static bool PostReply(MessageDB *messages, const uint8_t *block, char *body,
+    long length, const User *user)
+{
+    MessageHeader header;
+    MessageArea *area;
+    char field[32];
+    unsigned int areaID;
+    long i;
+
+    /* Replies carry the conference number where the message number was. */
+    GetField(block, 1, 7, field, sizeof(field));
+    areaID = (unsigned int)atoi(field);
+    if (areaID == 0)
+    {
+        areaID = block[123] | (block[124] << 8);
+    }
+    area = _GetMessageAreaByID(messages, areaID);
+    if (area == NULL)
+    {
+        Warn("Reply from %s is for unknown conference %u", user->username,
+            areaID);
+        return FALSE;
+    }
+
+    while (length > 0 && (body[length - 1] == ' ' || body[length - 1] == '\0'))
+    {
+        length--;
+    }
+    for (i = 0; i < length; i++)
+    {
+        if ((uint8_t)body[i] == QWK_LINE_END)
+        {
+            body[i] = '\n';
+        }
+    }
+
+    memset(&header, 0, sizeof(header));
+    GetField(block, 21, 25, field, sizeof(field));
+    InitMessageHeader(&header, user->username, field, "");
+    GetField(block, 71, 25, header.subject, sizeof(header.subject));
+    GetField(block, 108, 8, field, sizeof(field));
+    header.replyTo = (uint32_t)atol(field);
+    header.fromUserID = user->userID;
+    if (block[0] == '*' || block[0] == '+')
+    {
+        header.flags |= MESSAGE_PRIVATE;
+    }
+    return PostMessage(area, &header, body, (uint32_t)length) != 0;
+}
+
+int _ImportReplyPacket(MessageDB *messages, const char *path,
+    const User *user)
+{
+    uint8_t block[QWK_BLOCK_SIZE];
+    char field[16];
+    char *body;
+    FILE *file;
+    long remaining, blocks, length;
+    int posted = 0;
+
+    if (messages == NULL || path == NULL || user == NULL)
+    {
+        return -1;
+    }
+    file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        Error("Failed to open reply packet %s", path);
+        return -1;
+    }
+
+    remaining = FindZipEntry(file, QWK_BBS_ID ".MSG");
+    if (remaining < 0)
+    {
+        if (fseek(file, 0, SEEK_SET) != 0 ||
+            fread(block, 4, 1, file) != 1 || memcmp(block, "PK\003\004", 4) == 0)
+        {
+            Error("Reply packet %s is compressed or has no " QWK_BBS_ID
+                ".MSG", path);
+            fclose(file);
+            return -1;
+        }
+        fseek(file, 0, SEEK_END);
+        remaining = ftell(file);
+        fseek(file, 0, SEEK_SET);
+    }
+
+    /* The first block names the BBS the replies are for. */
+    if (remaining < QWK_BLOCK_SIZE ||
+        fread(block, QWK_BLOCK_SIZE, 1, file) != 1)
+    {
+        fclose(file);
+        return -1;
+    }
+    remaining -= QWK_BLOCK_SIZE;
+    GetField(block, 0, 8, field, sizeof(field));
+    if (!NamesEqual(field, QWK_BBS_ID))
+    {
+        Error("Reply packet %s is for %s, not " QWK_BBS_ID, path, field);
+        fclose(file);
+        return -1;
+    }
+
+    body = (char *)TrackedMalloc(QWK_MAX_REPLY_BLOCKS * QWK_BLOCK_SIZE);
+    if (body == NULL)
+    {
+        Error("Failed to allocate memory for reply packet");
+        fclose(file);
+        return -1;
+    }
+
+    while (remaining >= QWK_BLOCK_SIZE &&
+        fread(block, QWK_BLOCK_SIZE, 1, file) == 1)
+    {
+        remaining -= QWK_BLOCK_SIZE;
+        GetField(block, 116, 6, field, sizeof(field));
+        blocks = atol(field) - 1;
+        length = blocks * QWK_BLOCK_SIZE;
+        if (blocks < 0 || length > remaining)
+        {
+            Warn("Reply packet %s is damaged", path);
+            break;
+        }
+        remaining -= length;
+        if (blocks > QWK_MAX_REPLY_BLOCKS)
+        {
+            Warn("Skipping %ld block reply from %s", blocks, user->username);
+            fseek(file, length, SEEK_CUR);
+            continue;
+        }
+        if (length > 0 && fread(body, length, 1, file) != 1)
+        {
+            break;
+        }
+        if (PostReply(messages, block, body, length, user))
+        {
+            posted++;
+        }
+    }
+
+    TrackedFree(body);
+    fclose(file);
+    Info("Imported %d replies from %s for %s", posted, path, user->username);
+    return posted;
+}
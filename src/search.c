@@ -0,0 +1,436 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/log.h>
+#include <vbbs/search.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#define IS_TERM_CHAR(c) \
+    (((c) >= 'a' && (c) <= 'z') || ((c) >= 'A' && (c) <= 'Z') || \
+     ((c) >= '0' && (c) <= '9'))
+
+uint32_t TokenizeText(const char *text, size_t length, TokenHandler handler,
+    void *context)
+{
+    char term[SEARCH_MAX_TERM_LENGTH];
+    uint32_t position = 0;
+    size_t i = 0;
+    int n;
+    char c;
+
+    if (text == NULL)
+    {
+        return 0;
+    }
+
+    while (i < length)
+    {
+        while (i < length && !IS_TERM_CHAR(text[i]))
+        {
+            i++;
+        }
+        n = 0;
+        while (i < length && IS_TERM_CHAR(text[i]))
+        {
+            c = text[i++];
+            if (n < SEARCH_MAX_TERM_LENGTH - 1)
+            {
+                term[n++] = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+            }
+        }
+        if (n > 0)
+        {
+            term[n] = '\0';
+            if (handler != NULL)
+            {
+                handler(context, term, n, position);
+            }
+            position++;
+        }
+    }
+
+    return position;
+}
+
+int EncodeVarint(uint8_t *buffer, uint32_t value)
+{
+    int n = 0;
+    while (value >= 0x80)
+    {
+        buffer[n++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    buffer[n++] = (uint8_t)value;
+    return n;
+}
+
+const uint8_t *DecodeVarint(const uint8_t *buffer, uint32_t *value)
+{
+    uint32_t result = 0;
+    int shift = 0;
+
+    while (*buffer & 0x80)
+    {
+        result |= (uint32_t)(*buffer++ & 0x7F) << shift;
+        shift += 7;
+    }
+    result |= (uint32_t)*buffer++ << shift;
+    *value = result;
+    return buffer;
+}
+
+/* Step over count varints without decoding them. */
+static const uint8_t *SkipVarints(const uint8_t *buffer, uint32_t count)
+{
+    while (count > 0)
+    {
+        if ((*buffer++ & 0x80) == 0)
+        {
+            count--;
+        }
+    }
+    return buffer;
+}
+
+/* Decode a varint that has to end before end. Returns NULL if it doesn't. */
+static const uint8_t *DecodeVarintBefore(const uint8_t *buffer,
+    const uint8_t *end, uint32_t *value)
+{
+    uint32_t result = 0;
+    int shift = 0;
+
+    while (buffer < end && shift < 32)
+    {
+        result |= (uint32_t)(*buffer & 0x7F) << shift;
+        if ((*buffer++ & 0x80) == 0)
+        {
+            *value = result;
+            return buffer;
+        }
+        shift += 7;
+    }
+    return NULL;
+}
+
+void InitPostingList(PostingList *list)
+{
+    memset(list, 0, sizeof(PostingList));
+}
+
+void FreePostingList(PostingList *list)
+{
+    if (list == NULL)
+    {
+        return;
+    }
+    free(list->data);
+    free(list->blocks);
+    InitPostingList(list);
+}
+
+static bool ReservePostingData(PostingList *list, uint32_t needed)
+{
+    uint32_t capacity;
+    uint8_t *data;
+
+    if (list->length + needed <= list->capacity)
+    {
+        return TRUE;
+    }
+    capacity = list->capacity == 0 ? 16 : list->capacity;
+    while (capacity < list->length + needed)
+    {
+        capacity *= 2;
+    }
+    data = (uint8_t *)realloc(list->data, capacity);
+    if (data == NULL)
+    {
+        Error("Failed to allocate memory for posting list");
+        return FALSE;
+    }
+    list->data = data;
+    list->capacity = capacity;
+    return TRUE;
+}
+
+static bool StartPostingBlock(PostingList *list)
+{
+    uint32_t capacity;
+    PostingBlock *blocks;
+    PostingBlock *block;
+
+    if (list->blockCount == list->blockCapacity)
+    {
+        capacity = list->blockCapacity == 0 ? 1 : list->blockCapacity * 2;
+        blocks = (PostingBlock *)realloc(list->blocks,
+            capacity * sizeof(PostingBlock));
+        if (blocks == NULL)
+        {
+            Error("Failed to allocate memory for posting list");
+            return FALSE;
+        }
+        list->blocks = blocks;
+        list->blockCapacity = capacity;
+    }
+    block = &list->blocks[list->blockCount++];
+    block->lastDoc = list->lastDoc;
+    block->offset = list->length;
+    block->count = 0;
+    return TRUE;
+}
+
+bool AppendPosting(PostingList *list, uint32_t doc, const uint32_t *positions,
+    uint32_t count)
+{
+    PostingBlock *block;
+    uint32_t i, previous = 0;
+    uint8_t *out;
+
+    if (list == NULL || (list->docCount > 0 && doc <= list->lastDoc))
+    {
+        return FALSE;
+    }
+
+    if ((list->blockCount == 0 ||
+        list->blocks[list->blockCount - 1].count == SEARCH_BLOCK_SIZE) &&
+        !StartPostingBlock(list))
+    {
+        return FALSE;
+    }
+    /* Worst case of five bytes for every varint. */
+    if (!ReservePostingData(list, 5 * (count + 2)))
+    {
+        return FALSE;
+    }
+
+    out = list->data + list->length;
+    out += EncodeVarint(out, doc - list->lastDoc);
+    out += EncodeVarint(out, count);
+    for (i = 0; i < count; i++)
+    {
+        out += EncodeVarint(out, positions[i] - previous);
+        previous = positions[i];
+    }
+    list->length = (uint32_t)(out - list->data);
+
+    block = &list->blocks[list->blockCount - 1];
+    block->count++;
+    block->lastDoc = doc;
+    list->lastDoc = doc;
+    list->docCount++;
+    return TRUE;
+}
+
+bool IsPostingListValid(const PostingList *list, uint32_t maxDoc)
+{
+    const PostingBlock *block;
+    const uint8_t *p, *end;
+    uint32_t b, i, j, next, delta, frequency, doc = 0, docs = 0;
+
+    if (list->docCount == 0)
+    {
+        return list->blockCount == 0 && list->length == 0;
+    }
+    if (list->blockCount == 0 || list->blockCount > list->docCount ||
+        list->blocks[0].offset != 0)
+    {
+        return FALSE;
+    }
+
+    for (b = 0; b < list->blockCount; b++)
+    {
+        block = &list->blocks[b];
+        next = b + 1 < list->blockCount ?
+            list->blocks[b + 1].offset : list->length;
+        if (block->count == 0 || block->count > SEARCH_BLOCK_SIZE ||
+            block->offset > next || next > list->length)
+        {
+            return FALSE;
+        }
+        p = list->data + block->offset;
+        end = list->data + next;
+        for (i = 0; i < block->count; i++)
+        {
+            p = DecodeVarintBefore(p, end, &delta);
+            if (p == NULL || delta == 0 || delta > maxDoc - doc)
+            {
+                return FALSE;
+            }
+            doc += delta;
+            p = DecodeVarintBefore(p, end, &frequency);
+            for (j = 0; p != NULL && j < frequency; j++)
+            {
+                p = DecodeVarintBefore(p, end, &delta);
+            }
+            if (p == NULL)
+            {
+                return FALSE;
+            }
+        }
+        if (p != end || block->lastDoc != doc)
+        {
+            return FALSE;
+        }
+        docs += block->count;
+    }
+    return docs == list->docCount && list->lastDoc == doc;
+}
+
+/* Decode the document entry at cursor->next, relative to base. */
+static void DecodePosting(PostingCursor *cursor, uint32_t base)
+{
+    uint32_t delta;
+    const uint8_t *p = cursor->next;
+
+    p = DecodeVarint(p, &delta);
+    p = DecodeVarint(p, &cursor->frequency);
+    cursor->doc = base + delta;
+    cursor->positions = p;
+    cursor->next = SkipVarints(p, cursor->frequency);
+    cursor->inBlock++;
+}
+
+static void StartBlock(PostingCursor *cursor, uint32_t block)
+{
+    const PostingList *list = cursor->list;
+
+    cursor->block = block;
+    cursor->inBlock = 0;
+    cursor->next = list->data + list->blocks[block].offset;
+    DecodePosting(cursor, block == 0 ? 0 : list->blocks[block - 1].lastDoc);
+}
+
+void OpenPostingCursor(PostingCursor *cursor, const PostingList *list)
+{
+    memset(cursor, 0, sizeof(PostingCursor));
+    cursor->list = list;
+    if (list == NULL || list->docCount == 0)
+    {
+        cursor->done = TRUE;
+        return;
+    }
+    StartBlock(cursor, 0);
+}
+
+bool NextPosting(PostingCursor *cursor)
+{
+    const PostingList *list = cursor->list;
+
+    if (cursor->done)
+    {
+        return FALSE;
+    }
+    if (cursor->inBlock < list->blocks[cursor->block].count)
+    {
+        DecodePosting(cursor, cursor->doc);
+        return TRUE;
+    }
+    if (cursor->block + 1 >= list->blockCount)
+    {
+        cursor->done = TRUE;
+        return FALSE;
+    }
+    StartBlock(cursor, cursor->block + 1);
+    return TRUE;
+}
+
+bool SeekPosting(PostingCursor *cursor, uint32_t target)
+{
+    const PostingList *list = cursor->list;
+    const PostingBlock *blocks;
+    uint32_t low, high, step, middle;
+
+    if (cursor->done)
+    {
+        return FALSE;
+    }
+    if (cursor->doc >= target)
+    {
+        return TRUE;
+    }
+
+    blocks = list->blocks;
+    if (blocks[cursor->block].lastDoc < target)
+    {
+        /* Gallop to a block whose last document is at or past target. */
+        low = cursor->block;
+        high = low + 1;
+        step = 1;
+        while (high < list->blockCount && blocks[high].lastDoc < target)
+        {
+            low = high;
+            step *= 2;
+            high += step;
+        }
+        if (high >= list->blockCount)
+        {
+            high = list->blockCount - 1;
+            if (blocks[high].lastDoc < target)
+            {
+                cursor->done = TRUE;
+                return FALSE;
+            }
+        }
+        /* blocks[low] ends before target and blocks[high] doesn't. */
+        while (high - low > 1)
+        {
+            middle = low + (high - low) / 2;
+            if (blocks[middle].lastDoc < target)
+            {
+                low = middle;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        StartBlock(cursor, high);
+    }
+
+    while (cursor->doc < target)
+    {
+        if (!NextPosting(cursor))
+        {
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+void ReadPositions(const PostingCursor *cursor, uint32_t *buffer)
+{
+    const uint8_t *p = cursor->positions;
+    uint32_t i, delta, position = 0;
+
+    for (i = 0; i < cursor->frequency; i++)
+    {
+        p = DecodeVarint(p, &delta);
+        position += delta;
+        buffer[i] = position;
+    }
+}
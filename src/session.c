@@ -27,12 +27,22 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <vbbs/session.h>
 #include <vbbs/log.h>
+#include <vbbs/metrics.h>
 #include <vbbs/conn.h>
 #include <vbbs/user.h>
 #include <vbbs/terminal.h>
 #include <vbbs/time.h>
 #include <vbbs/db.h>
+#include <vbbs/event.h>
 #include <vbbs/db/user.h>
+#include <vbbs/db/msg.h>
+#include <vbbs/db/lastread.h>
+#include <vbbs/db/search.h>
+#include <vbbs/transfer.h>
+#include <vbbs/qwk.h>
+#include <vbbs/worker.h>
+#include <vbbs/throttle.h>
+#include <vbbs/pool.h>
 
 #include <vbbs/conn/telnet.h>
 #include <vbbs/conn/console.h>
@@ -45,8 +55,28 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <time.h>
 
 #define MAX_LOGIN_ATTEMPTS 3
+#define MAX_SEARCH_RESULTS 20
+#define QWK_TEMP_FILE_FORMAT "qwk%05lu.tmp"
+
+/**
+ * A password check or hash, done by the worker pool so a slow hash never
+ * holds up other callers. password is wiped as soon as it has been used,
+ * and the whole job when it is freed, even if it never ran.
+ * A check that matches an outdated hash also makes its replacement.
+ */
+typedef struct PasswordWork
+{
+    WorkItem work;
+    char pwHash[PASSWORD_HASH_SIZE];
+    char newHash[PASSWORD_HASH_SIZE];
+    char password[256];
+    bool matched;
+} PasswordWork;
 
 static uint32_t sessionIDCounter = 0;
+static Pool sessionPool = POOL("session", sizeof(Session), 32);
+static unsigned long slowHandlerNanos = SLOW_HANDLER_THRESHOLD_MS * 1000000UL;
+static size_t sessionMemoryLimit = SESSION_MEMORY_LIMIT;
 
 /** Input handlers */
 void IdentifyTerminal(Session *session);
@@ -54,34 +84,261 @@ void CheckTerminalIdentity(Session *session);
 void PromptUserName(Session *session);
 void PromptPassword(Session *session);
 void CheckPassword(Session *session);
+void PasswordChecked(Session *session);
+void AwaitWork(Session *session);
 void LoggedIn(Session *session);
+void ShowNewMessageCounts(Session *session);
 void Logout(Session *session);
 void NewUserPromptUserName(Session *session);
 void NewUserCheckUserName(Session *session);
 void NewUserPromptPassword(Session *session);
 void NewUserPromptPasswordConfirm(Session *session);
 void NewUserCheckPassword(Session *session);
+void NewUserPasswordSet(Session *session);
 void NewUserPromptEmail(Session *session);
 void NewUserSubmit(Session *session);
 void ListUsers(Session *session);
+void ListMoreUsers(Session *session);
 void ShowMainMenu(Session *session);
 void MainMenuSelection(Session *session);
+void PromptSearch(Session *session);
+void SearchSelection(Session *session);
+void DownloadQwkPacket(Session *session);
+void BuildMoreQwkPacket(Session *session);
+void QwkPacketReceived(Session *session);
+void DownloadInProgress(Session *session);
+
+/**
+ * Whether a handler writing a lot of output should stop for now, because
+ * the caller hasn't kept up. If so handler is run again once it has.
+ */
+static bool WaitForOutput(Session *session, EventHandler handler)
+{
+    if (!IsOutputPaused(session->conn))
+    {
+        return FALSE;
+    }
+    session->eventHandler = handler;
+    session->awaitingOutput = TRUE;
+    return TRUE;
+}
+
+/**
+ * Free the scratch memory of the last screen. Anything allocated before
+ * screenMark was taken lasts for the whole session.
+ */
+static void NewScreen(Session *session)
+{
+    ResetArena(&session->arena, session->screenMark);
+}
+
+typedef struct EventHandlerName
+{
+    EventHandler handler;
+    const char *name;
+} EventHandlerName;
+
+static const EventHandlerName EVENT_HANDLER_NAMES[] = {
+    { Connected, "Connected" },
+    { IdentifyTerminal, "IdentifyTerminal" },
+    { CheckTerminalIdentity, "CheckTerminalIdentity" },
+    { PromptUserName, "PromptUserName" },
+    { PromptPassword, "PromptPassword" },
+    { CheckPassword, "CheckPassword" },
+    { PasswordChecked, "PasswordChecked" },
+    { AwaitWork, "AwaitWork" },
+    { LoggedIn, "LoggedIn" },
+    { ShowNewMessageCounts, "ShowNewMessageCounts" },
+    { Logout, "Logout" },
+    { NewUserPromptUserName, "NewUserPromptUserName" },
+    { NewUserCheckUserName, "NewUserCheckUserName" },
+    { NewUserPromptPassword, "NewUserPromptPassword" },
+    { NewUserPromptPasswordConfirm, "NewUserPromptPasswordConfirm" },
+    { NewUserCheckPassword, "NewUserCheckPassword" },
+    { NewUserPasswordSet, "NewUserPasswordSet" },
+    { NewUserPromptEmail, "NewUserPromptEmail" },
+    { NewUserSubmit, "NewUserSubmit" },
+    { ListUsers, "ListUsers" },
+    { ListMoreUsers, "ListMoreUsers" },
+    { ShowMainMenu, "ShowMainMenu" },
+    { MainMenuSelection, "MainMenuSelection" },
+    { PromptSearch, "PromptSearch" },
+    { SearchSelection, "SearchSelection" },
+    { DownloadQwkPacket, "DownloadQwkPacket" },
+    { BuildMoreQwkPacket, "BuildMoreQwkPacket" },
+    { QwkPacketReceived, "QwkPacketReceived" },
+    { DownloadInProgress, "DownloadInProgress" },
+    { NULL, NULL }
+};
+
+const char *GetEventHandlerName(EventHandler handler)
+{
+    int i;
+
+    if (handler == NULL)
+    {
+        return "None";
+    }
+    for (i = 0; EVENT_HANDLER_NAMES[i].name != NULL; i++)
+    {
+        if (EVENT_HANDLER_NAMES[i].handler == handler)
+        {
+            return EVENT_HANDLER_NAMES[i].name;
+        }
+    }
+    return "Unknown";
+}
+
+void SetSlowHandlerThreshold(unsigned long milliseconds)
+{
+    slowHandlerNanos = milliseconds * 1000000UL;
+}
+
+unsigned long GetSlowHandlerThreshold(void)
+{
+    return slowHandlerNanos / 1000000UL;
+}
+
+size_t GetSessionMemory(const Session *session)
+{
+    return session->arena.reserved +
+        (session->memory != NULL ? session->memory->bytes : 0);
+}
+
+void SetSessionMemoryLimit(size_t limit)
+{
+    sessionMemoryLimit = limit;
+}
+
+size_t GetSessionMemoryLimit(void)
+{
+    return sessionMemoryLimit;
+}
+
+/** Hang up on a session holding more memory than it is allowed. */
+static void CheckSessionMemory(Session *session)
+{
+    Connection *conn = session->conn;
+    size_t memory = GetSessionMemory(session);
+
+    if (memory > session->peakMemory)
+    {
+        session->peakMemory = memory;
+    }
+    if (sessionMemoryLimit == 0 || memory <= sessionMemoryLimit ||
+        conn == NULL || conn->connectionStatus == DISCONNECTED)
+    {
+        return;
+    }
+    IncrementCounter(&memoryDisconnects);
+    Warn("[%d] Session holds %lu bytes, over the limit of %lu, "
+        "disconnecting", session->sessionID,
+        (unsigned long)memory, (unsigned long)sessionMemoryLimit);
+    WriteToConnection(conn, RESET_MODES);
+    WriteToConnection(conn, "\nOut of memory, disconnecting.\n");
+    session->eventHandler = NULL;
+    Disconnect(conn, FALSE);
+}
+
+void RunEventHandler(Session *session)
+{
+    EventHandler handler = session->eventHandler;
+    MemoryAccount *account;
+    unsigned long start, elapsed;
+
+    if (handler == NULL)
+    {
+        return;
+    }
+    account = GetMemoryAccount();
+    SetMemoryAccount(session->memory);
+    start = MonotonicNanos();
+    handler(session);
+    elapsed = MonotonicNanos() - start;
+    SetMemoryAccount(account);
+    RecordHistogram(&handlerTime, elapsed);
+    if (elapsed >= slowHandlerNanos)
+    {
+        IncrementCounter(&slowHandlers);
+        Warn("[%d] Slow event handler %s took %lu.%03lu ms",
+            session->sessionID, GetEventHandlerName(handler),
+            elapsed / 1000000UL, elapsed / 1000UL % 1000UL);
+    }
+    CheckSessionMemory(session);
+}
+
+/**
+ * Record a well-known event in the binary event log, if one is open. The
+ * username defaults to the session's user.
+ */
+static void LogSessionEvent(Session *session, EventType type,
+    const char *username, uint32_t value)
+{
+    Event event;
+
+    if (!IsEventLogOpen() || session == NULL)
+    {
+        return;
+    }
+    memset(&event, 0, sizeof(event));
+    event.type = (uint16_t)type;
+    event.sessionID = session->sessionID;
+    event.value = value;
+    if (session->user != NULL)
+    {
+        event.userID = session->user->userID;
+        if (username == NULL)
+        {
+            username = session->user->username;
+        }
+    }
+    if (username != NULL)
+    {
+        strncpy(event.username, username, EVENT_USERNAME_SIZE);
+    }
+    if (session->conn != NULL)
+    {
+        event.connectionType = (uint16_t)session->conn->connectionType;
+        if (session->conn->connectionType == TELNET)
+        {
+            event.remoteIP = TelnetRemoteIP(session->conn);
+            event.remotePort = (uint16_t)TelnetRemotePort(session->conn);
+        }
+    }
+    LogEvent(&event);
+}
 
 Session* NewSession(Connection *conn)
 {
-    Session *session = (Session *)malloc(sizeof(Session));
+    Session *session = (Session *)PoolAlloc(&sessionPool);
     if (session == NULL)
     {
         Error("Failed to allocate memory for session.");
         return NULL;
     }
+    session->memory = NewMemoryAccount();
+    if (session->memory == NULL)
+    {
+        Error("Failed to allocate memory for session.");
+        PoolFree(&sessionPool, session);
+        return NULL;
+    }
+    session->peakMemory = 0;
+    session->awaitingOutput = FALSE;
+    session->listPosition = 0;
     session->sessionID = ++sessionIDCounter;
     session->conn = conn;
     session->user = NULL;
     session->eventHandler = NULL;
     session->loginAttempts = 0;
     session->isNewUser = FALSE;
+    session->passwordMatched = FALSE;
+    session->qwkBuilder = NULL;
+    session->qwkPacket = NULL;
+    session->lastActivity = time(NULL);
     memset(session->tempBuffer, 0, sizeof(session->tempBuffer));
+    InitArena(&session->arena, SESSION_ARENA_LIMIT);
+    session->screenMark = GetArenaMark(&session->arena);
 
     if (conn != NULL)
     {
@@ -113,6 +370,7 @@ Session* NewSession(Connection *conn)
                     TelnetRemotePort(session->conn));
                 break;
         }
+        LogSessionEvent(session, EVENT_CONNECT, NULL, 0);
     }
 
     return session;
@@ -125,6 +383,9 @@ void DestroySession(Session *session)
         return;
     }
 
+    /* A password check may still be running for this session. */
+    CancelWork(session);
+
     if (session->eventHandler != NULL)
     {
         session->eventHandler = NULL;
@@ -156,6 +417,7 @@ void DestroySession(Session *session)
                     TelnetRemotePort(session->conn));
                 break;
         }
+        LogSessionEvent(session, EVENT_DISCONNECT, NULL, 0);
         DestroyConnection(session->conn);
         session->conn = NULL;
     }
@@ -168,7 +430,25 @@ void DestroySession(Session *session)
         session->user = NULL;
     }
 
-    free(session);
+    if (session->qwkBuilder != NULL)
+    {
+        /* The caller hung up while the packet was being built. */
+        DestroyQwkBuilder(session->qwkBuilder);
+        session->qwkBuilder = NULL;
+    }
+
+    if (session->qwkPacket != NULL)
+    {
+        /* The caller hung up before the packet arrived. */
+        DestroyQwkPacket(session->qwkPacket);
+        session->qwkPacket = NULL;
+    }
+
+    DestroyArena(&session->arena);
+    RecordHistogram(&sessionMemory, (unsigned long)session->peakMemory);
+    ReleaseMemoryAccount(session->memory);
+    session->memory = NULL;
+    PoolFree(&sessionPool, session);
 }
 
 void CheckTerminalIdentity(Session *session)
@@ -205,6 +485,7 @@ void IdentifyTerminal(Session *session)
     conn->inputBuffer->buffer->terminalType = SetSessionTerminalType;
     conn->inputBuffer->buffer->connectionSpeed = SetSessionConnectionSpeed;
     conn->inputBuffer->buffer->echo = EchoCharToSession;
+    conn->inputBuffer->buffer->telnetOption = SetSessionTelnetOption;
 
     Identify(conn->outputBuffer);
     session->eventHandler = CheckTerminalIdentity;
@@ -239,11 +520,23 @@ void SetSessionTerminalType(void *userData, const char *type)
 void SetSessionConnectionSpeed(void *userData, const char *speed)
 {
     Session *session = (Session *)userData;
+    char *end;
+    long bitsPerSecond;
+
     if (session == NULL || session->conn == NULL)
     {
         return;
     }
-    session->conn->connectionSpeed = (unsigned int)atoi(speed);
+    /* Keep the configured speed unless the client sends a usable one. */
+    bitsPerSecond = strtol(speed, &end, 10);
+    if (end == speed || bitsPerSecond <= 0)
+    {
+        Warn("[%d] Ignoring connection speed: %s", session->sessionID,
+            speed);
+        return;
+    }
+    SetConnectionSpeed(session->conn,
+        (unsigned int)MIN(bitsPerSecond, CONNECTION_MAX_SPEED));
     Info("[%d] Connection speed set to %d bps: %s", 
         session->sessionID, session->conn->connectionSpeed, speed);
 }
@@ -271,6 +564,34 @@ void EchoCharToSession(void *userData, const char c)
     }
 }
 
+void SetSessionTelnetOption(void *userData, int command, int option)
+{
+    Session *session = (Session *)userData;
+    if (session == NULL || session->conn == NULL)
+    {
+        return;
+    }
+
+    if (option == TELNET_OPTION_BINARY)
+    {
+        /* DO/DONT BINARY is the client's answer to our WILL BINARY. */
+        if (command == TELNET_DO)
+        {
+            session->conn->binaryMode = TRUE;
+        }
+        else if (command == TELNET_DONT)
+        {
+            session->conn->binaryMode = FALSE;
+        }
+        Debug("[%d] Binary output %s", session->sessionID,
+            session->conn->binaryMode ? "enabled" : "disabled");
+        if (command == TELNET_DO || command == TELNET_DONT)
+        {
+            SetTransferBinaryMode(session->conn, session->conn->binaryMode);
+        }
+    }
+}
+
 void Connected(Session *session)
 {
     Connection *conn;
@@ -300,6 +621,7 @@ void PromptUserName(Session *session)
     }
     conn = session->conn;
 
+    NewScreen(session);
     WriteToConnection(conn, RESET_MODES);
     conn->inputBuffer->buffer->echoMode = ECHO_ON;
     WriteToConnection(conn, "Username (or 'new' to sign up) => ");
@@ -355,10 +677,132 @@ void PromptPassword(Session *session)
     }
 }
 
+static void VerifyPasswordWork(WorkItem *item)
+{
+    PasswordWork *job = (PasswordWork *)item;
+
+    job->matched = VerifyPassword(job->pwHash, job->password);
+    if (job->matched && PasswordNeedsRehash(job->pwHash))
+    {
+        HashPassword(job->password, job->newHash);
+    }
+    memset(job->password, 0, sizeof(job->password));
+}
+
+static void HashPasswordWork(WorkItem *item)
+{
+    PasswordWork *job = (PasswordWork *)item;
+
+    HashPassword(job->password, job->pwHash);
+    memset(job->password, 0, sizeof(job->password));
+}
+
+/* Jobs dropped before they ran still hold the password. */
+static void DestroyPasswordWork(WorkItem *item)
+{
+    memset(item, 0, sizeof(PasswordWork));
+}
+
+/** Carry on with the session from handler, unless it has hung up. */
+static void ResumeSession(Session *session, EventHandler handler)
+{
+    if (session->conn == NULL ||
+        session->conn->connectionStatus == DISCONNECTED)
+    {
+        return;
+    }
+    SetLogSession(session->sessionID);
+    session->eventHandler = handler;
+    RunEventHandler(session);
+    SetLogSession(0);
+}
+
+static void PasswordVerified(WorkItem *item)
+{
+    PasswordWork *job = (PasswordWork *)item;
+    Session *session = (Session *)item->owner;
+    User *user;
+
+    session->passwordMatched = job->matched;
+    user = GetUserByUsername(session->tempBuffer);
+    /* Unless the password was changed while we were checking it. */
+    if (job->newHash[0] != '\0' && user != NULL &&
+        strcmp(user->pwHash, job->pwHash) == 0)
+    {
+        Info("[%d] Upgraded the password hash for %s.", session->sessionID,
+            user->username);
+        strcpy(user->pwHash, job->newHash);
+    }
+    ResumeSession(session, PasswordChecked);
+}
+
+static void PasswordHashed(WorkItem *item)
+{
+    Session *session = (Session *)item->owner;
+
+    strcpy(session->user->pwHash, ((PasswordWork *)item)->pwHash);
+    ResumeSession(session, NewUserPasswordSet);
+}
+
+/**
+ * Hand a password to the worker pool, then wait for complete to be called.
+ * Returns FALSE, having told the caller, if the pool is too busy.
+ */
+static bool SubmitPasswordWork(Session *session, WorkFunction run,
+    WorkFunction complete, const char *pwHash, const char *password)
+{
+    PasswordWork *job = (PasswordWork *)malloc(sizeof(PasswordWork));
+
+    if (job == NULL)
+    {
+        Error("[%d] Failed to allocate memory for a password check.",
+            session->sessionID);
+        WriteToConnection(session->conn, "System error.\n");
+        return FALSE;
+    }
+    memset(job, 0, sizeof(PasswordWork));
+    job->work.run = run;
+    job->work.complete = complete;
+    job->work.destroy = DestroyPasswordWork;
+    job->work.owner = session;
+    strncpy(job->pwHash, pwHash, sizeof(job->pwHash) - 1);
+    strncpy(job->password, password, sizeof(job->password) - 1);
+
+    if (!SubmitWork(&job->work))
+    {
+        memset(job, 0, sizeof(PasswordWork));
+        free(job);
+        Warn("[%d] Worker queue is full, turning away a password.",
+            session->sessionID);
+        WriteToConnection(session->conn,
+            "The system is busy, please try again.\n");
+        return FALSE;
+    }
+    session->eventHandler = AwaitWork;
+    return TRUE;
+}
+
+/** The caller's IPv4 address, or 0 if it isn't a telnet connection. */
+static uint32_t SessionAddress(Session *session)
+{
+    if (session->conn == NULL || session->conn->connectionType != TELNET)
+    {
+        return 0;
+    }
+    return TelnetRemoteIP(session->conn);
+}
+
+void AwaitWork(Session *session)
+{
+    /* Input is left in the buffer until the job completes. */
+    (void)session;
+}
+
 void CheckPassword(Session *session)
 {
     Connection *conn;
     User *user;
+    unsigned long delay;
     
     if (session == NULL || session->conn == NULL)
     {
@@ -368,41 +812,80 @@ void CheckPassword(Session *session)
 
     if (IsNextLineReady(conn->inputBuffer))
     {
-
-        /** TODO: Look up user by username in user database. */
-        user = GetUserByUsername(session->tempBuffer);
         conn->inputBuffer->buffer->echoMode = ECHO_ON;
-        if (user == NULL || !AuthenticateUser(user, session->tempBuffer, 
+        /* Don't spend a hash on an address that is waiting out failures. */
+        delay = GetThrottleDelay(SessionAddress(session));
+        if (delay > 0)
+        {
+            ClearNextLine(conn->inputBuffer);
+            IncrementCounter(&throttledLogins);
+            Info("[%d] Refused a login, the address must wait %lu seconds.",
+                session->sessionID, delay);
+            WriteToConnection(conn,
+                "Too many failed logins, try again in %lu seconds.\n", delay);
+            Disconnect(conn, FALSE);
+            return;
+        }
+        user = GetUserByUsername(session->tempBuffer);
+        /* Unknown users are checked against "", which VerifyPassword makes
+           cost as much as a real hash, so timing gives nothing away. */
+        if (!SubmitPasswordWork(session, VerifyPasswordWork,
+            PasswordVerified, user != NULL ? user->pwHash : "",
             conn->inputBuffer->nextLine))
         {
-            Info("[%d] Authentication failure for user %s.", 
-                session->sessionID, session->tempBuffer);
-            WriteToConnection(conn, "Authentication failed.\n");
             ClearNextLine(conn->inputBuffer);
-            session->loginAttempts++;
-            if (session->loginAttempts >= MAX_LOGIN_ATTEMPTS)
-            {
-                WriteToConnection(conn, 
-                    "Too many failed attempts. Disconnecting...\n");
-                Info("[%d] Too many failed attempts. Disconnecting...", 
-                    session->sessionID);
-                Disconnect(conn, FALSE);
-            }
-            else
-            {
-                PromptUserName(session);
-            }
+            PromptUserName(session);
+            return;
+        }
+        ClearNextLine(conn->inputBuffer);
+    }
+}
+
+void PasswordChecked(Session *session)
+{
+    Connection *conn;
+    User *user;
+    
+    if (session == NULL || session->conn == NULL)
+    {
+        return;
+    }
+    conn = session->conn;
+
+    /* Look the user up again, they may have gone while we waited. */
+    user = GetUserByUsername(session->tempBuffer);
+    if (user == NULL || !session->passwordMatched)
+    {
+        Info("[%d] Authentication failure for user %s.", 
+            session->sessionID, session->tempBuffer);
+        WriteToConnection(conn, "Authentication failed.\n");
+        RecordLoginFailure(SessionAddress(session));
+        session->loginAttempts++;
+        LogSessionEvent(session, EVENT_LOGIN_FAILED, session->tempBuffer,
+            session->loginAttempts);
+        if (session->loginAttempts >= MAX_LOGIN_ATTEMPTS)
+        {
+            WriteToConnection(conn, 
+                "Too many failed attempts. Disconnecting...\n");
+            Info("[%d] Too many failed attempts. Disconnecting...", 
+                session->sessionID);
+            Disconnect(conn, FALSE);
         }
         else
         {
-            session->user = user;
-            conn->connectionStatus = AUTHENTICATED;
-            Info("[%d] User %s logged in successfully.", 
-                session->sessionID, session->user->username);
-            ClearNextLine(conn->inputBuffer);
-            LoggedIn(session);
+            PromptUserName(session);
         }
     }
+    else
+    {
+        session->user = user;
+        conn->connectionStatus = AUTHENTICATED;
+        RecordLoginSuccess(SessionAddress(session));
+        Info("[%d] User %s logged in successfully.", 
+            session->sessionID, session->user->username);
+        LogSessionEvent(session, EVENT_LOGIN, NULL, 0);
+        LoggedIn(session);
+    }
 }
 
 void LoggedIn(Session *session)
@@ -422,10 +905,54 @@ void LoggedIn(Session *session)
     WriteToConnection(conn, RESET_MODES);
     WriteToConnection(conn, "Welcome %s!\n", session->user->username);
     WriteToConnection(conn, "You are now logged in.\n");
+    ShowNewMessageCounts(session);
 
     ShowMainMenu(session);
 }
 
+/** Tell the user how many unread messages are waiting for them. */
+void ShowNewMessageCounts(Session *session)
+{
+    NewScanResult *results;
+    ArenaMark mark;
+    unsigned long unread = 0;
+    int i, count, areas = 0;
+
+    if (lastReadDB == NULL || GetMessageAreaCount() == 0)
+    {
+        return;
+    }
+
+    count = GetMessageAreaCount();
+    mark = GetArenaMark(&session->arena);
+    results = (NewScanResult *)ArenaAlloc(&session->arena,
+        sizeof(NewScanResult) * count);
+    if (results == NULL)
+    {
+        Error("[%d] Not enough session memory for new message scan.",
+            session->sessionID);
+        return;
+    }
+
+    count = NewScan(session->user->userID, results, count);
+    for (i = 0; i < count; i++)
+    {
+        if (results[i].unread > 0)
+        {
+            unread += results[i].unread;
+            areas++;
+        }
+    }
+    ResetArena(&session->arena, mark);
+
+    if (unread > 0)
+    {
+        WriteToConnection(session->conn,
+            "You have %lu new message%s in %d area%s.\n", unread,
+            unread == 1 ? "" : "s", areas, areas == 1 ? "" : "s");
+    }
+}
+
 void Logout(Session *session)
 {
     Connection *conn;
@@ -533,6 +1060,7 @@ void NewUserPromptPasswordConfirm(Session *session)
 void NewUserCheckPassword(Session *session)
 {
     Connection *conn;
+    bool submitted;
     
     if (session == NULL || session->conn == NULL)
     {
@@ -551,11 +1079,25 @@ void NewUserCheckPassword(Session *session)
             return;
         }
         ClearNextLine(conn->inputBuffer);
-        ChangePassword(session->user, session->tempBuffer);
-        Debug("New user password set for %s: %s.", 
-            session->user->username, session->user->pwHash);
-        NewUserPromptEmail(session);
+        submitted = SubmitPasswordWork(session, HashPasswordWork,
+            PasswordHashed, "", session->tempBuffer);
+        memset(session->tempBuffer, 0, sizeof(session->tempBuffer));
+        if (!submitted)
+        {
+            NewUserPromptPassword(session);
+        }
+    }
+}
+
+void NewUserPasswordSet(Session *session)
+{
+    if (session == NULL || session->conn == NULL)
+    {
+        return;
     }
+    Debug("New user password set for %s: %s.", 
+        session->user->username, session->user->pwHash);
+    NewUserPromptEmail(session);
 }
 
 void NewUserPromptEmail(Session *session)
@@ -596,19 +1138,18 @@ void NewUserSubmit(Session *session)
             session->user->username);
 
         conn->connectionStatus = AUTHENTICATED;
+        LogSessionEvent(session, EVENT_LOGIN, NULL, 0);
         
         ClearNextLine(conn->inputBuffer);
         LoggedIn(session);
     }
 }
 
+#define USER_LIST_FORMAT "%18s %40s %20s\n"
+
 void ListUsers(Session *session)
 {
     Connection *conn;
-    User *user;
-    int i;
-    char *userListFormat;
-    char lastSeen[21];
     
     if (session == NULL || session->conn == NULL)
     {
@@ -616,20 +1157,44 @@ void ListUsers(Session *session)
     }
     conn = session->conn;
 
-    userListFormat = "%18s %40s %20s\n";
-
     WriteToConnection(conn, "User List:\n");
     WriteToConnection(conn, "------------------ ");
     WriteToConnection(conn, "---------------------------------------- ");
     WriteToConnection(conn, "--------------------\n");
-    WriteToConnection(conn, userListFormat, "Username", "Email", "Last Seen");
-    for (i = 0; i < userDB->users->size; i++)
+    WriteToConnection(conn, USER_LIST_FORMAT, "Username", "Email",
+        "Last Seen");
+    session->listPosition = 0;
+    ListMoreUsers(session);
+}
+
+/**
+ * Show users from listPosition on. A long list stops whenever output is
+ * paused and carries on from where it was once the caller catches up.
+ */
+void ListMoreUsers(Session *session)
+{
+    Connection *conn;
+    User *user;
+    char lastSeen[21];
+
+    if (session == NULL || session->conn == NULL)
     {
-        user = (User *)GetFromArrayList(userDB->users, i);
+        return;
+    }
+    conn = session->conn;
+
+    for (; session->listPosition < userDB->users->size;
+        session->listPosition++)
+    {
+        if (WaitForOutput(session, ListMoreUsers))
+        {
+            return;
+        }
+        user = (User *)GetFromArrayList(userDB->users, session->listPosition);
         if (user != NULL)
         {
             FormatTime(lastSeen, sizeof(lastSeen), user->lastSeen);
-            WriteToConnection(conn, userListFormat, user->username, 
+            WriteToConnection(conn, USER_LIST_FORMAT, user->username, 
                 user->email, lastSeen);
             Debug("User: %s, email: %s", 
                 user->username, user->email);
@@ -651,10 +1216,13 @@ void ShowMainMenu(Session *session)
     }
     conn = session->conn;
 
+    NewScreen(session);
     WriteToConnection(conn, RESET_MODES);
     WriteToConnection(conn, "Main Menu:\n");
     WriteToConnection(conn, "1. List Users\n");
     WriteToConnection(conn, "2. Logout\n");
+    WriteToConnection(conn, "3. Search Messages\n");
+    WriteToConnection(conn, "4. Download QWK Packet\n");
     WriteToConnection(conn, "Choose an option: ");
     
     session->eventHandler = MainMenuSelection;
@@ -687,6 +1255,14 @@ void MainMenuSelection(Session *session)
         {
             Logout(session);
         }
+        else if (strcmp(choice, "3") == 0)
+        {
+            PromptSearch(session);
+        }
+        else if (strcmp(choice, "4") == 0)
+        {
+            DownloadQwkPacket(session);
+        }
         else
         {
             WriteToConnection(conn, "Invalid option. Please try again.\n");
@@ -694,3 +1270,276 @@ void MainMenuSelection(Session *session)
         }
     }
 }
+
+void PromptSearch(Session *session)
+{
+    Connection *conn;
+
+    if (session == NULL || session->conn == NULL)
+    {
+        return;
+    }
+    conn = session->conn;
+
+    WriteToConnection(conn, "\nSearch for words, or \"a phrase\" => ");
+    SetInputMode(conn->inputBuffer, LINE_INPUT_MODE);
+    session->eventHandler = SearchSelection;
+}
+
+void SearchSelection(Session *session)
+{
+    Connection *conn;
+    SearchHit *hits;
+    MessageArea *area;
+    const MessageHeader *header;
+    char *query;
+    int i, count;
+
+    if (session == NULL || session->conn == NULL)
+    {
+        return;
+    }
+    conn = session->conn;
+
+    if (!IsNextLineReady(conn->inputBuffer))
+    {
+        return;
+    }
+    /* Both last until the caller leaves the results screen. */
+    query = ArenaCopyString(&session->arena, conn->inputBuffer->nextLine);
+    hits = (SearchHit *)ArenaAlloc(&session->arena,
+        sizeof(SearchHit) * MAX_SEARCH_RESULTS);
+    ClearNextLine(conn->inputBuffer);
+    if (query == NULL || hits == NULL)
+    {
+        Error("[%d] Not enough session memory for a search.",
+            session->sessionID);
+        WriteToConnection(conn, "System error.\n");
+        ShowMainMenu(session);
+        return;
+    }
+
+    /* Messages are indexed as they are posted, see IndexPostedMessage. */
+    count = SearchVisibleMessages(query, session->user, hits,
+        MAX_SEARCH_RESULTS);
+    Debug("[%d] Search for '%s' found %d messages", session->sessionID,
+        query, count);
+
+    if (count <= 0)
+    {
+        WriteToConnection(conn, "No messages found.\n");
+    }
+    else
+    {
+        WriteToConnection(conn, "%-20s %6s %-30s %s\n", "Area", "Number",
+            "Subject", "From");
+        for (i = 0; i < count; i++)
+        {
+            area = GetMessageAreaByID(hits[i].areaID);
+            header = GetMessageHeader(area, hits[i].number);
+            if (area == NULL || !IsMessageVisible(header, session->user))
+            {
+                continue;
+            }
+            WriteToConnection(conn, "%-20.20s %6lu %-30.30s %s\n",
+                area->name, (unsigned long)header->number, header->subject,
+                header->from);
+        }
+        if (count == MAX_SEARCH_RESULTS)
+        {
+            WriteToConnection(conn, "Only the first %d matches are shown.\n",
+                MAX_SEARCH_RESULTS);
+        }
+    }
+
+    WriteToConnection(conn, "Press any key to continue...\n");
+    SetInputMode(conn->inputBuffer, CHARACTER_INPUT_MODE);
+    session->eventHandler = ShowMainMenu;
+}
+
+void DownloadQwkPacket(Session *session)
+{
+    Connection *conn;
+    char path[64];
+
+    if (session == NULL || session->conn == NULL || session->user == NULL)
+    {
+        return;
+    }
+    conn = session->conn;
+
+    sprintf(path, QWK_TEMP_FILE_FORMAT, (unsigned long)session->sessionID);
+    session->qwkBuilder = StartQwkPacket(path, session->user, 0);
+    if (session->qwkBuilder == NULL)
+    {
+        WriteToConnection(conn, "Unable to build your QWK packet.\n");
+        ShowMainMenu(session);
+        return;
+    }
+    WriteToConnection(conn, "Building your QWK packet");
+    BuildMoreQwkPacket(session);
+}
+
+/**
+ * Add the next few messages to the packet. Between passes a dot is sent,
+ * and the handler runs again once it has gone out, so other callers
+ * aren't kept waiting while a large packet is built.
+ */
+void BuildMoreQwkPacket(Session *session)
+{
+    Connection *conn;
+
+    if (session == NULL || session->conn == NULL ||
+        session->qwkBuilder == NULL)
+    {
+        return;
+    }
+    conn = session->conn;
+
+    if (ContinueQwkPacket(session->qwkBuilder, QWK_MESSAGES_PER_PASS))
+    {
+        WriteToConnection(conn, ".");
+        session->eventHandler = BuildMoreQwkPacket;
+        session->awaitingOutput = TRUE;
+        return;
+    }
+    WriteToConnection(conn, "\n");
+    session->qwkPacket = FinishQwkPacket(session->qwkBuilder);
+    session->qwkBuilder = NULL;
+    if (session->qwkPacket == NULL)
+    {
+        WriteToConnection(conn, "Unable to build your QWK packet.\n");
+        ShowMainMenu(session);
+        return;
+    }
+
+    WriteToConnection(conn, "Sending " QWK_BBS_ID ".QWK: %lu messages, "
+        "%ld bytes.\n", (unsigned long)session->qwkPacket->messageCount,
+        session->qwkPacket->size);
+    if (!StartDownload(session, session->qwkPacket->path, QwkPacketReceived))
+    {
+        DestroyQwkPacket(session->qwkPacket);
+        session->qwkPacket = NULL;
+        ShowMainMenu(session);
+    }
+}
+
+void QwkPacketReceived(Session *session)
+{
+    if (session == NULL || session->conn == NULL)
+    {
+        return;
+    }
+
+    /* Only now is it safe to mark the messages as read. */
+    if (session->qwkPacket != NULL)
+    {
+        CommitQwkPacket(session->qwkPacket);
+        DestroyQwkPacket(session->qwkPacket);
+        session->qwkPacket = NULL;
+    }
+    ShowMainMenu(session);
+}
+
+bool StartDownload(Session *session, const char *path, EventHandler next)
+{
+    Connection *conn;
+
+    if (session == NULL || session->conn == NULL || path == NULL)
+    {
+        return FALSE;
+    }
+    conn = session->conn;
+
+    if (conn->transfer != NULL)
+    {
+        Warn("[%d] A transfer is already in progress.", session->sessionID);
+        return FALSE;
+    }
+
+    conn->transfer = NewTransfer(conn, path);
+    if (conn->transfer == NULL)
+    {
+        WriteToConnection(conn, "File not available.\n");
+        return FALSE;
+    }
+
+    if (conn->connectionType == TELNET && !conn->binaryMode)
+    {
+        /* The file waits for the answer, which decides if CRs are sent
+           as CR NUL. */
+        WriteStringToBuffer(conn->outputBuffer, TELNET_WILL_BINARY);
+        AwaitBinaryMode(conn);
+    }
+
+    Info("[%d] Starting download of %s (%ld bytes)", session->sessionID,
+        path, conn->transfer->size);
+
+    session->nextEventHandler = next;
+    session->eventHandler = DownloadInProgress;
+    return TRUE;
+}
+
+void DownloadInProgress(Session *session)
+{
+    if (session == NULL || session->conn == NULL)
+    {
+        return;
+    }
+    /* Input is ignored until the transfer is finished. */
+    ClearNextLine(session->conn->inputBuffer);
+}
+
+void ContinueDownload(Session *session)
+{
+    Connection *conn;
+    Transfer *transfer;
+    int sent;
+
+    if (session == NULL || session->conn == NULL || 
+        session->conn->transfer == NULL)
+    {
+        return;
+    }
+    conn = session->conn;
+    transfer = conn->transfer;
+
+    sent = ContinueTransfer(conn);
+    if (sent > 0)
+    {
+        AddToCounter(&bytesSent, (unsigned long)sent);
+    }
+
+    if (transfer->status == TRANSFER_FAILED)
+    {
+        Error("[%d] Download of %s failed after %lu bytes", 
+            session->sessionID, transfer->path, transfer->bytesSent);
+        LogSessionEvent(session, EVENT_TRANSFER_FAILED, NULL,
+            (uint32_t)transfer->bytesSent);
+        DestroyTransfer(transfer);
+        conn->transfer = NULL;
+        Disconnect(conn, TRUE);
+    }
+    else if (transfer->status == TRANSFER_COMPLETE)
+    {
+        Info("[%d] Download of %s complete, %lu bytes sent", 
+            session->sessionID, transfer->path, transfer->bytesSent);
+        LogSessionEvent(session, EVENT_TRANSFER_COMPLETE, NULL,
+            (uint32_t)transfer->bytesSent);
+        DestroyTransfer(transfer);
+        conn->transfer = NULL;
+        session->eventHandler = session->nextEventHandler;
+        RunEventHandler(session);
+    }
+}
+
+void ContinueOutput(Session *session)
+{
+    if (session == NULL || session->conn == NULL ||
+        !session->awaitingOutput || IsOutputPaused(session->conn))
+    {
+        return;
+    }
+    session->awaitingOutput = FALSE;
+    RunEventHandler(session);
+}
@@ -61,7 +61,7 @@ const union {
 
 /* Hash a single 512-bit block. This is the core of the algorithm. */
 
-void SHA1Transform(
+static void SHA1TransformPortable(
     uint32_t state[5],
     const unsigned char buffer[64]
 )
@@ -187,6 +187,325 @@ void SHA1Transform(
 }
 
 
+/*
+ * SHA1Transform and SHA1Update hash whole blocks through one of these,
+ * chosen by SHA1SelectImplementation.
+ */
+typedef void (*SHA1BlockFunction)(
+    uint32_t state[5],
+    const unsigned char *data,
+    uint32_t blocks
+    );
+
+static void SHA1BlocksPortable(
+    uint32_t state[5],
+    const unsigned char *data,
+    uint32_t blocks
+)
+{
+    for (; blocks > 0; blocks--, data += 64)
+    {
+        SHA1TransformPortable(state, data);
+    }
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || __GNUC__ >= 5)
+#define SHA1_X86
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+/* CPUID feature bits, leaf 1 ECX and leaf 7 EBX. */
+#define CPUID_SSSE3 (1 << 9)
+#define CPUID_SSE41 (1 << 19)
+#define CPUID_SHA (1 << 29)
+
+#define f1(x, y, z) (((x) & ((y) ^ (z))) ^ (z))
+#define f2(x, y, z) ((x) ^ (y) ^ (z))
+#define f3(x, y, z) ((((x) | (y)) & (z)) | ((x) & (y)))
+#define RK(f, v, w, x, y, z, i) \
+    z += f(w, x, y) + wk[i] + rol(v, 5); w = rol(w, 30);
+#define RK5(f, i) \
+    RK(f, a, b, c, d, e, i); RK(f, e, a, b, c, d, i + 1); \
+    RK(f, d, e, a, b, c, i + 2); RK(f, c, d, e, a, b, i + 3); \
+    RK(f, b, c, d, e, a, i + 4);
+
+#define rol1_epi32(x) _mm_or_si128(_mm_slli_epi32(x, 1), _mm_srli_epi32(x, 31))
+
+/*
+ * The message schedule four words at a time with SSE, then the rounds as
+ * before, reading W[t] + K from memory. W[t + 3] needs W[t], so each group
+ * is computed without it and the last word fixed up afterwards.
+ */
+__attribute__((target("ssse3")))
+static void SHA1BlocksSSSE3(
+    uint32_t state[5],
+    const unsigned char *data,
+    uint32_t blocks
+)
+{
+    static const uint32_t K[4] = {
+        0x5A827999, 0x6ED9EBA1, 0x8F1BBCDC, 0xCA62C1D6
+    };
+    const __m128i swap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11,
+        4, 5, 6, 7, 0, 1, 2, 3);
+    uint32_t w[80], wk[80];
+    uint32_t a, b, c, d, e;
+    __m128i x, fix;
+    int i;
+
+    for (; blocks > 0; blocks--, data += 64)
+    {
+        for (i = 0; i < 80; i += 4)
+        {
+            if (i < 16)
+            {
+                x = _mm_loadu_si128((const __m128i *)(data + i * 4));
+                x = _mm_shuffle_epi8(x, swap);
+            }
+            else
+            {
+                x = _mm_xor_si128(_mm_loadu_si128((__m128i *)&w[i - 16]),
+                    _mm_loadu_si128((__m128i *)&w[i - 14]));
+                x = _mm_xor_si128(x, _mm_loadu_si128((__m128i *)&w[i - 8]));
+                x = _mm_xor_si128(x,
+                    _mm_srli_si128(_mm_loadu_si128((__m128i *)&w[i - 4]), 4));
+                x = rol1_epi32(x);
+                fix = _mm_slli_si128(x, 12);
+                x = _mm_xor_si128(x, rol1_epi32(fix));
+            }
+            _mm_storeu_si128((__m128i *)&w[i], x);
+            _mm_storeu_si128((__m128i *)&wk[i],
+                _mm_add_epi32(x, _mm_set1_epi32((int)K[i / 20])));
+        }
+
+        a = state[0];
+        b = state[1];
+        c = state[2];
+        d = state[3];
+        e = state[4];
+        for (i = 0; i < 20; i += 5)
+        {
+            RK5(f1, i);
+        }
+        for (; i < 40; i += 5)
+        {
+            RK5(f2, i);
+        }
+        for (; i < 60; i += 5)
+        {
+            RK5(f3, i);
+        }
+        for (; i < 80; i += 5)
+        {
+            RK5(f2, i);
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+    memset(w, 0, sizeof(w));
+    memset(wk, 0, sizeof(wk));
+}
+
+/*
+ * Four rounds with the SHA extensions, while the schedule for the next
+ * words is computed from m0, the words these rounds use.
+ */
+#define SHANI4(e, next, m0, m1, m2, m3, f) \
+    e = _mm_sha1nexte_epu32(e, m0); \
+    next = abcd; \
+    m1 = _mm_sha1msg2_epu32(m1, m0); \
+    abcd = _mm_sha1rnds4_epu32(abcd, e, f); \
+    m3 = _mm_sha1msg1_epu32(m3, m0); \
+    m2 = _mm_xor_si128(m2, m0);
+
+__attribute__((target("sha,sse4.1")))
+static void SHA1BlocksSHANI(
+    uint32_t state[5],
+    const unsigned char *data,
+    uint32_t blocks
+)
+{
+    const __m128i swap = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+        8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i abcd, abcdSave, e0, e0Save, e1;
+    __m128i msg0, msg1, msg2, msg3;
+
+    abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)state), 0x1B);
+    e0 = _mm_set_epi32((int)state[4], 0, 0, 0);
+
+    for (; blocks > 0; blocks--, data += 64)
+    {
+        abcdSave = abcd;
+        e0Save = e0;
+
+        /* Rounds 0-15 start the schedule from the message itself. */
+        msg0 = _mm_shuffle_epi8(
+            _mm_loadu_si128((const __m128i *)data), swap);
+        e0 = _mm_add_epi32(e0, msg0);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+        msg1 = _mm_shuffle_epi8(
+            _mm_loadu_si128((const __m128i *)(data + 16)), swap);
+        e1 = _mm_sha1nexte_epu32(e1, msg1);
+        e0 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+        msg2 = _mm_shuffle_epi8(
+            _mm_loadu_si128((const __m128i *)(data + 32)), swap);
+        e0 = _mm_sha1nexte_epu32(e0, msg2);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        msg3 = _mm_shuffle_epi8(
+            _mm_loadu_si128((const __m128i *)(data + 48)), swap);
+        SHANI4(e1, e0, msg3, msg0, msg1, msg2, 0);
+
+        /* Rounds 16-63 */
+        SHANI4(e0, e1, msg0, msg1, msg2, msg3, 0);
+        SHANI4(e1, e0, msg1, msg2, msg3, msg0, 1);
+        SHANI4(e0, e1, msg2, msg3, msg0, msg1, 1);
+        SHANI4(e1, e0, msg3, msg0, msg1, msg2, 1);
+        SHANI4(e0, e1, msg0, msg1, msg2, msg3, 1);
+        SHANI4(e1, e0, msg1, msg2, msg3, msg0, 1);
+        SHANI4(e0, e1, msg2, msg3, msg0, msg1, 2);
+        SHANI4(e1, e0, msg3, msg0, msg1, msg2, 2);
+        SHANI4(e0, e1, msg0, msg1, msg2, msg3, 2);
+        SHANI4(e1, e0, msg1, msg2, msg3, msg0, 2);
+        SHANI4(e0, e1, msg2, msg3, msg0, msg1, 2);
+        SHANI4(e1, e0, msg3, msg0, msg1, msg2, 3);
+
+        /* Rounds 64-79 need less and less of the schedule. */
+        SHANI4(e0, e1, msg0, msg1, msg2, msg3, 3);
+        e1 = _mm_sha1nexte_epu32(e1, msg1);
+        e0 = abcd;
+        msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+        msg3 = _mm_xor_si128(msg3, msg1);
+
+        e0 = _mm_sha1nexte_epu32(e0, msg2);
+        e1 = abcd;
+        msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 3);
+
+        e1 = _mm_sha1nexte_epu32(e1, msg3);
+        e0 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+
+        e0 = _mm_sha1nexte_epu32(e0, e0Save);
+        abcd = _mm_add_epi32(abcd, abcdSave);
+    }
+
+    _mm_storeu_si128((__m128i *)state, _mm_shuffle_epi32(abcd, 0x1B));
+    state[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+
+#endif /* SHA1_X86 */
+
+static SHA1BlockFunction sha1Blocks = SHA1BlocksPortable;
+static SHA1Implementation sha1Implementation = SHA1_PORTABLE;
+
+int SHA1Supported(
+    SHA1Implementation implementation
+)
+{
+#ifdef SHA1_X86
+    unsigned int eax, ebx, ecx, edx;
+
+    if (implementation == SHA1_PORTABLE)
+    {
+        return 1;
+    }
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    {
+        return 0;
+    }
+    if (implementation == SHA1_SSSE3)
+    {
+        return (ecx & CPUID_SSSE3) != 0;
+    }
+    if (implementation == SHA1_SHA_NI && (ecx & CPUID_SSE41) != 0 &&
+        __get_cpuid_max(0, NULL) >= 7)
+    {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        return (ebx & CPUID_SHA) != 0;
+    }
+    return 0;
+#else
+    return implementation == SHA1_PORTABLE;
+#endif
+}
+
+int SHA1UseImplementation(
+    SHA1Implementation implementation
+)
+{
+    if (!SHA1Supported(implementation))
+    {
+        return 0;
+    }
+    switch (implementation)
+    {
+#ifdef SHA1_X86
+    case SHA1_SSSE3:
+        sha1Blocks = SHA1BlocksSSSE3;
+        break;
+    case SHA1_SHA_NI:
+        sha1Blocks = SHA1BlocksSHANI;
+        break;
+#endif
+    default:
+        sha1Blocks = SHA1BlocksPortable;
+        break;
+    }
+    sha1Implementation = implementation;
+    return 1;
+}
+
+SHA1Implementation SHA1SelectImplementation(
+    void
+)
+{
+    if (!SHA1UseImplementation(SHA1_SHA_NI) &&
+        !SHA1UseImplementation(SHA1_SSSE3))
+    {
+        SHA1UseImplementation(SHA1_PORTABLE);
+    }
+    return sha1Implementation;
+}
+
+const char *SHA1ImplementationName(
+    SHA1Implementation implementation
+)
+{
+    switch (implementation)
+    {
+    case SHA1_SSSE3:
+        return "SSSE3";
+    case SHA1_SHA_NI:
+        return "SHA-NI";
+    default:
+        return "portable";
+    }
+}
+
+void SHA1Transform(
+    uint32_t state[5],
+    const unsigned char buffer[64]
+)
+{
+    sha1Blocks(state, buffer, 1);
+}
+
+
 /* SHA1Init - Initialize new context */
 
 void SHA1Init(
@@ -223,11 +542,9 @@ void SHA1Update(
     if ((j + len) > 63)
     {
         memcpy(&context->buffer[j], data, (i = 64 - j));
-        SHA1Transform(context->state, context->buffer);
-        for (; i + 63 < len; i += 64)
-        {
-            SHA1Transform(context->state, &data[i]);
-        }
+        sha1Blocks(context->state, context->buffer, 1);
+        sha1Blocks(context->state, &data[i], (len - i) / 64);
+        i += (len - i) & ~63U;
         j = 0;
     }
     else
@@ -238,6 +555,8 @@ void SHA1Update(
 
 /* Add padding and return the message digest. */
 
+static const unsigned char sha1Padding[64] = { 0x80 };
+
 void SHA1Final(
     unsigned char digest[20],
     SHA1_CTX * context
@@ -271,13 +590,9 @@ void SHA1Final(
         finalcount[i] = (unsigned char) ((context->count[(i >= 4 ? 0 : 1)] >> ((3 - (i & 3)) * 8)) & 255);      /* Endian independent */
     }
 #endif
-    c = 0200;
-    SHA1Update(context, &c, 1);
-    while ((context->count[0] & 504) != 448)
-    {
-        c = 0000;
-        SHA1Update(context, &c, 1);
-    }
+    /* 0x80 then zeros, to leave 8 bytes free in the last block */
+    c = (unsigned char) ((context->count[0] >> 3) & 63);
+    SHA1Update(context, sha1Padding, c < 56 ? 56 - c : 120 - c);
     SHA1Update(context, finalcount, 8); /* Should cause a SHA1Transform() */
     for (i = 0; i < 20; i++)
     {
@@ -295,11 +610,9 @@ void SHA1(
     uint32_t len)
 {
     SHA1_CTX ctx;
-    unsigned int ii;
 
     SHA1Init(&ctx);
-    for (ii=0; ii<len; ii+=1)
-        SHA1Update(&ctx, (const unsigned char*)str + ii, 1);
+    SHA1Update(&ctx, (const unsigned char*)str, len);
     SHA1Final((unsigned char *)hash_out, &ctx);
 }
 
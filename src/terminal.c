@@ -64,7 +64,7 @@ void CheckIdentifyResponse(Buffer *out, const char *response,
 {
     char da[51], attr[51];
     int i = 0, j = 0, n = 0;
-    int attrs[25]; /* each attribute is at least 2 bytes */
+    int attrs[MAX_IDENTIFY_ATTRIBUTES];
 
     if (out == NULL || response == NULL || terminal == NULL)
     {
@@ -83,7 +83,7 @@ void CheckIdentifyResponse(Buffer *out, const char *response,
         /* Parse the response */
         n = 0;
         j = 0;
-        for (i = 0; i < (int)strlen(da); i++)
+        for (i = 0; da[i] != '\0' && n < MAX_IDENTIFY_ATTRIBUTES; i++)
         {
             if (da[i] == ';')
             {
@@ -98,8 +98,15 @@ void CheckIdentifyResponse(Buffer *out, const char *response,
                 j++;
             }
         }
+        if (j > 0 && n < MAX_IDENTIFY_ATTRIBUTES)
+        {
+            /* The last attribute runs up to the final 'c'. */
+            attr[j] = '\0';
+            attrs[n] = atoi(attr);
+            n++;
+        }
 
-        switch(attrs[0])
+        if (n > 0) switch(attrs[0])
         {
             case 1:
                 Debug("Terminal type: VT100");
@@ -0,0 +1,171 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/admin.h>
+#include <vbbs/session.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _POSIX_VERSION
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#endif
+
+#include "shared.h"
+
+#define TEST_SOCKET "admintest.sock"
+
+static char response[ADMIN_RESPONSE_SIZE];
+
+static const char *respond(const char *request, ArrayList *sessions) {
+    MetricsText out;
+    InitMetricsText(&out, response, sizeof(response));
+    BuildAdminResponse(request, sessions, &out);
+    return response;
+}
+
+static void testAdminRequests(void) {
+    ArrayList *sessions;
+    Connection conn;
+    Session session;
+    bool ok;
+
+    InitMetrics();
+    sessions = NewArrayList(4, NULL);
+    memset(&conn, 0, sizeof(conn));
+    conn.connectionType = SERIAL;
+    conn.outputBuffer = NewBuffer(64);
+    memset(&session, 0, sizeof(session));
+    session.conn = &conn;
+    session.sessionID = 42;
+    session.eventHandler = Connected;
+    session.lastActivity = time(NULL);
+    AddToArrayList(sessions, &session);
+
+    ok = strstr(respond("metrics", sessions),
+        "# TYPE vbbs_active_sessions gauge\n") != NULL &&
+        strncmp(response, "HTTP", 4) != 0;
+    ok = ok && strncmp(respond("GET /metrics HTTP/1.1\r", sessions),
+        "HTTP/1.0 200 OK\r\n", 17) == 0 &&
+        strstr(response, "vbbs_read_nanoseconds_bucket{le=\"+Inf\"}") != NULL;
+    ok = ok && strstr(respond("GET /json HTTP/1.0", sessions),
+        "\"sessions\": [{\"id\": 42, \"type\": \"serial\"") != NULL &&
+        strstr(response, "\"handler\": \"Connected\"") != NULL &&
+        strstr(response, "\"vbbs_active_sessions\": ") != NULL;
+    ok = ok && strstr(respond("sessions", sessions), "Connected") != NULL;
+    ok = ok && strncmp(respond("GET /nothing HTTP/1.0", sessions),
+        "HTTP/1.0 404", 12) == 0;
+    ok = ok && strncmp(respond("status", sessions), "Unknown", 7) == 0;
+
+    DestroyBuffer(conn.outputBuffer);
+    DestroyArrayList(sessions);
+    printTestResult("testAdminRequests", ok);
+}
+
+#ifdef _POSIX_VERSION
+static void testAdminSocket(void) {
+    AdminListener *listener;
+    ArrayList *sessions;
+    struct sockaddr_un address;
+    struct stat status;
+    struct timeval timeout;
+    fd_set readFds, writeFds;
+    char reply[256];
+    int client, i, maxFd, length = 0;
+    ssize_t n;
+    bool ok;
+
+    sessions = NewArrayList(4, NULL);
+    listener = NewAdminListener(TEST_SOCKET);
+    ok = listener != NULL;
+    /* Only the owner may connect. */
+    ok = ok && stat(TEST_SOCKET, &status) == 0 &&
+        (status.st_mode & (S_IRWXG | S_IRWXO)) == 0;
+    client = socket(AF_UNIX, SOCK_STREAM, 0);
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strcpy(address.sun_path, TEST_SOCKET);
+    ok = ok && connect(client, (struct sockaddr *)&address,
+        sizeof(address)) == 0;
+    ok = ok && write(client, "sessions\n", 9) == 9;
+
+    /* Accept, read and answer, as the event loop would. */
+    for (i = 0; ok && i < 10; i++) {
+        FD_ZERO(&readFds);
+        FD_ZERO(&writeFds);
+        maxFd = SetAdminFds(listener, &readFds, &writeFds, 0);
+        timeout.tv_sec = 0;
+        timeout.tv_usec = 100000;
+        if (select(maxFd + 1, &readFds, &writeFds, NULL, &timeout) > 0) {
+            HandleAdminFds(listener, &readFds, &writeFds, sessions);
+        }
+    }
+    while (ok && (n = read(client, reply + length,
+        sizeof(reply) - 1 - length)) > 0) {
+        length += (int)n;
+    }
+    reply[length] = '\0';
+    ok = ok && strncmp(reply, "ID ", 3) == 0 && strstr(reply, "IDLE\n");
+
+    close(client);
+    DestroyAdminListener(listener);
+    ok = ok && access(TEST_SOCKET, F_OK) != 0;
+    DestroyArrayList(sessions);
+    printTestResult("testAdminSocket", ok);
+}
+
+static void testAdminSocketPath(void) {
+    AdminListener *listener;
+    FILE *file;
+    bool ok;
+
+    /* A file that isn't a socket is left alone. */
+    file = fopen(TEST_SOCKET, "w");
+    ok = file != NULL;
+    if (file != NULL) {
+        fclose(file);
+    }
+    listener = NewAdminListener(TEST_SOCKET);
+    ok = ok && listener == NULL && access(TEST_SOCKET, F_OK) == 0;
+    DestroyAdminListener(listener);
+    unlink(TEST_SOCKET);
+    printTestResult("testAdminSocketPath", ok);
+}
+#endif
+
+void runAllAdminTests(void) {
+    printf("Running Admin Tests...\n");
+    testAdminRequests();
+#ifdef _POSIX_VERSION
+    testAdminSocket();
+    testAdminSocketPath();
+#endif
+    printf("\n");
+}
@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/arena.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+static void testArenaAlloc(void) {
+    Arena arena;
+    ArenaMark mark;
+    char *a, *b, *c, *copy;
+    bool passed;
+
+    InitArena(&arena, 0);
+    a = (char *)ArenaAlloc(&arena, 3);
+    b = (char *)ArenaAlloc(&arena, 8);
+    passed = a != NULL && b != NULL && b > a &&
+        (size_t)b % sizeof(double) == 0 && arena.used == 16;
+    copy = ArenaCopyString(&arena, "hello");
+    passed = passed && copy != NULL && strcmp(copy, "hello") == 0;
+
+    /* Everything after the mark goes, and the space is used again. */
+    mark = GetArenaMark(&arena);
+    c = (char *)ArenaAlloc(&arena, 100);
+    ArenaAlloc(&arena, ARENA_CHUNK_SIZE * 3);
+    passed = passed && arena.reserved > ARENA_CHUNK_SIZE * 3;
+    ResetArena(&arena, mark);
+    passed = passed && arena.reserved == ARENA_CHUNK_SIZE &&
+        ArenaAlloc(&arena, 100) == c && strcmp(copy, "hello") == 0;
+
+    DestroyArena(&arena);
+    passed = passed && arena.reserved == 0 && arena.used == 0 &&
+        arena.peak > ARENA_CHUNK_SIZE * 3;
+    printTestResult("testArenaAlloc", passed);
+}
+
+static void testArenaLimit(void) {
+    Arena arena;
+    bool passed = TRUE;
+    int i;
+
+    InitArena(&arena, ARENA_CHUNK_SIZE * 2);
+    for (i = 0; i < 1000; i++) {
+        if (ArenaAlloc(&arena, 64) == NULL) {
+            break;
+        }
+    }
+    /* Two chunks' worth, less their headers, then no more. */
+    passed = i > 2 * ARENA_CHUNK_SIZE / 64 - 4 &&
+        i < 2 * ARENA_CHUNK_SIZE / 64 &&
+        arena.reserved == ARENA_CHUNK_SIZE * 2 && arena.refused == 1;
+    passed = passed && ArenaAlloc(&arena, ARENA_CHUNK_SIZE * 4) == NULL;
+    DestroyArena(&arena);
+    passed = passed && ArenaAlloc(&arena, 64) != NULL;
+    DestroyArena(&arena);
+    printTestResult("testArenaLimit", passed);
+}
+
+void runAllArenaTests(void) {
+    printf("Running Arena Tests...\n");
+    testArenaAlloc();
+    testArenaLimit();
+    printf("\n");
+}
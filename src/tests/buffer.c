@@ -25,6 +25,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <vbbs/types.h>
 #include <vbbs/buffer.h>
+#include <vbbs/globals.h>
+#include <vbbs/memory.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -163,6 +165,128 @@ void testReplaceNewlines(void) {
     DestroyBuffer(buffer);
 }
 
+void testGrowableBuffer(void) {
+    Buffer *buffer = NewBuffer(CONNECTION_BUFFER_SIZE);
+    size_t before = GetTrackedMemory();
+    char data[CONNECTION_BUFFER_SIZE * 5];
+    bool passed;
+    int i, written;
+
+    for (i = 0; i < (int)sizeof(data); i++) {
+        data[i] = 'A' + i % 26;
+    }
+    SetBufferLimit(buffer, CONNECTION_BUFFER_SIZE * 4);
+
+    /* Room is added as it is needed, doubling each time. */
+    written = WriteToBuffer(buffer, data, CONNECTION_BUFFER_SIZE * 3);
+    passed = written == CONNECTION_BUFFER_SIZE * 3 &&
+        buffer->length == written &&
+        buffer->capacity == CONNECTION_BUFFER_SIZE * 4 &&
+        memcmp(buffer->bytes, data, written) == 0 &&
+        GetTrackedMemory() > before;
+
+    /* No further than the limit. */
+    written = WriteToBuffer(buffer, data + buffer->length,
+        CONNECTION_BUFFER_SIZE * 2);
+    passed = passed && written == CONNECTION_BUFFER_SIZE &&
+        IsBufferFull(buffer) &&
+        memcmp(buffer->bytes, data, CONNECTION_BUFFER_SIZE * 4) == 0;
+
+    /* Draining it gives the memory back. */
+    ShiftBuffer(buffer, CONNECTION_BUFFER_SIZE);
+    passed = passed && buffer->capacity == CONNECTION_BUFFER_SIZE * 4 &&
+        buffer->bytes[0] == data[CONNECTION_BUFFER_SIZE];
+    ShiftBuffer(buffer, buffer->length);
+    passed = passed && IsBufferEmpty(buffer) &&
+        buffer->capacity == CONNECTION_BUFFER_SIZE &&
+        GetTrackedMemory() == before;
+    written = WriteToBuffer(buffer, data, 10);
+    passed = passed && written == 10 && memcmp(buffer->bytes, data, 10) == 0;
+
+    DestroyBuffer(buffer);
+    printTestResult("testGrowableBuffer", passed);
+}
+
+static char terminalType[64];
+
+static void saveTerminalType(void *userData, const char *type) {
+    (void)userData;
+    strncpy(terminalType, type, sizeof(terminalType) - 1);
+    terminalType[sizeof(terminalType) - 1] = '\0';
+}
+
+void testLongSubnegotiation(void) {
+    char data[600];
+    int length = 0;
+    Buffer *buffer = NewBuffer(64);
+    if (buffer == NULL) {
+        printTestResult("testLongSubnegotiation", FALSE);
+        return;
+    }
+    buffer->handleTelnet = TRUE;
+    buffer->terminalType = saveTerminalType;
+    terminalType[0] = '\0';
+
+    /* IAC SB TERMINAL-TYPE IS, far more than commandBuffer holds, IAC SE */
+    memcpy(data, "\377\372\030\000", 4);
+    length = 4;
+    memset(data + length, 'X', 500);
+    length += 500;
+    memcpy(data + length, "\377\360ok\377\377", 6);
+    length += 6;
+    WriteToBuffer(buffer, data, length);
+
+    if (buffer->length == 3 && memcmp(buffer->bytes, "ok\377", 3) == 0 &&
+        strlen(terminalType) == sizeof(terminalType) - 1 &&
+        terminalType[0] == 'X') {
+        printTestResult("testLongSubnegotiation", TRUE);
+    } else {
+        printf("Got %d bytes, terminal type %s\n", buffer->length,
+            terminalType);
+        printTestResult("testLongSubnegotiation", FALSE);
+    }
+    DestroyBuffer(buffer);
+}
+
+void testFindNextLine(void) {
+    char line[600];
+    bool passed = TRUE;
+    int i;
+    InputBuffer *input = NewInputBuffer(1024);
+    if (input == NULL) {
+        printTestResult("testFindNextLine", FALSE);
+        return;
+    }
+
+    /* LF and NUL are dropped wherever they are. */
+    WriteToBuffer(input->buffer, "\n\nab\0c\r\nd", 9);
+    passed = passed && IsNextLineReady(input) &&
+        strcmp(input->nextLine, "abc") == 0;
+    ClearNextLine(input);
+    passed = passed && !IsNextLineReady(input) && input->buffer->length == 1;
+
+    /* A line typed a byte at a time. */
+    for (i = 0; i < 5; i++) {
+        passed = passed && !IsNextLineReady(input);
+        WriteToBuffer(input->buffer, "e\n", 2);
+    }
+    WriteToBuffer(input->buffer, "\r", 1);
+    passed = passed && IsNextLineReady(input) &&
+        strcmp(input->nextLine, "deeeee") == 0;
+    ClearNextLine(input);
+
+    /* A line longer than nextLine is cut short. */
+    memset(line, 'f', sizeof(line));
+    line[sizeof(line) - 1] = '\r';
+    WriteToBuffer(input->buffer, line, sizeof(line));
+    passed = passed && IsNextLineReady(input) &&
+        strlen(input->nextLine) == sizeof(input->nextLine) - 1 &&
+        IsBufferEmpty(input->buffer);
+
+    printTestResult("testFindNextLine", passed);
+    DestroyInputBuffer(input);
+}
+
 void runAllBufferTests(void) {
     printf("Running Buffer Tests...\n");
     testIsBufferEmpty();
@@ -171,5 +295,8 @@ void runAllBufferTests(void) {
     testReadWriteBuffer();
     testBufferOverflow();
     testReplaceNewlines();
+    testGrowableBuffer();
+    testLongSubnegotiation();
+    testFindNextLine();
     printf("\n");
 }
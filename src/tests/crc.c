@@ -34,6 +34,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EXPECTED_CHECKSUM 0x1B
 #define EXPECTED_CRC16_CCITT 0xB65E
 #define EXPECTED_CRC16_XMODEM 0xE8AF
+#define EXPECTED_CRC32 0xABF77822UL
 
 #define SUCCESS "\033[0;32mSuccess\033[0m"
 #define FAILURE "\033[0;31m\033[5mFailed\033[0m"
@@ -54,10 +55,18 @@ void testCRC16_XMODEM(void) {
     printTestResult("CRC16/XMODEM", crc == EXPECTED_CRC16_XMODEM);
 }
 
+void testCRC32(void) {
+    uint32_t crc = CRC32S(TEST_STRING);
+    /* The same value fed in two pieces. */
+    uint32_t split = CRC32(CRC32(0, TEST_STRING, 10), TEST_STRING + 10, 16);
+    printTestResult("CRC32", crc == EXPECTED_CRC32 && split == crc);
+}
+
 void runAllCRCTests(void) {
     printf("\nRunning CRC Tests...\n");
     testChecksum();
     testCRC16_CCITT();
     testCRC16_XMODEM();
+    testCRC32();
     printf("\n");
 }
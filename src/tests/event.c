@@ -0,0 +1,125 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/event.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+#define TEST_EVENT_FILE "test.evt"
+
+static void fillEvent(Event *event, uint32_t n) {
+    memset(event, 0, sizeof(Event));
+    event->time = 1700000000UL + n;
+    event->type = (uint16_t)(n % (EVENT_TYPE_COUNT - 1) + 1);
+    event->connectionType = 3;
+    event->sessionID = n;
+    event->userID = n * 7;
+    event->remoteIP = 0xC0A80001UL + n;
+    event->remotePort = (uint16_t)(1024 + n);
+    event->value = n * 1000;
+    sprintf(event->username, "user%lu", (unsigned long)n);
+}
+
+static bool sameEvent(const Event *a, const Event *b) {
+    return a->time == b->time && a->type == b->type &&
+        a->connectionType == b->connectionType &&
+        a->sessionID == b->sessionID && a->userID == b->userID &&
+        a->remoteIP == b->remoteIP && a->remotePort == b->remotePort &&
+        a->value == b->value && strcmp(a->username, b->username) == 0;
+}
+
+static void testEventEncoding(void) {
+    uint8_t record[EVENT_RECORD_SIZE];
+    Event event, decoded;
+    bool ok;
+
+    fillEvent(&event, 5);
+    /* A full length name has no room for a NUL in the record. */
+    strcpy(event.username, "abcdefghijklmnopqrst");
+    EncodeEvent(&event, record);
+    DecodeEvent(record, &decoded);
+    ok = sameEvent(&event, &decoded) &&
+        record[0] == 0x05 && record[1] == 0xF1 && record[4] == event.type &&
+        record[16] == 0x06 && record[19] == 0xC0;
+    ok = ok && ParseEventType("Login-Failed") == EVENT_LOGIN_FAILED &&
+        ParseEventType("login") == EVENT_LOGIN &&
+        ParseEventType("log") == EVENT_NONE &&
+        strcmp(EventTypeName(EVENT_TRANSFER_COMPLETE), "transfer") == 0;
+    printTestResult("testEventEncoding", ok);
+}
+
+static void testEventLog(void) {
+    EventReader *reader;
+    Event event, read;
+    FILE *file;
+    uint32_t n = 0;
+    bool ok;
+    int i;
+
+    remove(TEST_EVENT_FILE);
+    ok = OpenEventLog(TEST_EVENT_FILE);
+    for (i = 0; i < 1500; i++) {
+        fillEvent(&event, (uint32_t)i);
+        LogEvent(&event);
+    }
+    CloseEventLog();
+    /* Reopening appends after the existing records. */
+    ok = ok && OpenEventLog(TEST_EVENT_FILE);
+    for (; i < 2500; i++) {
+        fillEvent(&event, (uint32_t)i);
+        LogEvent(&event);
+    }
+    FlushEventLog();
+    CloseEventLog();
+
+    reader = OpenEventReader(TEST_EVENT_FILE);
+    ok = ok && reader != NULL;
+    while (ok && ReadEvent(reader, &read)) {
+        fillEvent(&event, n++);
+        ok = sameEvent(&event, &read);
+    }
+    ok = ok && n == 2500;
+    CloseEventReader(reader);
+
+    /* A partial record means the file can't safely be appended to. */
+    file = fopen(TEST_EVENT_FILE, "ab");
+    if (file != NULL) {
+        fputc(0, file);
+        fclose(file);
+    }
+    ok = ok && !OpenEventLog(TEST_EVENT_FILE) && !IsEventLogOpen();
+    remove(TEST_EVENT_FILE);
+    printTestResult("testEventLog", ok);
+}
+
+void runAllEventTests(void) {
+    printf("Running Event Tests...\n");
+    testEventEncoding();
+    testEventLog();
+    printf("\n");
+}
@@ -0,0 +1,269 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/log.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "shared.h"
+
+#define TEST_LOG_FILE "logtest.log"
+
+/* Count the lines in the test log that contain text. */
+static long countLinesIn(const char *filename, const char *text) {
+    char line[LOG_MESSAGE_SIZE + 2];
+    long count = 0;
+    FILE *file = fopen(filename, "r");
+    if (file == NULL) {
+        return -1;
+    }
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (strstr(line, text) != NULL) {
+            count++;
+        }
+    }
+    fclose(file);
+    return count;
+}
+
+static long countLogLines(const char *text) {
+    return countLinesIn(TEST_LOG_FILE, text);
+}
+
+/* Rate limits are off unless a test turns them on. */
+static void openTestLog(void) {
+    remove(TEST_LOG_FILE);
+    SetLogEcho(FALSE);
+    SetLogRateLimits(0, 0, 0, 0);
+    InitLog(TEST_LOG_FILE);
+}
+
+static void closeTestLog(void) {
+    CloseLog();
+    SetLogEcho(TRUE);
+    SetLogRateLimits(LOG_SITE_RATE, LOG_SITE_BURST, LOG_SESSION_RATE,
+        LOG_SESSION_BURST);
+    remove(TEST_LOG_FILE);
+}
+
+static void testSyncLog(void) {
+    char longMessage[LOG_MESSAGE_SIZE * 2];
+    bool ok;
+
+    openTestLog();
+    Info("sync test %d", 1);
+    Debug("sync test %s", "two");
+    memset(longMessage, 'x', sizeof(longMessage) - 1);
+    longMessage[sizeof(longMessage) - 1] = '\0';
+    Warn("sync test long %s", longMessage);
+    ok = countLogLines("sync test") ==
+        (LOG_MIN_LEVEL > LOG_DEBUG ? 2 : 3) &&
+        countLogLines("[INFO] sync test 1") == 1 &&
+        countLogLines("[WARNING] sync test long xxx") == 1;
+    printTestResult("testSyncLog", ok);
+    closeTestLog();
+}
+
+static int countCalls(int *calls) {
+    return ++*calls;
+}
+
+/* Arguments of a disabled level must not be evaluated. */
+static void testLogLevelGating(void) {
+    LogLevel level = LOG_LEVEL;
+    int calls = 0;
+    bool ok;
+
+    openTestLog();
+    SetLogLevel(LOG_WARN);
+    Info("gating test %d", countCalls(&calls));
+    Debug("gating test %d", countCalls(&calls));
+    ok = calls == 0;
+    /* The macros must still pair with an unbraced else. */
+    if (ok)
+        Warn("gating test %d", countCalls(&calls));
+    else
+        calls = -1;
+    ok = ok && calls == 1 && countLogLines("gating test 1") == 1 &&
+        countLogLines("gating test") == 1;
+    SetLogLevel(level);
+    printTestResult("testLogLevelGating", ok);
+    closeTestLog();
+}
+
+static void testAsyncLog(void) {
+    bool ok;
+    int i;
+
+    openTestLog();
+    ok = StartAsyncLog();
+#ifdef LOG_ASYNC_SUPPORTED
+    for (i = 0; i < 100; i++) {
+        Info("async test %d", i);
+    }
+    StopAsyncLog();
+    ok = ok && countLogLines("async test") == 100 &&
+        countLogLines("async test 99") == 1;
+#else
+    (void)i;
+    ok = !ok;
+#endif
+    printTestResult("testAsyncLog", ok);
+    closeTestLog();
+}
+
+static void testAsyncLogOverload(void) {
+    unsigned long dropped;
+    long written;
+    bool ok;
+    int i;
+
+    openTestLog();
+    dropped = GetDroppedLogMessages();
+    ok = StartAsyncLog();
+#ifdef LOG_ASYNC_SUPPORTED
+    /* Far more than the ring holds, faster than it can be written. */
+    for (i = 0; i < LOG_RING_SIZE * 20; i++) {
+        Info("overload test %d", i);
+    }
+    StopAsyncLog();
+    dropped = GetDroppedLogMessages() - dropped;
+    written = countLogLines("overload test");
+    ok = ok && written + (long)dropped == LOG_RING_SIZE * 20;
+    ok = ok && (dropped == 0 || countLogLines("messages were dropped") > 0);
+#else
+    (void)i;
+    (void)written;
+    ok = !ok && dropped == 0;
+#endif
+    printTestResult("testAsyncLogOverload", ok);
+    closeTestLog();
+}
+
+/* Every call comes from the same call site. */
+static void logSiteLimitTest(int i) {
+    Info("site limit test %d", i);
+}
+
+static void testLogRateLimit(void) {
+    unsigned long suppressed;
+    long written;
+    bool ok;
+    int i;
+
+    openTestLog();
+    suppressed = GetSuppressedLogMessages();
+    SetLogRateLimits(20, 10, 0, 0);
+    for (i = 0; i < 50; i++) {
+        logSiteLimitTest(i);
+    }
+    written = countLogLines("site limit test");
+    ok = written >= 10 && written <= 12 &&
+        GetSuppressedLogMessages() - suppressed == (unsigned long)(50 - written);
+#ifdef _POSIX_VERSION
+    {
+        /* Long enough for two more tokens. */
+        struct timespec pause;
+        pause.tv_sec = 0;
+        pause.tv_nsec = 110000000L;
+        nanosleep(&pause, NULL);
+        for (i = 0; i < 50; i++) {
+            logSiteLimitTest(i);
+        }
+        ok = ok && countLogLines("Suppressed") == 1 &&
+            countLogLines("site limit test") >= written + 2;
+    }
+#endif
+
+    SetLogRateLimits(0, 0, 20, 5);
+    SetLogSession(7);
+    for (i = 0; i < 20; i++) {
+        Info("session limit test %d", i);
+    }
+    SetLogSession(0);
+    for (i = 0; i < 20; i++) {
+        Info("no session test %d", i);
+    }
+    written = countLogLines("session limit test");
+    ok = ok && written >= 5 && written <= 6 &&
+        countLogLines("no session test") == 20;
+    printTestResult("testLogRateLimit", ok);
+    closeTestLog();
+}
+
+static bool testRotation(bool async) {
+    char name[64];
+    long lines = 0;
+    bool ok;
+    int i;
+
+    openTestLog();
+    SetLogRotation(4096, 0, 2);
+    if (async) {
+        StartAsyncLog();
+    }
+    for (i = 0; i < 300; i++) {
+        Info("rotation test %03d .........................................", i);
+        /* The writer rotates between batches, so make several. */
+        if (i % 50 == 49) {
+            FlushLog();
+        }
+    }
+    StopAsyncLog();
+    for (i = 1; i <= 3; i++) {
+        sprintf(name, "%s.%d", TEST_LOG_FILE, i);
+        lines += countLinesIn(name, "rotation test") > 0 ? 1 : 0;
+    }
+    /* Only the two newest old files are kept. */
+    ok = countLogLines("rotation test 299") == 1 && lines == 2 && countLogLines("rotation test") <= 50;
+    SetLogRotation(LOG_ROTATE_SIZE, LOG_ROTATE_INTERVAL, LOG_ROTATE_KEEP);
+    closeTestLog();
+    for (i = 1; i <= 3; i++) {
+        sprintf(name, "%s.%d", TEST_LOG_FILE, i);
+        remove(name);
+    }
+    return ok;
+}
+
+static void testLogRotation(void) {
+    bool ok = testRotation(FALSE);
+#ifdef LOG_ASYNC_SUPPORTED
+    ok = ok && testRotation(TRUE);
+#endif
+    printTestResult("testLogRotation", ok);
+}
+
+void runAllLogTests(void) {
+    printf("Running Log Tests...\n");
+    testSyncLog();
+    testLogLevelGating();
+    testAsyncLog();
+    testAsyncLogOverload();
+    testLogRateLimit();
+    testLogRotation();
+    printf("\n");
+}
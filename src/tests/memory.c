@@ -0,0 +1,148 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/memory.h>
+#include <vbbs/list.h>
+#include <vbbs/map.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+static void testTrackedAlloc(void) {
+    MemoryAccount *account = NewMemoryAccount();
+    size_t before = GetTrackedMemory();
+    char *a, *b;
+    bool passed;
+    int i;
+
+    SetMemoryAccount(account);
+    a = (char *)TrackedMalloc(100);
+    b = (char *)TrackedCalloc(10, 8);
+    SetMemoryAccount(NULL);
+    passed = a != NULL && b != NULL && account->bytes == 180 &&
+        account->blocks == 2 && GetTrackedMemory() == before + 180 &&
+        GetMemoryAccountOf(a) == account && (size_t)b % sizeof(double) == 0;
+    for (i = 0; passed && i < 80; i++) {
+        passed = b[i] == 0;
+    }
+
+    /* A block stays with its account when it grows elsewhere. */
+    memset(a, 'x', 100);
+    a = (char *)TrackedRealloc(a, 300);
+    passed = passed && a != NULL && a[99] == 'x' && account->bytes == 380 &&
+        account->blocks == 2 && account->peak == 380 &&
+        GetTrackedMemory() == before + 380;
+
+    TrackedFree(a);
+    TrackedFree(b);
+    TrackedFree(NULL);
+    passed = passed && account->bytes == 0 && account->blocks == 0 &&
+        GetTrackedMemory() == before;
+    ReleaseMemoryAccount(account);
+    printTestResult("testTrackedAlloc", passed);
+}
+
+static void testReleasedAccount(void) {
+    MemoryAccount *account = NewMemoryAccount();
+    size_t before = GetTrackedMemory();
+    void *block;
+    bool passed;
+
+    SetMemoryAccount(account);
+    block = TrackedMalloc(64);
+    ReleaseMemoryAccount(account);
+
+    /* Releasing the current account stops charging to it. */
+    passed = GetMemoryAccount() == NULL && account->released &&
+        account->bytes == 64 && GetMemoryAccountOf(block) == account;
+    block = TrackedRealloc(block, 128);
+    passed = passed && account->bytes == 128;
+    /* The last block takes the account with it. */
+    TrackedFree(block);
+    passed = passed && GetTrackedMemory() == before;
+    printTestResult("testReleasedAccount", passed);
+}
+
+static void testContainerAccounts(void) {
+    MemoryAccount *owner = NewMemoryAccount(), *caller = NewMemoryAccount();
+    ArrayList *list;
+    Map *map;
+    size_t created;
+    char key[16];
+    bool passed;
+    int i;
+
+    SetMemoryAccount(owner);
+    list = NewArrayList(1, NULL);
+    map = NewMap(NULL);
+    created = owner->bytes;
+    passed = list != NULL && map != NULL && created > 0;
+
+    /* Growing someone else's list or map doesn't charge the caller. */
+    SetMemoryAccount(caller);
+    for (i = 0; i < 100; i++) {
+        sprintf(key, "key%d", i);
+        AddToArrayList(list, list);
+        MapPut(map, key, map);
+    }
+    passed = passed && caller->bytes == 0 && owner->bytes > created &&
+        map->size == 100;
+    SetMemoryAccount(NULL);
+
+    DestroyArrayList(list);
+    DestroyMap(map);
+    passed = passed && owner->bytes == 0 && owner->blocks == 0;
+    ReleaseMemoryAccount(owner);
+    ReleaseMemoryAccount(caller);
+    printTestResult("testContainerAccounts", passed);
+}
+
+static void testMemoryLimit(void) {
+    size_t saved = GetMemoryLimit();
+    void *block;
+    bool passed;
+
+    SetMemoryLimit(0);
+    passed = !IsMemoryExhausted();
+    SetMemoryLimit(GetTrackedMemory() + 1000);
+    passed = passed && !IsMemoryExhausted();
+    block = TrackedMalloc(2000);
+    passed = passed && block != NULL && IsMemoryExhausted();
+    TrackedFree(block);
+    passed = passed && !IsMemoryExhausted();
+    SetMemoryLimit(saved);
+    printTestResult("testMemoryLimit", passed);
+}
+
+void runAllMemoryTests(void) {
+    printf("Running Memory Tests...\n");
+    testTrackedAlloc();
+    testReleasedAccount();
+    testContainerAccounts();
+    testMemoryLimit();
+    printf("\n");
+}
@@ -0,0 +1,158 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/metrics.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _POSIX_VERSION
+#include <pthread.h>
+#endif
+
+#include "shared.h"
+
+#define TEST_THREADS 4
+#define TEST_INCREMENTS 100000L
+
+static Counter testCounter;
+static Histogram testHistogram;
+
+#ifdef _POSIX_VERSION
+static void *incrementThread(void *arg) {
+    long i;
+    (void)arg;
+    for (i = 0; i < TEST_INCREMENTS; i++) {
+        IncrementCounter(&testCounter);
+    }
+    return NULL;
+}
+#endif
+
+static void testCounters(void) {
+    Gauge gauge;
+    bool ok;
+#ifdef _POSIX_VERSION
+    pthread_t threads[TEST_THREADS];
+    int i;
+#endif
+
+    memset(&testCounter, 0, sizeof(testCounter));
+    AddToCounter(&testCounter, 5);
+    IncrementCounter(&testCounter);
+    ok = GetCounterValue(&testCounter) == 6;
+#ifdef _POSIX_VERSION
+    /* Shards are per thread, but the total must still be exact. */
+    for (i = 0; i < TEST_THREADS; i++) {
+        pthread_create(&threads[i], NULL, incrementThread, NULL);
+    }
+    for (i = 0; i < TEST_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    ok = ok && GetCounterValue(&testCounter) ==
+        6 + TEST_THREADS * TEST_INCREMENTS;
+#endif
+
+    memset(&gauge, 0, sizeof(gauge));
+    SetGauge(&gauge, 10);
+    AddToGauge(&gauge, -3);
+    ok = ok && GetGaugeValue(&gauge) == 7;
+    printTestResult("testCounters", ok);
+}
+
+static bool closeTo(unsigned long value, unsigned long expected) {
+    return value >= expected && value <= expected + expected / 16 + 1;
+}
+
+static void testHistograms(void) {
+    unsigned long i, sum = 0, previous = 0;
+    bool ok = TRUE;
+    int b;
+
+    /* Bucket starts go up, each at most 1/16th past the last. */
+    for (b = 1; b < HISTOGRAM_BUCKETS && ok; b++) {
+        ok = HistogramBucketValue(b) > previous &&
+            (b <= HISTOGRAM_SUB_BUCKETS ||
+            HistogramBucketValue(b) - previous <= previous / 16 + 1);
+        previous = HistogramBucketValue(b);
+    }
+
+    ResetHistogram(&testHistogram);
+    ok = ok && GetHistogramPercentile(&testHistogram, 0.5) == 0;
+    for (i = 1; i <= 10000; i++) {
+        RecordHistogram(&testHistogram, i);
+        sum += i;
+    }
+    ok = ok && GetHistogramCount(&testHistogram) == 10000 &&
+        GetHistogramSum(&testHistogram) == sum &&
+        closeTo(GetHistogramPercentile(&testHistogram, 0.5), 5000) &&
+        closeTo(GetHistogramPercentile(&testHistogram, 0.99), 9900) &&
+        GetHistogramPercentile(&testHistogram, 0.0) == 1;
+    /* Huge values land in the last bucket instead of overflowing. */
+    RecordHistogram(&testHistogram, (unsigned long)-1);
+    ok = ok && GetHistogramPercentile(&testHistogram, 1.0) ==
+        HistogramBucketValue(HISTOGRAM_BUCKETS - 1);
+    printTestResult("testHistograms", ok);
+}
+
+static void testMetricRegistry(void) {
+    const Metric *metric;
+    bool ok;
+
+    InitMetrics();
+    metric = FindMetric("vbbs_active_sessions");
+    ok = metric != NULL && metric->type == METRIC_GAUGE &&
+        metric->metric == &activeSessions && GetMetricCount() > 1 &&
+        GetMetric(0) != NULL && GetMetric(GetMetricCount()) == NULL;
+    ok = ok && !RegisterMetric("vbbs_active_sessions", "Duplicate",
+        METRIC_GAUGE, &activeSessions);
+    printTestResult("testMetricRegistry", ok);
+}
+
+static void testMetricsText(void) {
+    MetricsText out;
+    char buffer[32];
+    bool ok;
+
+    InitMetricsText(&out, buffer, sizeof(buffer));
+    AppendMetricsText(&out, "%s %d\n", "first", 1);
+    ok = out.length == 8 && !out.truncated;
+    /* A line that doesn't fit is dropped whole, not cut in half. */
+    AppendMetricsText(&out, "%s\n", "much too long to fit in the rest");
+    ok = ok && out.truncated && out.length == 8 &&
+        strcmp(buffer, "first 1\n") == 0;
+    AppendMetricsText(&out, "x");
+    ok = ok && out.length == 8;
+    printTestResult("testMetricsText", ok);
+}
+
+void runAllMetricsTests(void) {
+    printf("Running Metrics Tests...\n");
+    testCounters();
+    testHistograms();
+    testMetricRegistry();
+    testMetricsText();
+    printf("\n");
+}
@@ -0,0 +1,338 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/msg.h>
+#include <vbbs/db/msg.h>
+#include <vbbs/db/lastread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+#define TEST_MESSAGE_DB "msgtest.db"
+#define TEST_AREA_INDEX "area0001.idx"
+#define TEST_AREA_DATA "area0001.dat"
+#define TEST_LASTREAD_DB "lastreadtest.db"
+
+static void removeTestFiles(void) {
+    remove(TEST_MESSAGE_DB);
+    remove(TEST_AREA_INDEX);
+    remove(TEST_AREA_DATA);
+}
+
+static uint32_t postTestMessage(MessageArea *area, const char *subject,
+    const char *body) {
+    MessageHeader header;
+    InitMessageHeader(&header, "Sysop", "All", subject);
+    return PostMessage(area, &header, body, strlen(body));
+}
+
+static void testPostAndReadMessages(void) {
+    MessageDB *db;
+    MessageArea *area;
+    const MessageHeader *header;
+    char body[64];
+    int n;
+    bool ok = TRUE;
+
+    removeTestFiles();
+    db = NewMessageDB(TEST_MESSAGE_DB);
+    area = _AddMessageArea(db, "General", "General discussion");
+    if (area == NULL) {
+        printTestResult("testPostAndReadMessages", FALSE);
+        DestroyMessageDB(db);
+        return;
+    }
+
+    ok = ok && postTestMessage(area, "First", "Hello, world!") == 1;
+    ok = ok && postTestMessage(area, "Second", "Another body") == 2;
+    ok = ok && postTestMessage(area, "Empty", "") == 3;
+    ok = ok && GetHighWaterMark(area) == 3;
+
+    header = GetMessageHeader(area, 2);
+    ok = ok && header != NULL && strcmp(header->subject, "Second") == 0;
+    n = ReadMessageBody(area, header, 0, body, sizeof(body));
+    ok = ok && n == 12 && memcmp(body, "Another body", 12) == 0;
+    n = ReadMessageBody(area, header, 8, body, sizeof(body));
+    ok = ok && n == 4 && memcmp(body, "body", 4) == 0;
+
+    ok = ok && GetMessageHeader(area, 0) == NULL;
+    ok = ok && GetMessageHeader(area, 4) == NULL;
+
+    printTestResult("testPostAndReadMessages", ok);
+    _SaveMessageDB(db);
+    DestroyMessageDB(db);
+}
+
+static void testReloadMessageDB(void) {
+    MessageDB *db;
+    MessageArea *area;
+    const MessageHeader *header;
+    char body[64];
+    bool ok;
+
+    db = NewMessageDB(TEST_MESSAGE_DB);
+    ok = _LoadMessageDB(db) && _GetMessageAreaCount(db) == 1;
+    area = _GetMessageAreaByName(db, "general");
+    ok = ok && area != NULL && area->areaID == 1 &&
+        strcmp(area->description, "General discussion") == 0;
+    ok = ok && GetHighWaterMark(area) == 3;
+    header = GetMessageHeader(area, 1);
+    ok = ok && header != NULL &&
+        ReadMessageBody(area, header, 0, body, sizeof(body)) == 13 &&
+        memcmp(body, "Hello, world!", 13) == 0;
+    ok = ok && postTestMessage(area, "Fourth", "After reload") == 4;
+
+    printTestResult("testReloadMessageDB", ok);
+    DestroyMessageDB(db);
+    removeTestFiles();
+}
+
+static void testMessageIndexGrowth(void) {
+    MessageDB *db;
+    MessageArea *area;
+    const MessageHeader *header;
+    uint32_t i, count = MESSAGE_INDEX_GROWTH * 2 + 10;
+    char subject[32];
+    bool ok = TRUE;
+
+    removeTestFiles();
+    db = NewMessageDB(TEST_MESSAGE_DB);
+    area = _AddMessageArea(db, "Growth", "");
+    for (i = 1; ok && i <= count; i++) {
+        sprintf(subject, "Message %lu", (unsigned long)i);
+        ok = postTestMessage(area, subject, subject) == i;
+    }
+    for (i = 1; ok && i <= count; i += 97) {
+        sprintf(subject, "Message %lu", (unsigned long)i);
+        header = GetMessageHeader(area, i);
+        ok = header != NULL && header->number == i &&
+            strcmp(header->subject, subject) == 0;
+    }
+    printTestResult("testMessageIndexGrowth", ok);
+    DestroyMessageDB(db);
+    removeTestFiles();
+}
+
+static void testLastReadPointers(void) {
+    LastReadDB *db;
+    bool ok;
+
+    remove(TEST_LASTREAD_DB);
+    db = OpenLastReadDB(TEST_LASTREAD_DB);
+    ok = db != NULL;
+    ok = ok && _GetLastRead(db, 5, 3) == 0;
+    ok = ok && _SetLastRead(db, 5, 3, 42);
+    ok = ok && _SetLastRead(db, 5, 4, 7);
+    /* Far past the initial capacity, so the file has to grow. */
+    ok = ok && _SetLastRead(db, LASTREAD_USER_GROWTH * 3 + 1, 3, 99);
+    ok = ok && !_SetLastRead(db, 5, LASTREAD_MAX_AREAS, 1);
+    ok = ok && _GetLastRead(db, 5, 3) == 42 && _GetLastRead(db, 5, 4) == 7;
+    ok = ok && _GetLastRead(db, 6, 3) == 0;
+    ok = ok && _GetLastRead(db, LASTREAD_USER_GROWTH * 3 + 1, 3) == 99;
+    CloseLastReadDB(db);
+
+    db = OpenLastReadDB(TEST_LASTREAD_DB);
+    ok = ok && db != NULL && _GetLastRead(db, 5, 3) == 42 &&
+        _GetLastRead(db, LASTREAD_USER_GROWTH * 3 + 1, 3) == 99;
+    printTestResult("testLastReadPointers", ok);
+    CloseLastReadDB(db);
+    remove(TEST_LASTREAD_DB);
+}
+
+static void testLastReadWidening(void) {
+    LastReadDB *db;
+    unsigned int user, area = LASTREAD_AREA_GROWTH * 4 + 3;
+    bool ok;
+
+    remove(TEST_LASTREAD_DB);
+    db = OpenLastReadDB(TEST_LASTREAD_DB);
+    ok = db != NULL && db->header->areaStride == LASTREAD_AREA_GROWTH;
+    for (user = 0; ok && user < LASTREAD_USER_GROWTH + 5; user++) {
+        ok = _SetLastRead(db, user, 1, user + 100);
+    }
+
+    /* A higher area widens every row and keeps the pointers. */
+    ok = ok && _SetLastRead(db, 3, area, 77) &&
+        db->header->areaStride > area;
+    for (user = 0; ok && user < LASTREAD_USER_GROWTH + 5; user++) {
+        ok = _GetLastRead(db, user, 1) == user + 100;
+    }
+    ok = ok && _GetLastRead(db, 3, area) == 77 &&
+        _GetLastRead(db, 4, area) == 0;
+    CloseLastReadDB(db);
+
+    db = OpenLastReadDB(TEST_LASTREAD_DB);
+    ok = ok && db != NULL && db->header->areaStride > area &&
+        _GetLastRead(db, 3, area) == 77 &&
+        _GetLastRead(db, LASTREAD_USER_GROWTH + 4, 1) ==
+            LASTREAD_USER_GROWTH + 104;
+    printTestResult("testLastReadWidening", ok);
+    CloseLastReadDB(db);
+    remove(TEST_LASTREAD_DB);
+}
+
+static void testLastReadCorruptHeader(void) {
+    LastReadDB *db;
+    LastReadHeader header;
+    FILE *file;
+    long size = -1;
+    bool ok;
+
+    remove(TEST_LASTREAD_DB);
+    db = OpenLastReadDB(TEST_LASTREAD_DB);
+    ok = db != NULL && _SetLastRead(db, 5, 1, 42);
+    CloseLastReadDB(db);
+
+    /* A header claiming more users than the file holds isn't opened, and
+       the file isn't grown to match it. */
+    file = fopen(TEST_LASTREAD_DB, "r+b");
+    ok = ok && file != NULL &&
+        fread(&header, sizeof(header), 1, file) == 1;
+    if (file != NULL) {
+        header.userCapacity = 0x7FFFFFFF;
+        rewind(file);
+        fwrite(&header, sizeof(header), 1, file);
+        fseek(file, 0, SEEK_END);
+        size = ftell(file);
+        fclose(file);
+    }
+    db = OpenLastReadDB(TEST_LASTREAD_DB);
+    ok = ok && db == NULL;
+    CloseLastReadDB(db);
+    file = fopen(TEST_LASTREAD_DB, "rb");
+    if (file != NULL) {
+        fseek(file, 0, SEEK_END);
+        ok = ok && ftell(file) == size;
+        fclose(file);
+    }
+
+    printTestResult("testLastReadCorruptHeader", ok);
+    remove(TEST_LASTREAD_DB);
+}
+
+static void testNewScan(void) {
+    MessageDB *messages;
+    MessageArea *first, *second;
+    LastReadDB *db;
+    NewScanResult results[4];
+    int i, count;
+    bool ok;
+
+    removeTestFiles();
+    remove("area0002.idx");
+    remove("area0002.dat");
+    remove(TEST_LASTREAD_DB);
+    messages = NewMessageDB(TEST_MESSAGE_DB);
+    first = _AddMessageArea(messages, "First", "");
+    second = _AddMessageArea(messages, "Second", "");
+    db = OpenLastReadDB(TEST_LASTREAD_DB);
+    ok = first != NULL && second != NULL && db != NULL;
+    for (i = 0; ok && i < 10; i++) {
+        ok = postTestMessage(first, "Subject", "Body") != 0;
+    }
+    for (i = 0; ok && i < 3; i++) {
+        ok = postTestMessage(second, "Subject", "Body") != 0;
+    }
+
+    ok = ok && _SetLastRead(db, 1, first->areaID, 4);
+    count = _NewScan(db, messages, 1, results, 4);
+    ok = ok && count == 2 &&
+        results[0].areaID == first->areaID && results[0].unread == 6 &&
+        results[1].areaID == second->areaID && results[1].unread == 3;
+
+    /* A user who has never read anything sees every message. */
+    count = _NewScan(db, messages, 2, results, 4);
+    ok = ok && count == 2 && results[0].unread == 10;
+
+    /* A pointer past the high-water mark counts as nothing unread. */
+    ok = ok && _SetLastRead(db, 1, second->areaID, 50);
+    count = _NewScan(db, messages, 1, results, 1);
+    ok = ok && count == 1 && results[0].unread == 6;
+    count = _NewScan(db, messages, 1, results, 4);
+    ok = ok && count == 2 && results[1].unread == 0;
+
+    printTestResult("testNewScan", ok);
+    CloseLastReadDB(db);
+    DestroyMessageDB(messages);
+    removeTestFiles();
+    remove("area0002.idx");
+    remove("area0002.dat");
+    remove(TEST_LASTREAD_DB);
+}
+
+static void testMessageAreaLimits(void) {
+    MessageArea *area;
+    MessageIndexHeader header;
+    FILE *file;
+    long dataSize;
+    bool ok;
+
+    removeTestFiles();
+    area = OpenMessageArea("", 1, "Limits", "");
+    ok = area != NULL && postTestMessage(area, "First", "Hello") == 1;
+
+    /* A body whose offset wouldn't fit in 32 bits is refused. */
+    if (area != NULL) {
+        dataSize = area->dataSize;
+        area->dataSize = (long)(MESSAGE_DATA_MAX - 8);
+        ok = ok && postTestMessage(area, "Too far", "Hello, world") == 0 &&
+            GetHighWaterMark(area) == 1;
+        area->dataSize = dataSize;
+        ok = ok && postTestMessage(area, "Second", "Hello") == 2;
+        CloseMessageArea(area);
+    }
+
+    /* An index claiming more messages than it holds isn't opened. */
+    file = fopen(TEST_AREA_INDEX, "r+b");
+    ok = ok && file != NULL &&
+        fread(&header, sizeof(header), 1, file) == 1;
+    if (file != NULL) {
+        header.highWater = header.capacity + 1;
+        rewind(file);
+        fwrite(&header, sizeof(header), 1, file);
+        fclose(file);
+    }
+    area = OpenMessageArea("", 1, "Limits", "");
+    ok = ok && area == NULL;
+    CloseMessageArea(area);
+
+    printTestResult("testMessageAreaLimits", ok);
+    removeTestFiles();
+}
+
+void runAllMessageTests(void) {
+    printf("Running Message Base Tests...\n");
+    testPostAndReadMessages();
+    testReloadMessageDB();
+    testMessageIndexGrowth();
+    testMessageAreaLimits();
+    testLastReadPointers();
+    testLastReadWidening();
+    testLastReadCorruptHeader();
+    testNewScan();
+    printf("\n");
+}
@@ -0,0 +1,114 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/pbkdf2.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+static void toHex(const unsigned char *bytes, int length, char *out) {
+    int i;
+    for (i = 0; i < length; i++) {
+        sprintf(out + i * 2, "%02x", bytes[i]);
+    }
+}
+
+/* Test cases 1, 2 and 6 from RFC 2202. */
+static void testHMACSHA1(void) {
+    unsigned char key[80], digest[SHA1_DIGEST_SIZE];
+    char hex[SHA1_DIGEST_SIZE * 2 + 1];
+    HMAC_SHA1_CTX hmac;
+    bool passed;
+
+    memset(key, 0x0b, 20);
+    HMACSHA1Init(&hmac, key, 20);
+    HMACSHA1(&hmac, (const unsigned char *)"Hi There", 8, digest);
+    toHex(digest, sizeof(digest), hex);
+    passed = strcmp(hex, "b617318655057264e28bc0b6fb378c8ef146be00") == 0;
+
+    HMACSHA1Init(&hmac, (const unsigned char *)"Jefe", 4);
+    HMACSHA1(&hmac, (const unsigned char *)"what do ya want for nothing?",
+        28, digest);
+    toHex(digest, sizeof(digest), hex);
+    passed = passed &&
+        strcmp(hex, "effcdf6ae5eb2fa2d27416d5f184df9c259a7c79") == 0;
+
+    /* Keys longer than a block are hashed first. */
+    memset(key, 0xaa, 80);
+    HMACSHA1Init(&hmac, key, 80);
+    HMACSHA1(&hmac, (const unsigned char *)
+        "Test Using Larger Than Block-Size Key - Hash Key First", 54, digest);
+    toHex(digest, sizeof(digest), hex);
+    passed = passed &&
+        strcmp(hex, "aa4ae5e15272d00e95705637ce8a3b55ed402112") == 0;
+    printTestResult("testHMACSHA1", passed);
+}
+
+/* Test vectors from RFC 6070, except the 16777216 iteration one. */
+static void testPBKDF2SHA1(void) {
+    unsigned char key[25];
+    char hex[sizeof(key) * 2 + 1];
+    bool passed;
+
+    PBKDF2SHA1((const unsigned char *)"password", 8,
+        (const unsigned char *)"salt", 4, 1, key, 20);
+    toHex(key, 20, hex);
+    passed = strcmp(hex, "0c60c80f961f0e71f3a9b524af6012062fe037a6") == 0;
+
+    PBKDF2SHA1((const unsigned char *)"password", 8,
+        (const unsigned char *)"salt", 4, 2, key, 20);
+    toHex(key, 20, hex);
+    passed = passed &&
+        strcmp(hex, "ea6c014dc72d6f8ccd1ed92ace1d41f0d8de8957") == 0;
+
+    PBKDF2SHA1((const unsigned char *)"password", 8,
+        (const unsigned char *)"salt", 4, 4096, key, 20);
+    toHex(key, 20, hex);
+    passed = passed &&
+        strcmp(hex, "4b007901b765489abead49d926f721d065a429c1") == 0;
+
+    /* More than one block of output. */
+    PBKDF2SHA1((const unsigned char *)"passwordPASSWORDpassword", 24,
+        (const unsigned char *)"saltSALTsaltSALTsaltSALTsaltSALTsalt", 36,
+        4096, key, 25);
+    toHex(key, 25, hex);
+    passed = passed && strcmp(hex,
+        "3d2eec4fe41c849b80c8d83662c0e44a8b291a964cf2f07038") == 0;
+
+    PBKDF2SHA1((const unsigned char *)"pass\0word", 9,
+        (const unsigned char *)"sa\0lt", 5, 4096, key, 16);
+    toHex(key, 16, hex);
+    passed = passed && strcmp(hex, "56fa6aa75548099dcc37d7f03425e0c3") == 0;
+    printTestResult("testPBKDF2SHA1", passed);
+}
+
+void runAllPBKDF2Tests(void) {
+    printf("Running PBKDF2 Tests...\n");
+    testHMACSHA1();
+    testPBKDF2SHA1();
+    printf("\n");
+}
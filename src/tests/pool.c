@@ -0,0 +1,104 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/pool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+typedef struct PoolTestObject {
+    char name[21];
+    double value;
+} PoolTestObject;
+
+static void testPoolReuse(void) {
+    Pool pool = POOL("test", sizeof(PoolTestObject), 4);
+    PoolTestObject *objects[10], *again;
+    bool passed = TRUE;
+    int i;
+
+    for (i = 0; i < 10; i++) {
+        objects[i] = (PoolTestObject *)PoolAlloc(&pool);
+        passed = passed && objects[i] != NULL &&
+            (size_t)objects[i] % sizeof(double) == 0;
+        if (objects[i] != NULL) {
+            sprintf(objects[i]->name, "object %d", i);
+            objects[i]->value = i;
+        }
+    }
+    for (i = 0; i < 10; i++) {
+        passed = passed && objects[i]->value == i;
+    }
+    passed = passed && pool.inUse == 10 && pool.allocations == 10;
+#ifndef POOL_DISABLED
+    passed = passed && pool.slabCount == 3;
+#endif
+
+    /* Freed objects are handed out again before any new slab. */
+    PoolFree(&pool, objects[3]);
+    PoolFree(&pool, NULL);
+    again = (PoolTestObject *)PoolAlloc(&pool);
+#ifndef POOL_DISABLED
+    passed = passed && again == objects[3] && pool.slabCount == 3;
+#endif
+    objects[3] = again;
+    for (i = 0; i < 10; i++) {
+        PoolFree(&pool, objects[i]);
+    }
+    passed = passed && pool.inUse == 0 && pool.frees == 11 &&
+        pool.peakInUse == 10;
+    DestroyPool(&pool);
+    passed = passed && pool.slabCount == 0 && pool.freeList == NULL;
+    printTestResult("testPoolReuse", passed);
+}
+
+/* Objects smaller than a pointer still have room for the free list. */
+static void testPoolSmallObjects(void) {
+    Pool pool = POOL("small", 1, 8);
+    char *a, *b;
+    bool passed;
+
+    a = (char *)PoolAlloc(&pool);
+    b = (char *)PoolAlloc(&pool);
+    passed = a != NULL && b != NULL && a != b;
+    if (passed) {
+        *a = 'a';
+        *b = 'b';
+        passed = *a == 'a' && *b == 'b';
+    }
+    PoolFree(&pool, a);
+    PoolFree(&pool, b);
+    DestroyPool(&pool);
+    printTestResult("testPoolSmallObjects", passed);
+}
+
+void runAllPoolTests(void) {
+    printf("Running Pool Tests...\n");
+    testPoolReuse();
+    testPoolSmallObjects();
+    printf("\n");
+}
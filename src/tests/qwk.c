@@ -0,0 +1,317 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/msg.h>
+#include <vbbs/qwk.h>
+#include <vbbs/user.h>
+#include <vbbs/zip.h>
+#include <vbbs/db/lastread.h>
+#include <vbbs/db/msg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "shared.h"
+
+#define TEST_MESSAGE_DB "qwktest.db"
+#define TEST_LASTREAD_DB "qwktest.lr"
+#define TEST_PACKET "qwktest.qwk"
+#define TEST_REPLY "qwktest.msg"
+
+static void removeTestFiles(void) {
+    remove(TEST_MESSAGE_DB);
+    remove(TEST_LASTREAD_DB);
+    remove(TEST_PACKET);
+    remove(TEST_REPLY);
+    remove("area0001.idx");
+    remove("area0001.dat");
+    remove("area0002.idx");
+    remove("area0002.dat");
+}
+
+static void postTestMessage(MessageArea *area, const char *to,
+    const char *subject, const char *body, uint32_t flags) {
+    MessageHeader header;
+    InitMessageHeader(&header, "Sysop", to, subject);
+    header.flags = flags;
+    PostMessage(area, &header, body, strlen(body));
+}
+
+static void testEncodeMSBIN(void) {
+    uint8_t out[4];
+    bool ok;
+
+    EncodeMSBIN(1, out);
+    ok = out[0] == 0 && out[1] == 0 && out[2] == 0 && out[3] == 0x81;
+    EncodeMSBIN(2, out);
+    ok = ok && out[0] == 0 && out[1] == 0 && out[2] == 0 && out[3] == 0x82;
+    EncodeMSBIN(3, out);
+    ok = ok && out[0] == 0 && out[1] == 0 && out[2] == 0x40 && out[3] == 0x82;
+    EncodeMSBIN(0, out);
+    ok = ok && out[0] == 0 && out[1] == 0 && out[2] == 0 && out[3] == 0;
+    printTestResult("testEncodeMSBIN", ok);
+}
+
+/* Read a whole entry from a packet into a new buffer. */
+static char *readEntry(FILE *file, const char *name, long *size) {
+    char *data;
+    *size = FindZipEntry(file, name);
+    if (*size < 0) {
+        return NULL;
+    }
+    data = (char *)malloc(*size + 1);
+    if (data != NULL && *size > 0 && fread(data, *size, 1, file) != 1) {
+        free(data);
+        return NULL;
+    }
+    if (data != NULL) {
+        data[*size] = '\0';
+    }
+    return data;
+}
+
+static void testBuildQwkPacket(void) {
+    MessageDB *messages;
+    MessageArea *general, *other;
+    LastReadDB *lastRead;
+    QwkPacket *packet;
+    User user;
+    FILE *file;
+    char *data;
+    long size;
+    bool ok;
+
+    removeTestFiles();
+    memset(&user, 0, sizeof(user));
+    user.userID = 7;
+    strcpy(user.username, "caller");
+
+    messages = NewMessageDB(TEST_MESSAGE_DB);
+    general = _AddMessageArea(messages, "General", "");
+    other = _AddMessageArea(messages, "Other", "");
+    lastRead = OpenLastReadDB(TEST_LASTREAD_DB);
+    postTestMessage(general, "All", "Already read", "Old\n", 0);
+    postTestMessage(general, "All", "Welcome", "Line one\r\nLine two", 0);
+    postTestMessage(general, "Someone", "Secret", "Not for you\n", 
+        MESSAGE_PRIVATE);
+    postTestMessage(general, "CALLER", "For you", "Hello\n", MESSAGE_PRIVATE);
+    postTestMessage(other, "All", "Other area", "", 0);
+    _SetLastRead(lastRead, user.userID, general->areaID, 1);
+
+    packet = _BuildQwkPacket(messages, lastRead, TEST_PACKET, &user, 0);
+    ok = packet != NULL && packet->messageCount == 3;
+
+    file = fopen(TEST_PACKET, "rb");
+    ok = ok && file != NULL;
+    data = ok ? readEntry(file, "MESSAGES.DAT", &size) : NULL;
+    /* Copyright block, then a header and one body block per message. */
+    ok = ok && data != NULL && size == 7 * QWK_BLOCK_SIZE;
+    ok = ok && strncmp(data, "Produced by Qmail", 17) == 0;
+    ok = ok && strncmp(data + 128 + 71, "Welcome", 7) == 0;
+    ok = ok && strncmp(data + 128 + 116, "2     ", 6) == 0;
+    ok = ok && (uint8_t)data[128 + 122] == QWK_ACTIVE;
+    ok = ok && memcmp(data + 256, "Line one\343Line two\343 ", 19) == 0;
+    ok = ok && data[384] == '*' && strncmp(data + 384 + 71, "For you", 7) == 0;
+    ok = ok && strncmp(data + 640 + 71, "Other area", 10) == 0;
+    free(data);
+
+    data = ok ? readEntry(file, "001.NDX", &size) : NULL;
+    ok = ok && data != NULL && size == 10;
+    ok = ok && (uint8_t)data[3] == 0x82 && data[4] == 1;
+    ok = ok && (uint8_t)data[8] == 0x83 && data[7] == 0 && data[9] == 1;
+    free(data);
+    data = ok ? readEntry(file, "002.NDX", &size) : NULL;
+    ok = ok && data != NULL && size == 5 && (uint8_t)data[2] == 0x40 &&
+        (uint8_t)data[3] == 0x83 &&
+        data[4] == 2;
+    free(data);
+    data = ok ? readEntry(file, "CONTROL.DAT", &size) : NULL;
+    ok = ok && data != NULL && strstr(data, "\r\nCALLER\r\n") != NULL &&
+        strstr(data, "\r\n3\r\n1\r\n1\r\nGeneral\r\n2\r\nOther\r\n") != NULL;
+    free(data);
+    if (file != NULL) {
+        fclose(file);
+    }
+
+    /* Pointers only move once the packet is known to have arrived. */
+    ok = ok && _GetLastRead(lastRead, user.userID, general->areaID) == 1;
+    ok = ok && _CommitQwkPacket(lastRead, packet);
+    ok = ok && _GetLastRead(lastRead, user.userID, general->areaID) == 4;
+    ok = ok && _GetLastRead(lastRead, user.userID, other->areaID) == 1;
+    DestroyQwkPacket(packet);
+    ok = ok && fopen(TEST_PACKET, "rb") == NULL;
+
+    printTestResult("testBuildQwkPacket", ok);
+    CloseLastReadDB(lastRead);
+    DestroyMessageDB(messages);
+    removeTestFiles();
+}
+
+static void testBuildQwkPacketInPasses(void) {
+    MessageDB *messages;
+    MessageArea *area;
+    LastReadDB *lastRead;
+    QwkBuilder *builder;
+    QwkPacket *packet;
+    User user;
+    FILE *file;
+    char field[8];
+    char *data, *body;
+    long size, offset;
+    int i, passes = 0, count = 0;
+    bool ok;
+
+    removeTestFiles();
+    memset(&user, 0, sizeof(user));
+    user.userID = 7;
+    strcpy(user.username, "caller");
+
+    /* Longer than one chunk, so its size is reserved before it is read. */
+    body = (char *)malloc(100 * 64 + 1);
+    for (i = 0; body != NULL && i < 100; i++) {
+        sprintf(body + i * 64, "%-62d\r\n", i);
+    }
+
+    messages = NewMessageDB(TEST_MESSAGE_DB);
+    area = _AddMessageArea(messages, "General", "");
+    lastRead = OpenLastReadDB(TEST_LASTREAD_DB);
+    for (i = 0; i < 4; i++) {
+        postTestMessage(area, "All", "Short", "Hello\n", 0);
+    }
+    postTestMessage(area, "All", "Long", body != NULL ? body : "", 0);
+
+    builder = _StartQwkPacket(messages, lastRead, TEST_PACKET, &user, 0);
+    while (ContinueQwkPacket(builder, 1)) {
+        passes++;
+    }
+    packet = FinishQwkPacket(builder);
+    ok = body != NULL && packet != NULL && packet->messageCount == 5 &&
+        passes == 5;
+
+    /* Each header's block count leads to the next header. */
+    file = ok ? fopen(TEST_PACKET, "rb") : NULL;
+    data = file != NULL ? readEntry(file, "MESSAGES.DAT", &size) : NULL;
+    ok = ok && data != NULL;
+    for (offset = QWK_BLOCK_SIZE; ok && offset < size; count++) {
+        memcpy(field, data + offset + 116, 6);
+        field[6] = '\0';
+        ok = (uint8_t)data[offset + 122] == QWK_ACTIVE && atoi(field) > 1;
+        offset += atoi(field) * QWK_BLOCK_SIZE;
+    }
+    ok = ok && offset == size && count == 5;
+    ok = ok && memchr(data, '\r', size) == NULL;
+    free(data);
+    if (file != NULL) {
+        fclose(file);
+    }
+
+    ok = ok && _CommitQwkPacket(lastRead, packet) &&
+        _GetLastRead(lastRead, user.userID, area->areaID) == 5;
+
+    /* Abandoning a packet part way through deletes it. */
+    postTestMessage(area, "All", "Later", "Hello\n", 0);
+    builder = _StartQwkPacket(messages, lastRead, TEST_REPLY, &user, 0);
+    ok = ok && builder != NULL && ContinueQwkPacket(builder, 1);
+    DestroyQwkBuilder(builder);
+    file = fopen(TEST_REPLY, "rb");
+    ok = ok && file == NULL;
+    if (file != NULL) {
+        fclose(file);
+    }
+
+    printTestResult("testBuildQwkPacketInPasses", ok);
+    DestroyQwkPacket(packet);
+    CloseLastReadDB(lastRead);
+    DestroyMessageDB(messages);
+    free(body);
+    removeTestFiles();
+}
+
+static void writeReplyBlock(FILE *file, const char *conference,
+    const char *to, const char *subject, int blocks) {
+    char block[QWK_BLOCK_SIZE];
+    char field[8];
+    memset(block, ' ', sizeof(block));
+    memcpy(block + 1, conference, strlen(conference));
+    memcpy(block + 21, to, strlen(to));
+    memcpy(block + 71, subject, strlen(subject));
+    sprintf(field, "%d", blocks);
+    memcpy(block + 116, field, strlen(field));
+    block[122] = (char)QWK_ACTIVE;
+    fwrite(block, sizeof(block), 1, file);
+}
+
+static void testImportReplyPacket(void) {
+    MessageDB *messages;
+    MessageArea *area;
+    const MessageHeader *header;
+    char block[QWK_BLOCK_SIZE];
+    char body[64];
+    User user;
+    FILE *file;
+    int n;
+    bool ok;
+
+    removeTestFiles();
+    memset(&user, 0, sizeof(user));
+    user.userID = 7;
+    strcpy(user.username, "caller");
+    messages = NewMessageDB(TEST_MESSAGE_DB);
+    area = _AddMessageArea(messages, "General", "");
+
+    file = fopen(TEST_REPLY, "wb");
+    memset(block, ' ', sizeof(block));
+    memcpy(block, QWK_BBS_ID, strlen(QWK_BBS_ID));
+    fwrite(block, sizeof(block), 1, file);
+    writeReplyBlock(file, "1", "SYSOP", "Re: Welcome", 2);
+    memset(block, ' ', sizeof(block));
+    memcpy(block, "Thanks!\343Bye\343", 12);
+    fwrite(block, sizeof(block), 1, file);
+    writeReplyBlock(file, "99", "ALL", "Lost", 1);
+    fclose(file);
+
+    n = _ImportReplyPacket(messages, TEST_REPLY, &user);
+    ok = n == 1 && GetHighWaterMark(area) == 1;
+    header = GetMessageHeader(area, 1);
+    ok = ok && header != NULL && strcmp(header->subject, "Re: Welcome") == 0 &&
+        strcmp(header->to, "SYSOP") == 0 &&
+        strcmp(header->from, "caller") == 0 && header->fromUserID == 7;
+    ok = ok && ReadMessageBody(area, header, 0, body, sizeof(body)) == 12 &&
+        memcmp(body, "Thanks!\nBye\n", 12) == 0;
+
+    printTestResult("testImportReplyPacket", ok);
+    DestroyMessageDB(messages);
+    removeTestFiles();
+}
+
+void runAllQwkTests(void) {
+    printf("Running QWK Tests...\n");
+    testEncodeMSBIN();
+    testBuildQwkPacket();
+    testBuildQwkPacketInPasses();
+    testImportReplyPacket();
+    printf("\n");
+}
@@ -0,0 +1,443 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/search.h>
+#include <vbbs/db/search.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+#define TEST_SEARCH_DB "searchtest.idx"
+#define TEST_SEARCH_MESSAGE_DB "searchtest.db"
+#define TEST_SEARCH_AREA 9
+#define TEST_SEARCH_AREA_INDEX "area0009.idx"
+#define TEST_SEARCH_AREA_DATA "area0009.dat"
+
+typedef struct TokenList {
+    char terms[8][SEARCH_MAX_TERM_LENGTH];
+    uint32_t positions[8];
+    int count;
+} TokenList;
+
+static void collectToken(void *context, const char *term, int length,
+    uint32_t position) {
+    TokenList *list = (TokenList *)context;
+    if (list->count < 8) {
+        memcpy(list->terms[list->count], term, length + 1);
+        list->positions[list->count] = position;
+        list->count++;
+    }
+}
+
+static void testTokenizeText(void) {
+    const char *text = "Hello, World!  It's 2025...";
+    TokenList list;
+    bool ok;
+
+    memset(&list, 0, sizeof(list));
+    ok = TokenizeText(text, strlen(text), collectToken, &list) == 5;
+    ok = ok && list.count == 5;
+    ok = ok && strcmp(list.terms[0], "hello") == 0;
+    ok = ok && strcmp(list.terms[1], "world") == 0;
+    ok = ok && strcmp(list.terms[2], "it") == 0;
+    ok = ok && strcmp(list.terms[3], "s") == 0;
+    ok = ok && strcmp(list.terms[4], "2025") == 0 && list.positions[4] == 4;
+    printTestResult("testTokenizeText", ok);
+}
+
+static void testVarint(void) {
+    uint32_t values[] = { 0, 1, 127, 128, 16383, 16384, 0xFFFFFFFFUL };
+    uint8_t buffer[8];
+    uint32_t value;
+    int i, n;
+    bool ok = TRUE;
+
+    for (i = 0; ok && i < (int)(sizeof(values) / sizeof(values[0])); i++) {
+        n = EncodeVarint(buffer, values[i]);
+        ok = DecodeVarint(buffer, &value) == buffer + n && value == values[i];
+    }
+    ok = ok && EncodeVarint(buffer, 127) == 1 && EncodeVarint(buffer, 128) == 2;
+    printTestResult("testVarint", ok);
+}
+
+static void testPostingCursor(void) {
+    PostingList list;
+    PostingCursor cursor;
+    uint32_t doc, positions[3], read[3];
+    int count = 0;
+    bool ok = TRUE;
+
+    InitPostingList(&list);
+    /* Every third document, spread over many blocks. */
+    for (doc = 3; ok && doc <= 3000; doc += 3) {
+        positions[0] = doc % 7;
+        positions[1] = positions[0] + 2;
+        positions[2] = positions[0] + 100;
+        ok = AppendPosting(&list, doc, positions, 3);
+    }
+    ok = ok && !AppendPosting(&list, 3000, positions, 1);
+    ok = ok && list.docCount == 1000 &&
+        list.blockCount == (1000 + SEARCH_BLOCK_SIZE - 1) / SEARCH_BLOCK_SIZE;
+    ok = ok && IsPostingListValid(&list, 3000) &&
+        !IsPostingListValid(&list, 2999);
+    list.blocks[2].lastDoc++;
+    ok = ok && !IsPostingListValid(&list, 3000);
+    list.blocks[2].lastDoc--;
+
+    OpenPostingCursor(&cursor, &list);
+    while (ok && !cursor.done) {
+        count++;
+        ok = cursor.doc == (uint32_t)count * 3 && cursor.frequency == 3;
+        NextPosting(&cursor);
+    }
+    ok = ok && count == 1000;
+
+    OpenPostingCursor(&cursor, &list);
+    ok = ok && SeekPosting(&cursor, 1000) && cursor.doc == 1002;
+    ReadPositions(&cursor, read);
+    ok = ok && read[0] == 1002 % 7 && read[1] == read[0] + 2 &&
+        read[2] == read[0] + 100;
+    ok = ok && SeekPosting(&cursor, 999) && cursor.doc == 1002;
+    ok = ok && SeekPosting(&cursor, 2998) && cursor.doc == 3000;
+    ok = ok && !SeekPosting(&cursor, 3001) && cursor.done;
+
+    printTestResult("testPostingCursor", ok);
+    FreePostingList(&list);
+}
+
+static bool hasHit(SearchHit *hits, int count, uint32_t number) {
+    int i;
+    for (i = 0; i < count; i++) {
+        if (hits[i].number == number) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void addTestDocuments(SearchIndex *index) {
+    IndexDocument(index, 1, 1, "The quick brown fox", 19);
+    IndexDocument(index, 1, 2, "A brown dog and a quick cat", 27);
+    IndexDocument(index, 2, 1, "Quick! Brown fox, jumping.", 26);
+    IndexDocument(index, 2, 2, "Nothing to see here", 19);
+}
+
+static void testSearchQueries(void) {
+    SearchIndex *index;
+    SearchHit hits[8];
+    int count;
+    bool ok;
+
+    index = NewSearchIndex(NULL);
+    addTestDocuments(index);
+
+    count = _SearchMessages(index, "brown", hits, 8);
+    ok = count == 3;
+    count = _SearchMessages(index, "QUICK brown", hits, 8);
+    ok = ok && count == 3;
+    count = _SearchMessages(index, "\"quick brown\"", hits, 8);
+    ok = ok && count == 2 && hits[0].areaID == 1 && hits[0].number == 1 &&
+        hits[1].areaID == 2 && hits[1].number == 1;
+    count = _SearchMessages(index, "\"brown quick\"", hits, 8);
+    ok = ok && count == 0;
+    count = _SearchMessages(index, "cat \"brown dog\"", hits, 8);
+    ok = ok && count == 1 && hasHit(hits, count, 2);
+    count = _SearchMessages(index, "brown unicorn", hits, 8);
+    ok = ok && count == 0;
+    count = _SearchMessages(index, "brown", hits, 2);
+    ok = ok && count == 2;
+    count = _SearchMessages(index, "", hits, 8);
+    ok = ok && count == 0;
+
+    printTestResult("testSearchQueries", ok);
+    DestroySearchIndex(index);
+}
+
+static void testSearchIntersection(void) {
+    SearchIndex *index;
+    SearchHit hits[64];
+    char text[64];
+    uint32_t i;
+    int count;
+    bool ok = TRUE;
+
+    index = NewSearchIndex(NULL);
+    for (i = 1; i <= 5000; i++) {
+        sprintf(text, "common %s %s", i % 97 == 0 ? "rare" : "word",
+            i % 2 == 0 ? "even" : "odd");
+        IndexDocument(index, 1, i, text, strlen(text));
+    }
+    count = _SearchMessages(index, "rare common even", hits, 64);
+    ok = count == 25;
+    for (i = 0; ok && i < (uint32_t)count; i++) {
+        ok = hits[i].number % 194 == 0;
+    }
+    printTestResult("testSearchIntersection", ok);
+    DestroySearchIndex(index);
+}
+
+static void testSaveAndLoadSearchIndex(void) {
+    SearchIndex *index;
+    SearchHit hits[8];
+    int count;
+    bool ok;
+
+    remove(TEST_SEARCH_DB);
+    index = NewSearchIndex(TEST_SEARCH_DB);
+    addTestDocuments(index);
+    ok = _SaveSearchIndex(index);
+    DestroySearchIndex(index);
+
+    index = NewSearchIndex(TEST_SEARCH_DB);
+    ok = ok && _LoadSearchIndex(index) && index->documentCount == 4;
+    ok = ok && index->areaCapacity > 2 && index->indexedHighWater[2] == 2;
+    count = _SearchMessages(index, "\"quick brown fox\"", hits, 8);
+    ok = ok && count == 2;
+    ok = ok && IndexDocument(index, 2, 3, "Another brown fox", 17);
+    count = _SearchMessages(index, "\"brown fox\"", hits, 8);
+    ok = ok && count == 3 && hits[2].number == 3;
+
+    printTestResult("testSaveAndLoadSearchIndex", ok);
+    DestroySearchIndex(index);
+    remove(TEST_SEARCH_DB);
+}
+
+/* Save the test documents, then damage the saved file with damage(). */
+static bool loadDamagedIndex(long (*damage)(uint8_t *data, long size)) {
+    SearchIndex *index;
+    SearchHit hits[8];
+    uint8_t data[4096];
+    FILE *file;
+    long size = 0;
+    bool ok;
+
+    remove(TEST_SEARCH_DB);
+    index = NewSearchIndex(TEST_SEARCH_DB);
+    addTestDocuments(index);
+    ok = _SaveSearchIndex(index);
+    DestroySearchIndex(index);
+
+    file = fopen(TEST_SEARCH_DB, "rb");
+    if (file != NULL) {
+        size = (long)fread(data, 1, sizeof(data), file);
+        fclose(file);
+    }
+    ok = ok && size > 0 && size < (long)sizeof(data);
+    size = damage(data, size);
+    file = fopen(TEST_SEARCH_DB, "wb");
+    if (file != NULL) {
+        fwrite(data, 1, size, file);
+        fclose(file);
+    }
+
+    /* Nothing half loaded is kept, and the index can be rebuilt. */
+    index = NewSearchIndex(TEST_SEARCH_DB);
+    ok = ok && !_LoadSearchIndex(index) && index->documentCount == 0 &&
+        index->termCount == 0 && index->areaCapacity == 0 && index->dirty;
+    ok = ok && _SearchMessages(index, "fox", hits, 8) == 0;
+    ok = ok && IndexDocument(index, 1, 1, "quick brown fox", 15) &&
+        _SearchMessages(index, "fox", hits, 8) == 1;
+    DestroySearchIndex(index);
+    remove(TEST_SEARCH_DB);
+    return ok;
+}
+
+static long truncateIndex(uint8_t *data, long size) {
+    (void)data;
+    return size - 20;
+}
+
+static long corruptPostings(uint8_t *data, long size) {
+    /* The last term's postings end the file. */
+    data[size - 2] = 0xFF;
+    data[size - 1] = 0xFF;
+    return size;
+}
+
+static long corruptAreaCapacity(uint8_t *data, long size) {
+    uint32_t capacity = 0x7FFFFFFF;
+
+    /* After the magic, version, document count and term count. */
+    memcpy(data + 16, &capacity, sizeof(capacity));
+    return size;
+}
+
+static void testLoadDamagedSearchIndex(void) {
+    bool ok;
+
+    ok = loadDamagedIndex(truncateIndex);
+    ok = ok && loadDamagedIndex(corruptPostings);
+    ok = ok && loadDamagedIndex(corruptAreaCapacity);
+    printTestResult("testLoadDamagedSearchIndex", ok);
+}
+
+static uint32_t postSearchMessage(MessageArea *area, const char *subject,
+    const char *body) {
+    MessageHeader header;
+
+    InitMessageHeader(&header, "Sysop", "All", subject);
+    return PostMessage(area, &header, body, (uint32_t)strlen(body));
+}
+
+static void testIndexPostedMessages(void) {
+    SearchIndex *saved = searchIndex;
+    MessageArea *area;
+    SearchHit hits[8];
+    bool ok;
+
+    remove(TEST_SEARCH_AREA_INDEX);
+    remove(TEST_SEARCH_AREA_DATA);
+    area = OpenMessageArea("", TEST_SEARCH_AREA, "Search", "");
+    searchIndex = NewSearchIndex(TEST_SEARCH_DB);
+    ok = area != NULL && searchIndex != NULL;
+
+    /* Posted before the handler was set, so picked up with the next one. */
+    ok = ok && postSearchMessage(area, "Early", "The early bird") == 1;
+    ok = ok && SearchMessages("bird", hits, 8) == 0;
+
+    SetMessagePostHandler(IndexPostedMessage);
+    ok = ok && postSearchMessage(area, "Fox", "The quick brown fox") == 2;
+    ok = ok && SearchMessages("fox", hits, 8) == 1 &&
+        hits[0].areaID == TEST_SEARCH_AREA && hits[0].number == 2;
+    ok = ok && SearchMessages("bird", hits, 8) == 1 && hits[0].number == 1;
+    ok = ok && searchIndex->dirty;
+    SetMessagePostHandler(NULL);
+
+    printTestResult("testIndexPostedMessages", ok);
+    DestroySearchIndex(searchIndex);
+    searchIndex = saved;
+    CloseMessageArea(area);
+    remove(TEST_SEARCH_AREA_INDEX);
+    remove(TEST_SEARCH_AREA_DATA);
+}
+
+static void removePrivateSearchFiles(void) {
+    remove(TEST_SEARCH_MESSAGE_DB);
+    remove("area0001.idx");
+    remove("area0001.dat");
+}
+
+static void testSearchPrivateMessages(void) {
+    SearchIndex *index;
+    MessageDB *messages;
+    MessageArea *area;
+    MessageHeader header;
+    SearchHit hits[8];
+    User alice, bob, carol;
+    int count = 0;
+    bool ok;
+
+    removePrivateSearchFiles();
+    memset(&alice, 0, sizeof(alice));
+    alice.userID = 1;
+    strcpy(alice.username, "Alice");
+    bob = alice;
+    bob.userID = 2;
+    strcpy(bob.username, "Bob");
+    carol = alice;
+    carol.userID = 3;
+    strcpy(carol.username, "Carol");
+
+    messages = NewMessageDB(TEST_SEARCH_MESSAGE_DB);
+    area = _AddMessageArea(messages, "General", "");
+    index = NewSearchIndex(TEST_SEARCH_DB);
+    ok = area != NULL && index != NULL;
+    ok = ok && postSearchMessage(area, "Public", "The quick brown fox") == 1;
+    InitMessageHeader(&header, "Alice", "BOB", "Private");
+    header.fromUserID = alice.userID;
+    header.flags = MESSAGE_PRIVATE;
+    ok = ok && PostMessage(area, &header, "A secret fox", 12) == 2;
+    ok = ok && IndexNewMessages(index, area, &count) && count == 2;
+
+    /* Someone else's private mail is never a hit. */
+    ok = ok && _SearchVisibleMessages(index, messages, &carol, "fox",
+        hits, 8) == 1 && hits[0].number == 1;
+    ok = ok && _SearchVisibleMessages(index, messages, &carol, "secret",
+        hits, 8) == 0;
+    /* Its author and the user it is to, in any case, both see it. */
+    ok = ok && _SearchVisibleMessages(index, messages, &alice, "fox",
+        hits, 8) == 2;
+    ok = ok && _SearchVisibleMessages(index, messages, &bob, "secret",
+        hits, 8) == 1 && hits[0].number == 2;
+
+    printTestResult("testSearchPrivateMessages", ok);
+    DestroySearchIndex(index);
+    DestroyMessageDB(messages);
+    removePrivateSearchFiles();
+}
+
+static void testCheckpointSearchIndex(void) {
+    SearchIndex *index;
+    FILE *file;
+    time_t savedAt;
+    bool ok;
+
+    remove(TEST_SEARCH_DB);
+    index = NewSearchIndex(TEST_SEARCH_DB);
+    addTestDocuments(index);
+    savedAt = index->savedAt;
+
+    /* Nothing is written until the interval has passed. */
+    ok = !_CheckpointSearchIndex(index,
+        savedAt + SEARCH_CHECKPOINT_INTERVAL - 1);
+    file = fopen(TEST_SEARCH_DB, "rb");
+    ok = ok && file == NULL;
+    if (file != NULL) {
+        fclose(file);
+    }
+
+    ok = ok && _CheckpointSearchIndex(index,
+        savedAt + SEARCH_CHECKPOINT_INTERVAL) && !index->dirty;
+    file = fopen(TEST_SEARCH_DB, "rb");
+    ok = ok && file != NULL;
+    if (file != NULL) {
+        fclose(file);
+    }
+
+    /* A clean index is left alone. */
+    ok = ok && !_CheckpointSearchIndex(index,
+        savedAt + SEARCH_CHECKPOINT_INTERVAL * 3);
+
+    printTestResult("testCheckpointSearchIndex", ok);
+    DestroySearchIndex(index);
+    remove(TEST_SEARCH_DB);
+}
+
+void runAllSearchTests(void) {
+    printf("Running Search Tests...\n");
+    testTokenizeText();
+    testVarint();
+    testPostingCursor();
+    testSearchQueries();
+    testSearchIntersection();
+    testSaveAndLoadSearchIndex();
+    testLoadDamagedSearchIndex();
+    testIndexPostedMessages();
+    testSearchPrivateMessages();
+    testCheckpointSearchIndex();
+    printf("\n");
+}
@@ -0,0 +1,298 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/session.h>
+#include <vbbs/metrics.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+static int handlerCalls;
+
+static void countingHandler(Session *session) {
+    (void)session;
+    handlerCalls++;
+}
+
+static void testRunEventHandler(void) {
+    Session session;
+    unsigned long saved, slow, timed;
+    bool ok;
+
+    memset(&session, 0, sizeof(session));
+    saved = GetSlowHandlerThreshold();
+    handlerCalls = 0;
+    slow = GetCounterValue(&slowHandlers);
+    timed = GetHistogramCount(&handlerTime);
+
+    /* Nothing to run is not an error. */
+    RunEventHandler(&session);
+    ok = handlerCalls == 0 && GetHistogramCount(&handlerTime) == timed;
+
+    session.eventHandler = countingHandler;
+    SetSlowHandlerThreshold(60000);
+    RunEventHandler(&session);
+    ok = ok && handlerCalls == 1 && GetCounterValue(&slowHandlers) == slow &&
+        GetHistogramCount(&handlerTime) == timed + 1;
+
+    /* With no threshold every call counts as slow. */
+    SetSlowHandlerThreshold(0);
+    RunEventHandler(&session);
+    ok = ok && handlerCalls == 2 && GetCounterValue(&slowHandlers) == slow + 1;
+
+    ok = ok && strcmp(GetEventHandlerName(Connected), "Connected") == 0 &&
+        strcmp(GetEventHandlerName(countingHandler), "Unknown") == 0 &&
+        strcmp(GetEventHandlerName(NULL), "None") == 0;
+
+    SetSlowHandlerThreshold(saved);
+    printTestResult("testRunEventHandler", ok);
+}
+
+static void *hogged;
+
+static void hogHandler(Session *session) {
+    (void)session;
+    hogged = TrackedMalloc(GetSessionMemoryLimit() + 1);
+}
+
+static void testSessionMemoryLimit(void) {
+    Session *session;
+    Connection *conn;
+    size_t saved = GetSessionMemoryLimit();
+    unsigned long disconnects = GetCounterValue(&memoryDisconnects);
+    bool ok;
+
+    conn = NewConnection();
+    session = NewSession(NULL);
+    if (conn == NULL || session == NULL) {
+        printTestResult("testSessionMemoryLimit", FALSE);
+        return;
+    }
+    conn->inputStream = NULL;
+    conn->outputStream = NULL;
+    conn->connectionStatus = CONNECTED;
+    session->conn = conn;
+
+    /* Staying under the limit is fine. */
+    SetSessionMemoryLimit(0);
+    session->eventHandler = countingHandler;
+    RunEventHandler(session);
+    ok = conn->connectionStatus == CONNECTED &&
+        GetSessionMemory(session) == 0;
+
+    /* What the handler allocates is the session's, and too much of it
+       hangs up. */
+    SetSessionMemoryLimit(4096);
+    session->eventHandler = hogHandler;
+    RunEventHandler(session);
+    ok = ok && hogged != NULL && GetMemoryAccount() == NULL &&
+        GetMemoryAccountOf(hogged) == session->memory &&
+        GetSessionMemory(session) > 4096 && session->peakMemory > 4096 &&
+        conn->connectionStatus == DISCONNECTED &&
+        session->eventHandler == NULL && !IsBufferEmpty(conn->outputBuffer) &&
+        GetCounterValue(&memoryDisconnects) == disconnects + 1;
+
+    /* The block outlives the session. */
+    DestroySession(session);
+    TrackedFree(hogged);
+    SetSessionMemoryLimit(saved);
+    printTestResult("testSessionMemoryLimit", ok);
+}
+
+static void testOutputBackpressure(void) {
+    Session *session;
+    Connection *conn;
+    char line[201];
+    int limit, highWater, lowWater, i;
+    unsigned long pauses = GetCounterValue(&outputPauses);
+    unsigned long dropped = GetCounterValue(&droppedOutput);
+    bool ok;
+
+    GetOutputLimits(&limit, &highWater, &lowWater);
+    ok = !SetOutputLimits(8192, 2048, 2048) &&
+        !SetOutputLimits(8192, 9000, 512) &&
+        SetOutputLimits(8192, 2048, 512);
+    conn = NewConnection();
+    session = NewSession(NULL);
+    if (conn == NULL || session == NULL) {
+        printTestResult("testOutputBackpressure", FALSE);
+        return;
+    }
+    conn->inputStream = NULL;
+    conn->outputStream = NULL;
+    conn->connectionStatus = CONNECTED;
+    session->conn = conn;
+    memset(line, 'x', sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+
+    /* Paused at the high watermark, until drained to the low one. */
+    for (i = 0; i < 10; i++) {
+        WriteToConnection(conn, "%s", line);
+    }
+    ok = ok && !IsOutputPaused(conn);
+    WriteToConnection(conn, "%s", line);
+    ok = ok && IsOutputPaused(conn) &&
+        GetCounterValue(&outputPauses) == pauses + 1;
+    ShiftBuffer(conn->outputBuffer, 1600);
+    ok = ok && IsOutputPaused(conn);
+
+    /* A waiting handler runs again once the output drains. */
+    handlerCalls = 0;
+    session->eventHandler = countingHandler;
+    session->awaitingOutput = TRUE;
+    ContinueOutput(session);
+    ok = ok && handlerCalls == 0;
+    ShiftBuffer(conn->outputBuffer, 100);
+    ContinueOutput(session);
+    ok = ok && !IsOutputPaused(conn) && handlerCalls == 1 &&
+        !session->awaitingOutput;
+    ContinueOutput(session);
+    ok = ok && handlerCalls == 1;
+
+    /* Past the limit output is dropped, and counted. */
+    for (i = 0; i < 50; i++) {
+        WriteToConnection(conn, "%s", line);
+    }
+    ok = ok && conn->outputBuffer->length == 8192 &&
+        GetCounterValue(&droppedOutput) > dropped;
+
+    DestroySession(session);
+    SetOutputLimits(limit, highWater, lowWater);
+    printTestResult("testOutputBackpressure", ok);
+}
+
+static void testOutputPacing(void) {
+    Connection *conn;
+    char line[201];
+    unsigned int rate = GetOutputRate();
+    unsigned long delays = GetCounterValue(&outputDelays);
+    unsigned long delay;
+    int i;
+    bool ok;
+
+    SetOutputRate(0);
+    conn = NewConnection();
+    if (conn == NULL) {
+        printTestResult("testOutputPacing", FALSE);
+        return;
+    }
+    conn->inputStream = NULL;
+    conn->outputStream = tmpfile();
+    memset(line, 'x', sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+
+    /* Unpaced, everything goes at once. */
+    for (i = 0; i < 5; i++) {
+        WriteToConnection(conn, "%s", line);
+    }
+    ok = conn->outputStream != NULL && conn->outputNanosPerByte == 0 &&
+        WriteBufferToConnection(conn) == 1000 &&
+        IsBufferEmpty(conn->outputBuffer);
+    SetConnectionSpeed(conn, 2400);
+    ok = ok && conn->connectionSpeed == 2400 &&
+        conn->outputNanosPerByte == 0;
+
+    /* At 9600 bps a connection sends a 50ms burst, then must wait. */
+    SetOutputRate(9600);
+    SetConnectionSpeed(conn, 9600);
+    for (i = 0; i < 5; i++) {
+        WriteToConnection(conn, "%s", line);
+    }
+    ok = ok && GetOutputDelay(conn) == 0 &&
+        WriteBufferToConnection(conn) == 48 &&
+        WriteBufferToConnection(conn) == 0 &&
+        conn->outputBuffer->length == 952 &&
+        GetCounterValue(&outputDelays) >= delays + 2;
+    delay = GetOutputDelay(conn);
+    ok = ok && delay > 0 && delay <= CONNECTION_OUTPUT_BURST_NANOS;
+
+    /* Escape codes stripped for a plain terminal aren't counted as sent. */
+    SetOutputRate(0);
+    SetConnectionSpeed(conn, 9600);
+    ClearBuffer(conn->outputBuffer);
+    conn->terminal.isANSI = FALSE;
+    WriteToConnection(conn, "\033[1mbold\033[0m text");
+    ok = ok && GetOutputDelay(conn) == 0 &&
+        WriteBufferToConnection(conn) == 9 &&
+        IsBufferEmpty(conn->outputBuffer);
+
+    DestroyConnection(conn);
+    SetOutputRate(rate);
+    printTestResult("testOutputPacing", ok);
+}
+
+static void testNegotiatedSpeed(void) {
+    Session *session;
+    Connection *conn;
+    unsigned int rate = GetOutputRate();
+    unsigned long paced;
+    bool ok;
+
+    SetOutputRate(2400);
+    conn = NewConnection();
+    session = NewSession(NULL);
+    if (conn == NULL || session == NULL) {
+        printTestResult("testNegotiatedSpeed", FALSE);
+        return;
+    }
+    conn->inputStream = NULL;
+    conn->outputStream = NULL;
+    session->conn = conn;
+    paced = conn->outputNanosPerByte;
+
+    /* A speed of 0, or one that doesn't parse, keeps the configured rate. */
+    ok = paced > 0 && conn->connectionSpeed == 2400;
+    SetSessionConnectionSpeed(session, "0,0");
+    SetSessionConnectionSpeed(session, "fast");
+    SetSessionConnectionSpeed(session, "-300");
+    SetConnectionSpeed(conn, 0);
+    ok = ok && conn->connectionSpeed == 2400 &&
+        conn->outputNanosPerByte == paced;
+
+    /* Usable speeds are taken, within what a serial line could do. */
+    SetSessionConnectionSpeed(session, "38400,38400");
+    ok = ok && conn->connectionSpeed == 38400 &&
+        conn->outputNanosPerByte < paced;
+    SetSessionConnectionSpeed(session, "99999999999");
+    ok = ok && conn->connectionSpeed == CONNECTION_MAX_SPEED;
+    SetConnectionSpeed(conn, 1);
+    ok = ok && conn->connectionSpeed == CONNECTION_MIN_SPEED;
+
+    DestroySession(session);
+    SetOutputRate(rate);
+    printTestResult("testNegotiatedSpeed", ok);
+}
+
+void runAllSessionTests(void) {
+    printf("Running Session Tests...\n");
+    testRunEventHandler();
+    testSessionMemoryLimit();
+    testOutputBackpressure();
+    testOutputPacing();
+    testNegotiatedSpeed();
+    printf("\n");
+}
@@ -0,0 +1,131 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/sha1.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+static void toHex(const unsigned char *digest, char *out) {
+    int i;
+    for (i = 0; i < 20; i++) {
+        sprintf(out + i * 2, "%02X", digest[i]);
+    }
+}
+
+/* The FIPS 180-1 vectors from sha1.c, plus the empty message. */
+static bool checkVectors(void) {
+    unsigned char digest[20], chunk[1000];
+    char hex[41];
+    SHA1_CTX ctx;
+    bool passed;
+    int i;
+
+    SHA1((char *)digest, "abc", 3);
+    toHex(digest, hex);
+    passed = strcmp(hex, "A9993E364706816ABA3E25717850C26C9CD0D89D") == 0;
+
+    SHA1((char *)digest,
+        "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56);
+    toHex(digest, hex);
+    passed = passed &&
+        strcmp(hex, "84983E441C3BD26EBAAE4AA1F95129E5E54670F1") == 0;
+
+    SHA1((char *)digest, "", 0);
+    toHex(digest, hex);
+    passed = passed &&
+        strcmp(hex, "DA39A3EE5E6B4B0D3255BFEF95601890AFD80709") == 0;
+
+    memset(chunk, 'a', sizeof(chunk));
+    SHA1Init(&ctx);
+    for (i = 0; i < 1000; i++) {
+        SHA1Update(&ctx, chunk, sizeof(chunk));
+    }
+    SHA1Final(digest, &ctx);
+    toHex(digest, hex);
+    passed = passed &&
+        strcmp(hex, "34AA973CD4C4DAA4F61EEB2BDBAD27316534016F") == 0;
+    return passed;
+}
+
+/*
+ * Hash the same data in uneven pieces, so updates start and end part way
+ * through blocks and cover several blocks at once.
+ */
+static void hashPieces(const unsigned char *data, int length, int piece,
+    unsigned char digest[20]) {
+    SHA1_CTX ctx;
+    int i, n;
+
+    SHA1Init(&ctx);
+    for (i = 0; i < length; i += n) {
+        n = MIN(piece, length - i);
+        SHA1Update(&ctx, data + i, n);
+        piece = piece * 7 % 251 + 1;
+    }
+    SHA1Final(digest, &ctx);
+}
+
+static void testSHA1Implementations(void) {
+    static const SHA1Implementation implementations[] = {
+        SHA1_PORTABLE, SHA1_SSSE3, SHA1_SHA_NI
+    };
+    unsigned char data[1024], expected[20], digest[20];
+    SHA1Implementation selected;
+    char name[80];
+    bool passed;
+    int i, length;
+
+    for (i = 0; i < (int)sizeof(data); i++) {
+        data[i] = (unsigned char)(i * 131 + 7);
+    }
+    selected = SHA1SelectImplementation();
+    for (i = 0; i < 3; i++) {
+        sprintf(name, "testSHA1 (%s)",
+            SHA1ImplementationName(implementations[i]));
+        if (!SHA1UseImplementation(implementations[i])) {
+            printf("%50s: Not supported\n", name);
+            continue;
+        }
+        passed = checkVectors();
+        for (length = 0; length <= (int)sizeof(data); length += 61) {
+            SHA1UseImplementation(SHA1_PORTABLE);
+            hashPieces(data, length, sizeof(data), expected);
+            SHA1UseImplementation(implementations[i]);
+            hashPieces(data, length, 1 + length % 97, digest);
+            passed = passed && memcmp(expected, digest, 20) == 0;
+        }
+        printTestResult(name, passed);
+    }
+    SHA1UseImplementation(selected);
+}
+
+void runAllSHA1Tests(void) {
+    printf("Running SHA1 Tests...\n");
+    testSHA1Implementations();
+    printf("\n");
+}
@@ -12,5 +12,25 @@ void runAllBufferTests(void);
 void runAllCRCTests(void);
 void runAllRingBufferTests(void);
 void runAllMapTests(void);
+void runAllTransferTests(void);
+void runAllMessageTests(void);
+void runAllSearchTests(void);
+void runAllZipTests(void);
+void runAllQwkTests(void);
+void runAllLogTests(void);
+void runAllTimeTests(void);
+void runAllEventTests(void);
+void runAllMetricsTests(void);
+void runAllAdminTests(void);
+void runAllSessionTests(void);
+void runAllTerminalTests(void);
+void runAllWorkerTests(void);
+void runAllSHA1Tests(void);
+void runAllPBKDF2Tests(void);
+void runAllUserTests(void);
+void runAllThrottleTests(void);
+void runAllPoolTests(void);
+void runAllArenaTests(void);
+void runAllMemoryTests(void);
 
 #endif
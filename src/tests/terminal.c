@@ -0,0 +1,70 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/buffer.h>
+#include <vbbs/terminal.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+static bool identifiesAs(const char *response, const char *type) {
+    Terminal terminal;
+    Buffer *out = NewBuffer(1024);
+    bool matched;
+
+    if (out == NULL) {
+        return FALSE;
+    }
+    InitTerminal(&terminal);
+    CheckIdentifyResponse(out, response, &terminal);
+    matched = strcmp(terminal.type, type) == 0;
+    if (!matched) {
+        printf("%s identified as %s, expected %s\n", response + 1,
+            terminal.type, type);
+    }
+    DestroyBuffer(out);
+    return matched;
+}
+
+static void testCheckIdentifyResponse(void) {
+    bool passed;
+
+    passed = identifiesAs("\033[?1;2c", "VT100");
+    /* A lone attribute has no ';' after it. */
+    passed = identifiesAs("\033[?62c", "VT220") && passed;
+    passed = identifiesAs("no response", "Unknown") && passed;
+    /* More attributes than fit are ignored. */
+    passed = identifiesAs("\033[?64;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;c",
+        "VT420") && passed;
+    printTestResult("testCheckIdentifyResponse", passed);
+}
+
+void runAllTerminalTests(void) {
+    printf("Running Terminal Tests...\n");
+    testCheckIdentifyResponse();
+    printf("\n");
+}
@@ -0,0 +1,121 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/throttle.h>
+#include <stdio.h>
+
+#include "shared.h"
+
+#define ADDRESS 0xC0A80001UL       /* 192.168.0.1 */
+
+static void testThrottleBackoff(void) {
+    unsigned long now = 1000;
+    bool passed = TRUE;
+    int i;
+
+    InitThrottle();
+    for (i = 0; i < THROTTLE_FREE_FAILURES; i++) {
+        passed = passed && _RecordLoginFailure(ADDRESS, now) == 0;
+    }
+    passed = passed && _GetThrottleDelay(ADDRESS, now) == 0;
+    passed = passed &&
+        _RecordLoginFailure(ADDRESS, now) == THROTTLE_BASE_DELAY &&
+        _GetThrottleDelay(ADDRESS, now) == THROTTLE_BASE_DELAY &&
+        _GetThrottleDelay(ADDRESS, now + 1) == THROTTLE_BASE_DELAY - 1 &&
+        _GetThrottleDelay(ADDRESS, now + THROTTLE_BASE_DELAY) == 0;
+    passed = passed &&
+        _RecordLoginFailure(ADDRESS, now) == THROTTLE_BASE_DELAY * 2 &&
+        _RecordLoginFailure(ADDRESS, now) == THROTTLE_BASE_DELAY * 4;
+    for (i = 0; i < 40; i++) {
+        _RecordLoginFailure(ADDRESS, now);
+    }
+    passed = passed && _GetThrottleDelay(ADDRESS, now) == THROTTLE_MAX_DELAY;
+    /* Other addresses, loopback and non-telnet callers are unaffected. */
+    passed = passed && _GetThrottleDelay(ADDRESS + 1, now) == 0 &&
+        _RecordLoginFailure(0x7F000001UL, now) == 0 &&
+        _RecordLoginFailure(0, now) == 0 && GetThrottleCount() == 1;
+
+    RecordLoginSuccess(ADDRESS);
+    passed = passed && _GetThrottleDelay(ADDRESS, now) == 0 &&
+        GetThrottleCount() == 0;
+    printTestResult("testThrottleBackoff", passed);
+}
+
+static void testThrottleDecay(void) {
+    unsigned long now = 1000;
+    bool passed;
+    int i;
+
+    InitThrottle();
+    for (i = 0; i <= THROTTLE_FREE_FAILURES; i++) {
+        _RecordLoginFailure(ADDRESS, now);
+    }
+    /* Two quiet periods forget two failures, so one more is free. */
+    now += THROTTLE_DECAY * 2;
+    passed = _GetThrottleDelay(ADDRESS, now) == 0 &&
+        _RecordLoginFailure(ADDRESS, now) == 0 &&
+        _RecordLoginFailure(ADDRESS, now) == THROTTLE_BASE_DELAY;
+    now += THROTTLE_DECAY * 100;
+    passed = passed && _RecordLoginFailure(ADDRESS, now) == 0;
+    printTestResult("testThrottleDecay", passed);
+}
+
+/*
+ * Far more addresses than entries: the table stays the same size, a busy
+ * address keeps its entry and one that went quiet is the one that goes.
+ */
+static void testThrottleEviction(void) {
+    unsigned long now = 1000, i;
+    uint32_t busy = ADDRESS, quiet = ADDRESS + 1;
+    bool passed;
+
+    InitThrottle();
+    _RecordLoginFailure(quiet, now);
+    for (i = 0; i <= THROTTLE_FREE_FAILURES; i++) {
+        _RecordLoginFailure(busy, now);
+    }
+    for (i = 0; i < 2000000UL; i++) {
+        if (i % 1000 == 0) {
+            now++;
+            _RecordLoginFailure(busy, now);
+        }
+        _RecordLoginFailure((uint32_t)(0x0A000000UL + i), now);
+    }
+    passed = GetThrottleCount() == THROTTLE_SETS * THROTTLE_WAYS;
+    passed = passed && _GetThrottleDelay(busy, now) > 0;
+    /* Starting again from nothing, so no wait after one failure. */
+    passed = passed && _RecordLoginFailure(quiet, now) == 0;
+    printTestResult("testThrottleEviction", passed);
+    InitThrottle();
+}
+
+void runAllThrottleTests(void) {
+    printf("Running Throttle Tests...\n");
+    testThrottleBackoff();
+    testThrottleDecay();
+    testThrottleEviction();
+    printf("\n");
+}
@@ -0,0 +1,117 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "shared.h"
+
+/* Covers 2024, including both daylight saving changes. */
+#define TEST_TIME_START 1704067200L
+#define TEST_TIME_STEP 2711L
+#define TEST_TIME_STEPS 11700
+
+static bool sameTime(const struct tm *a, const struct tm *b) {
+    return a->tm_year == b->tm_year && a->tm_mon == b->tm_mon &&
+        a->tm_mday == b->tm_mday && a->tm_hour == b->tm_hour &&
+        a->tm_min == b->tm_min && a->tm_sec == b->tm_sec &&
+        a->tm_wday == b->tm_wday && a->tm_yday == b->tm_yday &&
+        a->tm_isdst == b->tm_isdst;
+}
+
+/* Every cached conversion must match the C library's. */
+static bool checkLocalTimes(void) {
+    struct tm cached, expected;
+    time_t t;
+    int i;
+
+    ResetTimeCache();
+    for (i = 0; i < TEST_TIME_STEPS; i++) {
+        t = (time_t)(TEST_TIME_START + (long)i * TEST_TIME_STEP);
+        expected = *localtime(&t);
+        if (!LocalTime(t, &cached) || !sameTime(&cached, &expected)) {
+            printf("LocalTime mismatch at %ld\n", (long)t);
+            return FALSE;
+        }
+    }
+    return TRUE;
+}
+
+static void testLocalTime(void) {
+    bool ok = checkLocalTimes();
+#ifdef _POSIX_VERSION
+    char *saved = getenv("TZ");
+    char previous[64];
+
+    previous[0] = '\0';
+    if (saved != NULL) {
+        strncpy(previous, saved, sizeof(previous) - 1);
+        previous[sizeof(previous) - 1] = '\0';
+    }
+    setenv("TZ", "EST5EDT,M3.2.0,M11.1.0", 1);
+    tzset();
+    ok = ok && checkLocalTimes();
+    if (saved != NULL) {
+        setenv("TZ", previous, 1);
+    } else {
+        unsetenv("TZ");
+    }
+    tzset();
+    ResetTimeCache();
+#endif
+    printTestResult("testLocalTime", ok);
+}
+
+static void testFormatTime(void) {
+    char buffer[32], expected[32];
+    struct tm *tm;
+    time_t t = (time_t)1717243199L;
+    bool ok;
+
+    tm = localtime(&t);
+    strftime(expected, sizeof(expected), "%d %b %Y %H:%M:%S", tm);
+    FormatTime(buffer, sizeof(buffer), t);
+    ok = strcmp(buffer, expected) == 0;
+
+    strftime(expected, sizeof(expected), "%Y-%m-%d %H:%M:%S", tm);
+    ok = ok && FormatTimestamp(buffer, sizeof(buffer), t) == TIMESTAMP_LENGTH &&
+        strcmp(buffer, expected) == 0;
+    /* Cached the second time. */
+    ok = ok && FormatTimestamp(buffer, sizeof(buffer), t) == TIMESTAMP_LENGTH &&
+        strcmp(buffer, expected) == 0;
+    ok = ok && FormatTimestamp(buffer, TIMESTAMP_LENGTH, t) == 0;
+    printTestResult("testFormatTime", ok);
+}
+
+void runAllTimeTests(void) {
+    printf("Running Time Tests...\n");
+    testLocalTime();
+    testFormatTime();
+    printf("\n");
+}
@@ -0,0 +1,206 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/conn.h>
+#include <vbbs/metrics.h>
+#include <vbbs/transfer.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+#ifdef _POSIX_VERSION
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#endif
+
+#define TRANSFER_TEST_FILE "transfer_test.tmp"
+
+#ifdef _POSIX_VERSION
+
+/* Start a transfer of size bytes of data to a socket, read from fds[1]. */
+static Connection *openTransfer(const uint8_t *data, int size,
+    bool binaryMode, int *fds)
+{
+    FILE *file;
+    Connection *conn;
+
+    file = fopen(TRANSFER_TEST_FILE, "wb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fwrite(data, 1, size, file);
+    fclose(file);
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) {
+        return NULL;
+    }
+    fcntl(fds[0], F_SETFL, O_NONBLOCK);
+
+    conn = NewConnection();
+    conn->connectionType = TELNET;
+    conn->binaryMode = binaryMode;
+    conn->inputStream = NULL;
+    conn->outputStream = fdopen(fds[0], "w");
+    setvbuf(conn->outputStream, NULL, _IONBF, 0);
+    conn->transfer = NewTransfer(conn, TRANSFER_TEST_FILE);
+    return conn;
+}
+
+/* Finish a transfer from openTransfer and return what arrived. */
+static int drainTransfer(Connection *conn, int *fds, uint8_t *out,
+    int outSize)
+{
+    int n, received = 0;
+
+    while (IsTransferActive(conn)) {
+        if (ContinueTransfer(conn) < 0) {
+            break;
+        }
+        n = read(fds[1], out + received, outSize - received);
+        if (n > 0) {
+            received += n;
+        }
+    }
+    fclose(conn->outputStream);
+    conn->outputStream = NULL;
+    while ((n = read(fds[1], out + received, outSize - received)) > 0) {
+        received += n;
+    }
+    close(fds[1]);
+
+    conn->connectionType = CONSOLE;
+    DestroyConnection(conn);
+    remove(TRANSFER_TEST_FILE);
+    return received;
+}
+
+/* Send size bytes of pattern through a transfer and return what arrives. */
+static int runTransfer(const uint8_t *data, int size, bool binaryMode,
+    uint8_t *out, int outSize)
+{
+    int fds[2];
+    Connection *conn = openTransfer(data, size, binaryMode, fds);
+    if (conn == NULL) {
+        return -1;
+    }
+    return drainTransfer(conn, fds, out, outSize);
+}
+
+void testTransferEscapesIAC(void) {
+    uint8_t data[] = { 'A', 0xFF, 'B', '\r', 'C', 0xFF };
+    uint8_t expected[] = { 'A', 0xFF, 0xFF, 'B', '\r', 'C', 0xFF, 0xFF };
+    uint8_t out[64];
+    int n = runTransfer(data, sizeof(data), TRUE, out, sizeof(out));
+    printTestResult("testTransferEscapesIAC",
+        n == sizeof(expected) && memcmp(out, expected, n) == 0);
+}
+
+void testTransferEscapesCR(void) {
+    uint8_t data[] = { 'A', '\r', '\n', 0xFF };
+    uint8_t expected[] = { 'A', '\r', '\0', '\n', 0xFF, 0xFF };
+    uint8_t out[64];
+    int n = runTransfer(data, sizeof(data), FALSE, out, sizeof(out));
+    printTestResult("testTransferEscapesCR",
+        n == sizeof(expected) && memcmp(out, expected, n) == 0);
+}
+
+void testTransferLargeFile(void) {
+    static uint8_t data[100000];
+    static uint8_t out[110000];
+    int i, n, expected = 0;
+    bool ok = TRUE;
+
+    for (i = 0; i < (int)sizeof(data); i++) {
+        /* Long unescaped runs with the occasional IAC. */
+        data[i] = (i % 20000 == 19999) ? 0xFF : (uint8_t)('a' + i % 26);
+        expected += data[i] == 0xFF ? 2 : 1;
+    }
+    n = runTransfer(data, sizeof(data), TRUE, out, sizeof(out));
+    if (n != expected) {
+        printf("Expected %d bytes, received %d.\n", expected, n);
+        ok = FALSE;
+    }
+    for (i = 0; ok && i < (int)sizeof(data); i++) {
+        if (data[i] == 0xFF) {
+            ok = out[i] == 0xFF && out[i + 1] == 0xFF;
+            break;
+        }
+        ok = out[i] == data[i];
+    }
+    printTestResult("testTransferLargeFile", ok);
+}
+
+void testTransferAwaitsBinaryMode(void) {
+    uint8_t data[] = { 'A', '\r', '\n' };
+    uint8_t binary[] = { 'A', '\r', '\n' };
+    uint8_t text[] = { 'A', '\r', '\0', '\n' };
+    uint8_t out[64];
+    Connection *conn;
+    int fds[2], n;
+    bool ok;
+
+    /* Nothing is sent until the client answers, and then CRs go as is. */
+    conn = openTransfer(data, sizeof(data), FALSE, fds);
+    ok = conn != NULL;
+    if (ok) {
+        AwaitBinaryMode(conn);
+        ok = ContinueTransfer(conn) == 0 && conn->transfer->offset == 0 &&
+            GetTransferDelay(conn) > 0;
+        SetTransferBinaryMode(conn, TRUE);
+        ok = ok && GetTransferDelay(conn) == 0;
+        n = drainTransfer(conn, fds, out, sizeof(out));
+        ok = ok && n == sizeof(binary) && memcmp(out, binary, n) == 0;
+    }
+
+    /* With no answer in time CRs are escaped, and a late one is ignored. */
+    conn = ok ? openTransfer(data, sizeof(data), FALSE, fds) : NULL;
+    ok = ok && conn != NULL;
+    if (ok) {
+        AwaitBinaryMode(conn);
+        conn->transfer->negotiateDeadline = MonotonicNanos();
+        ok = GetTransferDelay(conn) == 0 && ContinueTransfer(conn) > 0;
+        SetTransferBinaryMode(conn, TRUE);
+        ok = ok && conn->transfer->escapeCR;
+        n = drainTransfer(conn, fds, out, sizeof(out));
+        ok = ok && n == sizeof(text) && memcmp(out, text, n) == 0;
+    }
+    printTestResult("testTransferAwaitsBinaryMode", ok);
+}
+
+#endif /* _POSIX_VERSION */
+
+void runAllTransferTests(void) {
+    printf("Running Transfer Tests...\n");
+#ifdef _POSIX_VERSION
+    testTransferEscapesIAC();
+    testTransferEscapesCR();
+    testTransferLargeFile();
+    testTransferAwaitsBinaryMode();
+#endif
+    printf("\n");
+}
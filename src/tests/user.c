@@ -0,0 +1,105 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/user.h>
+#include <vbbs/metrics.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+static void testHashPassword(void) {
+    char first[PASSWORD_HASH_SIZE], second[PASSWORD_HASH_SIZE];
+    bool passed;
+
+    HashPassword("secret", first);
+    HashPassword("secret", second);
+    passed = strncmp(first, PASSWORD_HASH_PREFIX "10000$",
+        strlen(PASSWORD_HASH_PREFIX "10000$")) == 0;
+    /* Each hash gets its own salt. */
+    passed = passed && strcmp(first, second) != 0;
+    passed = passed && VerifyPassword(first, "secret") &&
+        VerifyPassword(second, "secret");
+    passed = passed && !VerifyPassword(first, "Secret") &&
+        !VerifyPassword(first, "");
+    passed = passed && !PasswordNeedsRehash(first);
+    printTestResult("testHashPassword", passed);
+}
+
+static void testLegacyPassword(void) {
+    /* SHA1 of "secret", as stored before PBKDF2. */
+    const char *legacy = "E5E9FA1BA31ECD1AE84F75CAAA474F3A663F05F4";
+    bool passed;
+
+    passed = VerifyPassword(legacy, "secret") &&
+        !VerifyPassword(legacy, "secret2") && PasswordNeedsRehash(legacy);
+    passed = passed && !VerifyPassword("", "") &&
+        !VerifyPassword(PASSWORD_HASH_PREFIX "0$00$00", "") &&
+        !VerifyPassword(PASSWORD_HASH_PREFIX "1$zz$00", "");
+    printTestResult("testLegacyPassword", passed);
+}
+
+static void testPasswordIterations(void) {
+    char hash[PASSWORD_HASH_SIZE];
+    bool passed;
+
+    SetPasswordIterations(100);
+    HashPassword("secret", hash);
+    passed = !PasswordNeedsRehash(hash);
+    SetPasswordIterations(PASSWORD_ITERATIONS);
+    /* Raising the cost marks older hashes for an upgrade. */
+    passed = passed && PasswordNeedsRehash(hash) &&
+        VerifyPassword(hash, "secret");
+    printTestResult("testPasswordIterations", passed);
+}
+
+static void testUnknownUserTiming(void) {
+    char hash[PASSWORD_HASH_SIZE];
+    unsigned long start, known = 0, unknown = 0;
+    int i;
+
+    /* A user that doesn't exist is checked against "", which must cost
+       about as much as checking a real hash. */
+    HashPassword("secret", hash);
+    for (i = 0; i < 3; i++) {
+        start = MonotonicNanos();
+        VerifyPassword(hash, "guess");
+        known += MonotonicNanos() - start;
+        start = MonotonicNanos();
+        VerifyPassword("", "guess");
+        unknown += MonotonicNanos() - start;
+    }
+    printTestResult("testUnknownUserTiming", unknown * 2 > known);
+}
+
+void runAllUserTests(void) {
+    printf("Running User Tests...\n");
+    testHashPassword();
+    testLegacyPassword();
+    testUnknownUserTiming();
+    testPasswordIterations();
+    printf("\n");
+}
@@ -0,0 +1,181 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/worker.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "shared.h"
+
+typedef struct TestWork {
+    WorkItem work;
+    int input;
+    int output;
+} TestWork;
+
+static int completions;
+static int destroyed;
+static int completedTotal;
+static volatile int blocking;
+static volatile int started;
+
+static void squareWork(WorkItem *item) {
+    TestWork *job = (TestWork *)item;
+    job->output = job->input * job->input;
+}
+
+static void blockingWork(WorkItem *item) {
+    struct timespec pause;
+
+    (void)item;
+    pause.tv_sec = 0;
+    pause.tv_nsec = 1000000L;
+    __atomic_add_fetch(&started, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&blocking, __ATOMIC_SEQ_CST)) {
+        nanosleep(&pause, NULL);
+    }
+}
+
+static void countCompletion(WorkItem *item) {
+    TestWork *job = (TestWork *)item;
+    completions++;
+    completedTotal += job->output;
+}
+
+static void countDestroy(WorkItem *item) {
+    (void)item;
+    destroyed++;
+}
+
+static TestWork *newWork(WorkFunction run, void *owner, int input) {
+    TestWork *job = (TestWork *)malloc(sizeof(TestWork));
+    memset(job, 0, sizeof(TestWork));
+    job->work.run = run;
+    job->work.complete = countCompletion;
+    job->work.destroy = countDestroy;
+    job->work.owner = owner;
+    job->input = input;
+    return job;
+}
+
+/* Run completions until nothing is pending, giving up after 5 seconds. */
+static void waitForWork(void) {
+    struct timespec pause;
+    int i;
+
+    pause.tv_sec = 0;
+    pause.tv_nsec = 1000000L;
+    for (i = 0; i < 5000 && GetPendingWorkCount() > 0; i++) {
+        RunCompletedWork();
+        nanosleep(&pause, NULL);
+    }
+    RunCompletedWork();
+}
+
+static void testWorkWithoutPool(void) {
+    int owner;
+    bool passed;
+
+    completions = 0;
+    completedTotal = 0;
+    passed = SubmitWork(&newWork(squareWork, &owner, 3)->work);
+    /* The job has run, but only completes from the event loop. */
+    passed = passed && completions == 0 && GetPendingWorkCount() == 1;
+    passed = passed && RunCompletedWork() == 1 && completedTotal == 9 &&
+        GetPendingWorkCount() == 0;
+    printTestResult("testWorkWithoutPool", passed);
+}
+
+static void testWorkerPool(void) {
+    int owner, i, expected = 0;
+    bool passed;
+
+    completions = 0;
+    completedTotal = 0;
+    passed = StartWorkerPool(3, 100);
+    for (i = 0; i < 100; i++) {
+        passed = passed && SubmitWork(&newWork(squareWork, &owner, i)->work);
+        expected += i * i;
+    }
+    waitForWork();
+    passed = passed && completions == 100 && completedTotal == expected;
+    StopWorkerPool();
+    printTestResult("testWorkerPool", passed);
+}
+
+static void testWorkQueueLimit(void) {
+    int busy, flood, i;
+    struct timespec pause;
+    TestWork *rejected;
+    bool passed;
+
+    completions = 0;
+    completedTotal = 0;
+    destroyed = 0;
+    blocking = 1;
+    started = 0;
+    pause.tv_sec = 0;
+    pause.tv_nsec = 1000000L;
+    passed = StartWorkerPool(2, 4);
+
+    /* Tie up both workers, one of them for an owner that goes away. */
+    passed = passed && SubmitWork(&newWork(blockingWork, &busy, 1)->work);
+    passed = passed && SubmitWork(&newWork(blockingWork, &flood, 1)->work);
+    for (i = 0; i < 5000 && __atomic_load_n(&started, __ATOMIC_SEQ_CST) < 2;
+        i++) {
+        nanosleep(&pause, NULL);
+    }
+    for (i = 0; i < 4; i++) {
+        passed = passed && SubmitWork(&newWork(squareWork, &flood, 2)->work);
+    }
+    rejected = newWork(squareWork, &flood, 2);
+    passed = passed && !SubmitWork(&rejected->work);
+    free(rejected);
+    passed = passed && GetPendingWorkCount() == 6;
+
+    /* Cancelling frees the queue at once, and skips the running job. */
+    CancelWork(&flood);
+    passed = passed && GetPendingWorkCount() == 2 && destroyed == 4;
+    passed = passed && SubmitWork(&newWork(squareWork, &busy, 5)->work);
+    __atomic_store_n(&blocking, 0, __ATOMIC_SEQ_CST);
+    waitForWork();
+    passed = passed && completions == 2 && completedTotal == 25 &&
+        destroyed == 7;
+    StopWorkerPool();
+    printTestResult("testWorkQueueLimit", passed);
+}
+
+void runAllWorkerTests(void) {
+    printf("Running Worker Tests...\n");
+    testWorkWithoutPool();
+#ifdef WORKER_THREADS_SUPPORTED
+    testWorkerPool();
+    testWorkQueueLimit();
+#endif
+    printf("\n");
+}
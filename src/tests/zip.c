@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/crc.h>
+#include <vbbs/zip.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "shared.h"
+
+#define TEST_ZIP_FILE "ziptest.zip"
+
+static void testWriteAndFindZipEntries(void) {
+    ZipWriter *zip;
+    FILE *file;
+    char data[32];
+    long size;
+    bool ok;
+
+    file = fopen(TEST_ZIP_FILE, "w+b");
+    zip = NewZipWriter(file);
+    ok = zip != NULL;
+    ok = ok && StartZipEntry(zip, "FIRST.TXT", 0);
+    ok = ok && WriteZipData(zip, "Hello, ", 7);
+    ok = ok && WriteZipData(zip, "world!", 6);
+    ok = ok && FinishZipEntry(zip);
+    ok = ok && StartZipEntry(zip, "EMPTY.TXT", 0);
+    ok = ok && FinishZipEntry(zip);
+    ok = ok && StartZipEntry(zip, "SECOND.TXT", 0);
+    ok = ok && WriteZipData(zip, "Second", 6);
+    /* Entries can't be nested. */
+    ok = ok && !StartZipEntry(zip, "THIRD.TXT", 0);
+    DestroyZipWriter(zip);
+    fclose(file);
+    printTestResult("testNestedZipEntryRejected", ok);
+
+    file = fopen(TEST_ZIP_FILE, "w+b");
+    zip = NewZipWriter(file);
+    ok = StartZipEntry(zip, "FIRST.TXT", 0) &&
+        WriteZipData(zip, "Hello, world!", 13) && FinishZipEntry(zip) &&
+        StartZipEntry(zip, "SECOND.TXT", 0) &&
+        WriteZipData(zip, "Second", 6) && FinishZipEntry(zip) &&
+        FinishZip(zip);
+    ok = ok && zip->entries->size == 2;
+    ok = ok && ((ZipEntry *)zip->entries->items[0])->crc ==
+        CRC32S("Hello, world!");
+    DestroyZipWriter(zip);
+
+    size = FindZipEntry(file, "second.txt");
+    ok = ok && size == 6 && fread(data, 6, 1, file) == 1 &&
+        memcmp(data, "Second", 6) == 0;
+    size = FindZipEntry(file, "FIRST.TXT");
+    ok = ok && size == 13 && fread(data, 13, 1, file) == 1 &&
+        memcmp(data, "Hello, world!", 13) == 0;
+    ok = ok && FindZipEntry(file, "MISSING.TXT") == -1;
+    ok = ok && FindZipEntry(file, "FIRST") == -1;
+    fclose(file);
+    remove(TEST_ZIP_FILE);
+    printTestResult("testWriteAndFindZipEntries", ok);
+}
+
+void runAllZipTests(void) {
+    printf("Running ZIP Tests...\n");
+    testWriteAndFindZipEntries();
+    printf("\n");
+}
@@ -0,0 +1,206 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+#include <string.h>
+#include <time.h>
+#include <vbbs/throttle.h>
+#include <vbbs/metrics.h>
+
+typedef struct ThrottleEntry
+{
+    uint32_t address;
+    uint32_t lastSeen;             /* 0 for an empty entry */
+    uint32_t blockedUntil;
+    uint32_t failures;
+} ThrottleEntry;
+
+static ThrottleEntry throttle[THROTTLE_SETS][THROTTLE_WAYS];
+static uint32_t throttleKey = 0;
+
+/** Seconds since an arbitrary point, never 0. */
+static unsigned long ThrottleNow(void)
+{
+#ifdef _POSIX_VERSION
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long)now.tv_sec + 1;
+#else
+    return (unsigned long)time(NULL);
+#endif
+}
+
+static bool IsThrottled(uint32_t address)
+{
+    return address != 0 && (address >> 24) != 127;
+}
+
+static ThrottleEntry *GetThrottleSet(uint32_t address)
+{
+    uint32_t hash = (uint32_t)((address ^ throttleKey) * 2654435761UL);
+    return throttle[hash >> (32 - THROTTLE_SET_BITS)];
+}
+
+/** Find an address, or NULL if it has no entry. */
+static ThrottleEntry *FindThrottleEntry(uint32_t address)
+{
+    ThrottleEntry *set = GetThrottleSet(address);
+    int i;
+
+    for (i = 0; i < THROTTLE_WAYS; i++)
+    {
+        if (set[i].address == address && set[i].lastSeen != 0)
+        {
+            return &set[i];
+        }
+    }
+    return NULL;
+}
+
+/** Forget failures for the quiet time since the entry was last seen. */
+static void DecayThrottleEntry(ThrottleEntry *entry, unsigned long now)
+{
+    unsigned long quiet = (now - entry->lastSeen) / THROTTLE_DECAY;
+
+    entry->failures = quiet >= entry->failures ? 0 :
+        entry->failures - (uint32_t)quiet;
+    entry->lastSeen = (uint32_t)now;
+}
+
+void InitThrottle(void)
+{
+    memset(throttle, 0, sizeof(throttle));
+    throttleKey = (uint32_t)(MonotonicNanos() ^ (unsigned long)time(NULL));
+}
+
+unsigned long _GetThrottleDelay(uint32_t address, unsigned long now)
+{
+    ThrottleEntry *entry;
+
+    if (!IsThrottled(address))
+    {
+        return 0;
+    }
+    entry = FindThrottleEntry(address);
+    if (entry == NULL || entry->blockedUntil <= now)
+    {
+        return 0;
+    }
+    return entry->blockedUntil - now;
+}
+
+unsigned long _RecordLoginFailure(uint32_t address, unsigned long now)
+{
+    ThrottleEntry *entry, *set;
+    unsigned long delay = 0;
+    uint32_t excess;
+    int i;
+
+    if (!IsThrottled(address))
+    {
+        return 0;
+    }
+    entry = FindThrottleEntry(address);
+    if (entry != NULL)
+    {
+        DecayThrottleEntry(entry, now);
+    }
+    else
+    {
+        /* Take an empty entry, or the least recently seen one. */
+        set = GetThrottleSet(address);
+        entry = &set[0];
+        for (i = 1; i < THROTTLE_WAYS && entry->lastSeen != 0; i++)
+        {
+            if (set[i].lastSeen < entry->lastSeen)
+            {
+                entry = &set[i];
+            }
+        }
+        memset(entry, 0, sizeof(ThrottleEntry));
+        entry->address = address;
+        entry->lastSeen = (uint32_t)now;
+    }
+
+    if (entry->failures < 0xFFFF)
+    {
+        entry->failures++;
+    }
+    if (entry->failures > THROTTLE_FREE_FAILURES)
+    {
+        excess = entry->failures - THROTTLE_FREE_FAILURES - 1;
+        delay = THROTTLE_MAX_DELAY;
+        if (excess < 16 && ((unsigned long)THROTTLE_BASE_DELAY << excess) <
+            THROTTLE_MAX_DELAY)
+        {
+            delay = (unsigned long)THROTTLE_BASE_DELAY << excess;
+        }
+        entry->blockedUntil = (uint32_t)(now + delay);
+    }
+    return delay;
+}
+
+unsigned long GetThrottleDelay(uint32_t address)
+{
+    return _GetThrottleDelay(address, ThrottleNow());
+}
+
+unsigned long RecordLoginFailure(uint32_t address)
+{
+    return _RecordLoginFailure(address, ThrottleNow());
+}
+
+void RecordLoginSuccess(uint32_t address)
+{
+    ThrottleEntry *entry;
+
+    if (!IsThrottled(address))
+    {
+        return;
+    }
+    entry = FindThrottleEntry(address);
+    if (entry != NULL)
+    {
+        memset(entry, 0, sizeof(ThrottleEntry));
+    }
+}
+
+int GetThrottleCount(void)
+{
+    int i, j, count = 0;
+
+    for (i = 0; i < THROTTLE_SETS; i++)
+    {
+        for (j = 0; j < THROTTLE_WAYS; j++)
+        {
+            if (throttle[i][j].lastSeen != 0)
+            {
+                count++;
+            }
+        }
+    }
+    return count;
+}
@@ -31,22 +31,155 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string.h>
 #include <stdio.h>
 
-#define TIME_FORMAT "%02d %3s %04d %02d:%02d:%02d"
-
 static char *months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
                          "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
 
+/*
+ * The local midnight of the last day converted, and its broken down time.
+ * Any time in the same day is that plus the seconds since midnight. Days
+ * with a daylight saving change are never cached.
+ */
+static THREAD_LOCAL time_t cachedDayStart = (time_t)-1;
+static THREAD_LOCAL struct tm cachedDay;
+
+/* The last timestamp formatted by this thread. */
+static THREAD_LOCAL time_t cachedStampTime = (time_t)-1;
+static THREAD_LOCAL char cachedStamp[TIMESTAMP_LENGTH + 1];
+
+static bool SystemLocalTime(time_t time, struct tm *result)
+{
+#ifdef _POSIX_VERSION
+    return localtime_r(&time, result) != NULL;
+#else
+    struct tm *tm = localtime(&time);
+    if (tm == NULL)
+    {
+        return FALSE;
+    }
+    *result = *tm;
+    return TRUE;
+#endif
+}
+
+static void CacheDay(time_t time, const struct tm *tm)
+{
+    struct tm end;
+    time_t dayStart;
+
+    dayStart = time - (tm->tm_hour * 3600L + tm->tm_min * 60L + tm->tm_sec);
+    /* If the clocks change today, the last second won't be 23:59:59. */
+    if (!SystemLocalTime(dayStart + SECONDS_PER_DAY - 1, &end) ||
+        end.tm_mday != tm->tm_mday || end.tm_hour != 23 ||
+        end.tm_min != 59 || end.tm_sec != 59)
+    {
+        return;
+    }
+    cachedDay = *tm;
+    cachedDay.tm_hour = 0;
+    cachedDay.tm_min = 0;
+    cachedDay.tm_sec = 0;
+    cachedDayStart = dayStart;
+}
+
+bool LocalTime(time_t time, struct tm *result)
+{
+    long seconds;
+
+    if (result == NULL)
+    {
+        return FALSE;
+    }
+    if (cachedDayStart != (time_t)-1 && time >= cachedDayStart &&
+        time - cachedDayStart < SECONDS_PER_DAY)
+    {
+        seconds = (long)(time - cachedDayStart);
+        *result = cachedDay;
+        result->tm_hour = (int)(seconds / 3600);
+        result->tm_min = (int)(seconds / 60 % 60);
+        result->tm_sec = (int)(seconds % 60);
+        return TRUE;
+    }
+    if (!SystemLocalTime(time, result))
+    {
+        return FALSE;
+    }
+    CacheDay(time, result);
+    return TRUE;
+}
+
+void ResetTimeCache(void)
+{
+    cachedDayStart = (time_t)-1;
+    cachedStampTime = (time_t)-1;
+}
+
+/* Write value as exactly digits decimal digits. */
+static void PutDigits(char *out, int value, int digits)
+{
+    while (digits-- > 0)
+    {
+        out[digits] = (char)('0' + value % 10);
+        value /= 10;
+    }
+}
+
 void FormatTime(char *buffer, size_t bufferSize, time_t time)
 {
-    struct tm *tm;
+    struct tm tm;
     if (buffer == NULL || bufferSize < 21)
     {
         return;
     }
 
-    tm = localtime(&time);
-    sprintf(buffer, TIME_FORMAT,
-             tm->tm_mday, months[tm->tm_mon], tm->tm_year + 1900,
-             tm->tm_hour, tm->tm_min, tm->tm_sec);
-    buffer[bufferSize - 1] = '\0';
+    if (!LocalTime(time, &tm))
+    {
+        buffer[0] = '\0';
+        return;
+    }
+    /* "31 Jan 2025 23:59:59" */
+    PutDigits(buffer, tm.tm_mday, 2);
+    buffer[2] = ' ';
+    memcpy(buffer + 3, months[tm.tm_mon], 3);
+    buffer[6] = ' ';
+    PutDigits(buffer + 7, tm.tm_year + 1900, 4);
+    buffer[11] = ' ';
+    PutDigits(buffer + 12, tm.tm_hour, 2);
+    buffer[14] = ':';
+    PutDigits(buffer + 15, tm.tm_min, 2);
+    buffer[17] = ':';
+    PutDigits(buffer + 18, tm.tm_sec, 2);
+    buffer[20] = '\0';
+}
+
+int FormatTimestamp(char *buffer, size_t bufferSize, time_t time)
+{
+    struct tm tm;
+
+    if (buffer == NULL || bufferSize < TIMESTAMP_LENGTH + 1)
+    {
+        return 0;
+    }
+    if (time != cachedStampTime)
+    {
+        if (!LocalTime(time, &tm))
+        {
+            return 0;
+        }
+        /* "2025-01-31 23:59:59" */
+        PutDigits(cachedStamp, tm.tm_year + 1900, 4);
+        cachedStamp[4] = '-';
+        PutDigits(cachedStamp + 5, tm.tm_mon + 1, 2);
+        cachedStamp[7] = '-';
+        PutDigits(cachedStamp + 8, tm.tm_mday, 2);
+        cachedStamp[10] = ' ';
+        PutDigits(cachedStamp + 11, tm.tm_hour, 2);
+        cachedStamp[13] = ':';
+        PutDigits(cachedStamp + 14, tm.tm_min, 2);
+        cachedStamp[16] = ':';
+        PutDigits(cachedStamp + 17, tm.tm_sec, 2);
+        cachedStamp[TIMESTAMP_LENGTH] = '\0';
+        cachedStampTime = time;
+    }
+    memcpy(buffer, cachedStamp, TIMESTAMP_LENGTH + 1);
+    return TIMESTAMP_LENGTH;
 }
@@ -0,0 +1,474 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <vbbs/log.h>
+#include <vbbs/memory.h>
+#include <vbbs/metrics.h>
+#include <vbbs/conn.h>
+#include <vbbs/terminal.h>
+#include <vbbs/transfer.h>
+
+#ifdef _POSIX_VERSION
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#endif
+
+#ifdef __linux__
+#include <sys/sendfile.h>
+#endif
+
+/* The byte that follows an escaped byte: IAC IAC and CR NUL. */
+static uint8_t IAC_ESCAPE = TELNET_IAC;
+static uint8_t CR_ESCAPE = '\0';
+
+Transfer *NewTransfer(Connection *conn, const char *path)
+{
+    Transfer *transfer;
+
+    if (conn == NULL || path == NULL)
+    {
+        return NULL;
+    }
+
+    transfer = (Transfer *)TrackedMalloc(sizeof(Transfer));
+    if (transfer == NULL)
+    {
+        Error("Transfer: Failed to allocate memory for transfer.");
+        return NULL;
+    }
+    memset(transfer, 0, sizeof(Transfer));
+    strncpy(transfer->path, path, sizeof(transfer->path) - 1);
+    transfer->path[sizeof(transfer->path) - 1] = '\0';
+    transfer->pendingEscape = -1;
+    transfer->status = TRANSFER_ACTIVE;
+    transfer->escapeIAC = conn->connectionType == TELNET;
+    transfer->escapeCR = transfer->escapeIAC && !conn->binaryMode;
+
+    transfer->file = fopen(path, "rb");
+    if (transfer->file == NULL)
+    {
+        Error("Transfer: Could not open %s", path);
+        TrackedFree(transfer);
+        return NULL;
+    }
+    fseek(transfer->file, 0, SEEK_END);
+    transfer->size = ftell(transfer->file);
+    fseek(transfer->file, 0, SEEK_SET);
+    if (transfer->size < 0)
+    {
+        Error("Transfer: Could not determine size of %s", path);
+        DestroyTransfer(transfer);
+        return NULL;
+    }
+
+#ifdef _POSIX_VERSION
+    if (transfer->size > 0)
+    {
+        transfer->map = (uint8_t *)mmap(NULL, transfer->size, PROT_READ,
+            MAP_PRIVATE, fileno(transfer->file), 0);
+        if (transfer->map == (uint8_t *)MAP_FAILED)
+        {
+            Debug("Transfer: mmap failed for %s, using buffered copy.", path);
+            transfer->map = NULL;
+        }
+        else
+        {
+            posix_madvise(transfer->map, transfer->size,
+                POSIX_MADV_SEQUENTIAL);
+        }
+    }
+#endif
+
+    if (transfer->map == NULL)
+    {
+        /* Every byte may need escaping, so leave room for doubling. */
+        transfer->pending =
+            (uint8_t *)TrackedMalloc(TRANSFER_CHUNK_SIZE * 2);
+        if (transfer->pending == NULL)
+        {
+            Error("Transfer: Failed to allocate transfer buffer.");
+            DestroyTransfer(transfer);
+            return NULL;
+        }
+    }
+
+    return transfer;
+}
+
+void DestroyTransfer(Transfer *transfer)
+{
+    if (transfer == NULL)
+    {
+        return;
+    }
+#ifdef _POSIX_VERSION
+    if (transfer->map != NULL)
+    {
+        munmap(transfer->map, transfer->size);
+        transfer->map = NULL;
+    }
+#endif
+    if (transfer->file != NULL)
+    {
+        fclose(transfer->file);
+        transfer->file = NULL;
+    }
+    if (transfer->pending != NULL)
+    {
+        TrackedFree(transfer->pending);
+        transfer->pending = NULL;
+    }
+    TrackedFree(transfer);
+}
+
+bool IsTransferActive(Connection *conn)
+{
+    return conn != NULL && conn->transfer != NULL &&
+        conn->transfer->status == TRANSFER_ACTIVE;
+}
+
+/** Returns the escape byte that must follow c, or -1 if none is needed. */
+static int EscapeFor(Transfer *transfer, uint8_t c)
+{
+    if (c == TELNET_IAC && transfer->escapeIAC)
+    {
+        return IAC_ESCAPE;
+    }
+    if (c == '\r' && transfer->escapeCR)
+    {
+        return CR_ESCAPE;
+    }
+    return -1;
+}
+
+#ifdef _POSIX_VERSION
+
+/** Find the first byte in map[from, to) that needs escaping. */
+static long FindEscape(Transfer *transfer, long from, long to)
+{
+    uint8_t *p;
+
+    if (transfer->escapeIAC)
+    {
+        p = (uint8_t *)memchr(transfer->map + from, TELNET_IAC, to - from);
+        if (p != NULL)
+        {
+            to = p - transfer->map;
+        }
+    }
+    if (transfer->escapeCR && to > from)
+    {
+        p = (uint8_t *)memchr(transfer->map + from, '\r', to - from);
+        if (p != NULL)
+        {
+            to = p - transfer->map;
+        }
+    }
+    return to;
+}
+
+static bool WouldBlock(int error)
+{
+    return error == EAGAIN || error == EWOULDBLOCK || error == EINTR;
+}
+
+static int SendMapped(Transfer *transfer, int fd)
+{
+    struct iovec iov[TRANSFER_IOV_MAX];
+    int count, i, total = 0;
+    long end, next, pos;
+    ssize_t n = 0;
+    size_t length;
+    uint8_t c;
+
+    while (transfer->pendingEscape >= 0 || transfer->offset < transfer->size)
+    {
+        if (transfer->pendingEscape >= 0)
+        {
+            c = (uint8_t)transfer->pendingEscape;
+            n = write(fd, &c, 1);
+            if (n <= 0)
+            {
+                break;
+            }
+            transfer->pendingEscape = -1;
+            transfer->bytesSent++;
+            total++;
+            continue;
+        }
+
+        end = MIN(transfer->size, transfer->offset + TRANSFER_CHUNK_SIZE);
+        next = FindEscape(transfer, transfer->offset, end);
+
+#ifdef __linux__
+        if (next - transfer->offset >= TRANSFER_SENDFILE_MIN)
+        {
+            /* Nothing to escape, let the kernel copy from the page cache. */
+            off_t offset = transfer->offset;
+            n = sendfile(fd, fileno(transfer->file), &offset,
+                next - transfer->offset);
+            if (n <= 0)
+            {
+                break;
+            }
+            transfer->offset += n;
+            transfer->bytesSent += n;
+            total += n;
+            continue;
+        }
+#endif
+
+        /* Escape by pointing iovecs into the mapping, with each escape
+            byte inserted as its own segment. */
+        count = 0;
+        pos = transfer->offset;
+        while (pos < end && count < TRANSFER_IOV_MAX - 1)
+        {
+            next = FindEscape(transfer, pos, end);
+            if (next < end)
+            {
+                iov[count].iov_base = transfer->map + pos;
+                iov[count].iov_len = next - pos + 1;
+                count++;
+                iov[count].iov_base = transfer->map[next] == TELNET_IAC ?
+                    &IAC_ESCAPE : &CR_ESCAPE;
+                iov[count].iov_len = 1;
+                count++;
+                pos = next + 1;
+            }
+            else
+            {
+                iov[count].iov_base = transfer->map + pos;
+                iov[count].iov_len = end - pos;
+                count++;
+                pos = end;
+            }
+        }
+
+        n = writev(fd, iov, count);
+        if (n <= 0)
+        {
+            break;
+        }
+        transfer->bytesSent += n;
+        total += n;
+
+        /* Work out how much of the file was consumed by a possibly
+            partial write. */
+        for (i = 0; i < count && n > 0; i++)
+        {
+            length = iov[i].iov_len;
+            if (iov[i].iov_base == &IAC_ESCAPE ||
+                iov[i].iov_base == &CR_ESCAPE)
+            {
+                n--;
+                continue;
+            }
+            if ((size_t)n >= length)
+            {
+                transfer->offset += length;
+                n -= length;
+                if (n == 0 && i + 1 < count &&
+                    (iov[i + 1].iov_base == &IAC_ESCAPE ||
+                     iov[i + 1].iov_base == &CR_ESCAPE))
+                {
+                    /* The byte went out but its escape did not. */
+                    transfer->pendingEscape = *(uint8_t *)iov[i + 1].iov_base;
+                }
+            }
+            else
+            {
+                transfer->offset += n;
+                n = 0;
+            }
+        }
+    }
+
+    if (n < 0 && !WouldBlock(errno))
+    {
+        Error("Transfer: Error sending %s: %s", transfer->path,
+            strerror(errno));
+        transfer->status = TRANSFER_FAILED;
+        return -1;
+    }
+
+    return total;
+}
+
+#endif /* _POSIX_VERSION */
+
+static int SendBuffered(Transfer *transfer, FILE *out)
+{
+    uint8_t chunk[TRANSFER_CHUNK_SIZE];
+    int total = 0, n, i, escape;
+
+    while (TRUE)
+    {
+        if (transfer->pendingOffset < transfer->pendingLength)
+        {
+            n = fwrite(transfer->pending + transfer->pendingOffset, 1,
+                transfer->pendingLength - transfer->pendingOffset, out);
+            transfer->pendingOffset += n;
+            transfer->bytesSent += n;
+            total += n;
+            if (transfer->pendingOffset < transfer->pendingLength)
+            {
+                /* Can't write anymore, try again later. */
+                break;
+            }
+        }
+
+        if (transfer->offset >= transfer->size)
+        {
+            break;
+        }
+
+        n = fread(chunk, 1, sizeof(chunk), transfer->file);
+        if (n <= 0)
+        {
+            Error("Transfer: Error reading %s", transfer->path);
+            transfer->status = TRANSFER_FAILED;
+            return -1;
+        }
+        transfer->offset += n;
+        transfer->pendingOffset = 0;
+        transfer->pendingLength = 0;
+        for (i = 0; i < n; i++)
+        {
+            transfer->pending[transfer->pendingLength++] = chunk[i];
+            escape = EscapeFor(transfer, chunk[i]);
+            if (escape >= 0)
+            {
+                transfer->pending[transfer->pendingLength++] = escape;
+            }
+        }
+    }
+
+    return total;
+}
+
+int ContinueTransfer(Connection *conn)
+{
+    Transfer *transfer;
+    int n;
+
+    if (!IsTransferActive(conn) || conn->outputStream == NULL)
+    {
+        return 0;
+    }
+    transfer = conn->transfer;
+
+    if (!IsBufferEmpty(conn->outputBuffer))
+    {
+        /* Let queued text go out first. */
+        return 0;
+    }
+
+    if (transfer->negotiating)
+    {
+        if (MonotonicNanos() < transfer->negotiateDeadline)
+        {
+            return 0;
+        }
+        /* No answer, so the client is still in text mode. */
+        Debug("Transfer: No answer to WILL BINARY, escaping CRs in %s",
+            transfer->path);
+        transfer->negotiating = FALSE;
+    }
+
+#ifdef _POSIX_VERSION
+    if (transfer->map != NULL)
+    {
+        n = SendMapped(transfer, fileno(conn->outputStream));
+    }
+    else
+#endif
+    {
+        n = SendBuffered(transfer, conn->outputStream);
+    }
+
+    if (n >= 0 && transfer->offset >= transfer->size &&
+        transfer->pendingEscape < 0 &&
+        transfer->pendingOffset >= transfer->pendingLength)
+    {
+        transfer->status = TRANSFER_COMPLETE;
+    }
+
+    return n;
+}
+
+void AwaitBinaryMode(Connection *conn)
+{
+    if (!IsTransferActive(conn) || conn->transfer->offset > 0)
+    {
+        return;
+    }
+    conn->transfer->negotiating = TRUE;
+    conn->transfer->negotiateDeadline = MonotonicNanos() +
+        TRANSFER_NEGOTIATE_MS * 1000000UL;
+}
+
+void SetTransferBinaryMode(Connection *conn, bool binaryMode)
+{
+    Transfer *transfer;
+
+    if (!IsTransferActive(conn))
+    {
+        return;
+    }
+    transfer = conn->transfer;
+    if (!transfer->negotiating)
+    {
+        Debug("Transfer: Binary mode answer came after %s began",
+            transfer->path);
+        return;
+    }
+    transfer->escapeCR = transfer->escapeIAC && !binaryMode;
+    transfer->negotiating = FALSE;
+}
+
+unsigned long GetTransferDelay(Connection *conn)
+{
+    unsigned long now;
+
+    if (!IsTransferActive(conn) || !conn->transfer->negotiating)
+    {
+        return 0;
+    }
+    now = MonotonicNanos();
+    if (now >= conn->transfer->negotiateDeadline)
+    {
+        return 0;
+    }
+    return conn->transfer->negotiateDeadline - now;
+}
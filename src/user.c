@@ -25,11 +25,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <vbbs/types.h>
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <vbbs/user.h>
 #include <vbbs/sha1.h>
+#include <vbbs/pbkdf2.h>
 #include <vbbs/log.h>
+#include <vbbs/metrics.h>
 
 User *NewUser(void)
 {
@@ -71,62 +74,245 @@ User *CopyUser(const User *src)
     return user;
 }
 
-bool AuthenticateUser(User *user, const char *username, const char *password)
+static unsigned long passwordIterations = PASSWORD_ITERATIONS;
+
+static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+/* Checked against when there is no hash to check, see VerifyPassword. */
+static const unsigned char DUMMY_SALT[PASSWORD_SALT_SIZE] = { 0 };
+
+static void ToHex(const unsigned char *bytes, int length, char *out)
 {
     int i;
-    SHA1_CTX sha;
-    uint8_t hash[20];
-    char hashString[41];
 
-    Debug("Authenticating user: '%s'", username);
+    for (i = 0; i < length; i++)
+    {
+        *out++ = HEX_DIGITS[bytes[i] >> 4];
+        *out++ = HEX_DIGITS[bytes[i] & 0x0F];
+    }
+    *out = '\0';
+}
 
-    if (user == NULL || username == NULL || password == NULL)
+static int HexValue(char c)
+{
+    if (c >= '0' && c <= '9')
     {
-        return FALSE;
+        return c - '0';
     }
+    if (c >= 'A' && c <= 'F')
+    {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f')
+    {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
 
-    /* Hash the password */
-    SHA1Init(&sha);
-    SHA1Update(&sha, (uint8_t *) password, strlen(password));
-    SHA1Final(hash, &sha);
+/**
+ * Decode hex up to end (or the terminator, if end is NULL). Returns the
+ * number of bytes, or -1 if it is not valid hex or more than size bytes.
+ */
+static int FromHex(const char *hex, const char *end, unsigned char *out,
+    int size)
+{
+    int length = 0, high, low;
 
-    /* Convert hash to hex string */
-    for (i = 0; i < 20; i++)
+    while (hex != end && *hex != '\0')
     {
-        sprintf(&hashString[i * 2], "%02X", hash[i]);
+        high = HexValue(hex[0]);
+        low = high < 0 ? -1 : HexValue(hex[1]);
+        if (low < 0 || length >= size)
+        {
+            return -1;
+        }
+        out[length++] = (unsigned char)(high << 4 | low);
+        hex += 2;
     }
-    hashString[40] = '\0';
+    return length;
+}
 
-    Debug("Hash: %s", hashString);
+/** Compare without stopping at the first difference. */
+static bool SameBytes(const unsigned char *a, const unsigned char *b,
+    int length)
+{
+    unsigned char difference = 0;
+    int i;
 
-    if (strcmp(user->username, username) == 0 && 
-        strcmp(user->pwHash, hashString) == 0)
+    for (i = 0; i < length; i++)
     {
-        return TRUE;
+        difference |= a[i] ^ b[i];
     }
-    return FALSE;
+    return difference == 0;
 }
 
-bool ChangePassword(User *user, const char *newPassword)
+static void RandomSalt(unsigned char *salt, int length)
 {
+    FILE *random = fopen("/dev/urandom", "rb");
     int i;
+
+    if (random != NULL && fread(salt, 1, length, random) == (size_t)length)
+    {
+        fclose(random);
+        return;
+    }
+    if (random != NULL)
+    {
+        fclose(random);
+    }
+    Warn("No /dev/urandom, password salts are predictable.");
+    for (i = 0; i < length; i++)
+    {
+        salt[i] = (unsigned char)(rand() ^ (MonotonicNanos() >> (i & 7)));
+    }
+}
+
+/**
+ * Split "$pbkdf2-sha1$iterations$salt$key" into its parts. Returns FALSE
+ * for anything else, including iteration counts that are out of range.
+ */
+static bool ParsePasswordHash(const char *pwHash, unsigned long *iterations,
+    unsigned char *salt, int *saltLength, unsigned char *key, int *keyLength)
+{
+    const char *p;
+    char *end;
+
+    if (strncmp(pwHash, PASSWORD_HASH_PREFIX,
+        strlen(PASSWORD_HASH_PREFIX)) != 0)
+    {
+        return FALSE;
+    }
+    p = pwHash + strlen(PASSWORD_HASH_PREFIX);
+    *iterations = strtoul(p, &end, 10);
+    if (end == p || *end != '$' || *iterations == 0 ||
+        *iterations > PASSWORD_MAX_ITERATIONS)
+    {
+        return FALSE;
+    }
+    p = end + 1;
+    end = strchr(p, '$');
+    if (end == NULL)
+    {
+        return FALSE;
+    }
+    *saltLength = FromHex(p, end, salt, PASSWORD_SALT_SIZE);
+    *keyLength = FromHex(end + 1, NULL, key, PASSWORD_KEY_SIZE);
+    return *saltLength > 0 && *keyLength > 0;
+}
+
+void SetPasswordIterations(unsigned long iterations)
+{
+    if (iterations > 0 && iterations <= PASSWORD_MAX_ITERATIONS)
+    {
+        passwordIterations = iterations;
+    }
+}
+
+unsigned long GetPasswordIterations(void)
+{
+    return passwordIterations;
+}
+
+void HashPassword(const char *password, char *hashString)
+{
+    unsigned char salt[PASSWORD_SALT_SIZE];
+    unsigned char key[PASSWORD_KEY_SIZE];
+    int length;
+
+    RandomSalt(salt, sizeof(salt));
+    PBKDF2SHA1((const unsigned char *)password, strlen(password), salt,
+        sizeof(salt), passwordIterations, key, sizeof(key));
+
+    length = sprintf(hashString, PASSWORD_HASH_PREFIX "%lu$",
+        passwordIterations);
+    ToHex(salt, sizeof(salt), hashString + length);
+    length += sizeof(salt) * 2;
+    hashString[length++] = '$';
+    ToHex(key, sizeof(key), hashString + length);
+    memset(key, 0, sizeof(key));
+}
+
+bool PasswordNeedsRehash(const char *pwHash)
+{
+    unsigned char salt[PASSWORD_SALT_SIZE];
+    unsigned char key[PASSWORD_KEY_SIZE];
+    unsigned long iterations;
+    int saltLength, keyLength;
+
+    if (!ParsePasswordHash(pwHash, &iterations, salt, &saltLength, key,
+        &keyLength))
+    {
+        return TRUE;
+    }
+    return iterations < passwordIterations;
+}
+
+bool VerifyPassword(const char *pwHash, const char *password)
+{
+    unsigned char salt[PASSWORD_SALT_SIZE];
+    unsigned char key[PASSWORD_KEY_SIZE];
+    unsigned char derived[PASSWORD_KEY_SIZE];
+    unsigned long iterations;
+    int saltLength, keyLength;
     SHA1_CTX sha;
-    uint8_t hash[20];
-    char hashString[41];
+    unsigned long start = MonotonicNanos();
+    bool matched = FALSE;
 
-    /* Hash the password */
-    SHA1Init(&sha);
-    SHA1Update(&sha, (uint8_t *) newPassword, strlen(newPassword));
-    SHA1Final(hash, &sha);
+    if (pwHash == NULL || password == NULL)
+    {
+        return FALSE;
+    }
+
+    if (ParsePasswordHash(pwHash, &iterations, salt, &saltLength, key,
+        &keyLength))
+    {
+        PBKDF2SHA1((const unsigned char *)password, strlen(password), salt,
+            saltLength, iterations, derived, keyLength);
+        matched = SameBytes(key, derived, keyLength);
+    }
+    else
+    {
+        /* An unknown user, whose hash is "", costs as much as a known one
+            so timing doesn't tell them apart. */
+        PBKDF2SHA1((const unsigned char *)password, strlen(password),
+            DUMMY_SALT, sizeof(DUMMY_SALT), passwordIterations, derived,
+            sizeof(derived));
+        if (FromHex(pwHash, NULL, key, SHA1_DIGEST_SIZE) == SHA1_DIGEST_SIZE)
+        {
+            /* An unsalted SHA1 from before PBKDF2, upgraded at login. */
+            SHA1Init(&sha);
+            SHA1Update(&sha, (const unsigned char *)password,
+                strlen(password));
+            SHA1Final(derived, &sha);
+            matched = SameBytes(key, derived, SHA1_DIGEST_SIZE);
+        }
+    }
+    memset(derived, 0, sizeof(derived));
+
+    IncrementCounter(matched ? &authSuccesses : &authFailures);
+    RecordElapsed(&authTime, start);
+    return matched;
+}
+
+bool AuthenticateUser(User *user, const char *username, const char *password)
+{
+    Debug("Authenticating user: '%s'", username);
 
-    /* Convert hash to hex string */
-    for (i = 0; i < 20; i++)
-    { 
-        sprintf(&hashString[i * 2], "%02X", hash[i]);
+    if (user == NULL || username == NULL || password == NULL)
+    {
+        return FALSE;
     }
-    hashString[40] = '\0';
+    if (strcmp(user->username, username) != 0)
+    {
+        IncrementCounter(&authFailures);
+        return FALSE;
+    }
+    return VerifyPassword(user->pwHash, password);
+}
 
-    strncpy((char*)user->pwHash, hashString, sizeof(user->pwHash) - 1);
-    user->pwHash[sizeof(user->pwHash) - 1] = '\0';
+bool ChangePassword(User *user, const char *newPassword)
+{
+    HashPassword(newPassword, user->pwHash);
     return TRUE;
 }
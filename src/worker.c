@@ -0,0 +1,435 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <vbbs/log.h>
+#include <vbbs/metrics.h>
+#include <vbbs/worker.h>
+
+#ifdef WORKER_THREADS_SUPPORTED
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Jobs move from the queue to a worker, then to the done list, which the
+ * event loop empties. Everything below is protected by workMutex.
+ */
+static WorkItem *queueHead = NULL;
+static WorkItem *queueTail = NULL;
+static int queueLength = 0;
+static int queueDepth = WORKER_QUEUE_DEPTH;
+static WorkItem *doneHead = NULL;
+static WorkItem *doneTail = NULL;
+static int pendingCount = 0;
+
+#ifdef WORKER_THREADS_SUPPORTED
+static pthread_mutex_t workMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t workCond = PTHREAD_COND_INITIALIZER;
+static pthread_t *workerThreads = NULL;
+static WorkItem **runningItems = NULL; /* The job each worker is running */
+static int workerCount = 0;
+static bool workersRunning = FALSE;
+static int wakePipe[2] = { -1, -1 };
+#endif
+
+static void LockWork(void)
+{
+#ifdef WORKER_THREADS_SUPPORTED
+    pthread_mutex_lock(&workMutex);
+#endif
+}
+
+static void UnlockWork(void)
+{
+#ifdef WORKER_THREADS_SUPPORTED
+    pthread_mutex_unlock(&workMutex);
+#endif
+}
+
+/** Append to the done list. The lock must be held. */
+static void AddDoneWork(WorkItem *item)
+{
+    item->next = NULL;
+    if (doneTail == NULL)
+    {
+        doneHead = item;
+    }
+    else
+    {
+        doneTail->next = item;
+    }
+    doneTail = item;
+}
+
+static void FreeWork(WorkItem *item)
+{
+    if (item->destroy != NULL)
+    {
+        item->destroy(item);
+    }
+    free(item);
+}
+
+/** Free a list of jobs that will never complete. The lock must be held. */
+static void FreeWorkList(WorkItem *item)
+{
+    WorkItem *next;
+
+    for (; item != NULL; item = next)
+    {
+        next = item->next;
+        FreeWork(item);
+        pendingCount--;
+        AddToGauge(&pendingWork, -1);
+    }
+}
+
+#ifdef WORKER_THREADS_SUPPORTED
+
+static void *WorkerThread(void *arg)
+{
+    int index = (int)(long)arg;
+    WorkItem *item;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&workMutex);
+        while (queueHead == NULL && workersRunning)
+        {
+            pthread_cond_wait(&workCond, &workMutex);
+        }
+        if (!workersRunning)
+        {
+            pthread_mutex_unlock(&workMutex);
+            break;
+        }
+        item = queueHead;
+        queueHead = item->next;
+        if (queueHead == NULL)
+        {
+            queueTail = NULL;
+        }
+        queueLength--;
+        runningItems[index] = item;
+        pthread_mutex_unlock(&workMutex);
+
+        item->run(item);
+
+        pthread_mutex_lock(&workMutex);
+        runningItems[index] = NULL;
+        AddDoneWork(item);
+        pthread_mutex_unlock(&workMutex);
+
+        /* A full pipe already has a wakeup waiting in it. */
+        if (write(wakePipe[1], "w", 1) < 0 && errno != EAGAIN)
+        {
+            Error("Failed to wake the event loop: %s", strerror(errno));
+        }
+    }
+    return NULL;
+}
+
+#endif /* WORKER_THREADS_SUPPORTED */
+
+bool StartWorkerPool(int threads, int depth)
+{
+#ifdef WORKER_THREADS_SUPPORTED
+    if (workersRunning || threads <= 0 || depth <= 0)
+    {
+        return FALSE;
+    }
+    workerThreads = (pthread_t *)malloc(sizeof(pthread_t) * threads);
+    runningItems = (WorkItem **)calloc(threads, sizeof(WorkItem *));
+    if (workerThreads == NULL || runningItems == NULL)
+    {
+        Error("Failed to allocate memory for the worker pool.");
+        free(workerThreads);
+        free(runningItems);
+        workerThreads = NULL;
+        runningItems = NULL;
+        return FALSE;
+    }
+    if (pipe(wakePipe) < 0)
+    {
+        Error("Failed to create the worker pipe: %s", strerror(errno));
+        free(workerThreads);
+        free(runningItems);
+        workerThreads = NULL;
+        runningItems = NULL;
+        return FALSE;
+    }
+    fcntl(wakePipe[0], F_SETFL, O_NONBLOCK);
+    fcntl(wakePipe[1], F_SETFL, O_NONBLOCK);
+
+    queueDepth = depth;
+    workersRunning = TRUE;
+    for (workerCount = 0; workerCount < threads; workerCount++)
+    {
+        if (pthread_create(&workerThreads[workerCount], NULL, WorkerThread,
+            (void *)(long)workerCount) != 0)
+        {
+            Error("Failed to start worker thread %d.", workerCount);
+            break;
+        }
+    }
+    if (workerCount == 0)
+    {
+        StopWorkerPool();
+        return FALSE;
+    }
+    Info("Started %d worker threads, queue depth %d.", workerCount, depth);
+    return TRUE;
+#else
+    (void)threads;
+    (void)depth;
+    return FALSE;
+#endif
+}
+
+void StopWorkerPool(void)
+{
+#ifdef WORKER_THREADS_SUPPORTED
+    int i;
+
+    if (workerThreads == NULL)
+    {
+        return;
+    }
+    pthread_mutex_lock(&workMutex);
+    workersRunning = FALSE;
+    pthread_cond_broadcast(&workCond);
+    pthread_mutex_unlock(&workMutex);
+    for (i = 0; i < workerCount; i++)
+    {
+        pthread_join(workerThreads[i], NULL);
+    }
+    free(workerThreads);
+    free(runningItems);
+    workerThreads = NULL;
+    runningItems = NULL;
+    workerCount = 0;
+    close(wakePipe[0]);
+    close(wakePipe[1]);
+    wakePipe[0] = -1;
+    wakePipe[1] = -1;
+    queueDepth = WORKER_QUEUE_DEPTH;
+
+    pthread_mutex_lock(&workMutex);
+    FreeWorkList(queueHead);
+    FreeWorkList(doneHead);
+    queueHead = queueTail = NULL;
+    doneHead = doneTail = NULL;
+    queueLength = 0;
+    pthread_mutex_unlock(&workMutex);
+#endif
+}
+
+bool SubmitWork(WorkItem *item)
+{
+    if (item == NULL || item->run == NULL)
+    {
+        return FALSE;
+    }
+    item->cancelled = FALSE;
+    item->next = NULL;
+    item->submitted = MonotonicNanos();
+
+#ifdef WORKER_THREADS_SUPPORTED
+    pthread_mutex_lock(&workMutex);
+    if (workersRunning)
+    {
+        if (queueLength >= queueDepth)
+        {
+            pthread_mutex_unlock(&workMutex);
+            IncrementCounter(&rejectedWork);
+            return FALSE;
+        }
+        if (queueTail == NULL)
+        {
+            queueHead = item;
+        }
+        else
+        {
+            queueTail->next = item;
+        }
+        queueTail = item;
+        queueLength++;
+        pendingCount++;
+        AddToGauge(&pendingWork, 1);
+        pthread_cond_signal(&workCond);
+        pthread_mutex_unlock(&workMutex);
+        return TRUE;
+    }
+    pthread_mutex_unlock(&workMutex);
+#endif
+
+    /* No workers, so do it now. It still completes from the event loop. */
+    item->run(item);
+    LockWork();
+    AddDoneWork(item);
+    pendingCount++;
+    AddToGauge(&pendingWork, 1);
+    UnlockWork();
+    return TRUE;
+}
+
+void CancelWork(void *owner)
+{
+    WorkItem *item, *previous = NULL, *next;
+#ifdef WORKER_THREADS_SUPPORTED
+    int i;
+#endif
+
+    LockWork();
+    /* Waiting jobs are dropped now, freeing their place in the queue. */
+    for (item = queueHead; item != NULL; item = next)
+    {
+        next = item->next;
+        if (item->owner != owner)
+        {
+            previous = item;
+            continue;
+        }
+        if (previous == NULL)
+        {
+            queueHead = next;
+        }
+        else
+        {
+            previous->next = next;
+        }
+        if (queueTail == item)
+        {
+            queueTail = previous;
+        }
+        queueLength--;
+        item->next = NULL;
+        FreeWorkList(item);
+    }
+#ifdef WORKER_THREADS_SUPPORTED
+    for (i = 0; i < workerCount; i++)
+    {
+        if (runningItems[i] != NULL && runningItems[i]->owner == owner)
+        {
+            runningItems[i]->cancelled = TRUE;
+        }
+    }
+#endif
+    for (item = doneHead; item != NULL; item = item->next)
+    {
+        if (item->owner == owner)
+        {
+            item->cancelled = TRUE;
+        }
+    }
+    UnlockWork();
+}
+
+int RunCompletedWork(void)
+{
+    WorkItem *item;
+    bool cancelled;
+    int completed = 0;
+
+    for (;;)
+    {
+        /* One at a time, as a completion may cancel other jobs. */
+        LockWork();
+        item = doneHead;
+        if (item != NULL)
+        {
+            doneHead = item->next;
+            if (doneHead == NULL)
+            {
+                doneTail = NULL;
+            }
+            cancelled = item->cancelled;
+            pendingCount--;
+            AddToGauge(&pendingWork, -1);
+        }
+        UnlockWork();
+        if (item == NULL)
+        {
+            break;
+        }
+
+        if (!cancelled)
+        {
+            RecordElapsed(&workLatency, item->submitted);
+            if (item->complete != NULL)
+            {
+                item->complete(item);
+            }
+            completed++;
+        }
+        FreeWork(item);
+    }
+    return completed;
+}
+
+int GetPendingWorkCount(void)
+{
+    int count;
+
+    LockWork();
+    count = pendingCount;
+    UnlockWork();
+    return count;
+}
+
+#ifdef WORKER_THREADS_SUPPORTED
+
+int SetWorkerFds(fd_set *readFds, int maxFd)
+{
+    if (wakePipe[0] < 0)
+    {
+        return maxFd;
+    }
+    FD_SET(wakePipe[0], readFds);
+    return MAX(maxFd, wakePipe[0]);
+}
+
+void HandleWorkerFds(fd_set *readFds)
+{
+    char drain[64];
+
+    if (wakePipe[0] >= 0 && FD_ISSET(wakePipe[0], readFds))
+    {
+        while (read(wakePipe[0], drain, sizeof(drain)) > 0)
+        {
+            /* Each byte is one wakeup, the done list has the work. */
+        }
+    }
+    /* Jobs run without workers complete here too. */
+    RunCompletedWork();
+}
+
+#endif /* WORKER_THREADS_SUPPORTED */
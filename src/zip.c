@@ -0,0 +1,317 @@
+/*
+Copyright (c) 2025, Andrew Young
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ 
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <vbbs/types.h>
+#include <vbbs/crc.h>
+#include <vbbs/list.h>
+#include <vbbs/log.h>
+#include <vbbs/time.h>
+#include <vbbs/zip.h>
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+static void PutLE16(uint8_t *buffer, uint16_t value)
+{
+    buffer[0] = (uint8_t)(value & 0xFF);
+    buffer[1] = (uint8_t)((value >> 8) & 0xFF);
+}
+
+static void PutLE32(uint8_t *buffer, uint32_t value)
+{
+    buffer[0] = (uint8_t)(value & 0xFF);
+    buffer[1] = (uint8_t)((value >> 8) & 0xFF);
+    buffer[2] = (uint8_t)((value >> 16) & 0xFF);
+    buffer[3] = (uint8_t)((value >> 24) & 0xFF);
+}
+
+static uint16_t GetLE16(const uint8_t *buffer)
+{
+    return (uint16_t)(buffer[0] | (buffer[1] << 8));
+}
+
+static uint32_t GetLE32(const uint8_t *buffer)
+{
+    return (uint32_t)buffer[0] | ((uint32_t)buffer[1] << 8) |
+        ((uint32_t)buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+}
+
+ZipWriter *NewZipWriter(FILE *file)
+{
+    ZipWriter *zip;
+
+    if (file == NULL)
+    {
+        return NULL;
+    }
+    zip = (ZipWriter *)malloc(sizeof(ZipWriter));
+    if (zip == NULL)
+    {
+        Error("Failed to allocate memory for ZIP writer");
+        return NULL;
+    }
+    zip->file = file;
+    zip->entries = NewArrayList(8, free);
+    zip->current = NULL;
+    zip->failed = zip->entries == NULL;
+    return zip;
+}
+
+void DestroyZipWriter(ZipWriter *zip)
+{
+    if (zip == NULL)
+    {
+        return;
+    }
+    if (zip->current != NULL)
+    {
+        free(zip->current);
+    }
+    DestroyArrayList(zip->entries);
+    free(zip);
+}
+
+bool StartZipEntry(ZipWriter *zip, const char *name, time_t modified)
+{
+    uint8_t header[ZIP_LOCAL_HEADER_SIZE];
+    ZipEntry *entry;
+    struct tm tm;
+    long offset;
+    int length;
+
+    if (zip == NULL || zip->failed || zip->current != NULL || name == NULL)
+    {
+        return FALSE;
+    }
+    length = (int)strlen(name);
+    offset = ftell(zip->file);
+    if (length >= ZIP_MAX_NAME_LENGTH || offset < 0)
+    {
+        zip->failed = TRUE;
+        return FALSE;
+    }
+
+    entry = (ZipEntry *)malloc(sizeof(ZipEntry));
+    if (entry == NULL)
+    {
+        Error("Failed to allocate memory for ZIP entry");
+        zip->failed = TRUE;
+        return FALSE;
+    }
+    memset(entry, 0, sizeof(ZipEntry));
+    strcpy(entry->name, name);
+    entry->offset = (uint32_t)offset;
+    if (LocalTime(modified, &tm) && tm.tm_year >= 80)
+    {
+        entry->dosTime = (uint16_t)((tm.tm_hour << 11) |
+            (tm.tm_min << 5) | (tm.tm_sec / 2));
+        entry->dosDate = (uint16_t)(((tm.tm_year - 80) << 9) |
+            ((tm.tm_mon + 1) << 5) | tm.tm_mday);
+    }
+
+    /* The CRC and sizes are filled in by FinishZipEntry. */
+    memset(header, 0, sizeof(header));
+    PutLE32(header, ZIP_LOCAL_HEADER_SIGNATURE);
+    PutLE16(header + 4, 10);
+    PutLE16(header + 10, entry->dosTime);
+    PutLE16(header + 12, entry->dosDate);
+    PutLE16(header + 26, (uint16_t)length);
+    if (fwrite(header, sizeof(header), 1, zip->file) != 1 ||
+        fwrite(name, length, 1, zip->file) != 1)
+    {
+        free(entry);
+        zip->failed = TRUE;
+        return FALSE;
+    }
+    zip->current = entry;
+    return TRUE;
+}
+
+bool WriteZipData(ZipWriter *zip, const void *data, int length)
+{
+    if (zip == NULL || zip->failed || zip->current == NULL)
+    {
+        return FALSE;
+    }
+    if (length <= 0)
+    {
+        return TRUE;
+    }
+    if (fwrite(data, length, 1, zip->file) != 1)
+    {
+        zip->failed = TRUE;
+        return FALSE;
+    }
+    zip->current->crc = CRC32(zip->current->crc, data, length);
+    zip->current->size += length;
+    return TRUE;
+}
+
+bool FinishZipEntry(ZipWriter *zip)
+{
+    uint8_t sizes[12];
+    ZipEntry *entry;
+    long end;
+
+    if (zip == NULL || zip->failed || zip->current == NULL)
+    {
+        return FALSE;
+    }
+    entry = zip->current;
+    zip->current = NULL;
+
+    PutLE32(sizes, entry->crc);
+    PutLE32(sizes + 4, entry->size);
+    PutLE32(sizes + 8, entry->size);
+    end = ftell(zip->file);
+    if (end < 0 || fseek(zip->file, (long)entry->offset + 14, SEEK_SET) != 0 ||
+        fwrite(sizes, sizeof(sizes), 1, zip->file) != 1 ||
+        fseek(zip->file, end, SEEK_SET) != 0)
+    {
+        free(entry);
+        zip->failed = TRUE;
+        return FALSE;
+    }
+    AddToArrayList(zip->entries, entry);
+    return TRUE;
+}
+
+bool FinishZip(ZipWriter *zip)
+{
+    uint8_t header[ZIP_CENTRAL_HEADER_SIZE];
+    uint8_t end[ZIP_END_SIZE];
+    ZipEntry *entry;
+    long start, finish;
+    int i, length;
+
+    if (zip == NULL || zip->failed || zip->current != NULL)
+    {
+        return FALSE;
+    }
+
+    start = ftell(zip->file);
+    for (i = 0; i < zip->entries->size; i++)
+    {
+        entry = (ZipEntry *)GetFromArrayList(zip->entries, i);
+        length = (int)strlen(entry->name);
+        memset(header, 0, sizeof(header));
+        PutLE32(header, ZIP_CENTRAL_HEADER_SIGNATURE);
+        PutLE16(header + 4, 20);
+        PutLE16(header + 6, 10);
+        PutLE16(header + 12, entry->dosTime);
+        PutLE16(header + 14, entry->dosDate);
+        PutLE32(header + 16, entry->crc);
+        PutLE32(header + 20, entry->size);
+        PutLE32(header + 24, entry->size);
+        PutLE16(header + 28, (uint16_t)length);
+        PutLE32(header + 42, entry->offset);
+        if (fwrite(header, sizeof(header), 1, zip->file) != 1 ||
+            fwrite(entry->name, length, 1, zip->file) != 1)
+        {
+            zip->failed = TRUE;
+            return FALSE;
+        }
+    }
+    finish = ftell(zip->file);
+
+    memset(end, 0, sizeof(end));
+    PutLE32(end, ZIP_END_SIGNATURE);
+    PutLE16(end + 8, (uint16_t)zip->entries->size);
+    PutLE16(end + 10, (uint16_t)zip->entries->size);
+    PutLE32(end + 12, (uint32_t)(finish - start));
+    PutLE32(end + 16, (uint32_t)start);
+    if (start < 0 || finish < 0 || fwrite(end, sizeof(end), 1, zip->file) != 1 ||
+        fflush(zip->file) != 0)
+    {
+        zip->failed = TRUE;
+        return FALSE;
+    }
+    return TRUE;
+}
+
+static bool NamesMatch(const char *a, const char *b, int length)
+{
+    int i;
+    for (i = 0; i < length; i++)
+    {
+        if (toupper((unsigned char)a[i]) != toupper((unsigned char)b[i]))
+        {
+            return FALSE;
+        }
+    }
+    return b[length] == '\0';
+}
+
+long FindZipEntry(FILE *file, const char *name)
+{
+    uint8_t header[ZIP_LOCAL_HEADER_SIZE];
+    char entryName[ZIP_MAX_NAME_LENGTH];
+    uint16_t nameLength, extraLength;
+    uint32_t size;
+
+    if (file == NULL || name == NULL || fseek(file, 0, SEEK_SET) != 0)
+    {
+        return -1;
+    }
+
+    while (fread(header, sizeof(header), 1, file) == 1 &&
+        GetLE32(header) == ZIP_LOCAL_HEADER_SIGNATURE)
+    {
+        nameLength = GetLE16(header + 26);
+        extraLength = GetLE16(header + 28);
+        size = GetLE32(header + 18);
+        if ((GetLE16(header + 6) & 0x0008) != 0)
+        {
+            /* Sizes follow the data, so the next header can't be found. */
+            return -1;
+        }
+        if (nameLength < ZIP_MAX_NAME_LENGTH)
+        {
+            if (fread(entryName, nameLength, 1, file) != 1)
+            {
+                return -1;
+            }
+            if (fseek(file, extraLength, SEEK_CUR) != 0)
+            {
+                return -1;
+            }
+            if (NamesMatch(entryName, name, nameLength))
+            {
+                /* Only stored entries can be read directly. */
+                return GetLE16(header + 8) == 0 ? (long)size : -1;
+            }
+        }
+        else if (fseek(file, nameLength + extraLength, SEEK_CUR) != 0)
+        {
+            return -1;
+        }
+        if (fseek(file, (long)size, SEEK_CUR) != 0)
+        {
+            return -1;
+        }
+    }
+    return -1;
+}